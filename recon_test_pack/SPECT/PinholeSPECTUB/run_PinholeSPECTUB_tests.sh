@@ -31,6 +31,8 @@ echo
 MPIRUN=""
 CACHEALLVIEWS=0
 export CACHEALLVIEWS
+PRECOMPUTEALLVIEWS=0
+export PRECOMPUTEALLVIEWS
 
 #
 # Parse option arguments (--)
@@ -90,7 +92,9 @@ mkdir out
 # loop over reconstruction algorithms
 error_log_files=""
 
-for reconpar in FBP2D OSEM; do
+# OSEM_all_views and OSEM_precomputed run OSEM.par again, but keep all views in memory, such that views are
+# computed in parallel (if OpenMP is enabled), either when they are first needed, or all at once by set_up()
+for reconpar in FBP2D OSEM OSEM_all_views OSEM_precomputed; do
     # test first if analytic reconstruction and if so, run pre-correction
     isFBP=0
     if expr ${reconpar} : FBP > /dev/null; then
@@ -104,10 +108,19 @@ for reconpar in FBP2D OSEM; do
     echo "============================================="
     #echo "Using `command -v ${recon}`"
 
-    parfile=${reconpar}.par
+    if [ ${reconpar} = OSEM_all_views ]; then
+      parfile=OSEM.par
+      CACHEALLVIEWS=1
+    elif [ ${reconpar} = OSEM_precomputed ]; then
+      parfile=OSEM.par
+      CACHEALLVIEWS=1
+      PRECOMPUTEALLVIEWS=1
+    else
+      parfile=${reconpar}.par
+    fi
     # run actual reconstruction
-    echo "Running ${recon} ${parfile}"
-    logfile=out/${parfile}.log
+    echo "Running ${recon} ${parfile} (${reconpar})"
+    logfile=out/${reconpar}.par.log
     ${MPIRUN} ${recon} ${parfile} > ${logfile} 2>&1
     if [ $? -ne 0 ]; then
        echo "Error running reconstruction. CHECK RECONSTRUCTION LOG ${logfile}"
@@ -132,7 +145,7 @@ for reconpar in FBP2D OSEM; do
     echo ---- This test seems to be ok !;
     else
     echo There were problems here!
-    error_log_files="${error_log_files} my_${parfile}.log"
+    error_log_files="${error_log_files} ${logfile}"
     fi
 done
 
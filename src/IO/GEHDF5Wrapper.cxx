@@ -38,6 +38,26 @@ namespace GE
 namespace RDF_HDF5
 {
 
+//! Checks if a dataset is compressed with HDF5 filters that are all available in the current HDF5 library
+static bool
+uses_only_available_filters(const H5::DataSet& dataset)
+{
+  const H5::DSetCreatPropList create_plist = dataset.getCreatePlist();
+  const int num_filters = create_plist.getNfilters();
+  for (int filter_num = 0; filter_num < num_filters; ++filter_num)
+    {
+      unsigned int flags;
+      size_t num_client_values = 0;
+      unsigned int filter_config;
+      char name[256];
+      const H5Z_filter_t filter_id
+          = create_plist.getFilter(filter_num, flags, num_client_values, nullptr, sizeof(name), name, filter_config);
+      if (H5Zfilter_avail(filter_id) <= 0)
+        return false;
+    }
+  return num_filters > 0;
+}
+
 std::uint32_t
 GEHDF5Wrapper::read_dataset_uint32(const std::string& dataset_name)
 {
@@ -230,8 +250,13 @@ GEHDF5Wrapper::check_file()
           unsigned int is_compressed;
           H5::DataSet str_file_version = file.openDataSet("/HeaderData/ListHeader/isListCompressed");
           str_file_version.read(&is_compressed, H5::PredType::NATIVE_UINT32);
+          // Compression via the HDF5 filter pipeline is handled by the HDF5 library, but we cannot handle any other type.
           if (is_compressed)
-            error("The RDF9 Listmode file is compressed, we won't be able to read it. Please uncompress it and retry. Aborting");
+            {
+              if (!uses_only_available_filters(file.openDataSet("/ListData/listData")))
+                error("The RDF9 Listmode file is compressed, we won't be able to read it. Please uncompress it and retry. Aborting");
+              info("GEHDF5Wrapper: listmode data is compressed using HDF5 filters. It will be decompressed while reading.", 2);
+            }
         }
 
       return Succeeded::yes;
@@ -586,6 +611,18 @@ GEHDF5Wrapper::initialise_listmode_data()
   m_dataspace.getSimpleExtentDims(dims_out, NULL);
   m_list_size = dims_out[0];
 
+  {
+    const H5::DSetCreatPropList create_plist = m_dataset_sptr->getCreatePlist();
+    if (create_plist.getLayout() == H5D_CHUNKED)
+      {
+        hsize_t chunk_dims[m_max_dataset_dims];
+        create_plist.getChunk(m_dataset_list_Ndims, chunk_dims);
+        m_list_chunk_size = chunk_dims[0];
+      }
+    else
+      m_list_chunk_size = 0;
+  }
+
   return Succeeded::yes;
 }
 
@@ -651,7 +688,13 @@ GEHDF5Wrapper::initialise_proj_data(const unsigned int view_num)
       H5::DataSet str_file_version = file.openDataSet("/HeaderData/Sorter/Segment2/compDataSegSize");
       str_file_version.read(&is_compressed, H5::PredType::NATIVE_UINT32);
       if (is_compressed)
-        error("The RDF9 file sinogram is compressed, we won't be able to read it. Please uncompress it and retry. Aborting");
+        {
+          const auto num_tof_bins = read_dataset_uint32("/HeaderData/Sorter/numTOF_bins");
+          const std::string view1_address
+              = num_tof_bins > 1 ? "/SegmentData/Segment2/3D_TOF_Sinogram/view1" : "/SegmentData/Segment2/3D_Sinogram/view1";
+          if (!uses_only_available_filters(file.openDataSet(view1_address)))
+            error("The RDF9 file sinogram is compressed, we won't be able to read it. Please uncompress it and retry. Aborting");
+        }
     }
 
   if (view_num == 0 || view_num > static_cast<unsigned>(this->get_scanner_sptr()->get_num_detectors_per_ring() / 2))
@@ -811,31 +854,26 @@ GEHDF5Wrapper::read_sinogram(Array<3, unsigned char>& output,
   // We know the size of the DataSpace
   hsize_t str_dimsf[3]{ m_NX_SUB, m_NY_SUB, m_NZ_SUB };
 
-  // get a temporary buffer here,
-  std::vector<unsigned char> aux_buffer(m_NX_SUB * m_NY_SUB * m_NZ_SUB);
-
   m_dataspace.selectHyperslab(H5S_SELECT_SET, str_dimsf, offset.data());
   H5::DataSpace memspace(3, str_dimsf);
-  m_dataset_sptr->read(static_cast<void*>(aux_buffer.data()), H5::PredType::STD_U8LE, memspace, m_dataspace);
 
-  // the data is not in the correct size if its RDF9, so we will need to transpose the output of the data read.
+  // the data is not in the correct size if its RDF9, so we will need to reinterpret the dimensions of the data read.
   if (rdf_ver == 9)
     {
-      output.resize(IndexRange3D(m_NZ_SUB, m_NY_SUB, m_NX_SUB));
-      // now transpose the output.
-      // AB: todo
-      // todo 1: test
-      for (unsigned int i = 0; i < m_NZ_SUB; ++i)
+      // Note: output[i][j][k] corresponds to element i*m_NX_SUB*m_NY_SUB + j*m_NX_SUB + k in the (row-major) dataset,
+      // so we can read straight into the output if it is contiguous.
+      output = Array<3, unsigned char>(IndexRange3D(m_NZ_SUB, m_NY_SUB, m_NX_SUB));
+      if (output.is_contiguous())
         {
-          unsigned int ioffset = i * m_NX_SUB * m_NY_SUB;
-          for (unsigned int j = 0; j < m_NY_SUB; ++j)
-            {
-              unsigned int joffset = j * m_NX_SUB;
-              for (unsigned int k = 0; k < m_NX_SUB; ++k)
-                {
-                  output[i][j][k] = aux_buffer[ioffset + joffset + k];
-                }
-            }
+          m_dataset_sptr->read(static_cast<void*>(output.get_full_data_ptr()), H5::PredType::STD_U8LE, memspace, m_dataspace);
+          output.release_full_data_ptr();
+        }
+      else
+        {
+          // get a temporary buffer here,
+          std::vector<unsigned char> aux_buffer(m_NX_SUB * m_NY_SUB * m_NZ_SUB);
+          m_dataset_sptr->read(static_cast<void*>(aux_buffer.data()), H5::PredType::STD_U8LE, memspace, m_dataspace);
+          std::copy(aux_buffer.begin(), aux_buffer.end(), output.begin_all());
         }
     }
 
@@ -0,0 +1,203 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup projdata
+  \brief Implementation of classes stir::ViewTangPosToDetNumPairTable and stir::DetNumPairToViewTangPosTable
+
+  The formulas were moved from ProjDataInfoCylindricalNoArcCorr.
+*/
+
+#include "stir/DetNumPairViewTangPosTables.h"
+#include "stir/error.h"
+#include <boost/static_assert.hpp>
+#include <boost/format.hpp>
+#include <map>
+
+START_NAMESPACE_STIR
+
+namespace
+{
+// Find the table in the cache, or construct it.
+// The cache only keeps weak pointers, such that tables are deleted when they are no longer used.
+template <class TableT>
+shared_ptr<const TableT>
+get_table_from_cache(std::map<int, std::weak_ptr<const TableT>>& cache, const int num_detectors_per_ring)
+{
+  auto& cached_table = cache[num_detectors_per_ring];
+  shared_ptr<const TableT> table_sptr = cached_table.lock();
+  if (!table_sptr)
+    {
+      table_sptr = std::make_shared<const TableT>(num_detectors_per_ring);
+      cached_table = table_sptr;
+    }
+  return table_sptr;
+}
+} // namespace
+
+shared_ptr<const ViewTangPosToDetNumPairTable>
+ViewTangPosToDetNumPairTable::get_shared_table(const int num_detectors_per_ring)
+{
+  static std::map<int, std::weak_ptr<const ViewTangPosToDetNumPairTable>> cache;
+  shared_ptr<const ViewTangPosToDetNumPairTable> table_sptr;
+#ifdef STIR_OPENMP
+#  pragma omp critical(VIEWTANGPOSTODETNUMPAIRTABLE_CACHE)
+#endif
+  table_sptr = get_table_from_cache(cache, num_detectors_per_ring);
+  return table_sptr;
+}
+
+shared_ptr<const DetNumPairToViewTangPosTable>
+DetNumPairToViewTangPosTable::get_shared_table(const int num_detectors_per_ring)
+{
+  static std::map<int, std::weak_ptr<const DetNumPairToViewTangPosTable>> cache;
+  shared_ptr<const DetNumPairToViewTangPosTable> table_sptr;
+#ifdef STIR_OPENMP
+#  pragma omp critical(DETNUMPAIRTOVIEWTANGPOSTABLE_CACHE)
+#endif
+  table_sptr = get_table_from_cache(cache, num_detectors_per_ring);
+  return table_sptr;
+}
+
+/*
+   Warning:
+   this code makes use of an implementation dependent feature:
+   bit shifting negative ints to the right.
+    -1 >> 1 should be -1
+    -2 >> 1 should be -1
+   This is ok on every system which uses the 2-complement convention.
+   A compile time assert is implemented.
+*/
+
+/*
+  Go from sinograms to detectors.
+
+  Because sinograms are not arc-corrected, tang_pos_num corresponds
+  to an angle as well. Before interleaving we have that
+  \verbatim
+  det_angle_1 = LOR_angle + bin_angle
+  det_angle_2 = LOR_angle + (Pi - bin_angle)
+  \endverbatim
+  (Hint: understand this first at LOR_angle=0, then realise that
+  other LOR_angles follow just by rotation)
+
+  Code gets slightly intricate because:
+  - angles have to be defined modulo 2 Pi (so num_detectors)
+  - interleaving
+*/
+ViewTangPosToDetNumPairTable::ViewTangPosToDetNumPairTable(const int num_detectors)
+{
+  BOOST_STATIC_ASSERT(-1 >> 1 == -1);
+  BOOST_STATIC_ASSERT(-2 >> 1 == -1);
+
+  if (num_detectors <= 0 || num_detectors % 2 != 0)
+    error(boost::format("Number of detectors per ring should be even but is %1%") % num_detectors);
+
+  this->min_tang_pos_num = -(num_detectors / 2) + 1;
+  this->num_tang_poss = num_detectors;
+  const int max_tang_pos_num = this->get_max_tang_pos_num();
+  const int num_views = num_detectors / 2;
+
+  this->table.resize(static_cast<std::size_t>(num_views) * num_tang_poss);
+  for (int v_num = 0; v_num < num_views; ++v_num)
+    {
+      for (int tp_num = min_tang_pos_num; tp_num <= max_tang_pos_num; ++tp_num)
+        {
+          /*
+             adapted from CTI code
+             Note for implementation: avoid using % with negative numbers
+             so add num_detectors before doing modulo num_detectors)
+            */
+          Det1Det2& dets = this->table[v_num * num_tang_poss + (tp_num - min_tang_pos_num)];
+          dets.det1_num = (v_num + (tp_num >> 1) + num_detectors) % num_detectors;
+          dets.det2_num = (v_num - ((tp_num + 1) >> 1) + num_detectors / 2) % num_detectors;
+        }
+    }
+}
+
+DetNumPairToViewTangPosTable::DetNumPairToViewTangPosTable(const int num_detectors_v)
+    : num_detectors(num_detectors_v)
+{
+  BOOST_STATIC_ASSERT(-1 >> 1 == -1);
+  BOOST_STATIC_ASSERT(-2 >> 1 == -1);
+
+  if (num_detectors <= 0 || num_detectors % 2 != 0)
+    error(boost::format("Number of detectors per ring should be even but is %1%") % num_detectors);
+
+  const int max_num_views = num_detectors / 2;
+
+  this->table.resize(static_cast<std::size_t>(num_detectors) * num_detectors, ViewTangPosSwap{ 0, 0, false });
+  for (int det1_num = 0; det1_num < num_detectors; ++det1_num)
+    {
+      for (int det2_num = 0; det2_num < num_detectors; ++det2_num)
+        {
+          if (det1_num == det2_num)
+            continue;
+          /*
+           This somewhat obscure formula was obtained by inverting the code for
+           get_det_num_pair_for_view_tangential_pos_num()
+           This can be simplified (especially all the branching later on), but
+           as we execute this code only occasionally, it's probably not worth it.
+          */
+          int swap_detectors;
+          /*
+          Note for implementation: avoid using % with negative numbers
+          so add num_detectors before doing modulo num_detectors
+          */
+          int tang_pos_num = (det1_num - det2_num + 3 * num_detectors / 2) % num_detectors;
+          int view_num = (det1_num - (tang_pos_num >> 1) + num_detectors) % num_detectors;
+
+          /* Now adjust ranges for view_num, tang_pos_num.
+          The next lines go only wrong in the singular (and irrelevant) case
+          det_num1 == det_num2 (when tang_pos_num == num_detectors - tang_pos_num)
+
+            We use the combinations of the following 'symmetries' of
+            (tang_pos_num, view_num) == (tang_pos_num+2*num_views, view_num + num_views)
+            == (-tang_pos_num, view_num + num_views)
+            Using the latter interchanges det_num1 and det_num2, and this leaves
+            the LOR the same in the 2D case. However, in 3D this interchanges the rings
+            as well. So, we keep track of this in swap_detectors, and return its final
+            value.
+          */
+          if (view_num < max_num_views)
+            {
+              if (tang_pos_num >= max_num_views)
+                {
+                  tang_pos_num = num_detectors - tang_pos_num;
+                  swap_detectors = 1;
+                }
+              else
+                {
+                  swap_detectors = 0;
+                }
+            }
+          else
+            {
+              view_num -= max_num_views;
+              if (tang_pos_num >= max_num_views)
+                {
+                  tang_pos_num -= num_detectors;
+                  swap_detectors = 0;
+                }
+              else
+                {
+                  tang_pos_num *= -1;
+                  swap_detectors = 1;
+                }
+            }
+
+          ViewTangPosSwap& entry = this->table[det1_num * num_detectors + det2_num];
+          entry.view_num = view_num;
+          entry.tang_pos_num = tang_pos_num;
+          entry.swap_detectors = swap_detectors == 0;
+        }
+    }
+}
+
+END_NAMESPACE_STIR
@@ -26,14 +26,82 @@
 #include <boost/random/normal_distribution.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/variate_generator.hpp>
+#include <boost/math/constants/constants.hpp>
+#include <cmath>
 
 START_NAMESPACE_STIR
 
+namespace
+{
+// mixing function of the SplitMix64 generator, see
+// G. L. Steele, D. Lea, C. H. Flood, Fast splittable pseudorandom number generators, OOPSLA 2014
+inline std::uint64_t
+mix64(std::uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// counter-based generator of uniform random numbers in the open interval (0,1)
+// The stream only depends on the key and the counter passed to the constructor.
+class CounterBasedUniform01
+{
+public:
+  CounterBasedUniform01(const std::uint64_t key, const std::uint64_t counter)
+      : state(mix64(key ^ mix64(counter)))
+  {}
+
+  double operator()()
+  {
+    state += 0x9e3779b97f4a7c15ULL;
+    // use the 53 most significant bits
+    return (static_cast<double>(mix64(state) >> 11) + .5) / 9007199254740992.;
+  }
+
+private:
+  std::uint64_t state;
+};
+
+// Poisson random number for large mu, using a normal random number with mean=0 and sigma=1
+inline unsigned int
+poisson_from_normal01(const float mu, const double normal01)
+{
+  const double random = normal01 * sqrt(mu) + mu;
+  return static_cast<unsigned>(random <= 0 ? 0 : round(random));
+}
+
+// Poisson random number for small mu, using inversion of the cumulative distribution
+inline unsigned int
+poisson_by_inversion(const float mu, double u)
+{
+  // prevent problems of n growing too large (or even to infinity)
+  // when u is very close to 1
+  if (u > 1 - 1.E-6)
+    u = 1 - 1.E-6;
+
+  const double upper = exp(mu) * u;
+  double accum = 1.;
+  double term = 1.;
+  unsigned int n = 1;
+
+  while (accum < upper)
+    {
+      accum += (term *= mu / n);
+      n++;
+    }
+
+  return (n - 1);
+}
+
+} // namespace
+
 GeneralisedPoissonNoiseGenerator::base_generator_type GeneralisedPoissonNoiseGenerator::generator;
 
 GeneralisedPoissonNoiseGenerator::GeneralisedPoissonNoiseGenerator(const float scaling_factor, const bool preserve_mean)
     : scaling_factor(scaling_factor),
-      preserve_mean(preserve_mean)
+      preserve_mean(preserve_mean),
+      use_counter_based_generator(false)
 {
   this->seed(43u);
 }
@@ -44,6 +112,20 @@ GeneralisedPoissonNoiseGenerator::seed(unsigned int value)
   if (value == unsigned(0))
     error("Seed value has to be non-zero");
   this->generator.seed(static_cast<poisson_result_type>(value));
+  this->seed_value = value;
+  this->realisation_num = 0;
+}
+
+void
+GeneralisedPoissonNoiseGenerator::set_use_counter_based_generator(const bool arg)
+{
+  this->use_counter_based_generator = arg;
+}
+
+bool
+GeneralisedPoissonNoiseGenerator::get_use_counter_based_generator() const
+{
+  return this->use_counter_based_generator;
 }
 
 // function that generates a Poisson noise realisation, i.e. without
@@ -66,31 +148,11 @@ GeneralisedPoissonNoiseGenerator::generate_poisson_random(const float mu)
       // object every time. This will speed things up, especially because the
       // normal_distribution is implemented using with a polar method that calls
       // generator::operator() twice only on 'odd'- number of invocations
-      const double random = normal_distrib01(random01) * sqrt(mu) + mu;
-
-      return static_cast<unsigned>(random <= 0 ? 0 : round(random));
+      return poisson_from_normal01(mu, normal_distrib01(random01));
     }
   else
     {
-      double u = random01();
-
-      // prevent problems of n growing too large (or even to infinity)
-      // when u is very close to 1
-      if (u > 1 - 1.E-6)
-        u = 1 - 1.E-6;
-
-      const double upper = exp(mu) * u;
-      double accum = 1.;
-      double term = 1.;
-      unsigned int n = 1;
-
-      while (accum < upper)
-        {
-          accum += (term *= mu / n);
-          n++;
-        }
-
-      return (n - 1);
+      return poisson_by_inversion(mu, random01());
     }
 }
 
@@ -103,6 +165,27 @@ GeneralisedPoissonNoiseGenerator::generate_scaled_poisson_random(const float mu,
   return preserve_mean ? random_poisson / scaling_factor : static_cast<float>(random_poisson);
 }
 
+float
+GeneralisedPoissonNoiseGenerator::generate_scaled_poisson_random_counter_based(const float mu_unscaled,
+                                                                               const std::uint64_t index,
+                                                                               const std::uint64_t realisation) const
+{
+  const float mu = mu_unscaled * this->scaling_factor;
+  CounterBasedUniform01 random01(mix64(mix64(this->seed_value) ^ realisation), index);
+  unsigned int random_poisson;
+  // same thresholds as in generate_poisson_random(), but using the Box-Muller transform for the normal distribution
+  if (mu > 60.F)
+    {
+      const double u1 = random01();
+      const double u2 = random01();
+      const double normal01 = std::sqrt(-2 * std::log(u1)) * std::cos(2 * boost::math::constants::pi<double>() * u2);
+      random_poisson = poisson_from_normal01(mu, normal01);
+    }
+  else
+    random_poisson = poisson_by_inversion(mu, random01());
+  return this->preserve_mean ? random_poisson / this->scaling_factor : static_cast<float>(random_poisson);
+}
+
 float
 GeneralisedPoissonNoiseGenerator::generate_random(const float mu)
 {
@@ -112,18 +195,48 @@ GeneralisedPoissonNoiseGenerator::generate_random(const float mu)
 void
 GeneralisedPoissonNoiseGenerator::generate_random(ProjData& output_projdata, const ProjData& input_projdata)
 {
+  this->generate_random_for_all_outputs(std::vector<ProjData*>(1, &output_projdata), input_projdata);
+}
+
+void
+GeneralisedPoissonNoiseGenerator::generate_random(const std::vector<shared_ptr<ProjData>>& output_projdata_sptrs,
+                                                  const ProjData& input_projdata)
+{
+  std::vector<ProjData*> output_projdata_ptrs;
+  for (auto& output_projdata_sptr : output_projdata_sptrs)
+    output_projdata_ptrs.push_back(output_projdata_sptr.get());
+  this->generate_random_for_all_outputs(output_projdata_ptrs, input_projdata);
+}
+
+void
+GeneralisedPoissonNoiseGenerator::generate_random_for_all_outputs(const std::vector<ProjData*>& output_projdata_ptrs,
+                                                                  const ProjData& input_projdata)
+{
+  // index (for the counter-based generator) of the first bin of the current segment
+  std::uint64_t first_index = 0;
   for (int seg = input_projdata.get_min_segment_num(); seg <= input_projdata.get_max_segment_num(); seg++)
     {
       for (int timing_pos_num = input_projdata.get_min_tof_pos_num(); timing_pos_num <= input_projdata.get_max_tof_pos_num();
            ++timing_pos_num)
         {
-          SegmentByView<float> seg_output = output_projdata.get_empty_segment_by_view(seg, false, timing_pos_num);
-
-          this->generate_random(seg_output, input_projdata.get_segment_by_view(seg, timing_pos_num));
-          if (output_projdata.set_segment(seg_output) == Succeeded::no)
-            error("Problem writing to projection data");
+          const SegmentByView<float> seg_input = input_projdata.get_segment_by_view(seg, timing_pos_num);
+          for (std::size_t output_num = 0; output_num < output_projdata_ptrs.size(); ++output_num)
+            {
+              ProjData& output_projdata = *output_projdata_ptrs[output_num];
+              SegmentByView<float> seg_output = output_projdata.get_empty_segment_by_view(seg, false, timing_pos_num);
+
+              if (this->use_counter_based_generator)
+                this->generate_random_counter_based(seg_output, seg_input, first_index, this->realisation_num + output_num);
+              else
+                this->generate_random(seg_output, seg_input);
+              if (output_projdata.set_segment(seg_output) == Succeeded::no)
+                error("Problem writing to projection data");
+            }
+          first_index += seg_input.size_all();
         }
     }
+  if (this->use_counter_based_generator)
+    this->realisation_num += output_projdata_ptrs.size();
 }
 
 END_NAMESPACE_STIR
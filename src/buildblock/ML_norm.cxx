@@ -788,10 +788,10 @@ FanProjData::is_in_data(const int ra, const int a, const int rb, const int b) co
   assert(b >= 0);
   if (rb < (*this)[ra][a].get_min_index() || rb > (*this)[ra][a].get_max_index())
     return false;
-  if (b >= get_min_b(a))
-    return b <= get_max_b(a);
-  else
-    return b + num_detectors_per_ring <= get_max_b(a);
+  // b might have to be shifted by num_detectors_per_ring to be in the range [min_b, max_b]
+  const int min_b = get_min_b(a);
+  const int max_b = get_max_b(a);
+  return (b >= min_b && b <= max_b) || (b + num_detectors_per_ring >= min_b && b + num_detectors_per_ring <= max_b);
 }
 
 void
@@ -1048,36 +1048,58 @@ set_det_pair_data(ProjData& proj_data, const DetPairData& det_pair_data, const i
     }
 }
 
-/// **** This function make fan_data from projecion file while removing the intermodule gaps **** ////
-/// *** fan_data doesn't have gaps, proj_data has gaps *** ///
-template <class TProjDataInfo>
-static void
-make_fan_data_remove_gaps_help(FanProjData& fan_data,
-                               int num_rings,
-                               int num_detectors_per_ring,
-                               int max_delta,
-                               int fan_size,
-                               const TProjDataInfo& proj_data_info,
-                               const ProjData& proj_data)
+namespace
+{
+//! Helper class to convert detector numbers with gaps (i.e. virtual crystals) to numbers without gaps
+class RemoveGaps
+{
+public:
+  explicit RemoveGaps(const Scanner& scanner)
+      : num_transaxial_crystals_per_block(scanner.get_num_transaxial_crystals_per_block()),
+        num_axial_crystals_per_block(scanner.get_num_axial_crystals_per_block()),
+        num_virtual_transaxial_crystals_per_block(scanner.get_num_virtual_transaxial_crystals_per_block()),
+        num_virtual_axial_crystals_per_block(scanner.get_num_virtual_axial_crystals_per_block())
+  {}
+
+  //! convert in place, returning \c false if the detector is a virtual crystal
+  bool convert(int& r, int& a) const
+  {
+    if (a % num_transaxial_crystals_per_block >= num_transaxial_crystals_per_block - num_virtual_transaxial_crystals_per_block)
+      return false;
+    if (r % num_axial_crystals_per_block >= num_axial_crystals_per_block - num_virtual_axial_crystals_per_block)
+      return false;
+    a -= (a / num_transaxial_crystals_per_block) * num_virtual_transaxial_crystals_per_block;
+    r -= (r / num_axial_crystals_per_block) * num_virtual_axial_crystals_per_block;
+    return true;
+  }
+
+private:
+  int num_transaxial_crystals_per_block;
+  int num_axial_crystals_per_block;
+  int num_virtual_transaxial_crystals_per_block;
+  int num_virtual_axial_crystals_per_block;
+};
+} // namespace
+
+void
+make_fan_data_remove_gaps(FanProjData& fan_data, const ProjDataInfo& proj_data_info)
 {
-  if (proj_data.get_proj_data_info_sptr()->is_tof_data())
+  if (proj_data_info.is_tof_data())
     error("make_fan_data: Incompatible with TOF data. Abort.");
 
-  const int half_fan_size = fan_size / 2;
-  const int num_virtual_axial_crystals_per_block = proj_data_info.get_scanner_sptr()->get_num_virtual_axial_crystals_per_block();
-
-  const int num_virtual_transaxial_crystals_per_block
-      = proj_data_info.get_scanner_sptr()->get_num_virtual_transaxial_crystals_per_block();
-
-  const int num_transaxial_blocks = proj_data_info.get_scanner_sptr()->get_num_transaxial_blocks();
-  const int num_axial_blocks = proj_data_info.get_scanner_sptr()->get_num_axial_blocks();
-  const int num_transaxial_crystals_per_block = proj_data_info.get_scanner_sptr()->get_num_transaxial_crystals_per_block();
-  const int num_axial_crystals_per_block = proj_data_info.get_scanner_sptr()->get_num_axial_crystals_per_block();
-
-  const int num_physical_transaxial_crystals_per_block
-      = num_transaxial_crystals_per_block - num_virtual_transaxial_crystals_per_block;
+  int num_rings;
+  int num_detectors_per_ring;
+  int fan_size;
+  int max_delta;
+  get_fan_info(num_rings, num_detectors_per_ring, max_delta, fan_size, proj_data_info);
+  const Scanner& scanner = *proj_data_info.get_scanner_sptr();
 
-  const int num_physical_axial_crystals_per_block = num_axial_crystals_per_block - num_virtual_axial_crystals_per_block;
+  const int num_virtual_axial_crystals_per_block = scanner.get_num_virtual_axial_crystals_per_block();
+  const int num_virtual_transaxial_crystals_per_block = scanner.get_num_virtual_transaxial_crystals_per_block();
+  const int num_transaxial_blocks = scanner.get_num_transaxial_blocks();
+  const int num_axial_blocks = scanner.get_num_axial_blocks();
+  const int num_transaxial_crystals_per_block = scanner.get_num_transaxial_crystals_per_block();
+  const int num_axial_crystals_per_block = scanner.get_num_axial_crystals_per_block();
 
   const int num_transaxial_blocks_in_fansize = fan_size / (num_transaxial_crystals_per_block);
   const int new_fan_size = fan_size - num_transaxial_blocks_in_fansize * num_virtual_transaxial_crystals_per_block;
@@ -1088,49 +1110,72 @@ make_fan_data_remove_gaps_help(FanProjData& fan_data,
       = num_detectors_per_ring - num_transaxial_blocks * num_virtual_transaxial_crystals_per_block;
   const int num_physical_rings = num_rings - (num_axial_blocks - 1) * num_virtual_axial_crystals_per_block;
   fan_data = FanProjData(num_physical_rings, num_physical_detectors_per_ring, new_max_delta, 2 * new_half_fan_size + 1);
+}
 
-  shared_ptr<SegmentBySinogram<float>> segment_ptr;
-  Bin bin;
-
-  for (bin.segment_num() = proj_data.get_min_segment_num(); bin.segment_num() <= proj_data.get_max_segment_num();
-       ++bin.segment_num())
-    {
-      segment_ptr.reset(new SegmentBySinogram<float>(proj_data.get_segment_by_sinogram(bin.segment_num())));
-
-      for (bin.axial_pos_num() = proj_data.get_min_axial_pos_num(bin.segment_num());
-           bin.axial_pos_num() <= proj_data.get_max_axial_pos_num(bin.segment_num());
-           ++bin.axial_pos_num())
-        for (bin.view_num() = 0; bin.view_num() < num_detectors_per_ring / 2; bin.view_num()++)
-          for (bin.tangential_pos_num() = -half_fan_size; bin.tangential_pos_num() <= half_fan_size; ++bin.tangential_pos_num())
-            {
-              int ra = 0, a = 0;
-              int rb = 0, b = 0;
+bool
+add_to_fan_data_remove_gaps(
+    FanProjData& fan_data, const Scanner& scanner, int ra, int a, int rb, int b, const float value)
+{
+  const RemoveGaps remove_gaps(scanner);
+  if (!remove_gaps.convert(ra, a) || !remove_gaps.convert(rb, b))
+    return false;
+  // is_in_data() expects ra <= rb
+  if ((ra <= rb && !fan_data.is_in_data(ra, a, rb, b)) || (ra > rb && !fan_data.is_in_data(rb, b, ra, a)))
+    return false;
+  fan_data(ra, a, rb, b) += value;
+  // for ra == rb, the data are stored twice (see make_fan_data_remove_gaps)
+  if (ra == rb)
+    fan_data(rb, b, ra, a) += value;
+  return true;
+}
 
-              proj_data_info.get_det_pair_for_bin(a, ra, b, rb, bin);
-              int a_in_block = a % num_transaxial_crystals_per_block;
+/// **** This function make fan_data from projecion file while removing the intermodule gaps **** ////
+/// *** fan_data doesn't have gaps, proj_data has gaps *** ///
+template <class TProjDataInfo>
+static void
+make_fan_data_remove_gaps_help(FanProjData& fan_data,
+                               int num_rings,
+                               int num_detectors_per_ring,
+                               int max_delta,
+                               int fan_size,
+                               const TProjDataInfo& proj_data_info,
+                               const ProjData& proj_data)
+{
+  if (proj_data.get_proj_data_info_sptr()->is_tof_data())
+    error("make_fan_data: Incompatible with TOF data. Abort.");
 
-              if (a_in_block >= num_physical_transaxial_crystals_per_block)
-                continue;
-              int new_a = a - (a / num_transaxial_crystals_per_block) * num_virtual_transaxial_crystals_per_block;
+  const int half_fan_size = fan_size / 2;
+  const RemoveGaps remove_gaps(*proj_data_info.get_scanner_sptr());
+  make_fan_data_remove_gaps(fan_data, proj_data_info);
 
-              int ra_in_block = ra % num_axial_crystals_per_block;
-              if (ra_in_block >= num_physical_axial_crystals_per_block)
-                continue;
-              int new_ra = ra - (ra / num_axial_crystals_per_block) * num_virtual_axial_crystals_per_block;
+  for (int segment_num = proj_data.get_min_segment_num(); segment_num <= proj_data.get_max_segment_num(); ++segment_num)
+    {
+      const SegmentBySinogram<float> segment = proj_data.get_segment_by_sinogram(segment_num);
 
-              int b_in_block = b % num_transaxial_crystals_per_block;
-              if (b_in_block >= num_physical_transaxial_crystals_per_block)
-                continue;
-              int new_b = b - (b / num_transaxial_crystals_per_block) * num_virtual_transaxial_crystals_per_block;
+      // every bin corresponds to a different detector pair, so we can fill the fan data in parallel
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+      for (int axial_pos_num = proj_data.get_min_axial_pos_num(segment_num);
+           axial_pos_num <= proj_data.get_max_axial_pos_num(segment_num);
+           ++axial_pos_num)
+        {
+          Bin bin(segment_num, 0, axial_pos_num, 0);
+          for (bin.view_num() = 0; bin.view_num() < num_detectors_per_ring / 2; bin.view_num()++)
+            for (bin.tangential_pos_num() = -half_fan_size; bin.tangential_pos_num() <= half_fan_size;
+                 ++bin.tangential_pos_num())
+              {
+                int ra = 0, a = 0;
+                int rb = 0, b = 0;
 
-              int rb_in_block = rb % num_axial_crystals_per_block;
-              if (rb_in_block >= num_physical_axial_crystals_per_block)
-                continue;
-              int new_rb = rb - (rb / num_axial_crystals_per_block) * num_virtual_axial_crystals_per_block;
+                proj_data_info.get_det_pair_for_bin(a, ra, b, rb, bin);
+                if (!remove_gaps.convert(ra, a) || !remove_gaps.convert(rb, b))
+                  continue;
 
-              fan_data(new_ra, new_a, new_rb, new_b) = fan_data(new_rb, new_b, new_ra, new_a)
-                  = (*segment_ptr)[bin.axial_pos_num()][bin.view_num()][bin.tangential_pos_num()];
-            }
+                fan_data(ra, a, rb, b) = fan_data(rb, b, ra, a)
+                    = segment[bin.axial_pos_num()][bin.view_num()][bin.tangential_pos_num()];
+              }
+        }
     }
 }
 
@@ -1282,6 +1327,10 @@ apply_block_norm(FanProjData& fan_data, const BlockData3D& block_data, const boo
   const int num_tangential_crystals_per_block = num_tangential_detectors / num_tangential_blocks;
   assert(num_tangential_blocks * num_tangential_crystals_per_block == num_tangential_detectors);
 
+  // as rb >= ra, all entries modified for a given ra are stored in row ra, so we can parallelise over ra
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int ra = fan_data.get_min_ra(); ra <= fan_data.get_max_ra(); ++ra)
     for (int a = fan_data.get_min_a(); a <= fan_data.get_max_a(); ++a)
       // loop rb from ra to avoid double counting
@@ -1394,6 +1443,9 @@ apply_geo_norm(FanProjData& fan_data, const GeoData3D& geo_data, const bool appl
               }
           }
 
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int ra = fan_data.get_min_ra(); ra <= fan_data.get_max_ra(); ++ra)
     for (int a = fan_data.get_min_a(); a <= fan_data.get_max_a(); ++a)
       //    for (int rb = fan_data.get_min_ra(); rb <= fan_data.get_max_ra(); ++rb)
@@ -1414,6 +1466,10 @@ void
 apply_efficiencies(FanProjData& fan_data, const DetectorEfficiencies& efficiencies, const bool apply)
 {
   const int num_detectors_per_ring = fan_data.get_num_detectors_per_ring();
+  // as rb >= ra, all entries modified for a given ra are stored in row ra, so we can parallelise over ra
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int ra = fan_data.get_min_ra(); ra <= fan_data.get_max_ra(); ++ra)
     for (int a = fan_data.get_min_a(); a <= fan_data.get_max_a(); ++a)
       // loop rb from ra to avoid double counting
@@ -1432,6 +1488,9 @@ apply_efficiencies(FanProjData& fan_data, const DetectorEfficiencies& efficienci
 void
 make_fan_sum_data(Array<2, float>& data_fan_sums, const FanProjData& fan_data)
 {
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int ra = fan_data.get_min_ra(); ra <= fan_data.get_max_ra(); ++ra)
     for (int a = fan_data.get_min_a(); a <= fan_data.get_max_a(); ++a)
       data_fan_sums[ra][a] = fan_data.sum(ra, a);
@@ -1520,6 +1579,9 @@ make_fan_sum_data(Array<2, float>& data_fan_sums,
   assert(data_fan_sums.get_min_index() == 0);
   const int num_detectors_per_ring = data_fan_sums[0].get_length();
 
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int ra = data_fan_sums.get_min_index(); ra <= data_fan_sums.get_max_index(); ++ra)
     for (int a = data_fan_sums[ra].get_min_index(); a <= data_fan_sums[ra].get_max_index(); ++a)
       {
@@ -1547,6 +1609,9 @@ make_geo_data(GeoData3D& geo_data, const FanProjData& fan_data)
   FanProjData work = fan_data;
   work.fill(0);
 
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int ra = fan_data.get_min_ra(); ra <= fan_data.get_max_ra(); ++ra)
     for (int a = fan_data.get_min_a(); a <= fan_data.get_max_a(); ++a)
       // 1// for (int rb = fan_data.get_min_ra(); rb <= fan_data.get_max_ra(); ++rb)
@@ -1568,6 +1633,10 @@ make_geo_data(GeoData3D& geo_data, const FanProjData& fan_data)
 
   geo_data.fill(0);
 
+  // every ra updates only its own entries in geo_data (as rb >= ra)
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int ra = 0; ra < num_axial_crystals_per_block; ++ra)
     //  for (int a = 0; a <= num_transaxial_detectors/2; ++a)
     for (int a = 0; a < num_transaxial_crystals_per_block / 2; ++a)
@@ -1612,18 +1681,24 @@ make_block_data(BlockData3D& block_data, const FanProjData& fan_data)
   assert(num_transaxial_blocks * num_transaxial_crystals_per_block == num_transaxial_detectors);
 
   block_data.fill(0);
-  for (int ra = fan_data.get_min_ra(); ra <= fan_data.get_max_ra(); ++ra)
-    for (int a = fan_data.get_min_a(); a <= fan_data.get_max_a(); ++a)
-      // loop rb from ra to avoid double counting
-      for (int rb = max(ra, fan_data.get_min_rb(ra)); rb <= fan_data.get_max_rb(ra); ++rb)
-        for (int b = fan_data.get_min_b(a); b <= fan_data.get_max_b(a); ++b)
-          {
-            block_data(ra / num_axial_crystals_per_block,
-                       a / num_transaxial_crystals_per_block,
-                       rb / num_axial_crystals_per_block,
-                       b / num_transaxial_crystals_per_block)
-                += fan_data(ra, a, rb, b);
-          }
+  // parallelise over axial blocks: as rb >= ra, every thread only updates entries of its own axial block
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (int axial_block_num = 0; axial_block_num < num_axial_blocks; ++axial_block_num)
+    for (int ra = axial_block_num * num_axial_crystals_per_block; ra < (axial_block_num + 1) * num_axial_crystals_per_block;
+         ++ra)
+      for (int a = fan_data.get_min_a(); a <= fan_data.get_max_a(); ++a)
+        // loop rb from ra to avoid double counting
+        for (int rb = max(ra, fan_data.get_min_rb(ra)); rb <= fan_data.get_max_rb(ra); ++rb)
+          for (int b = fan_data.get_min_b(a); b <= fan_data.get_max_b(a); ++b)
+            {
+              block_data(axial_block_num,
+                         a / num_transaxial_crystals_per_block,
+                         rb / num_axial_crystals_per_block,
+                         b / num_transaxial_crystals_per_block)
+                  += fan_data(ra, a, rb, b);
+            }
 }
 
 void
@@ -1634,20 +1709,30 @@ iterate_efficiencies(DetectorEfficiencies& efficiencies, const Array<2, float>&
   assert(model.get_max_ra() == data_fan_sums.get_max_index());
   assert(model.get_min_a() == data_fan_sums[data_fan_sums.get_min_index()].get_min_index());
   assert(model.get_max_a() == data_fan_sums[data_fan_sums.get_min_index()].get_max_index());
-  for (int ra = model.get_min_ra(); ra <= model.get_max_ra(); ++ra)
-    for (int a = model.get_min_a(); a <= model.get_max_a(); ++a)
-      {
-        if (data_fan_sums[ra][a] == 0)
-          efficiencies[ra][a] = 0;
-        else
-          {
-            float denominator = 0;
-            for (int rb = model.get_min_rb(ra); rb <= model.get_max_rb(ra); ++rb)
-              for (int b = model.get_min_b(a); b <= model.get_max_b(a); ++b)
-                denominator += efficiencies[rb][b % num_detectors_per_ring] * model(ra, a, rb, b);
-            efficiencies[ra][a] = data_fan_sums[ra][a] / denominator;
-          }
-      }
+  // Gauss-Seidel type update, ordered by transaxial detector: the fan of (ra,a) never contains
+  // detector a itself, so the updates for all rings at a given a are independent.
+#ifdef STIR_OPENMP
+#  pragma omp parallel
+#endif
+  for (int a = model.get_min_a(); a <= model.get_max_a(); ++a)
+    {
+#ifdef STIR_OPENMP
+#  pragma omp for schedule(dynamic)
+#endif
+      for (int ra = model.get_min_ra(); ra <= model.get_max_ra(); ++ra)
+        {
+          if (data_fan_sums[ra][a] == 0)
+            efficiencies[ra][a] = 0;
+          else
+            {
+              float denominator = 0;
+              for (int rb = model.get_min_rb(ra); rb <= model.get_max_rb(ra); ++rb)
+                for (int b = model.get_min_b(a); b <= model.get_max_b(a); ++b)
+                  denominator += efficiencies[rb][b % num_detectors_per_ring] * model(ra, a, rb, b);
+              efficiencies[ra][a] = data_fan_sums[ra][a] / denominator;
+            }
+        }
+    }
 }
 
 // version without model
@@ -1662,39 +1747,64 @@ iterate_efficiencies(DetectorEfficiencies& efficiencies,
 #ifdef WRITE_ALL
   static int sub_iter_num = 0;
 #endif
-  for (int ra = data_fan_sums.get_min_index(); ra <= data_fan_sums.get_max_index(); ++ra)
-    for (int a = data_fan_sums[ra].get_min_index(); a <= data_fan_sums[ra].get_max_index(); ++a)
-      {
-        if (data_fan_sums[ra][a] == 0)
-          efficiencies[ra][a] = 0;
-        else
-          {
-            float denominator = 0;
-            for (int rb = max(ra - max_ring_diff, 0); rb <= min(ra + max_ring_diff, num_rings - 1); ++rb)
-              for (int b = a + num_detectors_per_ring / 2 - half_fan_size; b <= a + num_detectors_per_ring / 2 + half_fan_size;
-                   ++b)
-                denominator += efficiencies[rb][b % num_detectors_per_ring];
-            efficiencies[ra][a] = data_fan_sums[ra][a] / denominator;
-          }
-#ifdef WRITE_ALL
+  const int min_a = data_fan_sums[data_fan_sums.get_min_index()].get_min_index();
+  const int max_a = data_fan_sums[data_fan_sums.get_min_index()].get_max_index();
+  // sum of the efficiencies in the fan of a, for every ring
+  Array<1, float> ring_fan_sums(data_fan_sums.get_min_index(), data_fan_sums.get_max_index());
+  // Gauss-Seidel type update, ordered by transaxial detector (see above).
+  // As the fan of a does not contain a, the ring_fan_sums can be precomputed before updating all rings at a.
+#ifdef STIR_OPENMP
+#  pragma omp parallel
+#endif
+  for (int a = min_a; a <= max_a; ++a)
+    {
+#ifdef STIR_OPENMP
+#  pragma omp for
+#endif
+      for (int rb = data_fan_sums.get_min_index(); rb <= data_fan_sums.get_max_index(); ++rb)
         {
-          char out_filename[100];
-          sprintf(out_filename, "MLresult_subiter_eff_1_%d.out", sub_iter_num++);
-          ofstream out(out_filename);
-          if (!out)
-            {
-              warning("Error opening output file %s\n", out_filename);
-              exit(EXIT_FAILURE);
-            }
-          out << efficiencies;
-          if (!out)
+          float fan_sum = 0;
+          for (int b = a + num_detectors_per_ring / 2 - half_fan_size; b <= a + num_detectors_per_ring / 2 + half_fan_size; ++b)
+            fan_sum += efficiencies[rb][b % num_detectors_per_ring];
+          ring_fan_sums[rb] = fan_sum;
+        }
+#ifdef STIR_OPENMP
+#  pragma omp for
+#endif
+      for (int ra = data_fan_sums.get_min_index(); ra <= data_fan_sums.get_max_index(); ++ra)
+        {
+          if (data_fan_sums[ra][a] == 0)
+            efficiencies[ra][a] = 0;
+          else
             {
-              warning("Error writing data to output file %s\n", out_filename);
-              exit(EXIT_FAILURE);
+              float denominator = 0;
+              for (int rb = max(ra - max_ring_diff, 0); rb <= min(ra + max_ring_diff, num_rings - 1); ++rb)
+                denominator += ring_fan_sums[rb];
+              efficiencies[ra][a] = data_fan_sums[ra][a] / denominator;
             }
         }
-#endif
+#ifdef WRITE_ALL
+#  ifdef STIR_OPENMP
+#    pragma omp single
+#  endif
+      {
+        char out_filename[100];
+        sprintf(out_filename, "MLresult_subiter_eff_1_%d.out", sub_iter_num++);
+        ofstream out(out_filename);
+        if (!out)
+          {
+            warning("Error opening output file %s\n", out_filename);
+            exit(EXIT_FAILURE);
+          }
+        out << efficiencies;
+        if (!out)
+          {
+            warning("Error writing data to output file %s\n", out_filename);
+            exit(EXIT_FAILURE);
+          }
       }
+#endif
+    }
 }
 
 void
@@ -1745,7 +1855,11 @@ iterate_block_norm(BlockData3D& norm_block_data, const BlockData3D& measured_blo
 double
 KL(const FanProjData& d1, const FanProjData& d2, const double threshold)
 {
-  double sum = 0;
+  // compute partial sums per ring in parallel, but add them in a fixed order for reproducibility
+  VectorWithOffset<double> ra_sums(d1.get_min_ra(), d1.get_max_ra());
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int ra = d1.get_min_ra(); ra <= d1.get_max_ra(); ++ra)
     {
       double asum = 0;
@@ -1761,8 +1875,11 @@ KL(const FanProjData& d1, const FanProjData& d2, const double threshold)
             }
           asum += rbsum;
         }
-      sum += asum;
+      ra_sums[ra] = asum;
     }
+  double sum = 0;
+  for (int ra = d1.get_min_ra(); ra <= d1.get_max_ra(); ++ra)
+    sum += ra_sums[ra];
   return static_cast<double>(sum);
 }
 
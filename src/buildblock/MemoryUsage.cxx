@@ -0,0 +1,159 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup buildblock
+  \brief Implementation of class stir::MemoryUsage
+*/
+
+#include "stir/MemoryUsage.h"
+#include "stir/num_threads.h"
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/resource.h>
+#  include <unistd.h>
+#endif
+
+START_NAMESPACE_STIR
+
+namespace
+{
+std::atomic<std::size_t> current_bytes[MemoryUsage::num_categories];
+std::atomic<std::size_t> peak_bytes[MemoryUsage::num_categories];
+std::atomic<std::size_t> total_current_bytes(0);
+std::atomic<std::size_t> total_peak_bytes(0);
+
+void
+update_peak(std::atomic<std::size_t>& peak, const std::size_t value)
+{
+  std::size_t current_peak = peak.load(std::memory_order_relaxed);
+  while (value > current_peak && !peak.compare_exchange_weak(current_peak, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+double
+to_MB(const std::size_t num_bytes)
+{
+  return num_bytes / (1024. * 1024.);
+}
+} // namespace
+
+void
+MemoryUsage::add_allocation(Category category, std::size_t num_bytes)
+{
+  update_peak(peak_bytes[category], current_bytes[category].fetch_add(num_bytes, std::memory_order_relaxed) + num_bytes);
+  update_peak(total_peak_bytes, total_current_bytes.fetch_add(num_bytes, std::memory_order_relaxed) + num_bytes);
+}
+
+void
+MemoryUsage::add_deallocation(Category category, std::size_t num_bytes)
+{
+  current_bytes[category].fetch_sub(num_bytes, std::memory_order_relaxed);
+  total_current_bytes.fetch_sub(num_bytes, std::memory_order_relaxed);
+}
+
+std::size_t
+MemoryUsage::get_current_bytes(Category category)
+{
+  return current_bytes[category].load(std::memory_order_relaxed);
+}
+
+std::size_t
+MemoryUsage::get_peak_bytes(Category category)
+{
+  return peak_bytes[category].load(std::memory_order_relaxed);
+}
+
+std::size_t
+MemoryUsage::get_total_peak_bytes()
+{
+  return total_peak_bytes.load(std::memory_order_relaxed);
+}
+
+void
+MemoryUsage::reset_peaks()
+{
+  for (int c = 0; c < num_categories; ++c)
+    peak_bytes[c] = current_bytes[c].load();
+  total_peak_bytes = total_current_bytes.load();
+}
+
+const char*
+MemoryUsage::get_category_name(Category category)
+{
+  switch (category)
+    {
+    case arrays:
+      return "arrays";
+    case proj_data_in_memory:
+      return "proj_data_in_memory";
+    case proj_matrix_cache:
+      return "proj_matrix_cache";
+    default:
+      return "unknown";
+    }
+}
+
+std::size_t
+MemoryUsage::get_current_resident_set_size()
+{
+#if defined(__linux__)
+  // second field of statm is the number of resident pages
+  std::ifstream statm("/proc/self/statm");
+  std::size_t num_pages = 0, num_resident_pages = 0;
+  if (statm >> num_pages >> num_resident_pages)
+    return num_resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+  return 0;
+}
+
+std::size_t
+MemoryUsage::get_peak_resident_set_size()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#  if defined(__APPLE__)
+      // macOS reports in bytes
+      return static_cast<std::size_t>(usage.ru_maxrss);
+#  else
+      // Linux reports in kilobytes
+      return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#  endif
+    }
+#endif
+  return 0;
+}
+
+std::string
+MemoryUsage::get_report()
+{
+  std::ostringstream s;
+  s << std::fixed << std::setprecision(1);
+  s << "Memory usage (MB)           " << std::setw(12) << "current" << std::setw(12) << "peak" << '\n';
+  for (int c = 0; c < num_categories; ++c)
+    {
+      const Category category = static_cast<Category>(c);
+      s << std::setw(28) << std::left << get_category_name(category) << std::right << std::setw(12)
+        << to_MB(get_current_bytes(category)) << std::setw(12) << to_MB(get_peak_bytes(category)) << '\n';
+    }
+  s << std::setw(28) << std::left << "total tracked" << std::right << std::setw(12) << to_MB(total_current_bytes.load())
+    << std::setw(12) << to_MB(get_total_peak_bytes()) << '\n';
+  s << std::setw(28) << std::left << "resident set size" << std::right << std::setw(12) << to_MB(get_current_resident_set_size())
+    << std::setw(12) << to_MB(get_peak_resident_set_size()) << '\n';
+  s << "(maximum number of threads: " << get_max_num_threads() << ")\n";
+  return s.str();
+}
+
+END_NAMESPACE_STIR
@@ -0,0 +1,301 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup buildblock
+  \brief Implementation of class stir::Profiler
+*/
+
+#include "stir/Profiler.h"
+#include "stir/error.h"
+#include "stir/warning.h"
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+START_NAMESPACE_STIR
+
+namespace
+{
+struct TraceEvent
+{
+  const char* name;
+  double start_time_in_us;
+  double duration_in_us;
+};
+
+//! All profiling data of one thread. Only modified by the thread itself (except for reset())
+struct ThreadData
+{
+  int thread_index = 0;
+  std::string current_path;
+  std::unordered_map<std::string, Profiler::ZoneStatistics> statistics;
+  std::vector<TraceEvent> trace_events;
+  unsigned long num_dropped_trace_events = 0;
+};
+
+struct Registry
+{
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadData>> all_thread_data;
+  const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+};
+
+Registry&
+get_registry()
+{
+  static Registry registry;
+  return registry;
+}
+
+ThreadData&
+get_thread_data()
+{
+  thread_local ThreadData* thread_data_ptr = nullptr;
+  if (!thread_data_ptr)
+    {
+      Registry& registry = get_registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.all_thread_data.emplace_back(new ThreadData);
+      thread_data_ptr = registry.all_thread_data.back().get();
+      thread_data_ptr->thread_index = static_cast<int>(registry.all_thread_data.size()) - 1;
+    }
+  return *thread_data_ptr;
+}
+
+void
+add_to_statistics(Profiler::ZoneStatistics& stats, const Profiler::ZoneStatistics& other)
+{
+  if (other.num_calls == 0)
+    return;
+  if (stats.num_calls == 0)
+    {
+      stats = other;
+      return;
+    }
+  stats.num_calls += other.num_calls;
+  stats.total_time += other.total_time;
+  stats.min_time = std::min(stats.min_time, other.min_time);
+  stats.max_time = std::max(stats.max_time, other.max_time);
+}
+
+//! combine statistics of all threads, sorted by path
+std::map<std::string, Profiler::ZoneStatistics>
+get_all_statistics()
+{
+  Registry& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::map<std::string, Profiler::ZoneStatistics> all_statistics;
+  for (const auto& thread_data_ptr : registry.all_thread_data)
+    for (const auto& path_and_stats : thread_data_ptr->statistics)
+      add_to_statistics(all_statistics[path_and_stats.first], path_and_stats.second);
+  return all_statistics;
+}
+
+std::string
+json_escape(const std::string& str)
+{
+  std::string result;
+  for (const char c : str)
+    {
+      if (c == '"' || c == '\\')
+        result += '\\';
+      if (static_cast<unsigned char>(c) < 0x20)
+        result += ' ';
+      else
+        result += c;
+    }
+  return result;
+}
+
+std::string trace_filename;
+
+void
+write_profiling_results_at_exit()
+{
+  if (!Profiler::is_enabled())
+    return;
+  Profiler::write_statistics(std::cerr);
+  if (!trace_filename.empty())
+    Profiler::write_chrome_trace(trace_filename);
+}
+
+//! reads the environment variables at start-up
+class ProfilerEnvironmentInitialiser
+{
+public:
+  ProfilerEnvironmentInitialiser()
+  {
+    const char* const profile = std::getenv("STIR_PROFILE");
+    const char* const trace = std::getenv("STIR_PROFILE_TRACE");
+    const bool enable = (profile && std::string(profile) != "0" && std::string(profile) != "") || (trace && *trace);
+    if (!enable)
+      return;
+    // make sure the registry is constructed before registering the exit handler, such that it is destructed after it
+    get_registry();
+    if (trace && *trace)
+      {
+        trace_filename = trace;
+        Profiler::set_trace_enabled(true);
+      }
+    Profiler::set_enabled(true);
+    std::atexit(write_profiling_results_at_exit);
+  }
+};
+
+} // namespace
+
+std::atomic<bool> Profiler::_enabled(false);
+std::atomic<bool> Profiler::_trace_enabled(false);
+
+static ProfilerEnvironmentInitialiser profiler_environment_initialiser;
+
+void
+Profiler::set_enabled(bool enabled)
+{
+  _enabled = enabled;
+}
+
+void
+Profiler::set_trace_enabled(bool enabled)
+{
+  _trace_enabled = enabled;
+  if (enabled)
+    _enabled = true;
+}
+
+std::size_t
+Profiler::enter_zone(const char* name)
+{
+  ThreadData& thread_data = get_thread_data();
+  const std::size_t parent_path_length = thread_data.current_path.size();
+  if (parent_path_length > 0)
+    thread_data.current_path += '/';
+  thread_data.current_path += name;
+  return parent_path_length;
+}
+
+void
+Profiler::leave_zone(const char* name,
+                     std::size_t parent_path_length,
+                     std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::time_point end)
+{
+  ThreadData& thread_data = get_thread_data();
+  const double duration = std::chrono::duration<double>(end - start).count();
+  ZoneStatistics& stats = thread_data.statistics[thread_data.current_path];
+  if (stats.num_calls == 0 || duration < stats.min_time)
+    stats.min_time = duration;
+  if (stats.num_calls == 0 || duration > stats.max_time)
+    stats.max_time = duration;
+  ++stats.num_calls;
+  stats.total_time += duration;
+
+  if (is_trace_enabled())
+    {
+      if (thread_data.trace_events.size() < max_num_trace_events_per_thread)
+        {
+          const std::chrono::steady_clock::time_point origin = get_registry().origin;
+          thread_data.trace_events.push_back(
+              TraceEvent{ name,
+                          std::chrono::duration<double, std::micro>(start - origin).count(),
+                          std::chrono::duration<double, std::micro>(end - start).count() });
+        }
+      else
+        ++thread_data.num_dropped_trace_events;
+    }
+  thread_data.current_path.resize(parent_path_length);
+}
+
+Profiler::ZoneStatistics
+Profiler::get_statistics(const std::string& path)
+{
+  const std::map<std::string, ZoneStatistics> all_statistics = get_all_statistics();
+  const auto iter = all_statistics.find(path);
+  return iter == all_statistics.end() ? ZoneStatistics() : iter->second;
+}
+
+void
+Profiler::write_statistics(std::ostream& s)
+{
+  const std::map<std::string, ZoneStatistics> all_statistics = get_all_statistics();
+  s << "\nProfiling results (wall-clock times, summed over all threads)\n"
+    << std::setw(60) << std::left << "zone" << std::right << std::setw(12) << "calls" << std::setw(14) << "total (s)"
+    << std::setw(14) << "mean (ms)" << std::setw(14) << "min (ms)" << std::setw(14) << "max (ms)" << '\n';
+  for (const auto& path_and_stats : all_statistics)
+    {
+      // indent the name of the zone according to its depth
+      const std::string& path = path_and_stats.first;
+      const std::size_t depth = std::count(path.begin(), path.end(), '/');
+      const std::size_t last_separator = path.rfind('/');
+      const std::string name
+          = std::string(2 * depth, ' ') + (last_separator == std::string::npos ? path : path.substr(last_separator + 1));
+      const ZoneStatistics& stats = path_and_stats.second;
+      s << std::setw(60) << std::left << name << std::right << std::setw(12) << stats.num_calls << std::fixed
+        << std::setprecision(3) << std::setw(14) << stats.total_time << std::setw(14)
+        << stats.total_time / stats.num_calls * 1000 << std::setw(14) << stats.min_time * 1000 << std::setw(14)
+        << stats.max_time * 1000 << std::defaultfloat << '\n';
+    }
+  s << std::flush;
+}
+
+void
+Profiler::write_chrome_trace(const std::string& filename)
+{
+  std::ofstream s(filename.c_str());
+  if (!s)
+    error(boost::format("Profiler: error opening file '%1%' for writing the trace") % filename);
+
+  Registry& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  s << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+  unsigned long num_dropped_trace_events = 0;
+  s << std::fixed << std::setprecision(3);
+  for (const auto& thread_data_ptr : registry.all_thread_data)
+    {
+      const int tid = thread_data_ptr->thread_index;
+      s << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+        << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+      first = false;
+      for (const TraceEvent& event : thread_data_ptr->trace_events)
+        s << ",\n{\"name\":\"" << json_escape(event.name) << "\",\"cat\":\"stir\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+          << ",\"ts\":" << event.start_time_in_us << ",\"dur\":" << event.duration_in_us << "}";
+      num_dropped_trace_events += thread_data_ptr->num_dropped_trace_events;
+    }
+  s << "\n]}\n";
+  if (!s)
+    error(boost::format("Profiler: error writing the trace to '%1%'") % filename);
+  if (num_dropped_trace_events > 0)
+    warning(boost::format("Profiler: %1% trace events were not recorded, as the maximum number of events per thread was reached")
+            % num_dropped_trace_events);
+}
+
+void
+Profiler::reset()
+{
+  Registry& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (const auto& thread_data_ptr : registry.all_thread_data)
+    {
+      thread_data_ptr->statistics.clear();
+      thread_data_ptr->trace_events.clear();
+      thread_data_ptr->num_dropped_trace_events = 0;
+    }
+}
+
+END_NAMESPACE_STIR
@@ -37,6 +37,7 @@
 #include "stir/IO/write_data.h"
 #include "stir/IO/read_data.h"
 #include "stir/is_null_ptr.h"
+#include "stir/Profiler.h"
 #include <numeric>
 #include <iostream>
 #include <fstream>
@@ -181,6 +182,7 @@ ProjDataFromStream::get_viewgram(const int view_num,
                                  const bool make_num_tangential_poss_odd,
                                  const int timing_pos) const
 {
+  ProfilerZone profiler_zone("ProjDataFromStream::get_viewgram");
   if (is_null_ptr(sino_stream))
     {
       error("ProjDataFromStream::get_viewgram: stream ptr is 0\n");
@@ -308,6 +310,7 @@ ProjDataFromStream::set_bin_value(const Bin& this_bin)
 Succeeded
 ProjDataFromStream::set_viewgram(const Viewgram<float>& v)
 {
+  ProfilerZone profiler_zone("ProjDataFromStream::set_viewgram");
   if (is_null_ptr(sino_stream))
     {
       warning("ProjDataFromStream::set_viewgram: stream ptr is 0\n");
@@ -503,6 +506,7 @@ ProjDataFromStream::get_sinogram(const int ax_pos_num,
                                  const bool make_num_tangential_poss_odd,
                                  const int timing_pos) const
 {
+  ProfilerZone profiler_zone("ProjDataFromStream::get_sinogram");
   if (is_null_ptr(sino_stream))
     {
       error("ProjDataFromStream::get_sinogram: stream ptr is 0");
@@ -571,6 +575,7 @@ ProjDataFromStream::get_sinogram(const int ax_pos_num,
 Succeeded
 ProjDataFromStream::set_sinogram(const Sinogram<float>& s)
 {
+  ProfilerZone profiler_zone("ProjDataFromStream::set_sinogram");
   if (is_null_ptr(sino_stream))
     {
       warning("ProjDataFromStream::set_sinogram: stream ptr is 0\n");
@@ -660,6 +665,7 @@ ProjDataFromStream::set_sinogram(const Sinogram<float>& s)
 SegmentBySinogram<float>
 ProjDataFromStream::get_segment_by_sinogram(const int segment_num, const int timing_num) const
 {
+  ProfilerZone profiler_zone("ProjDataFromStream::get_segment_by_sinogram");
   if (is_null_ptr(sino_stream))
     {
       error("ProjDataFromStream::get_segment_by_sinogram: stream ptr is 0\n");
@@ -710,6 +716,7 @@ ProjDataFromStream::get_segment_by_sinogram(const int segment_num, const int tim
 SegmentByView<float>
 ProjDataFromStream::get_segment_by_view(const int segment_num, const int timing_pos) const
 {
+  ProfilerZone profiler_zone("ProjDataFromStream::get_segment_by_view");
   if (is_null_ptr(sino_stream))
     {
       error("ProjDataFromStream::get_segment_by_view: stream ptr is 0\n");
@@ -758,6 +765,7 @@ ProjDataFromStream::get_segment_by_view(const int segment_num, const int timing_
 Succeeded
 ProjDataFromStream::set_segment(const SegmentBySinogram<float>& segmentbysinogram_v)
 {
+  ProfilerZone profiler_zone("ProjDataFromStream::set_segment");
   if (is_null_ptr(sino_stream))
     {
       error("ProjDataFromStream::set_segment: stream ptr is 0\n");
@@ -833,6 +841,7 @@ ProjDataFromStream::set_segment(const SegmentBySinogram<float>& segmentbysinogra
 Succeeded
 ProjDataFromStream::set_segment(const SegmentByView<float>& segmentbyview_v)
 {
+  ProfilerZone profiler_zone("ProjDataFromStream::set_segment");
   if (is_null_ptr(sino_stream))
     {
       error("ProjDataFromStream::set_segment: stream ptr is 0\n");
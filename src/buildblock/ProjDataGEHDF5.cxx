@@ -22,6 +22,7 @@
 
 #include "stir/ProjDataGEHDF5.h"
 #include "stir/IndexRange.h"
+#include "stir/IndexRange2D.h"
 #include "stir/IndexRange3D.h"
 #include "stir/IndexRange4D.h"
 #include "stir/IO/GEHDF5Wrapper.h"
@@ -68,10 +69,10 @@ void
 ProjDataGEHDF5::initialise_viewgram_buffer()
 {
 
-  if (!this->tof_data.empty())
+  if (!this->view_data.empty())
     error("there is already data loaded. Aborting");
 
-  tof_data.reserve(get_num_views());
+  view_data.reserve(get_num_views());
   Array<3, unsigned char> buffer;
 
   for (int view_num = get_min_view_num(); view_num <= get_max_view_num(); view_num++)
@@ -80,7 +81,29 @@ ProjDataGEHDF5::initialise_viewgram_buffer()
       m_input_hdf5_sptr->initialise_proj_data(view_num - get_min_view_num() + 1);
 
       m_input_hdf5_sptr->read_sinogram(buffer);
-      this->tof_data.push_back(buffer);
+
+      // find num TOF bins
+      BasicCoordinate<3, int> min_index, max_index;
+      buffer.get_regular_range(min_index, max_index);
+      const int num_tof_poss = max_index[2] - min_index[2] + 1;
+      if (num_tof_poss <= 0)
+        error("ProjDataGEHDF5: internal error on TOF data dimension");
+      if (proj_data_info_sptr->get_scanner_ptr()->get_type() == Scanner::PETMR_Signa)
+        if (num_tof_poss != 27)
+          error("ProjDataGEHDF5: internal error on TOF data dimension for GE Signa");
+
+      // Sum over TOF bins now, as we return non-TOF viewgrams. This avoids keeping all TOF bins in memory,
+      // and having to sum them for every get_viewgram().
+      Array<2, float> summed_data(IndexRange2D(min_index[1], max_index[1], min_index[3], max_index[3]));
+      for (int i_tang = min_index[1]; i_tang <= max_index[1]; ++i_tang)
+        for (int tof_poss = min_index[2]; tof_poss <= max_index[2]; ++tof_poss)
+          {
+            const Array<1, unsigned char>& tof_row = buffer[i_tang][tof_poss];
+            Array<1, float>& summed_row = summed_data[i_tang];
+            for (int axial_pos = min_index[3]; axial_pos <= max_index[3]; ++axial_pos)
+              summed_row[axial_pos] += static_cast<float>(tof_row[axial_pos]);
+          }
+      this->view_data.push_back(summed_data);
     }
 }
 
@@ -127,32 +150,19 @@ ProjDataGEHDF5::get_viewgram(const int view_num,
   // not necessary
   // ret_viewgram.fill(0.0);
 
-  // find num TOF bins
-  BasicCoordinate<3, int> min_index, max_index;
-  tof_data[0].get_regular_range(min_index, max_index);
-  const int num_tof_poss = max_index[2] - min_index[2] + 1;
-  if (num_tof_poss <= 0)
-    error("ProjDataGEHDF5: internal error on TOF data dimension");
-  if (proj_data_info_sptr->get_scanner_ptr()->get_type() == Scanner::PETMR_Signa)
-    if (num_tof_poss != 27)
-      error("ProjDataGEHDF5: internal error on TOF data dimension for GE Signa");
-
-  // PW flip the tangential and view numbers. The TOF bins are added below to return non TOF viewgram.
+  // PW flip the tangential and view numbers. The TOF bins were already added in initialise_viewgram_buffer().
   if (get_min_view_num() != 0)
     error("ProjDataGEHDF5: internal error on views");
   if (get_max_tangential_pos_num() + get_min_tangential_pos_num() != 0)
     error("ProjDataGEHDF5: internal error on tangential positions");
+  const Array<2, float>& data = view_data[get_max_view_num() - view_num];
   for (int tang_pos = ret_viewgram.get_min_tangential_pos_num(), i_tang = 0;
        tang_pos <= ret_viewgram.get_max_tangential_pos_num();
        ++tang_pos, ++i_tang)
     for (int i_axial = get_min_axial_pos_num(segment_num), axial_pos = seg_ax_offset[find_segment_index_in_sequence(segment_num)];
          i_axial <= get_max_axial_pos_num(segment_num);
          i_axial++, axial_pos++)
-      for (int tof_poss = 0; tof_poss <= num_tof_poss - 1; tof_poss++)
-        {
-          ret_viewgram[i_axial][-tang_pos]
-              += static_cast<float>(tof_data[get_max_view_num() - view_num][i_tang][tof_poss][axial_pos]);
-        }
+      ret_viewgram[i_axial][-tang_pos] = data[i_tang][axial_pos];
 
 #if 0
     ofstream write_tof_data;
@@ -79,7 +79,13 @@ ProjDataInMemory::create_buffer(const bool initialise_with_0)
     memset(b, 0, this->size_all()*sizeof(float));
   return b;
 #else
-  this->buffer = Array<1, float>(static_cast<int>(this->size_all()));
+  // allocate via shared_ptr such that the buffer is registered in MemoryUsage
+  // (swap with the new array, as assignment would copy the data into untracked memory)
+  const std::size_t num_elements = this->size_all();
+  shared_ptr<float[]> data_sptr = detail::allocate_tracked_array_memory<float>(num_elements, MemoryUsage::proj_data_in_memory);
+  std::fill(data_sptr.get(), data_sptr.get() + num_elements, 0.F);
+  Array<1, float> new_buffer(IndexRange<1>(static_cast<int>(num_elements)), data_sptr);
+  swap(this->buffer, new_buffer);
 #endif
 }
 
@@ -42,6 +42,8 @@
 #include "stir/IndexRange3D.h"
 #include "stir/Bin.h"
 #include "stir/TOF_conversions.h"
+#include "stir/LORCoordinates.h"
+#include "stir/Succeeded.h"
 // include for ask and ask_num
 #include "stir/utilities.h"
 #include "stir/warning.h"
@@ -105,6 +107,51 @@ ProjDataInfo::get_sampling_in_m(const Bin& bin) const
          / 2;
 }
 
+void
+ProjDataInfo::get_LOR_end_points_for_viewgram(LOREndPoints& end_points,
+                                              const ViewgramIndices& viewgram_indices,
+                                              const float radius) const
+{
+  const int segment_num = viewgram_indices.segment_num();
+  const int min_axial_pos_num = get_min_axial_pos_num(segment_num);
+  const int max_axial_pos_num = get_max_axial_pos_num(segment_num);
+  const int min_tangential_pos_num = get_min_tangential_pos_num();
+  const int num_tangential_poss = get_num_tangential_poss();
+  end_points.resize(static_cast<std::size_t>(max_axial_pos_num - min_axial_pos_num + 1) * num_tangential_poss);
+
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+  for (int axial_pos_num = min_axial_pos_num; axial_pos_num <= max_axial_pos_num; ++axial_pos_num)
+    {
+      LORInAxialAndNoArcCorrSinogramCoordinates<float> lor;
+      LORAs2Points<float> lor_points;
+      for (int tangential_pos_num = min_tangential_pos_num; tangential_pos_num <= get_max_tangential_pos_num();
+           ++tangential_pos_num)
+        {
+          const std::size_t index = static_cast<std::size_t>(axial_pos_num - min_axial_pos_num) * num_tangential_poss
+                                    + (tangential_pos_num - min_tangential_pos_num);
+          const Bin bin(
+              segment_num, viewgram_indices.view_num(), axial_pos_num, tangential_pos_num, viewgram_indices.timing_pos_num());
+          get_LOR(lor, bin);
+          if (lor.get_intersections_with_cylinder(lor_points, radius) == Succeeded::no)
+            {
+              end_points.z1[index] = end_points.y1[index] = end_points.x1[index] = 0.F;
+              end_points.z2[index] = end_points.y2[index] = end_points.x2[index] = 0.F;
+            }
+          else
+            {
+              end_points.z1[index] = lor_points.p1().z();
+              end_points.y1[index] = lor_points.p1().y();
+              end_points.x1[index] = lor_points.p1().x();
+              end_points.z2[index] = lor_points.p2().z();
+              end_points.y2[index] = lor_points.p2().y();
+              end_points.x2[index] = lor_points.p2().x();
+            }
+        }
+    }
+}
+
 float
 ProjDataInfo::get_sampling_in_s(const Bin& bin) const
 {
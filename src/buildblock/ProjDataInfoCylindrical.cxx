@@ -27,7 +27,9 @@
 #include "stir/ProjDataInfoCylindrical.h"
 #include "stir/LORCoordinates.h"
 #include "stir/Array.h"
+#include "stir/Succeeded.h"
 #include <algorithm>
+#include <vector>
 #include <sstream>
 
 #include "stir/round.h"
@@ -542,6 +544,76 @@ ProjDataInfoCylindrical::get_LOR(LORInAxialAndNoArcCorrSinogramCoordinates<float
                                                          false); // needs to set "swapped" to false given above code
 }
 
+void
+ProjDataInfoCylindrical::get_LOR_end_points_for_viewgram(LOREndPoints& end_points,
+                                                         const ViewgramIndices& viewgram_indices,
+                                                         const float radius) const
+{
+  const int segment_num = viewgram_indices.segment_num();
+  const int min_axial_pos_num = get_min_axial_pos_num(segment_num);
+  const int num_axial_poss = get_num_axial_poss(segment_num);
+  const int min_tangential_pos_num = get_min_tangential_pos_num();
+  const int num_tangential_poss = get_num_tangential_poss();
+  end_points.resize(static_cast<std::size_t>(num_axial_poss) * num_tangential_poss);
+
+  Bin bin(segment_num, viewgram_indices.view_num(), min_axial_pos_num, 0, viewgram_indices.timing_pos_num());
+
+  // end-points for the first axial position
+  std::vector<bool> intersects(num_tangential_poss);
+  {
+    LORInAxialAndNoArcCorrSinogramCoordinates<float> lor;
+    LORAs2Points<float> lor_points;
+    for (int t = 0; t < num_tangential_poss; ++t)
+      {
+        bin.tangential_pos_num() = min_tangential_pos_num + t;
+        get_LOR(lor, bin);
+        intersects[t] = lor.get_intersections_with_cylinder(lor_points, radius) == Succeeded::yes;
+        if (!intersects[t])
+          {
+            end_points.z1[t] = end_points.y1[t] = end_points.x1[t] = 0.F;
+            end_points.z2[t] = end_points.y2[t] = end_points.x2[t] = 0.F;
+          }
+        else
+          {
+            end_points.z1[t] = lor_points.p1().z();
+            end_points.y1[t] = lor_points.p1().y();
+            end_points.x1[t] = lor_points.p1().x();
+            end_points.z2[t] = lor_points.p2().z();
+            end_points.y2[t] = lor_points.p2().y();
+            end_points.x2[t] = lor_points.p2().x();
+          }
+      }
+  }
+
+  // shift for the other axial positions
+  bin.tangential_pos_num() = 0;
+  const float first_m = get_m(bin);
+  std::vector<float> delta_m(num_axial_poss);
+  for (int a = 1; a < num_axial_poss; ++a)
+    {
+      bin.axial_pos_num() = min_axial_pos_num + a;
+      delta_m[a] = get_m(bin) - first_m;
+    }
+
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+  for (int a = 1; a < num_axial_poss; ++a)
+    {
+      const std::size_t offset = static_cast<std::size_t>(a) * num_tangential_poss;
+      for (int t = 0; t < num_tangential_poss; ++t)
+        {
+          const float dz = intersects[t] ? delta_m[a] : 0.F;
+          end_points.z1[offset + t] = end_points.z1[t] + dz;
+          end_points.y1[offset + t] = end_points.y1[t];
+          end_points.x1[offset + t] = end_points.x1[t];
+          end_points.z2[offset + t] = end_points.z2[t] + dz;
+          end_points.y2[offset + t] = end_points.y2[t];
+          end_points.x2[offset + t] = end_points.x2[t];
+        }
+    }
+}
+
 #if 0
   // KT disabled these as untested (and unused)
 
@@ -90,6 +90,14 @@ set_ring_spacing(float ring_spacing_v)
 #endif
 
 //! warning Find lor from cartesian coordinates of detector pair
+void
+ProjDataInfoGeneric::get_LOR_end_points_for_viewgram(LOREndPoints& end_points,
+                                                     const ViewgramIndices& viewgram_indices,
+                                                     const float radius) const
+{
+  ProjDataInfo::get_LOR_end_points_for_viewgram(end_points, viewgram_indices, radius);
+}
+
 void
 ProjDataInfoGeneric::get_LOR(LORInAxialAndNoArcCorrSinogramCoordinates<float>& lor, const Bin& bin) const
 {
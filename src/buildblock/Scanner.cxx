@@ -42,6 +42,8 @@
 #include <iostream>
 #include <algorithm>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 #include <boost/format.hpp>
 #include "stir/warning.h"
 #include "stir/error.h"
@@ -2180,31 +2182,48 @@ Scanner::ask_parameters()
     } // infinite loop
 }
 
+namespace
+{
+// Table with one (immutable) prototype for every predefined scanner, and a hash map
+// from the standardised names (and aliases) to these prototypes.
+// It is constructed only once (the first time it is needed), such that finding a scanner by name
+// does not need to construct all predefined scanners.
+struct PredefinedScanners
+{
+  //! prototypes in the order of Scanner::Type (excluding Unknown_scanner)
+  std::vector<shared_ptr<const Scanner>> prototypes;
+  std::unordered_map<string, shared_ptr<const Scanner>> by_standardised_name;
+
+  PredefinedScanners()
+  {
+    for (int int_type = Scanner::E931; int_type != Scanner::Unknown_scanner; ++int_type)
+      {
+        shared_ptr<const Scanner> scanner_sptr(new Scanner(static_cast<Scanner::Type>(int_type)));
+        prototypes.push_back(scanner_sptr);
+        // use emplace such that the first scanner with a given name is found (as before)
+        for (const auto& name : scanner_sptr->get_all_names())
+          by_standardised_name.emplace(standardise_interfile_keyword(name), scanner_sptr);
+      }
+  }
+};
+
+const PredefinedScanners&
+get_predefined_scanners()
+{
+  // initialisation of a static local variable is thread-safe
+  static const PredefinedScanners predefined_scanners;
+  return predefined_scanners;
+}
+} // namespace
+
 Scanner*
 Scanner::get_scanner_from_name(const string& name)
 {
-  Scanner* scanner_ptr;
-
-  const string matching_name = standardise_interfile_keyword(name);
-  Type type = E931;
-  while (type != Unknown_scanner)
-    {
-      scanner_ptr = new Scanner(type);
-      const list<string>& list_of_names = scanner_ptr->get_all_names();
-      for (std::list<string>::const_iterator iter = list_of_names.begin(); iter != list_of_names.end(); ++iter)
-        {
-          const string matching_scanner_name = standardise_interfile_keyword(*iter);
-          if (matching_scanner_name == matching_name)
-            return scanner_ptr;
-        }
+  const auto& by_name = get_predefined_scanners().by_standardised_name;
+  const auto iter = by_name.find(standardise_interfile_keyword(name));
+  if (iter != by_name.end())
+    return new Scanner(*iter->second);
 
-      // we didn't find it yet
-      delete scanner_ptr;
-      // tricky business to find next type
-      int int_type = type;
-      ++int_type;
-      type = static_cast<Type>(int_type);
-    }
   // it's not in the list
   warning(std::string("Scanner::get_scanner_from_name: scanner'") + name + "' not found");
   return new Scanner(Unknown_scanner);
@@ -2215,15 +2234,11 @@ Scanner::list_all_names()
 {
   std::ostringstream s;
 
-  Type type = E931;
-  while (type != Unknown_scanner)
+  for (const auto& scanner_sptr : get_predefined_scanners().prototypes)
     {
-      Scanner scanner(type);
-      // tricky business to find next type
-      type = static_cast<Type>(static_cast<int>(type) + 1);
-      if (scanner.get_type() == User_defined_scanner)
+      if (scanner_sptr->get_type() == User_defined_scanner)
         continue;
-      s << scanner.list_names() << '\n';
+      s << scanner_sptr->list_names() << '\n';
     }
 
   return s.str();
@@ -2233,15 +2248,11 @@ std::list<std::string>
 Scanner::get_names_of_predefined_scanners()
 {
   std::list<std::string> ret;
-  Type type = E931;
-  while (type != Unknown_scanner)
+  for (const auto& scanner_sptr : get_predefined_scanners().prototypes)
     {
-      Scanner scanner(type);
-      // tricky business to find next type
-      type = static_cast<Type>(static_cast<int>(type) + 1);
-      if (scanner.get_type() == User_defined_scanner)
+      if (scanner_sptr->get_type() == User_defined_scanner)
         continue;
-      ret.push_back(scanner.get_name());
+      ret.push_back(scanner_sptr->get_name());
     }
   return ret;
 }
@@ -21,10 +21,39 @@
 
 #include "stir/SeparableArrayFunctionObject.h"
 #include "stir/ArrayFunction.h"
+#include "stir/ArrayFilter1DUsingConvolution.h"
+#include "stir/ArrayFilter1DUsingConvolutionSymmetricKernel.h"
+#include "stir/detail/separable_convolution.h"
 #include "stir/is_null_ptr.h"
+#include <vector>
 
 START_NAMESPACE_STIR
 
+namespace
+{
+//! find the kernel of a 1D filter if it is a convolution that can be handled by detail::convolve_3d_array_along_dimension
+template <typename elemT>
+bool
+get_line_convolution_kernel(detail::LineConvolutionKernel<elemT>& kernel, const ArrayFunctionObject<1, elemT>& filter)
+{
+  if (auto conv_ptr = dynamic_cast<const ArrayFilter1DUsingConvolution<elemT>*>(&filter))
+    {
+      kernel.coefficients = conv_ptr->get_filter_coefficients();
+      kernel.symmetric = false;
+      kernel.bc = conv_ptr->get_boundary_condition();
+      return kernel.bc == BoundaryConditions::zero || kernel.bc == BoundaryConditions::constant;
+    }
+  if (auto conv_ptr = dynamic_cast<const ArrayFilter1DUsingConvolutionSymmetricKernel<elemT>*>(&filter))
+    {
+      kernel.coefficients = conv_ptr->get_filter_coefficients();
+      kernel.symmetric = true;
+      kernel.bc = BoundaryConditions::zero;
+      return true;
+    }
+  return false;
+}
+} // namespace
+
 template <int num_dim, typename elemT>
 SeparableArrayFunctionObject<num_dim, elemT>::SeparableArrayFunctionObject()
     : all_1d_array_filters(VectorWithOffset<shared_ptr<ArrayFunctionObject<1, elemT>>>(num_dim))
@@ -53,6 +82,24 @@ SeparableArrayFunctionObject<num_dim, elemT>::do_it(Array<num_dim, elemT>& array
            ++iter)
         assert(!is_null_ptr(*iter));
 #endif
+      if constexpr (num_dim == 3)
+        {
+          // if all filters are convolutions, filter many lines at once (in parallel)
+          std::vector<detail::LineConvolutionKernel<elemT>> kernels(num_dim);
+          bool all_convolutions = array.is_regular();
+          for (int d = 0; all_convolutions && d < num_dim; ++d)
+            {
+              const ArrayFunctionObject<1, elemT>& filter = **(all_1d_array_filters.begin() + d);
+              all_convolutions = filter.is_trivial() || get_line_convolution_kernel(kernels[d], filter);
+            }
+          if (all_convolutions)
+            {
+              for (int d = 0; d < num_dim; ++d)
+                if (!(*(all_1d_array_filters.begin() + d))->is_trivial())
+                  detail::convolve_3d_array_along_dimension(array, d + 1, kernels[d]);
+              return;
+            }
+        }
       in_place_apply_array_functions_on_each_index(array, all_1d_array_filters.begin(), all_1d_array_filters.end());
     }
 }
@@ -85,4 +85,14 @@ SinglesRates::get_singles(const DetectionPosition<>& det_pos, const double start
   return (get_singles(singles_bin_index, start_time, end_time));
 }
 
+std::vector<float>
+SinglesRates::get_singles_for_all_units(const double start_time, const double end_time) const
+{
+  const int num_singles_units = scanner_sptr->get_num_singles_units();
+  std::vector<float> singles(num_singles_units);
+  for (int singles_bin_index = 0; singles_bin_index < num_singles_units; ++singles_bin_index)
+    singles[singles_bin_index] = get_singles(singles_bin_index, start_time, end_time);
+  return singles;
+}
+
 END_NAMESPACE_STIR
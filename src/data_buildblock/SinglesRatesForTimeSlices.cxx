@@ -27,6 +27,7 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <memory>
 
 START_NAMESPACE_STIR
 
@@ -42,16 +43,10 @@ FrameSinglesRates
 SinglesRatesForTimeSlices::get_rates_for_frame(double start_time, double end_time) const
 {
 
-  int num_singles_units = scanner_sptr->get_num_singles_units();
-
-  // Create a temporary vector
-  std::vector<float> average_singles_rates(num_singles_units);
-
-  // Loop over all bins.
-  for (int singles_bin = 0; singles_bin < num_singles_units; ++singles_bin)
-    {
-      average_singles_rates[singles_bin] = get_singles_rate(singles_bin, start_time, end_time);
-    }
+  // Get the singles for all bins, and convert to rates.
+  std::vector<float> average_singles_rates = get_singles_for_all_units(start_time, end_time);
+  for (auto& rate : average_singles_rates)
+    rate = static_cast<float>(rate / (end_time - start_time));
 
   // Determine that start and end slice indices.
   int start_slice = get_start_time_slice_index(start_time);
@@ -71,44 +66,12 @@ SinglesRatesForTimeSlices::get_rates_for_frame(double start_time, double end_tim
 int
 SinglesRatesForTimeSlices::get_end_time_slice_index(double t) const
 {
-
-  int slice_index = 0;
-
-  // Start with an initial estimate.
-  if (_singles_time_interval != 0)
-    {
-      slice_index = static_cast<int>(floor(t / _singles_time_interval));
-    }
-
-  if (slice_index >= _num_time_slices)
-    {
-      slice_index = _num_time_slices - 1;
-    }
-
-  // Check estimate and determine whether to look further or backwards.
-  // Note that we could just move fowards first and then backwards but this
-  // method is more intuitive.
-
-  if (_times[slice_index] < t)
-    {
-
-      // Check forwards.
-      while (slice_index < _num_time_slices - 1 && _times[slice_index] < t)
-        {
-          slice_index++;
-        }
-    }
-  else
-    {
-
-      // Check backwards.
-      while (slice_index > 0 && _times[slice_index - 1] >= t)
-        {
-          slice_index--;
-        }
-    }
-
-  return (slice_index);
+  // find first slice ending at or after t
+  const auto end_iter = _times.begin() + _num_time_slices;
+  const auto iter = std::lower_bound(_times.begin(), end_iter, t);
+  if (iter == end_iter)
+    return _num_time_slices - 1;
+  return static_cast<int>(iter - _times.begin());
 }
 
 // Get time slice index.
@@ -116,44 +79,11 @@ SinglesRatesForTimeSlices::get_end_time_slice_index(double t) const
 int
 SinglesRatesForTimeSlices::get_start_time_slice_index(double t) const
 {
-
-  int slice_index = 0;
-
-  // Start with an initial estimate.
-  if (_singles_time_interval != 0)
-    {
-      slice_index = std::max(0, static_cast<int>(floor((t - _times[0]) / _singles_time_interval)));
-    }
-
-  if (slice_index >= _num_time_slices)
-    {
-      slice_index = _num_time_slices - 1;
-    }
-
-  // Check estimate and determine whether to look further or backwards.
-  // Note that we could just move fowards first and then backwards but this
-  // method is more intuitive.
-
-  if (_times[slice_index] < t)
-    {
-
-      // Check forwards.
-      while (slice_index < _num_time_slices - 1 && _times[slice_index] <= t)
-        {
-          slice_index++;
-        }
-    }
-  else
-    {
-
-      // Check backwards.
-      while (slice_index > 0 && _times[slice_index - 1] > t)
-        {
-          slice_index--;
-        }
-    }
-
-  return (slice_index);
+  const auto end_iter = _times.begin() + _num_time_slices;
+  const auto iter = std::upper_bound(_times.begin(), end_iter, t);
+  if (iter == end_iter)
+    return _num_time_slices - 1;
+  return static_cast<int>(iter - _times.begin());
 }
 
 #if 0
@@ -185,6 +115,7 @@ SinglesRatesForTimeSlices::set_singles(int singles_bin_index, int time_slice, in
   if (singles_bin_index >= 0 && singles_bin_index < total_singles_units && time_slice >= 0 && time_slice < _num_time_slices)
     {
       _singles[time_slice][singles_bin_index] = new_rate;
+      invalidate_cumulative_singles();
     }
 }
 
@@ -221,10 +152,11 @@ SinglesRatesForTimeSlices::rebin(std::vector<double>& new_end_times)
       else
         {
 
-          // Get the singles rate average between start and end times for all bins.
+          // Get the singles between start and end times for all bins.
+          const std::vector<float> singles = get_singles_for_all_units(start_time, end_time);
           for (int singles_bin = 0; singles_bin < total_singles_units; ++singles_bin)
             {
-              new_singles[new_slice][singles_bin] = round(get_singles(singles_bin, start_time, end_time));
+              new_singles[new_slice][singles_bin] = round(singles[singles_bin]);
             }
         }
 
@@ -236,6 +168,7 @@ SinglesRatesForTimeSlices::rebin(std::vector<double>& new_end_times)
   _singles = new_singles;
   _times = new_end_times;
   _num_time_slices = _times.size();
+  invalidate_cumulative_singles();
 
   return (_num_time_slices);
 }
@@ -258,66 +191,100 @@ SinglesRatesForTimeSlices::get_singles_time_interval() const
   return (_singles_time_interval);
 }
 
-float
-SinglesRatesForTimeSlices::get_singles(const int singles_bin_index, const double start_time, const double end_time) const
+void
+SinglesRatesForTimeSlices::find_slices_for_interval(int& start_slice,
+                                                    int& end_slice,
+                                                    const double start_time,
+                                                    const double end_time) const
 {
-
   // First Calculate an inclusive range. start_time_slice is the
   // the first slice with an ending time greater than start_time.
   // end_time_slice is the first time slice that ends at, or after,
   // end_time.
-  int start_slice = this->get_start_time_slice_index(start_time);
-  int end_slice = this->get_end_time_slice_index(end_time);
-
-  // Total contribution from all slices.
-  double total_singles;
-  // Start and end times for starting and ending slices.
-  double slice_start_time;
-  double slice_end_time;
-
-  // Calculate the fraction of the start_slice to include.
-  slice_start_time = get_slice_start_time(start_slice);
-  slice_end_time = _times[start_slice];
+  start_slice = this->get_start_time_slice_index(start_time);
+  end_slice = this->get_end_time_slice_index(end_time);
 
   if (start_time > end_time)
     error(boost::format("get_singles() called with start_time %1% larger than end time %2%") % start_time % end_time);
   if (start_time < get_slice_start_time(start_slice) - 1e-2 /* allow for some rounding */)
     error(boost::format("get_singles() called with start time %1% which is smaller than the start time in the data (%2%)")
-          % start_time % slice_start_time);
+          % start_time % get_slice_start_time(start_slice));
   if (end_time > _times[end_slice] + 1e-2 /* allow for some rounding */)
     error(boost::format("get_singles() called with end time %1% which is larger than the end time in the data (%2%)") % end_time
-          % slice_end_time);
-
-  double old_duration = slice_end_time - slice_start_time;
-  double included_duration = slice_end_time - start_time;
-
-  double fraction = included_duration / old_duration;
+          % _times[end_slice]);
+}
 
-  // Set the total singles so far to be the fraction of the bin.
-  total_singles = fraction * _singles[start_slice][singles_bin_index];
-  if (start_slice < end_slice)
-    {
+double
+SinglesRatesForTimeSlices::get_cumulative_singles(const Array<2, double>& cumulative_singles,
+                                                  const int singles_bin_index,
+                                                  const int slice,
+                                                  const double t) const
+{
+  // Add the fraction of the slice up to t (assuming uniform singles within the slice).
+  const double slice_start_time = get_slice_start_time(slice);
+  const double fraction = (t - slice_start_time) / (_times[slice] - slice_start_time);
+  return cumulative_singles[slice][singles_bin_index] + fraction * _singles[slice][singles_bin_index];
+}
 
-      // Calculate the fraction of the end_slice to include.
-      slice_start_time = get_slice_start_time(end_slice);
-      slice_end_time = _times[end_slice];
+float
+SinglesRatesForTimeSlices::get_singles(const int singles_bin_index, const double start_time, const double end_time) const
+{
+  int start_slice, end_slice;
+  this->find_slices_for_interval(start_slice, end_slice, start_time, end_time);
 
-      old_duration = slice_end_time - slice_start_time;
-      included_duration = end_time - slice_start_time;
+  const auto cumulative_singles_sptr = this->get_cumulative_singles();
+  const double total_singles = get_cumulative_singles(*cumulative_singles_sptr, singles_bin_index, end_slice, end_time)
+                               - get_cumulative_singles(*cumulative_singles_sptr, singles_bin_index, start_slice, start_time);
 
-      fraction = included_duration / old_duration;
+  return (static_cast<float>(total_singles));
+}
 
-      // Add the fraction of the bin to the running total.
-      total_singles += fraction * _singles[end_slice][singles_bin_index];
+std::vector<float>
+SinglesRatesForTimeSlices::get_singles_for_all_units(const double start_time, const double end_time) const
+{
+  int start_slice, end_slice;
+  this->find_slices_for_interval(start_slice, end_slice, start_time, end_time);
+
+  const auto cumulative_singles_sptr = this->get_cumulative_singles();
+  const int num_singles_units = scanner_sptr->get_num_singles_units();
+  std::vector<float> singles(num_singles_units);
+  for (int singles_bin_index = 0; singles_bin_index < num_singles_units; ++singles_bin_index)
+    singles[singles_bin_index]
+        = static_cast<float>(get_cumulative_singles(*cumulative_singles_sptr, singles_bin_index, end_slice, end_time)
+                             - get_cumulative_singles(*cumulative_singles_sptr, singles_bin_index, start_slice, start_time));
+  return singles;
+}
 
-      // Add all intervening slices.
-      for (int slice = start_slice + 1; slice < end_slice; ++slice)
-        {
-          total_singles += _singles[slice][singles_bin_index];
-        }
-    }
+shared_ptr<const Array<2, double>>
+SinglesRatesForTimeSlices::get_cumulative_singles() const
+{
+  {
+    auto cumulative_singles_sptr = std::atomic_load(&this->_cumulative_singles_sptr);
+    if (cumulative_singles_sptr)
+      return cumulative_singles_sptr;
+  }
 
-  return (static_cast<float>(total_singles));
+  shared_ptr<const Array<2, double>> result_sptr;
+#ifdef STIR_OPENMP
+#  pragma omp critical(SINGLESRATESFORTIMESLICES_CUMULATIVE)
+#endif
+  {
+    // check again, as another thread might have computed them in the mean time
+    result_sptr = std::atomic_load(&this->_cumulative_singles_sptr);
+    if (!result_sptr)
+      {
+        const int num_singles_units = scanner_sptr->get_num_singles_units();
+        auto cumulative_singles_sptr
+            = std::make_shared<Array<2, double>>(IndexRange2D(0, _num_time_slices, 0, num_singles_units - 1));
+        Array<2, double>& cumulative_singles = *cumulative_singles_sptr;
+        for (int slice = 0; slice < _num_time_slices; ++slice)
+          for (int singles_bin = 0; singles_bin < num_singles_units; ++singles_bin)
+            cumulative_singles[slice + 1][singles_bin] = cumulative_singles[slice][singles_bin] + _singles[slice][singles_bin];
+        result_sptr = cumulative_singles_sptr;
+        std::atomic_store(&this->_cumulative_singles_sptr, result_sptr);
+      }
+  }
+  return result_sptr;
 }
 
 /*
@@ -383,6 +350,12 @@ SinglesRatesForTimeSlices::get_slice_start_time(int slice_index) const
     }
 }
 
+void
+SinglesRatesForTimeSlices::invalidate_cumulative_singles()
+{
+  std::atomic_store(&this->_cumulative_singles_sptr, shared_ptr<const Array<2, double>>());
+}
+
 TimeFrameDefinitions
 SinglesRatesForTimeSlices::get_time_frame_definitions() const
 {
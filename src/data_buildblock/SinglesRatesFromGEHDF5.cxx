@@ -94,6 +94,7 @@ SinglesRatesFromGEHDF5::read_from_file(const std::string& rdf_filename)
       _times[0] = tf.get_end_time(1);
       _singles_time_interval = tf.get_duration(1);
     }
+  invalidate_cumulative_singles();
 }
 
 void
@@ -206,6 +206,7 @@ SinglesRatesFromSglFile::read_singles_from_sgl_file(const std::string& sgl_filen
 
 #endif
 
+  invalidate_cumulative_singles();
   // Return number of time slices read.
   return slice;
 }
@@ -43,13 +43,15 @@ randoms_from_singles(ProjData& proj_data, const SinglesRates& singles, float coi
 
   const TimeFrameDefinitions frame_defs = proj_data.get_exam_info_sptr()->get_time_frame_definitions();
 
-  // get total singles for this frame
+  // get total singles for this frame (for all singles units at once)
+  const std::vector<float> singles_per_unit
+      = singles.get_singles_for_all_units(frame_defs.get_start_time(1), frame_defs.get_end_time(1));
   Array<2, float> total_singles(IndexRange2D(num_rings, num_detectors_per_ring));
   for (int r = 0; r < num_rings; ++r)
     for (int c = 0; c < num_detectors_per_ring; ++c)
       {
         const DetectionPosition<> pos(c, r, 0);
-        total_singles[r][c] = singles.get_singles(pos, frame_defs.get_start_time(1), frame_defs.get_end_time(1));
+        total_singles[r][c] = singles_per_unit[scanner.get_singles_bin_index(pos)];
       }
 
   {
@@ -0,0 +1,213 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup evaluation
+
+  \brief Implementation of class stir::ROIValuesCalculator
+*/
+
+#include "stir/evaluation/ROIValuesCalculator.h"
+#include "stir/Shape/Shape3D.h"
+#include "stir/VoxelsOnCartesianGrid.h"
+#include "stir/CartesianCoordinate3D.h"
+#include "stir/unique_ptr.h"
+#include "stir/error.h"
+#include <boost/format.hpp>
+#include <limits>
+#include <ostream>
+
+START_NAMESPACE_STIR
+
+ROIValuesCalculator::ROIValuesCalculator(const DiscretisedDensity<3, float>& template_image)
+{
+  const VoxelsOnCartesianGrid<float>* const image_ptr = dynamic_cast<const VoxelsOnCartesianGrid<float>*>(&template_image);
+  if (image_ptr == 0)
+    error("ROIValuesCalculator: can only handle images of type VoxelsOnCartesianGrid");
+  this->template_image_sptr.reset(template_image.get_empty_copy());
+  const CartesianCoordinate3D<float> voxel_size = image_ptr->get_voxel_size();
+  this->voxel_volume = voxel_size.x() * voxel_size.y() * voxel_size.z();
+}
+
+void
+ROIValuesCalculator::check_image(const DiscretisedDensity<3, float>& image, const char* const caller) const
+{
+  if (!this->template_image_sptr->has_same_characteristics(image))
+    error(boost::format("ROIValuesCalculator::%1%: image does not have the same characteristics as the template image") % caller);
+}
+
+int
+ROIValuesCalculator::add_ROI(const Shape3D& shape, const CartesianCoordinate3D<int>& num_samples, const std::string& name)
+{
+  unique_ptr<DiscretisedDensity<3, float>> discretised_shape_uptr(this->template_image_sptr->get_empty_copy());
+  shape.construct_volume(static_cast<VoxelsOnCartesianGrid<float>&>(*discretised_shape_uptr), num_samples);
+  return this->add_ROI(*discretised_shape_uptr, name);
+}
+
+int
+ROIValuesCalculator::add_ROI(const DiscretisedDensity<3, float>& discretised_shape, const std::string& name)
+{
+  check_image(discretised_shape, "add_ROI");
+
+  DiscretisedROI ROI;
+  ROI.name = name;
+  ROI.plane_starts.reserve(discretised_shape.get_length() + 1);
+  // store voxels in the same order as the full iterators, such that results do not differ from
+  // compute_ROI_values_per_plane() due to the order of floating point summation
+  for (int z = discretised_shape.get_min_index(); z <= discretised_shape.get_max_index(); ++z)
+    {
+      ROI.plane_starts.push_back(ROI.weights.size());
+      const Array<2, float>& plane = discretised_shape[z];
+      for (int y = plane.get_min_index(); y <= plane.get_max_index(); ++y)
+        for (int x = plane[y].get_min_index(); x <= plane[y].get_max_index(); ++x)
+          {
+            const float weight = plane[y][x];
+            if (weight == 0)
+              continue;
+            ROI.y_indices.push_back(y);
+            ROI.x_indices.push_back(x);
+            ROI.weights.push_back(weight);
+          }
+    }
+  ROI.plane_starts.push_back(ROI.weights.size());
+
+  this->ROIs.push_back(std::move(ROI));
+  return static_cast<int>(this->ROIs.size()) - 1;
+}
+
+int
+ROIValuesCalculator::get_num_ROIs() const
+{
+  return static_cast<int>(this->ROIs.size());
+}
+
+const std::string&
+ROIValuesCalculator::get_ROI_name(const int ROI_num) const
+{
+  return this->ROIs.at(ROI_num).name;
+}
+
+std::size_t
+ROIValuesCalculator::get_num_voxels(const int ROI_num) const
+{
+  return this->ROIs.at(ROI_num).weights.size();
+}
+
+void
+ROIValuesCalculator::compute_ROI_values_per_plane(std::vector<VectorWithOffset<ROIValues>>& values,
+                                                  const DiscretisedDensity<3, float>& image) const
+{
+  check_image(image, "compute_ROI_values_per_plane");
+
+  const int min_z = image.get_min_index();
+  const int max_z = image.get_max_index();
+  const int num_planes = max_z - min_z + 1;
+  const int num_ROIs = this->get_num_ROIs();
+
+  values.resize(num_ROIs);
+  for (auto& ROI_values : values)
+    ROI_values = VectorWithOffset<ROIValues>(min_z, max_z);
+
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (int task_num = 0; task_num < num_ROIs * num_planes; ++task_num)
+    {
+      const int ROI_num = task_num / num_planes;
+      const int z = min_z + task_num % num_planes;
+      const DiscretisedROI& ROI = this->ROIs[ROI_num];
+      const Array<2, float>& plane = image[z];
+
+      float ROI_min = std::numeric_limits<float>::max();
+      float ROI_max = std::numeric_limits<float>::min();
+      float integral = 0;
+      float integral_square = 0;
+      float volume = 0;
+      for (std::size_t i = ROI.plane_starts[z - min_z]; i < ROI.plane_starts[z - min_z + 1]; ++i)
+        {
+          const float weight = ROI.weights[i];
+          volume += weight;
+          const float org_value = plane[ROI.y_indices[i]][ROI.x_indices[i]];
+          if (org_value < ROI_min)
+            ROI_min = org_value;
+          if (org_value > ROI_max)
+            ROI_max = org_value;
+          if (org_value == 0)
+            continue;
+          const float value = weight * org_value;
+          integral += value;
+          integral_square += value * org_value;
+        }
+      integral *= voxel_volume;
+      integral_square *= voxel_volume;
+      volume *= voxel_volume;
+      values[ROI_num][z] = ROIValues(volume, integral, integral_square, ROI_min, ROI_max);
+    }
+}
+
+std::vector<ROIValues>
+ROIValuesCalculator::compute_total_ROI_values(const DiscretisedDensity<3, float>& image) const
+{
+  std::vector<VectorWithOffset<ROIValues>> values_per_plane;
+  this->compute_ROI_values_per_plane(values_per_plane, image);
+  std::vector<ROIValues> values(values_per_plane.size());
+  for (std::size_t ROI_num = 0; ROI_num < values.size(); ++ROI_num)
+    for (const auto& plane_values : values_per_plane[ROI_num])
+      values[ROI_num] += plane_values;
+  return values;
+}
+
+namespace
+{
+void
+write_values(std::ostream& s, const ROIValues& values)
+{
+  s << '\t' << values.get_roi_volume() << '\t' << values.get_integral() << '\t' << values.get_integral_of_square() << '\t'
+    << values.get_mean() << '\t' << values.get_stddev() << '\t' << values.get_CV() << '\t' << values.get_min() << '\t'
+    << values.get_max() << '\n';
+}
+} // namespace
+
+void
+ROIValuesCalculator::write_table_header(std::ostream& s, const bool by_plane)
+{
+  s << "image\tROI";
+  if (by_plane)
+    s << "\tplane";
+  s << "\tvolume\tintegral\tintegral_of_square\tmean\tstddev\tCV\tmin\tmax\n";
+}
+
+void
+ROIValuesCalculator::write_table(std::ostream& s, const std::string& image_name, const std::vector<ROIValues>& values) const
+{
+  if (values.size() != this->ROIs.size())
+    error("ROIValuesCalculator::write_table: number of values does not match the number of ROIs");
+  for (std::size_t ROI_num = 0; ROI_num < values.size(); ++ROI_num)
+    {
+      s << image_name << '\t' << this->ROIs[ROI_num].name;
+      write_values(s, values[ROI_num]);
+    }
+}
+
+void
+ROIValuesCalculator::write_table(std::ostream& s,
+                                 const std::string& image_name,
+                                 const std::vector<VectorWithOffset<ROIValues>>& values) const
+{
+  if (values.size() != this->ROIs.size())
+    error("ROIValuesCalculator::write_table: number of values does not match the number of ROIs");
+  for (std::size_t ROI_num = 0; ROI_num < values.size(); ++ROI_num)
+    for (int z = values[ROI_num].get_min_index(); z <= values[ROI_num].get_max_index(); ++z)
+      {
+        s << image_name << '\t' << this->ROIs[ROI_num].name << '\t' << z - this->template_image_sptr->get_min_index() + 1;
+        write_values(s, values[ROI_num][z]);
+      }
+}
+
+END_NAMESPACE_STIR
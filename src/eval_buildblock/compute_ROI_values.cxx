@@ -18,6 +18,7 @@
     See STIR/LICENSE.txt for details
 */
 #include "stir/evaluation/compute_ROI_values.h"
+#include "stir/evaluation/ROIValuesCalculator.h"
 #include "stir/Shape/Shape3D.h"
 #include "stir/CartesianCoordinate2D.h"
 #include "stir/CartesianCoordinate3D.h"
@@ -25,6 +26,7 @@
 #include "stir/shared_ptr.h"
 #include "stir/error.h"
 #include <numeric>
+#include <vector>
 #include <boost/limits.hpp> // <limits> but also for old compilers
 
 START_NAMESPACE_STIR
@@ -51,61 +53,12 @@ compute_ROI_values_per_plane(VectorWithOffset<ROIValues>& values,
   if (!density.has_same_characteristics(discretised_shape))
     error("compute_ROI_values_per_plane: density and discretised_shape do not have the same characteristics.");
 
-  const int min_z = density.get_min_index();
-  const int max_z = density.get_max_index();
-  const VoxelsOnCartesianGrid<float>& image = dynamic_cast<const VoxelsOnCartesianGrid<float>&>(density);
-
-  const CartesianCoordinate3D<float> voxel_size = image.get_voxel_size();
-  const float voxel_volume = voxel_size.x() * voxel_size.y() * voxel_size.z();
-
-  // initialise values correct size
-  values = VectorWithOffset<ROIValues>(min_z, max_z);
-
-  for (int z = min_z; z <= max_z; z++)
-    {
-#if 0
-    const float volume = (discretised_shape)[z].sum() * voxel_volume;
-    (discretised_shape)[z] *= image[z];
-    // TODO incorrect: picks up the values outside the ROI, which are 0
-    const float ROI_min = (discretised_shape)[z].find_min();
-    const float ROI_max = (discretised_shape)[z].find_max();
-    const float integral = (discretised_shape)[z].sum() * voxel_volume;
-    (discretised_shape)[z] *= image[z];
-    const float integral_square =(discretised_shape)[z].sum() * voxel_volume;
-#else
-      float ROI_min = std::numeric_limits<float>::max();
-      float ROI_max = std::numeric_limits<float>::min();
-      float integral = 0;
-      float integral_square = 0;
-      float volume = 0;
-      {
-        Array<2, float>::const_full_iterator discr_shape_iter = (discretised_shape)[z].begin_all_const();
-        const Array<2, float>::const_full_iterator discr_shape_end = (discretised_shape)[z].end_all_const();
-        Array<2, float>::const_full_iterator image_iter = image[z].begin_all_const();
-        for (; discr_shape_iter != discr_shape_end; ++discr_shape_iter, ++image_iter)
-          {
-            const float weight = *discr_shape_iter;
-            if (weight == 0)
-              continue;
-            volume += weight;
-            const float org_value = (*image_iter);
-            if (org_value < ROI_min)
-              ROI_min = org_value;
-            if (org_value > ROI_max)
-              ROI_max = org_value;
-            if (org_value == 0)
-              continue;
-            const float value = weight * (*image_iter);
-            integral += value;
-            integral_square += value * (*image_iter);
-          }
-        integral *= voxel_volume;
-        integral_square *= voxel_volume;
-        volume *= voxel_volume;
-      }
-#endif
-      values[z] = ROIValues(volume, integral, integral_square, ROI_min, ROI_max);
-    }
+  // use ROIValuesCalculator, which only visits voxels in the ROI and processes planes in parallel
+  ROIValuesCalculator calculator(density);
+  calculator.add_ROI(discretised_shape);
+  std::vector<VectorWithOffset<ROIValues>> all_values;
+  calculator.compute_ROI_values_per_plane(all_values, density);
+  values = all_values[0];
 }
 
 ROIValues
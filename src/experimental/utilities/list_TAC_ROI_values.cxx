@@ -56,7 +56,7 @@
 
 */
 #include "stir/utilities.h"
-#include "stir/evaluation/compute_ROI_values.h"
+#include "stir/evaluation/ROIValuesCalculator.h"
 #include "stir/Shape/DiscretisedShape3D.h"
 #include "stir/VoxelsOnCartesianGrid.h"
 #include "stir/DynamicDiscretisedDensity.h"
@@ -72,6 +72,7 @@
 using std::cerr;
 using std::endl;
 using std::ofstream;
+using std::string;
 
 START_NAMESPACE_STIR
 // TODO repetition of postfilter.cxx to be able to use its .par file
@@ -215,7 +216,7 @@ main(int argc, char* argv[])
       return EXIT_FAILURE;
     }
 
-  const shared_ptr<DynamicDiscretisedDensity> dyn_image_sptr = DynamicDiscretisedDensity::read_from_file(input_file);
+  const shared_ptr<DynamicDiscretisedDensity> dyn_image_sptr(DynamicDiscretisedDensity::read_from_file(input_file));
   const DynamicDiscretisedDensity& dyn_image = *dyn_image_sptr;
 
   const unsigned int num_frames = (dyn_image.get_time_frame_definitions()).get_num_frames();
@@ -246,34 +247,32 @@ main(int argc, char* argv[])
   out << '\n';
 
   {
-    std::vector<shared_ptr<Shape3D>>::const_iterator current_shape_iter = parameters.shape_ptrs.begin();
-    std::vector<string>::const_iterator current_name_iter = parameters.shape_names.begin();
-    for (; current_shape_iter != parameters.shape_ptrs.end(); ++current_shape_iter, ++current_name_iter)
+    // discretise all ROIs only once, and compute their values for all ROIs in a single pass per frame
+    ROIValuesCalculator calculator(dyn_image[start_frame_num]);
+    for (std::size_t i = 0; i < parameters.shape_ptrs.size(); ++i)
+      calculator.add_ROI(*parameters.shape_ptrs[i], parameters.num_samples, parameters.shape_names[i]);
+
+    std::vector<std::vector<ROIValues>> values_per_frame;
+    for (unsigned int frame_num = start_frame_num; frame_num <= end_frame_num; frame_num++)
+      values_per_frame.push_back(calculator.compute_total_ROI_values(dyn_image[frame_num]));
+
+    for (int ROI_num = 0; ROI_num < calculator.get_num_ROIs(); ++ROI_num)
       {
         for (unsigned int frame_num = start_frame_num; frame_num <= end_frame_num; frame_num++)
           {
             const float frame_start_time = (dyn_image.get_time_frame_definitions()).get_start_time(frame_num);
             const float frame_end_time = (dyn_image.get_time_frame_definitions()).get_end_time(frame_num);
 
-            ROIValues values;
-            values = compute_total_ROI_values(dyn_image[frame_num], **current_shape_iter, parameters.num_samples);
-            out << std::setw(15) << *current_name_iter << std::setw(10) << frame_num << std::setw(15) << frame_start_time
-                << std::setw(15) << frame_end_time << std::setw(15) << values.get_mean() << std::setw(15) << values.get_stddev();
+            const ROIValues& values = values_per_frame[frame_num - start_frame_num][ROI_num];
+            out << std::setw(15) << calculator.get_ROI_name(ROI_num) << std::setw(10) << frame_num << std::setw(15)
+                << frame_start_time << std::setw(15) << frame_end_time << std::setw(15) << values.get_mean() << std::setw(15)
+                << values.get_stddev();
             if (do_CV)
               out << std::setw(15) << values.get_CV();
             if (do_V)
               out << std::setw(15) << values.get_roi_volume();
             out << '\n';
           }
-
-#if 0
-	for (VectorWithOffset<ROIValues>::const_iterator iter = values.begin();
-	     iter != values.end();
-	     iter++)
-	  {
-	    std::cout << iter->report();
-	  }
-#endif
       }
   }
 
@@ -26,6 +26,7 @@
 #include "stir/assign.h"
 #include "stir/HigherPrecision.h"
 #include "stir/error.h"
+#include "stir/MemoryUsage.h"
 //#include "stir/info.h"
 //#include <string>
 
@@ -91,10 +92,27 @@ Array<num_dimensions, elemT>::Array()
       _allocated_full_data_ptr(nullptr)
 {}
 
+namespace detail
+{
+//! Allocate (uninitialised) memory for \a num_elements, registering it in MemoryUsage until the memory is freed
+template <typename elemT>
+inline shared_ptr<elemT[]>
+allocate_tracked_array_memory(const std::size_t num_elements, const MemoryUsage::Category category = MemoryUsage::arrays)
+{
+  const std::size_t num_bytes = num_elements * sizeof(elemT);
+  shared_ptr<elemT[]> data_sptr(new elemT[num_elements], [num_bytes, category](elemT* data_ptr) {
+    delete[] data_ptr;
+    MemoryUsage::add_deallocation(category, num_bytes);
+  });
+  MemoryUsage::add_allocation(category, num_bytes);
+  return data_sptr;
+}
+} // namespace detail
+
 template <int num_dimensions, typename elemT>
 Array<num_dimensions, elemT>::Array(const IndexRange<num_dimensions>& range)
     : base_type(),
-      _allocated_full_data_ptr(new elemT[range.size_all()])
+      _allocated_full_data_ptr(detail::allocate_tracked_array_memory<elemT>(range.size_all()))
 {
   // info("Array constructor range " + std::to_string(reinterpret_cast<std::size_t>(this->_allocated_full_data_ptr)) + " of size "
   // + std::to_string(range.size_all())); set elements to zero
@@ -96,6 +96,11 @@ public:
 
   Succeeded get_influenced_indices(IndexRange<1>& influenced_indices, const IndexRange<1>& input_indices) const override;
 
+  //! get the kernel coefficients
+  const VectorWithOffset<elemT>& get_filter_coefficients() const { return filter_coefficients; }
+  //! get the boundary conditions
+  BoundaryConditions::BC get_boundary_condition() const { return _bc; }
+
 private:
   VectorWithOffset<elemT> filter_coefficients;
   BoundaryConditions::BC _bc;
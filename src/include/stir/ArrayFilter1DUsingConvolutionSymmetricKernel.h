@@ -62,6 +62,9 @@ public:
     */
   bool is_trivial() const override;
 
+  //! get the kernel coefficients (for indices 0 and higher)
+  const VectorWithOffset<elemT>& get_filter_coefficients() const { return filter_coefficients; }
+
 private:
   VectorWithOffset<elemT> filter_coefficients;
   void do_it(Array<1, elemT>& out_array, const Array<1, elemT>& in_array) const override;
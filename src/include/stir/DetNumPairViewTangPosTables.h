@@ -0,0 +1,100 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup projdata
+  \brief Declaration of classes stir::ViewTangPosToDetNumPairTable and stir::DetNumPairToViewTangPosTable
+*/
+
+#ifndef __stir_DetNumPairViewTangPosTables_H__
+#define __stir_DetNumPairViewTangPosTables_H__
+
+#include "stir/shared_ptr.h"
+#include <vector>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup projdata
+  \brief Look-up table from (unmashed) view and tangential position to the pair of detector numbers in a ring
+
+  This is used by the non-arc-corrected projection data info classes for a scanner with an even number of
+  detectors per ring (see ProjDataInfoCylindricalNoArcCorr::get_det_num_pair_for_view_tangential_pos_num()).
+  The table only depends on the number of detectors per ring. get_shared_table() therefore returns
+  a table that is shared between all objects (and copies) using the same number of detectors.
+
+  Views range from 0 to <tt>num_detectors_per_ring/2-1</tt> and tangential positions from
+  <tt>-num_detectors_per_ring/2+1</tt> to <tt>num_detectors_per_ring/2</tt>.
+  Data are stored contiguously.
+*/
+class ViewTangPosToDetNumPairTable
+{
+public:
+  struct Det1Det2
+  {
+    int det1_num;
+    int det2_num;
+  };
+
+  //! Get the table for this number of detectors, constructing it if it is not in the (process-wide) cache yet
+  static shared_ptr<const ViewTangPosToDetNumPairTable> get_shared_table(const int num_detectors_per_ring);
+
+  explicit ViewTangPosToDetNumPairTable(const int num_detectors_per_ring);
+
+  int get_min_tang_pos_num() const { return min_tang_pos_num; }
+  int get_max_tang_pos_num() const { return min_tang_pos_num + num_tang_poss - 1; }
+
+  const Det1Det2& operator()(const int view_num, const int tang_pos_num) const
+  {
+    return table[view_num * num_tang_poss + (tang_pos_num - min_tang_pos_num)];
+  }
+
+private:
+  int min_tang_pos_num;
+  int num_tang_poss;
+  std::vector<Det1Det2> table;
+};
+
+/*!
+  \ingroup projdata
+  \brief Look-up table from a pair of detector numbers in a ring to the (unmashed) view and tangential position
+
+  This is the inverse of ViewTangPosToDetNumPairTable, see there for more information.
+  For every pair of different detectors, the table stores the view and tangential position, and
+  if the detectors have to be swapped (see
+  ProjDataInfoCylindricalNoArcCorr::get_view_tangential_pos_num_for_det_num_pair()).
+*/
+class DetNumPairToViewTangPosTable
+{
+public:
+  struct ViewTangPosSwap
+  {
+    int view_num;
+    int tang_pos_num;
+    bool swap_detectors;
+  };
+
+  //! Get the table for this number of detectors, constructing it if it is not in the (process-wide) cache yet
+  static shared_ptr<const DetNumPairToViewTangPosTable> get_shared_table(const int num_detectors_per_ring);
+
+  explicit DetNumPairToViewTangPosTable(const int num_detectors_per_ring);
+
+  const ViewTangPosSwap& operator()(const int det1_num, const int det2_num) const
+  {
+    return table[det1_num * num_detectors + det2_num];
+  }
+
+private:
+  int num_detectors;
+  std::vector<ViewTangPosSwap> table;
+};
+
+END_NAMESPACE_STIR
+
+#endif
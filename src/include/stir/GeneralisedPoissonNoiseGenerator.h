@@ -15,11 +15,15 @@
 */
 
 #include "stir/ProjData.h"
+#include "stir/Array.h"
+#include "stir/error.h"
 
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/variate_generator.hpp>
 #include <algorithm>
 #include <functional>
+#include <vector>
+#include <cstdint>
 // boost::serialization::make_array was moved in boost 1.64
 #if BOOST_VERSION == 106400
 #  include <boost/serialization/array_wrapper.hpp>
@@ -39,6 +43,12 @@ START_NAMESPACE_STIR
   be equal to <tt>scaling_factor*mean_of_input</tt>, otherwise it
   will be equal to mean_of_input, but then the output is no longer Poisson
   distributed.
+
+  By default, a single (sequential) random number generator is used. Alternatively, a
+  counter-based generator can be used (see set_use_counter_based_generator()). In that case,
+  the random numbers used for an element only depend on the seed, the position of the element
+  and the number of the realisation, such that noise for arrays and projection data
+  can be generated in parallel (using OpenMP), while the results are independent of the number of threads.
 */
 class GeneralisedPoissonNoiseGenerator
 {
@@ -51,29 +61,106 @@ public:
   GeneralisedPoissonNoiseGenerator(const float scaling_factor = 1.0F, const bool preserve_mean = false);
 
   //! The seed value for the random number generator
+  /*! This also resets the realisation number used by the counter-based generator to 0. */
   void seed(unsigned int);
 
+  //! Use a counter-based random number generator for arrays and projection data
+  /*! In this mode, every call to generate_random() for an array or projection data generates
+      a new realisation, where the random numbers for an element are computed from the seed,
+      the realisation number and the index of the element (in the order of Array::begin_all(),
+      or of the segments for projection data). Generating noise twice after seeding with the same
+      value therefore gives the same realisations, whatever the number of threads.
+
+      Default is \c false, in which case a single boost::mt19937 generator is used (as in previous versions of STIR).
+      Note that generate_random(const float) always uses this sequential generator.
+  */
+  void set_use_counter_based_generator(const bool);
+  bool get_use_counter_based_generator() const;
+
   //! generate a random number according to a distribution with mean mu
   float generate_random(const float mu);
 
+  //! generate a noise realisation for every element of \a array_in
+  /*! In counter-based mode, \a array_out has to have the same index range as \a array_in. */
   template <int num_dimensions, class elemTout, class elemTin>
   void generate_random(Array<num_dimensions, elemTout>& array_out, const Array<num_dimensions, elemTin>& array_in)
   {
-    std::transform(array_in.begin_all(),
-                   array_in.end_all(),
-                   array_out.begin_all(),
-                   std::bind(generate_scaled_poisson_random, std::placeholders::_1, this->scaling_factor, this->preserve_mean));
+    if (this->use_counter_based_generator)
+      {
+        generate_random_counter_based(array_out, array_in, std::uint64_t(0), this->realisation_num);
+        ++this->realisation_num;
+      }
+    else
+      std::transform(array_in.begin_all(),
+                     array_in.end_all(),
+                     array_out.begin_all(),
+                     std::bind(generate_scaled_poisson_random, std::placeholders::_1, this->scaling_factor, this->preserve_mean));
   }
 
   void generate_random(ProjData& output_projdata, const ProjData& input_projdata);
 
+  //! generate several noise realisations, reading the input data only once
+  /*! Every segment of \a input_projdata is read once, and a noise realisation is written to every
+      element of \a output_projdata_sptrs.
+      In counter-based mode, the result is identical to calling generate_random(ProjData&, const ProjData&)
+      for every output in turn.
+  */
+  void generate_random(const std::vector<shared_ptr<ProjData>>& output_projdata_sptrs, const ProjData& input_projdata);
+
 private:
   static base_generator_type generator;
   const float scaling_factor;
   const bool preserve_mean;
+  bool use_counter_based_generator;
+  unsigned int seed_value;
+  //! number of realisations generated with the counter-based generator since the last call to seed()
+  std::uint64_t realisation_num;
+
+  void generate_random_for_all_outputs(const std::vector<ProjData*>& output_projdata_ptrs, const ProjData& input_projdata);
 
   static unsigned int generate_poisson_random(const float mu);
   static float generate_scaled_poisson_random(const float mu, const float scaling_factor, const bool preserve_mean);
+
+  //! counter-based version, using the seed, \a index and \a realisation
+  float
+  generate_scaled_poisson_random_counter_based(const float mu, const std::uint64_t index, const std::uint64_t realisation) const;
+
+  template <int num_dimensions, class elemTout, class elemTin>
+  void generate_random_counter_based(Array<num_dimensions, elemTout>& array_out,
+                                     const Array<num_dimensions, elemTin>& array_in,
+                                     const std::uint64_t first_index,
+                                     const std::uint64_t realisation) const
+  {
+    if (array_out.get_min_index() != array_in.get_min_index() || array_out.get_max_index() != array_in.get_max_index())
+      error("GeneralisedPoissonNoiseGenerator: output and input arrays need to have the same index range");
+    const int min_index = array_in.get_min_index();
+    const int max_index = array_in.get_max_index();
+    if constexpr (num_dimensions == 1)
+      {
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+        for (int i = min_index; i <= max_index; ++i)
+          array_out[i] = static_cast<elemTout>(generate_scaled_poisson_random_counter_based(
+              static_cast<float>(array_in[i]), first_index + static_cast<std::uint64_t>(i - min_index), realisation));
+      }
+    else
+      {
+        // index of the first element of every sub-array
+        std::vector<std::uint64_t> first_indices(array_in.size());
+        std::uint64_t current_index = first_index;
+        for (int i = min_index; i <= max_index; ++i)
+          {
+            first_indices[i - min_index] = current_index;
+            current_index += array_in[i].size_all();
+          }
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = min_index; i <= max_index; ++i)
+          generate_random_counter_based(array_out[i], array_in[i], first_indices[i - min_index], realisation);
+      }
+  }
 };
 
 END_NAMESPACE_STIR
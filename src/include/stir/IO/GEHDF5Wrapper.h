@@ -122,6 +122,13 @@ public:
 
   inline hsize_t get_dataset_size() const;
 
+  //! Size (in bytes) of the HDF5 chunks of the listmode dataset, or 0 if the dataset is not chunked
+  /*! Reading listmode data in multiples of this size (starting at a multiple of it) avoids
+      reading (and decompressing) the same chunk more than once.
+      Only valid after initialise_listmode_data().
+  */
+  inline hsize_t get_list_chunk_size() const;
+
   inline unsigned int get_geo_dims() const;
 
   unsigned int get_num_singles_samples();
@@ -179,6 +186,7 @@ private:
   H5::DataSpace m_dataspace;
 
   std::uint64_t m_list_size = 0;
+  hsize_t m_list_chunk_size = 0;
   int m_dataset_list_Ndims;
   unsigned int m_num_singles_samples;
 
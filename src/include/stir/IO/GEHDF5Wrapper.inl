@@ -59,6 +59,12 @@ GEHDF5Wrapper::get_dataset_size() const
   return m_list_size;
 }
 
+hsize_t
+GEHDF5Wrapper::get_list_chunk_size() const
+{
+  return m_list_chunk_size;
+}
+
 unsigned int
 GEHDF5Wrapper::get_geo_dims() const
 {
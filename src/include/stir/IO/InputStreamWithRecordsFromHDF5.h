@@ -34,6 +34,7 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <future>
 
 START_NAMESPACE_STIR
 
@@ -68,6 +69,10 @@ namespace RDF_HDF5
                          const OptionsT options);
     \endcode
 
+    Data are read in large blocks, aligned with the HDF5 chunks of the dataset (if any), such that
+    every chunk is read (and decompressed if necessary) only once. If the HDF5 library is thread-safe,
+    the next block is read in a background thread while the records in the current block are being processed.
+
     \todo Allow choosing between allocation with \c new or on the stack.
 */
 template <class RecordT>
@@ -87,7 +92,7 @@ public:
                                           const std::size_t size_of_record_signature,
                                           const std::size_t max_size_of_record);
 
-  virtual ~InputStreamWithRecordsFromHDF5() {}
+  virtual ~InputStreamWithRecordsFromHDF5();
 
   inline virtual Succeeded get_next_record(RecordT& record);
 
@@ -138,12 +143,23 @@ private:
   void read_data(char* output, const std::streampos offset, const hsize_t size) const;
   // members for buffering
 
-  boost::shared_array<char> buffer;
+  mutable boost::shared_array<char> buffer;
   std::size_t max_buffer_size;
   //! currently filled size
   mutable std::size_t buffer_size;
   mutable std::streampos start_of_buffer_offset;
   void fill_buffer(const std::streampos offset) const;
+
+  // members for reading the next block in the background
+  mutable boost::shared_array<char> prefetch_buffer;
+  mutable std::size_t prefetch_buffer_size;
+  mutable std::streampos start_of_prefetch_buffer_offset;
+  //! wait for the background read to finish (if any)
+  /*! \return \c true if there was one and it succeeded */
+  bool wait_for_prefetch() const;
+  void start_prefetch(const std::streampos offset) const;
+  // Note: declared last such that it is destructed first (i.e. waits for the background read while all buffers are still valid)
+  mutable std::future<void> prefetch_future;
 };
 
 } // namespace RDF_HDF5
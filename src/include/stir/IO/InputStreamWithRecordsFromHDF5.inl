@@ -64,16 +64,20 @@ InputStreamWithRecordsFromHDF5<RecordT>::InputStreamWithRecordsFromHDF5(const st
 {
   assert(size_of_record_signature <= max_size_of_record);
 
-  this->max_buffer_size = 10000000;
-  this->buffer.reset(new char[this->max_buffer_size]);
-
   set_up();
 }
 
+template <class RecordT>
+InputStreamWithRecordsFromHDF5<RecordT>::~InputStreamWithRecordsFromHDF5()
+{
+  this->wait_for_prefetch();
+}
+
 template <class RecordT>
 Succeeded
 InputStreamWithRecordsFromHDF5<RecordT>::set_up()
 {
+  this->wait_for_prefetch();
   input_sptr.reset(new GEHDF5Wrapper(m_filename));
   data_sptr.reset(new char[this->max_size_of_record]);
   starting_stream_position = 0;
@@ -82,17 +86,80 @@ InputStreamWithRecordsFromHDF5<RecordT>::set_up()
   input_sptr->initialise_listmode_data();
   m_list_size = input_sptr->get_dataset_size() - this->size_of_record_signature;
 
+  // use a multiple of the chunk size for the buffer, such that every chunk needs to be read only once
+  this->max_buffer_size = 10000000;
+  const std::size_t chunk_size = static_cast<std::size_t>(input_sptr->get_list_chunk_size());
+  if (chunk_size > 0)
+    this->max_buffer_size = std::max(std::size_t(1), this->max_buffer_size / chunk_size) * chunk_size;
+  this->buffer.reset(new char[this->max_buffer_size]);
+  this->prefetch_buffer.reset(new char[this->max_buffer_size]);
+
   this->buffer_size = 0;
   return Succeeded::yes;
 }
 
+template <class RecordT>
+bool
+InputStreamWithRecordsFromHDF5<RecordT>::wait_for_prefetch() const
+{
+  if (!this->prefetch_future.valid())
+    return false;
+  try
+    {
+      this->prefetch_future.get();
+      return true;
+    }
+  catch (...)
+    {
+      // ignore, as we will read the data again (and get the error then if it is relevant)
+      return false;
+    }
+}
+
+template <class RecordT>
+void
+InputStreamWithRecordsFromHDF5<RecordT>::start_prefetch(const std::streampos offset) const
+{
+#ifdef H5_HAVE_THREADSAFE
+  if (offset >= static_cast<std::streampos>(m_list_size))
+    return;
+  this->prefetch_buffer_size = static_cast<std::size_t>(
+      std::min(static_cast<uint64_t>(this->max_buffer_size), m_list_size - static_cast<uint64_t>(std::streamoff(offset))));
+  this->start_of_prefetch_buffer_offset = offset;
+  this->prefetch_future = std::async(std::launch::async, [this]() {
+    input_sptr->read_list_data(prefetch_buffer.get(), start_of_prefetch_buffer_offset, hsize_t(prefetch_buffer_size));
+  });
+#else
+  // HDF5 cannot be called from more than one thread, so we will read synchronously
+  (void)offset;
+#endif
+}
+
 template <class RecordT>
 void
 InputStreamWithRecordsFromHDF5<RecordT>::fill_buffer(const std::streampos offset) const
 {
-  this->buffer_size = static_cast<std::size_t>(std::min(static_cast<uint64_t>(this->max_buffer_size), m_list_size - offset));
-  input_sptr->read_list_data(buffer.get(), offset, hsize_t(this->buffer_size));
-  this->start_of_buffer_offset = offset;
+  // start at a chunk boundary
+  std::streamoff start_offset = std::streamoff(offset);
+  const std::streamoff chunk_size = static_cast<std::streamoff>(input_sptr->get_list_chunk_size());
+  if (chunk_size > 0)
+    start_offset -= start_offset % chunk_size;
+
+  // Note: we always need to wait for any background read, as the wrapper can only handle one read at a time
+  if (this->wait_for_prefetch() && std::streamoff(this->start_of_prefetch_buffer_offset) == start_offset)
+    {
+      std::swap(this->buffer, this->prefetch_buffer);
+      this->buffer_size = this->prefetch_buffer_size;
+    }
+  else
+    {
+      this->buffer_size = static_cast<std::size_t>(
+          std::min(static_cast<uint64_t>(this->max_buffer_size), m_list_size - static_cast<uint64_t>(start_offset)));
+      input_sptr->read_list_data(buffer.get(), std::streampos(start_offset), hsize_t(this->buffer_size));
+    }
+  this->start_of_buffer_offset = std::streampos(start_offset);
+
+  this->start_prefetch(std::streampos(start_offset + static_cast<std::streamoff>(this->buffer_size)));
 }
 
 template <class RecordT>
@@ -21,6 +21,7 @@
 #include "stir/IO/OutputFileFormat.h"
 #include "stir/Succeeded.h"
 #include "stir/warning.h"
+#include "stir/Profiler.h"
 
 START_NAMESPACE_STIR
 
@@ -195,6 +196,7 @@ template <typename DataT>
 Succeeded
 OutputFileFormat<DataT>::write_to_file(std::string& filename, const DataT& density) const
 {
+  ProfilerZone profiler_zone("write_to_file");
   return actual_write_to_file(filename, density);
 }
 
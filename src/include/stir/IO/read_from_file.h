@@ -22,6 +22,7 @@
 */
 #include "stir/IO/InputFileFormatRegistry.h"
 #include "stir/unique_ptr.h"
+#include "stir/Profiler.h"
 
 START_NAMESPACE_STIR
 
@@ -45,6 +46,7 @@ template <class DataT, class FileT>
 inline unique_ptr<DataT>
 read_from_file(const FileSignature& signature, FileT file)
 {
+  ProfilerZone profiler_zone("read_from_file");
   using hierarchy_base_type = typename DataT::hierarchy_base_type;
   const InputFileFormat<hierarchy_base_type>& factory
       = InputFileFormatRegistry<hierarchy_base_type>::default_sptr()->find_factory(signature, file);
@@ -207,6 +207,17 @@ typedef FanProjData BlockData3D;
 
 void make_fan_data_remove_gaps(FanProjData& fan_data, const ProjData& proj_data);
 
+//! Set \a fan_data to the size corresponding to \a proj_data_info (without gaps), filled with 0
+void make_fan_data_remove_gaps(FanProjData& fan_data, const ProjDataInfo& proj_data_info);
+
+//! Add \a value to the entry for the detector pair (ra,a), (rb,b), where detector numbers include gaps
+/*! This can be used to fill the fan data event by event (e.g. from list mode data), without needing
+    to store the whole projection data first. \a fan_data has to be sized with
+    make_fan_data_remove_gaps(FanProjData&, const ProjDataInfo&).
+    \return \c false if one of the detectors is a virtual crystal, or the pair is not in the fan data.
+*/
+bool add_to_fan_data_remove_gaps(FanProjData& fan_data, const Scanner& scanner, int ra, int a, int rb, int b, const float value);
+
 void set_fan_data_add_gaps(ProjData& proj_data, const FanProjData& fan_data, const float gap_value = 0.F);
 
 void apply_block_norm(FanProjData& fan_data, const BlockData3D& block_data, const bool apply = true);
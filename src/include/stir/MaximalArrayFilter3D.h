@@ -34,8 +34,9 @@ class Coordinate3D;
   The minimum value for a 1D array of 2n+1 elements is defined as the minimum element
   of the sorted array.
 
-  For 3D images, the current filter works by extracting all neigbours (given by
-  the mask) to a 1D array, and getting the maximal of that array.
+  For 3D images, the filter first finds the maximum over the mask in the z and y
+  directions for every x, and then the maximum of those values in the x direction.
+  Planes are filtered in parallel when OpenMP is enabled.
 
   This implementation of the maximal filter handles edges by taking the minimum of
   all available pixels. For instance, when a 3x3 mask is used, and the
@@ -60,11 +61,6 @@ private:
   int mask_radius_z;
 
   void do_it(Array<3, elemT>& out_array, const Array<3, elemT>& in_array) const override;
-
-  //! extract all neighbours and put them in a 1D array
-  /*! \return the number of neighbours within the image range
-   */
-  int extract_neighbours(Array<1, elemT>&, const Array<3, elemT>& array, const Coordinate3D<int>&) const;
 };
 
 END_NAMESPACE_STIR
@@ -37,8 +37,10 @@ class Coordinate3D;
   of the sorted array. For 2n elements, we use (sorted[n-1]+sorted[n])/2
   (starting indices from 0).
 
-  For 3D images, the current filter works by extracting all neigbours (given by
-  the mask) to a 1D array, and getting the median of that array.
+  For 3D images, the filter keeps a sorted list of all neighbours (given by
+  the mask) while moving along a row, such that only the values entering and
+  leaving the mask need to be handled for every voxel. Planes are filtered in
+  parallel when OpenMP is enabled.
 
   This implementation of the median filter handles edges by taking a median of
   all available pixels. For instance, when a 3x3 mask is used, and the
@@ -63,11 +65,6 @@ private:
   int mask_radius_z;
 
   void do_it(Array<3, elemT>& out_array, const Array<3, elemT>& in_array) const override;
-
-  //! extract all neighbours and put them in a 1D array
-  /*! \return the number of neighbours within the image range
-   */
-  int extract_neighbours(Array<1, elemT>&, const Array<3, elemT>& array, const Coordinate3D<int>&) const;
 };
 
 END_NAMESPACE_STIR
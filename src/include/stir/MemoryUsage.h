@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup buildblock
+  \brief Declaration of class stir::MemoryUsage
+*/
+
+#ifndef __stir_MemoryUsage_H__
+#define __stir_MemoryUsage_H__
+
+#include "stir/common.h"
+#include <cstddef>
+#include <string>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup buildblock
+  \brief Accounting of the memory used by the main STIR data structures
+
+  Allocations are tracked per category, keeping the current and peak number of bytes.
+  The following allocations are currently registered:
+  - \c arrays: the contiguous data of multi-dimensional Array objects (e.g. images, viewgrams,
+    sinograms, segments), including the per-thread images used by the back projectors and the
+    list-mode objective functions. (1D arrays and non-contiguous arrays are not counted.)
+  - \c proj_data_in_memory: the buffers of ProjDataInMemory objects
+  - \c proj_matrix_cache: the rows stored in the cache of ProjMatrixByBin objects (excluding
+    the overhead of the cache itself)
+
+  Accounting uses atomic counters and is always enabled.
+
+  In addition, the resident set size (RSS) of the process as reported by the operating system
+  is available (currently only on Linux and macOS, 0 is returned on other systems). The peak
+  RSS includes all memory used by the process, not only the categories above.
+
+  A summary is written at the end of a reconstruction, see get_report().
+*/
+class MemoryUsage
+{
+public:
+  //! Categories of tracked allocations
+  enum Category
+  {
+    arrays,
+    proj_data_in_memory,
+    proj_matrix_cache,
+    num_categories
+  };
+
+  //! Register an allocation of \a num_bytes for \a category
+  static void add_allocation(Category category, std::size_t num_bytes);
+  //! Register a deallocation of \a num_bytes for \a category
+  static void add_deallocation(Category category, std::size_t num_bytes);
+
+  //! Get the number of bytes currently allocated for \a category
+  static std::size_t get_current_bytes(Category category);
+  //! Get the maximum number of bytes allocated for \a category since the start (or reset_peaks())
+  static std::size_t get_peak_bytes(Category category);
+  //! Get the maximum of the total number of bytes allocated in all categories
+  /*! Note that this can be smaller than the sum of the peaks of all categories. */
+  static std::size_t get_total_peak_bytes();
+  //! Set all peak values to the currently allocated number of bytes
+  static void reset_peaks();
+
+  //! Get the name of the category (as used in the report)
+  static const char* get_category_name(Category category);
+
+  //! Get the current resident set size of the process (in bytes), or 0 if not supported
+  static std::size_t get_current_resident_set_size();
+  //! Get the peak resident set size of the process (in bytes), or 0 if not supported
+  static std::size_t get_peak_resident_set_size();
+
+  //! Get a table with current and peak memory usage (in MB) for every category and the RSS
+  static std::string get_report();
+};
+
+END_NAMESPACE_STIR
+
+#endif
@@ -200,6 +200,9 @@ private:
   PoissonLogLikelihoodWithLinearModelForMean<TargetT> const& objective_function() const;
 
   unique_ptr<TargetT> multiplicative_update_image_ptr;
+
+  //! work image for the denominator in the MAP-OSL update (only allocated when there is a prior)
+  unique_ptr<TargetT> denominator_ptr;
 };
 
 END_NAMESPACE_STIR
@@ -26,6 +26,7 @@
 #  include "stir/recon_buildblock/BinNormalisation.h"
 #  include "stir/ProjData.h"
 #  include "stir/RegisteredParsingObject.h"
+#  include "stir/unique_ptr.h"
 
 START_NAMESPACE_STIR
 
@@ -169,6 +170,10 @@ private:
   //! pointer to the precomputed denominator
   shared_ptr<TargetT> precomputed_denominator_ptr;
 
+  //! work images, reused across subiterations
+  unique_ptr<TargetT> numerator_ptr;
+  unique_ptr<TargetT> work_image_ptr;
+
   //! data corresponding to the gometric forward projection of an image full of ones
   /*! This is needed for the precomputed denominator. However, if the parameter is
       not set, precompute_denominator_without_penalty_of_conditioner() will compute it.
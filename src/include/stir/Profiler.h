@@ -0,0 +1,148 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup buildblock
+  \brief Declaration of classes stir::Profiler and stir::ProfilerZone
+*/
+
+#ifndef __stir_Profiler_H__
+#define __stir_Profiler_H__
+
+#include "stir/common.h"
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup buildblock
+  \brief Lightweight, thread-aware profiling of named code zones
+
+  Code is instrumented by creating a ProfilerZone at the start of a block. Zones can be nested,
+  and statistics are kept for every path of nested zones (e.g.
+  <tt>compute_sub_gradient/distributable_computation/forward_project</tt>), such that the time
+  spent in a zone can be attributed to its callers. Every thread keeps its own statistics, which
+  are combined when writing them. Note that zones are only nested within the same thread, i.e.
+  zones entered in an OpenMP parallel region by other threads than the one that started the region
+  are not nested in the zones of that thread. Times are summed over all threads, and can therefore
+  be larger than the elapsed time.
+
+  Profiling is disabled by default. A disabled ProfilerZone only checks a flag, such that zones
+  can be left in the code. It can be enabled at run-time without recompiling by setting the
+  following environment variables:
+  - \c STIR_PROFILE: if set (and not \c 0), the aggregated statistics are written to \c std::cerr at exit.
+  - \c STIR_PROFILE_TRACE: if set, it is used as file name to write a trace of all zones at exit, in the
+    JSON format used by \c chrome://tracing and <a href="https://ui.perfetto.dev">Perfetto</a>.
+    This also enables profiling.
+
+  Alternatively, use set_enabled(), set_trace_enabled(), write_statistics() and write_chrome_trace().
+  Trace recording stops after \c max_num_trace_events_per_thread events in a thread (statistics
+  continue to be accumulated).
+
+  \warning Statistics and traces should only be written or reset when no zones are active.
+*/
+class Profiler
+{
+public:
+  //! Maximum number of trace events stored per thread
+  static const std::size_t max_num_trace_events_per_thread = 1000000;
+
+  //! Check if profiling is enabled
+  static bool is_enabled() { return _enabled.load(std::memory_order_relaxed); }
+  //! Enable or disable profiling
+  static void set_enabled(bool enabled);
+  //! Check if trace events are recorded
+  static bool is_trace_enabled() { return _trace_enabled.load(std::memory_order_relaxed); }
+  //! Enable or disable recording of trace events (enabling it also enables profiling)
+  static void set_trace_enabled(bool enabled);
+
+  //! Write a table with number of calls, total, mean, minimum and maximum wall-clock time per zone
+  /*! Zones are listed hierarchically, sorted by their path. Totals are summed over all threads. */
+  static void write_statistics(std::ostream& s);
+  //! Write all recorded trace events to file in the Chrome trace (JSON) format
+  static void write_chrome_trace(const std::string& filename);
+  //! Remove all statistics and trace events
+  static void reset();
+
+  //! Statistics for one zone (and path of parent zones)
+  struct ZoneStatistics
+  {
+    unsigned long num_calls = 0;
+    double total_time = 0;
+    double min_time = 0;
+    double max_time = 0;
+  };
+  //! Get the statistics of a zone with the given path (summed over all threads)
+  /*! \a path consists of the names of the parent zones and the zone itself, separated by \c "/" */
+  static ZoneStatistics get_statistics(const std::string& path);
+
+private:
+  friend class ProfilerZone;
+  static std::atomic<bool> _enabled;
+  static std::atomic<bool> _trace_enabled;
+
+  //! Called by ProfilerZone when a zone is entered. Returns the length of the path of the parent
+  static std::size_t enter_zone(const char* name);
+  //! Called by ProfilerZone when a zone is left
+  static void leave_zone(const char* name,
+                         std::size_t parent_path_length,
+                         std::chrono::steady_clock::time_point start,
+                         std::chrono::steady_clock::time_point end);
+};
+
+/*!
+  \ingroup buildblock
+  \brief Measures the wall-clock time spent in a block of code for the Profiler
+
+  \par Usage:
+  \code
+  void f()
+  {
+    ProfilerZone zone("f");
+    // do something
+  }
+  \endcode
+
+  \a name has to remain valid until the profiling results are written (normally a string literal is used).
+  Do not create unnamed instances of this class, as they would be destructed immediately.
+*/
+class ProfilerZone
+{
+public:
+  explicit ProfilerZone(const char* name)
+      : _name(name),
+        _active(Profiler::is_enabled())
+  {
+    if (_active)
+      {
+        _parent_path_length = Profiler::enter_zone(name);
+        _start = std::chrono::steady_clock::now();
+      }
+  }
+  ~ProfilerZone()
+  {
+    if (_active)
+      Profiler::leave_zone(_name, _parent_path_length, _start, std::chrono::steady_clock::now());
+  }
+  ProfilerZone(const ProfilerZone&) = delete;
+  ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+private:
+  const char* const _name;
+  const bool _active;
+  std::size_t _parent_path_length = 0;
+  std::chrono::steady_clock::time_point _start;
+};
+
+END_NAMESPACE_STIR
+
+#endif
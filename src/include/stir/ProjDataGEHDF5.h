@@ -78,12 +78,14 @@ private:
 
   void initialise_ax_pos_offset();
 
+  //! Read all views and sum over TOF bins
   void initialise_viewgram_buffer();
   //! Handler of the HDF5 input data and header
   shared_ptr<GEHDF5Wrapper> m_input_hdf5_sptr;
 
   std::vector<int> segment_sequence;
-  std::vector<Array<3, unsigned char>> tof_data;
+  //! TOF-summed data for every view, indexed as [i_tang][axial_pos] (in the GE order of views and segments)
+  std::vector<Array<2, float>> view_data;
 };
 
 } // namespace RDF_HDF5
@@ -36,6 +36,7 @@
 #include "stir/unique_ptr.h"
 #include <string>
 #include <memory>
+#include <vector>
 
 START_NAMESPACE_STIR
 
@@ -58,6 +59,30 @@ template <typename T>
 class LORInAxialAndNoArcCorrSinogramCoordinates;
 class PMessage;
 
+/*!
+  \ingroup projdata
+  \brief End-points of a set of LORs, stored as a structure of arrays
+
+  Coordinates are in mm, in the same coordinate system as ProjDataInfo::get_LOR() (i.e. centred w.r.t. the gantry).
+  \see ProjDataInfo::get_LOR_end_points_for_viewgram()
+*/
+struct LOREndPoints
+{
+  std::vector<float> z1, y1, x1;
+  std::vector<float> z2, y2, x2;
+
+  void resize(const std::size_t n)
+  {
+    z1.resize(n);
+    y1.resize(n);
+    x1.resize(n);
+    z2.resize(n);
+    y2.resize(n);
+    x2.resize(n);
+  }
+  std::size_t size() const { return z1.size(); }
+};
+
 /*!
   \ingroup projdata
   \brief An (abstract base) class that contains information on the
@@ -330,6 +355,20 @@ public:
       in the next release.
   */
   virtual void get_LOR(LORInAxialAndNoArcCorrSinogramCoordinates<float>&, const Bin&) const = 0;
+
+  //! Get the end-points of the LORs for all bins in a viewgram
+  /*!
+      The end-points are the intersections of the LORs with a cylinder of radius \a radius (see
+      LOR::get_intersections_with_cylinder()). \a end_points is resized to the number of bins in the viewgram,
+      where the bin with axial position \c a and tangential position \c t has index
+      <tt>(a - get_min_axial_pos_num(segment_num)) * get_num_tangential_poss() + (t - get_min_tangential_pos_num())</tt>.
+      If a LOR does not intersect the cylinder, all its coordinates are set to 0.
+
+      The default implementation calls get_LOR() for every bin (using OpenMP). Derived classes can provide
+      faster versions, avoiding the per-bin virtual function calls.
+  */
+  virtual void
+  get_LOR_end_points_for_viewgram(LOREndPoints& end_points, const ViewgramIndices& viewgram_indices, const float radius) const;
   //@}
 
   //! \name Functions that return info on the sampling in the different coordinates
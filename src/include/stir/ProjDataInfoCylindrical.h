@@ -88,6 +88,14 @@ public:
   inline float get_m(const Bin&) const override;
 
   void get_LOR(LORInAxialAndNoArcCorrSinogramCoordinates<float>& lor, const Bin& bin) const override;
+
+  //! Get the end-points of the LORs for all bins in a viewgram
+  /*! In cylindrical geometry, changing the axial position shifts a LOR along z. This implementation
+      therefore calls get_LOR() only for the first axial position, and shifts the end-points for the others.
+  */
+  void get_LOR_end_points_for_viewgram(LOREndPoints& end_points,
+                                       const ViewgramIndices& viewgram_indices,
+                                       const float radius) const override;
 #if 0
   // KT disabled these as untested (and unused)
 
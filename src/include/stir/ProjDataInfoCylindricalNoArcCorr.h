@@ -24,6 +24,7 @@
 #define __stir_ProjDataInfoCylindricalNoArcCorr_H__
 
 #include "stir/ProjDataInfoCylindrical.h"
+#include "stir/DetNumPairViewTangPosTables.h"
 #include "stir/DetectionPositionPair.h"
 #include "stir/VectorWithOffset.h"
 #include "stir/CartesianCoordinate3D.h"
@@ -288,28 +289,17 @@ private:
   //! get offset in psi for first detector (i.e. angle along the scanner ring)
   float get_psi_offset() const;
 
-  // used in get_view_tangential_pos_num_for_det_num_pair()
-  struct Det1Det2
-  {
-    int det1_num;
-    int det2_num;
-  };
-  mutable VectorWithOffset<VectorWithOffset<Det1Det2>> uncompressed_view_tangpos_to_det1det2;
+  // used in get_det_num_pair_for_view_tangential_pos_num(), shared between all objects with the same number of detectors
+  mutable shared_ptr<const ViewTangPosToDetNumPairTable> uncompressed_view_tangpos_to_det1det2_sptr;
   mutable bool uncompressed_view_tangpos_to_det1det2_initialised;
-  //! build look-up table for get_view_tangential_pos_num_for_det_num_pair()
+  //! find look-up table for get_det_num_pair_for_view_tangential_pos_num()
   void initialise_uncompressed_view_tangpos_to_det1det2() const;
 
   // used in get_view_tangential_pos_num_for_det_num_pair()
-  // we prestore a lookup-table in terms for unmashed view/tangpos
-  struct ViewTangPosSwap
-  {
-    int view_num;
-    int tang_pos_num;
-    bool swap_detectors;
-  };
-  mutable VectorWithOffset<VectorWithOffset<ViewTangPosSwap>> det1det2_to_uncompressed_view_tangpos;
+  // we use a lookup-table in terms for unmashed view/tangpos, shared between all objects with the same number of detectors
+  mutable shared_ptr<const DetNumPairToViewTangPosTable> det1det2_to_uncompressed_view_tangpos_sptr;
   mutable bool det1det2_to_uncompressed_view_tangpos_initialised;
-  //! build look-up table for get_view_tangential_pos_num_for_det_num_pair()
+  //! find look-up table for get_view_tangential_pos_num_for_det_num_pair()
   void initialise_det1det2_to_uncompressed_view_tangpos() const;
 
   //! build look-up table unless already done before
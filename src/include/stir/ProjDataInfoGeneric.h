@@ -89,6 +89,14 @@ public:
 
   void get_LOR(LORInAxialAndNoArcCorrSinogramCoordinates<float>& lor, const Bin& bin) const override;
 
+  //! Get the end-points of the LORs for all bins in a viewgram
+  /*! This uses the (general) implementation of ProjDataInfo, as LORs for different axial positions are
+      not necessarily shifted versions of each other.
+  */
+  void get_LOR_end_points_for_viewgram(LOREndPoints& end_points,
+                                       const ViewgramIndices& viewgram_indices,
+                                       const float radius) const override;
+
   void set_azimuthal_angle_offset(const float angle) = delete;
   void set_azimuthal_angle_sampling(const float angle) = delete;
 
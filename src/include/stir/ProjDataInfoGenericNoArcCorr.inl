@@ -97,8 +97,9 @@ ProjDataInfoGenericNoArcCorr::get_det_num_pair_for_view_tangential_pos_num(int&
   assert(get_view_mashing_factor() == 1);
   this->initialise_uncompressed_view_tangpos_to_det1det2_if_not_done_yet();
 
-  det1_num = uncompressed_view_tangpos_to_det1det2[view_num][tang_pos_num].det1_num;
-  det2_num = uncompressed_view_tangpos_to_det1det2[view_num][tang_pos_num].det2_num;
+  const auto& dets = (*uncompressed_view_tangpos_to_det1det2_sptr)(view_num, tang_pos_num);
+  det1_num = dets.det1_num;
+  det2_num = dets.det2_num;
 }
 
 bool
@@ -110,9 +111,10 @@ ProjDataInfoGenericNoArcCorr::get_view_tangential_pos_num_for_det_num_pair(int&
   assert(det1_num != det2_num);
   this->initialise_det1det2_to_uncompressed_view_tangpos_if_not_done_yet();
 
-  view_num = det1det2_to_uncompressed_view_tangpos[det1_num][det2_num].view_num / get_view_mashing_factor();
-  tang_pos_num = det1det2_to_uncompressed_view_tangpos[det1_num][det2_num].tang_pos_num;
-  return det1det2_to_uncompressed_view_tangpos[det1_num][det2_num].swap_detectors;
+  const auto& view_tangpos = (*det1det2_to_uncompressed_view_tangpos_sptr)(det1_num, det2_num);
+  view_num = view_tangpos.view_num / get_view_mashing_factor();
+  tang_pos_num = view_tangpos.tang_pos_num;
+  return view_tangpos.swap_detectors;
 }
 
 Succeeded
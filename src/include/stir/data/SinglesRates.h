@@ -148,6 +148,13 @@ public:
 
   virtual float get_singles(const DetectionPosition<>& det_pos, const double start_time, const double end_time) const;
 
+  //! Get the number of singles for all singles units for the specified start and end times
+  /*! The result is indexed by the singles bin index (see Scanner::get_singles_bin_index()).
+
+    Default implementation calls get_singles(int,double,double) for every singles unit.
+  */
+  virtual std::vector<float> get_singles_for_all_units(const double start_time, const double end_time) const;
+
   //! Get the scanner pointer
   inline const Scanner* get_scanner_ptr() const;
 
@@ -26,6 +26,8 @@
 #include "stir/data/SinglesRates.h"
 #include "stir/Array.h"
 #include "stir/TimeFrameDefinitions.h"
+#include "stir/shared_ptr.h"
+#include <vector>
 
 START_NAMESPACE_STIR
 
@@ -33,6 +35,10 @@ START_NAMESPACE_STIR
   \ingroup singles_buildblock
   \brief A class for singles that are recorded at equal time intervals
 
+  The number of singles in a time interval is computed from cumulative sums of the singles
+  over the time slices (per singles unit), assuming that the singles are uniformly distributed
+  within each time slice. These cumulative sums are computed when first needed, such that
+  get_singles() only needs to find the first and last time slice of the interval (via binary search).
 */
 class SinglesRatesForTimeSlices : public SinglesRates
 
@@ -44,6 +50,9 @@ public:
   // implementation of pure virtual in SinglesRates
   float get_singles(const int singles_bin_index, const double start_time, const double end_time) const override;
 
+  //! Get the number of singles for all singles units, using the cumulative sums for all units at once
+  std::vector<float> get_singles_for_all_units(const double start_time, const double end_time) const override;
+
   //! Generate a FramesSinglesRate - containing the average rates
   //  for a frame begining at start_time and ending at end_time.
   FrameSinglesRates STIR_DEPRECATED get_rates_for_frame(double start_time, double end_time) const;
@@ -144,6 +153,29 @@ protected:
 
   //! get slice start time.
   double get_slice_start_time(int slice_index) const;
+
+  //! Discard the cumulative sums of the singles
+  /*! Has to be called by derived classes when modifying \c _singles or \c _times after
+      the singles have been used.
+  */
+  void invalidate_cumulative_singles();
+
+private:
+  //! cumulative singles, indexed by slice (from 0 to _num_time_slices) and singles bin index
+  /*! Entry [slice][bin] is the sum of the singles in all time slices before \c slice.
+      Computed by get_cumulative_singles().
+  */
+  mutable shared_ptr<const Array<2, double>> _cumulative_singles_sptr;
+
+  //! return the cumulative singles, computing them if necessary
+  shared_ptr<const Array<2, double>> get_cumulative_singles() const;
+
+  //! check the time interval and find the start and end slices
+  void find_slices_for_interval(int& start_slice, int& end_slice, const double start_time, const double end_time) const;
+
+  //! cumulative number of singles in \a singles_bin_index up to time \a t, which has to be in \a slice
+  double
+  get_cumulative_singles(const Array<2, double>& cumulative_singles, const int singles_bin_index, const int slice, const double t) const;
 };
 
 END_NAMESPACE_STIR
@@ -0,0 +1,221 @@
+/*!
+  \file
+  \ingroup buildblock_detail
+  \brief Implementation of the 3D rank filters used by stir::MedianArrayFilter3D, stir::MinimalArrayFilter3D
+  and stir::MaximalArrayFilter3D.
+
+  These functions are only intended to be used by the implementation of those classes.
+*/
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+
+#ifndef __stir_detail_rank_filter_3d_H__
+#define __stir_detail_rank_filter_3d_H__
+
+#include "stir/Array.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+START_NAMESPACE_STIR
+
+namespace detail
+{
+
+/*! \ingroup buildblock_detail
+  \brief Finds all rows of \a in_array that are within the mask of the row (\a z, \a y)
+
+  Rows outside the index range of \a in_array are skipped, as are rows with an empty range.
+*/
+template <typename elemT>
+inline void
+get_rows_in_rank_filter_mask(std::vector<const Array<1, elemT>*>& rows,
+                             const Array<3, elemT>& in_array,
+                             const int z,
+                             const int y,
+                             const int mask_radius_z,
+                             const int mask_radius_y)
+{
+  rows.clear();
+  const int min_z = std::max(z - mask_radius_z, in_array.get_min_index());
+  const int max_z = std::min(z + mask_radius_z, in_array.get_max_index());
+  for (int zi = min_z; zi <= max_z; ++zi)
+    {
+      const int min_y = std::max(y - mask_radius_y, in_array[zi].get_min_index());
+      const int max_y = std::min(y + mask_radius_y, in_array[zi].get_max_index());
+      for (int yi = min_y; yi <= max_y; ++yi)
+        if (in_array[zi][yi].size() > 0)
+          rows.push_back(&in_array[zi][yi]);
+    }
+}
+
+//! Appends all values of \a rows at index \a x (if in range) to \a column
+template <typename elemT>
+inline void
+append_rank_filter_column(std::vector<elemT>& column, const std::vector<const Array<1, elemT>*>& rows, const int x)
+{
+  for (const auto row_ptr : rows)
+    if (x >= row_ptr->get_min_index() && x <= row_ptr->get_max_index())
+      column.push_back((*row_ptr)[x]);
+}
+
+/*! \ingroup buildblock_detail
+  \brief Median filter of a 3D array, using only the neighbours within the index range of \a in_array
+
+  For every row along x, a sorted list of all values in the mask is kept. When moving to the
+  next voxel, the sorted column of values leaving the mask is removed and the sorted column
+  of values entering the mask is merged in. This only needs a number of operations proportional
+  to the size of the mask, as opposed to sorting (or partially sorting) all values for every voxel.
+
+  For an even number of neighbours \c n, the median is (sorted[n/2-1]+sorted[n/2])/2.
+  Voxels without any neighbour in \a in_array are left unchanged.
+
+  Planes are processed in parallel when OpenMP is enabled.
+*/
+template <typename elemT>
+void
+median_filter_3d(Array<3, elemT>& out_array,
+                 const Array<3, elemT>& in_array,
+                 const int mask_radius_z,
+                 const int mask_radius_y,
+                 const int mask_radius_x)
+{
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (int z = out_array.get_min_index(); z <= out_array.get_max_index(); ++z)
+    {
+      std::vector<const Array<1, elemT>*> rows;
+      std::vector<elemT> window, new_window, leaving, entering;
+      for (int y = out_array[z].get_min_index(); y <= out_array[z].get_max_index(); ++y)
+        {
+          Array<1, elemT>& out_row = out_array[z][y];
+          if (out_row.size() == 0)
+            continue;
+          get_rows_in_rank_filter_mask(rows, in_array, z, y, mask_radius_z, mask_radius_y);
+          if (rows.empty())
+            continue;
+
+          window.clear();
+          for (int x = out_row.get_min_index() - mask_radius_x; x <= out_row.get_min_index() + mask_radius_x; ++x)
+            append_rank_filter_column(window, rows, x);
+          std::sort(window.begin(), window.end());
+
+          for (int x = out_row.get_min_index(); x <= out_row.get_max_index(); ++x)
+            {
+              if (x > out_row.get_min_index())
+                {
+                  leaving.clear();
+                  append_rank_filter_column(leaving, rows, x - mask_radius_x - 1);
+                  std::sort(leaving.begin(), leaving.end());
+                  entering.clear();
+                  append_rank_filter_column(entering, rows, x + mask_radius_x);
+                  std::sort(entering.begin(), entering.end());
+
+                  new_window.clear();
+                  std::set_difference(
+                      window.begin(), window.end(), leaving.begin(), leaving.end(), std::back_inserter(new_window));
+                  window.clear();
+                  std::merge(
+                      new_window.begin(), new_window.end(), entering.begin(), entering.end(), std::back_inserter(window));
+                }
+              const std::size_t num_neighbours = window.size();
+              if (num_neighbours == 0)
+                continue;
+              if (num_neighbours % 2 == 1)
+                out_row[x] = window[num_neighbours / 2];
+              else
+                out_row[x] = (window[num_neighbours / 2] + window[num_neighbours / 2 - 1]) / 2;
+            }
+        }
+    }
+}
+
+/*! \ingroup buildblock_detail
+  \brief Minimum or maximum filter of a 3D array, using only the neighbours within the index range of \a in_array
+
+  For every row along x, the extremum over all rows in the mask is first computed for every
+  x-index (a "column"). The output is then the extremum over the columns in the mask, such that
+  every input value is only compared once per output row, instead of once per output voxel.
+
+  \a comp is the comparison function used to find the extremum, i.e. \c std::less for the minimum
+  and \c std::greater for the maximum.
+  Voxels without any neighbour in \a in_array are left unchanged.
+
+  Planes are processed in parallel when OpenMP is enabled.
+*/
+template <typename elemT, typename Compare>
+void
+extremum_filter_3d(Array<3, elemT>& out_array,
+                   const Array<3, elemT>& in_array,
+                   const int mask_radius_z,
+                   const int mask_radius_y,
+                   const int mask_radius_x,
+                   Compare comp)
+{
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (int z = out_array.get_min_index(); z <= out_array.get_max_index(); ++z)
+    {
+      std::vector<const Array<1, elemT>*> rows;
+      std::vector<elemT> column_extremum;
+      std::vector<bool> column_has_value;
+      for (int y = out_array[z].get_min_index(); y <= out_array[z].get_max_index(); ++y)
+        {
+          Array<1, elemT>& out_row = out_array[z][y];
+          if (out_row.size() == 0)
+            continue;
+          get_rows_in_rank_filter_mask(rows, in_array, z, y, mask_radius_z, mask_radius_y);
+          if (rows.empty())
+            continue;
+
+          // column_extremum[i] stores the extremum over all rows at x-index first_x+i
+          const int first_x = out_row.get_min_index() - mask_radius_x;
+          const int last_x = out_row.get_max_index() + mask_radius_x;
+          column_extremum.assign(last_x - first_x + 1, elemT(0));
+          column_has_value.assign(last_x - first_x + 1, false);
+          for (const auto row_ptr : rows)
+            {
+              const int min_x = std::max(first_x, row_ptr->get_min_index());
+              const int max_x = std::min(last_x, row_ptr->get_max_index());
+              for (int x = min_x; x <= max_x; ++x)
+                {
+                  const elemT value = (*row_ptr)[x];
+                  const int i = x - first_x;
+                  if (!column_has_value[i] || comp(value, column_extremum[i]))
+                    {
+                      column_extremum[i] = value;
+                      column_has_value[i] = true;
+                    }
+                }
+            }
+
+          for (int x = out_row.get_min_index(); x <= out_row.get_max_index(); ++x)
+            {
+              bool has_value = false;
+              elemT extremum = elemT(0);
+              for (int i = x - mask_radius_x - first_x; i <= x + mask_radius_x - first_x; ++i)
+                if (column_has_value[i] && (!has_value || comp(column_extremum[i], extremum)))
+                  {
+                    extremum = column_extremum[i];
+                    has_value = true;
+                  }
+              if (has_value)
+                out_row[x] = extremum;
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+END_NAMESPACE_STIR
+
+#endif
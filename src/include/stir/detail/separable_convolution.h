@@ -0,0 +1,215 @@
+/*!
+  \file
+  \ingroup buildblock_detail
+  \brief Implementation of 1D convolutions along one dimension of a 3D array, processing many lines at once.
+
+  These functions are used by stir::SeparableArrayFunctionObject when all its 1D filters are
+  convolutions (i.e. stir::ArrayFilter1DUsingConvolution or stir::ArrayFilter1DUsingConvolutionSymmetricKernel).
+*/
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+
+#ifndef __stir_detail_separable_convolution_H__
+#define __stir_detail_separable_convolution_H__
+
+#include "stir/Array.h"
+#include "stir/BasicCoordinate.h"
+#include "stir/BoundaryConditions.h"
+#include "stir/VectorWithOffset.h"
+#include "stir/error.h"
+#include <algorithm>
+#include <vector>
+
+START_NAMESPACE_STIR
+
+namespace detail
+{
+
+/*! \ingroup buildblock_detail
+  \brief Description of a 1D convolution as used by convolve_3d_array_along_dimension()
+
+  For a non-symmetric kernel, \f$ out_i = \sum_j kernel_j in_{i-j} \f$, as in ArrayFilter1DUsingConvolution.
+  For a symmetric kernel, only the coefficients for \c j>=0 are stored, as in
+  ArrayFilter1DUsingConvolutionSymmetricKernel.
+*/
+template <typename elemT>
+struct LineConvolutionKernel
+{
+  VectorWithOffset<elemT> coefficients;
+  bool symmetric;
+  BoundaryConditions::BC bc;
+};
+
+/*! \ingroup buildblock_detail
+  \brief Convolves \a width interleaved lines of a padded buffer
+
+  \a padded stores element \c p of line \c t at <tt>p*width+t</tt>. It has to contain
+  <tt>max(j_max,0)</tt> padding elements before the start of the lines and <tt>max(-j_min,0)</tt> after.
+  The result is stored in the same layout (without padding) in \a out.
+
+  As the innermost loop runs over the lines, it is contiguous and free of boundary checks, such
+  that it can be vectorised by the compiler. The order of the summation is the same as in the
+  1D filter classes, such that results are identical.
+*/
+template <typename elemT>
+inline void
+convolve_padded_lines(
+    elemT* out, const elemT* padded, const int length, const int width, const LineConvolutionKernel<elemT>& kernel)
+{
+  const VectorWithOffset<elemT>& coefficients = kernel.coefficients;
+  const int j_max = coefficients.get_max_index();
+  if (kernel.symmetric)
+    {
+      for (int l = 0; l < length; ++l)
+        {
+          elemT* const out_line = out + l * width;
+          const elemT* const centre = padded + (l + j_max) * width;
+          const elemT centre_coefficient = coefficients[0];
+          for (int t = 0; t < width; ++t)
+            out_line[t] = centre_coefficient * centre[t];
+          for (int j = 1; j <= j_max; ++j)
+            {
+              const elemT coefficient = coefficients[j];
+              const elemT* const left = centre - j * width;
+              const elemT* const right = centre + j * width;
+              for (int t = 0; t < width; ++t)
+                out_line[t] += coefficient * (left[t] + right[t]);
+            }
+        }
+    }
+  else
+    {
+      const int pad_before = std::max(j_max, 0);
+      for (int l = 0; l < length; ++l)
+        {
+          elemT* const out_line = out + l * width;
+          std::fill(out_line, out_line + width, elemT(0));
+          for (int j = coefficients.get_min_index(); j <= j_max; ++j)
+            {
+              const elemT coefficient = coefficients[j];
+              const elemT* const in_line = padded + (l - j + pad_before) * width;
+              for (int t = 0; t < width; ++t)
+                out_line[t] += coefficient * in_line[t];
+            }
+        }
+    }
+}
+
+/*! \ingroup buildblock_detail
+  \brief In-place convolution of all lines along dimension \a dim (1, 2 or 3) of a regular 3D array
+
+  Lines are processed in tiles of (at most) \c tile_width lines. For dimensions 1 and 2, the lines
+  in a tile are neighbours along the last index, such that they can be copied row-wise into the padded
+  buffer. For dimension 3, the tile is transposed when copying into the buffer (and back), such that
+  the same vectorised code can be used. Boundary conditions are handled when filling the padded
+  buffer, and not in the convolution itself.
+
+  Tiles are processed in parallel when OpenMP is enabled.
+*/
+template <typename elemT>
+void
+convolve_3d_array_along_dimension(Array<3, elemT>& array, const int dim, const LineConvolutionKernel<elemT>& kernel)
+{
+  assert(dim >= 1 && dim <= 3);
+  assert(kernel.bc == BoundaryConditions::zero || kernel.bc == BoundaryConditions::constant);
+  BasicCoordinate<3, int> min_indices, max_indices;
+  if (!array.get_regular_range(min_indices, max_indices))
+    error("convolve_3d_array_along_dimension: can only handle regular arrays");
+  const BasicCoordinate<3, int> sizes = max_indices - min_indices + 1;
+  if (sizes[1] <= 0 || sizes[2] <= 0 || sizes[3] <= 0)
+    return;
+
+  const int j_min = kernel.symmetric ? -kernel.coefficients.get_max_index() : kernel.coefficients.get_min_index();
+  const int j_max = kernel.coefficients.get_max_index();
+  const int pad_before = std::max(j_max, 0);
+  const int pad_after = std::max(-j_min, 0);
+
+  const int tile_width = 64;
+  const int length = sizes[dim];
+  // the lines in a tile run along the last index, except when filtering along that index
+  const int tile_dim = dim == 3 ? 2 : 3;
+  const int outer_dim = dim == 1 ? 2 : 1;
+  const int num_tiles_per_outer_index = (sizes[tile_dim] + tile_width - 1) / tile_width;
+  const int num_tiles = sizes[outer_dim] * num_tiles_per_outer_index;
+
+#ifdef STIR_OPENMP
+#  pragma omp parallel
+#endif
+  {
+    std::vector<elemT> padded, result;
+    // for dim 3: pointers to the start of every line in the tile
+    // otherwise: pointers to the first line of the tile at every position along the line
+    std::vector<elemT*> ptrs;
+#ifdef STIR_OPENMP
+#  pragma omp for schedule(static)
+#endif
+    for (int tile = 0; tile < num_tiles; ++tile)
+      {
+        const int outer_index = min_indices[outer_dim] + tile / num_tiles_per_outer_index;
+        const int tile_start = min_indices[tile_dim] + (tile % num_tiles_per_outer_index) * tile_width;
+        const int width = std::min(tile_width, max_indices[tile_dim] - tile_start + 1);
+
+        if (dim == 3)
+          {
+            ptrs.resize(width);
+            for (int t = 0; t < width; ++t)
+              ptrs[t] = &array[outer_index][tile_start + t][min_indices[3]];
+          }
+        else
+          {
+            ptrs.resize(length);
+            for (int l = 0; l < length; ++l)
+              ptrs[l] = dim == 1 ? &array[min_indices[1] + l][outer_index][tile_start]
+                                 : &array[outer_index][min_indices[2] + l][tile_start];
+          }
+
+        // fill padded buffer, handling boundary conditions
+        padded.resize(static_cast<std::size_t>(length + pad_before + pad_after) * width);
+        for (int p = 0; p < length + pad_before + pad_after; ++p)
+          {
+            elemT* const padded_line = &padded[static_cast<std::size_t>(p) * width];
+            int l = p - pad_before;
+            if (l < 0 || l >= length)
+              {
+                if (kernel.bc == BoundaryConditions::zero)
+                  {
+                    std::fill(padded_line, padded_line + width, elemT(0));
+                    continue;
+                  }
+                l = l < 0 ? 0 : length - 1;
+              }
+            if (dim == 3)
+              for (int t = 0; t < width; ++t)
+                padded_line[t] = ptrs[t][l];
+            else
+              std::copy(ptrs[l], ptrs[l] + width, padded_line);
+          }
+
+        result.resize(static_cast<std::size_t>(length) * width);
+        convolve_padded_lines(&result[0], &padded[0], length, width, kernel);
+
+        // copy result back
+        for (int l = 0; l < length; ++l)
+          {
+            const elemT* const result_line = &result[static_cast<std::size_t>(l) * width];
+            if (dim == 3)
+              for (int t = 0; t < width; ++t)
+                ptrs[t][l] = result_line[t];
+            else
+              std::copy(result_line, result_line + width, ptrs[l]);
+          }
+      }
+  }
+}
+
+} // namespace detail
+
+END_NAMESPACE_STIR
+
+#endif
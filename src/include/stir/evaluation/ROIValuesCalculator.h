@@ -0,0 +1,123 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup evaluation
+
+  \brief Declaration of class stir::ROIValuesCalculator
+*/
+
+#ifndef __stir_evaluation_ROIValuesCalculator__H__
+#define __stir_evaluation_ROIValuesCalculator__H__
+
+#include "stir/evaluation/ROIValues.h"
+#include "stir/VectorWithOffset.h"
+#include "stir/shared_ptr.h"
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+START_NAMESPACE_STIR
+
+template <typename coordT>
+class CartesianCoordinate3D;
+template <int num_dimensions, typename elemT>
+class DiscretisedDensity;
+class Shape3D;
+
+/*!
+  \ingroup evaluation
+  \brief Computes ROI values for many ROIs and images
+
+  Every ROI is discretised only once (when it is added), and stored as a list of voxels with non-zero weight.
+  The ROI values of all ROIs can then be computed for any image with the same characteristics as the template
+  image passed to the constructor. This is much faster than calling compute_ROI_values_per_plane() for every ROI
+  and image, as the shapes do not have to be discretised again, and voxels outside the ROIs are not visited.
+  All (ROI, plane) combinations are processed in parallel (when using OpenMP).
+
+  Results are identical to those of compute_ROI_values_per_plane() (see there for the use of the weights).
+
+  \par Example
+  \code
+  ROIValuesCalculator calculator(*images[0]);
+  for (auto& shape_sptr : shapes)
+    calculator.add_ROI(*shape_sptr, CartesianCoordinate3D<int>(1, 1, 1));
+  calculator.write_table_header(std::cout, false);
+  for (auto& image_sptr : images)
+    calculator.write_table(std::cout, "some name", calculator.compute_total_ROI_values(*image_sptr));
+  \endcode
+*/
+class ROIValuesCalculator
+{
+public:
+  //! Constructor, taking an image which determines the characteristics of all images used later
+  /*! \a template_image has to be a VoxelsOnCartesianGrid object. Its values are not used. */
+  explicit ROIValuesCalculator(const DiscretisedDensity<3, float>& template_image);
+
+  //! Discretise a shape and add it to the list of ROIs
+  /*! \see Shape3D::construct_volume for the meaning of \a num_samples.
+      \return the index of the new ROI
+  */
+  int add_ROI(const Shape3D& shape, const CartesianCoordinate3D<int>& num_samples, const std::string& name = "");
+
+  //! Add a discretised shape to the list of ROIs
+  /*! \a discretised_shape has to have the same characteristics as the template image.
+      \return the index of the new ROI
+  */
+  int add_ROI(const DiscretisedDensity<3, float>& discretised_shape, const std::string& name = "");
+
+  int get_num_ROIs() const;
+  const std::string& get_ROI_name(const int ROI_num) const;
+  //! Number of voxels with non-zero weight in the ROI
+  std::size_t get_num_voxels(const int ROI_num) const;
+
+  //! Compute ROI values in every plane for all ROIs
+  /*! On return, \a values[ROI_num][z] contains the values for plane \c z of ROI \c ROI_num. */
+  void compute_ROI_values_per_plane(std::vector<VectorWithOffset<ROIValues>>& values,
+                                    const DiscretisedDensity<3, float>& image) const;
+
+  //! Compute ROI values over all planes for all ROIs
+  std::vector<ROIValues> compute_total_ROI_values(const DiscretisedDensity<3, float>& image) const;
+
+  //! \name Functions to write the values as a table
+  /*! The table has one line per ROI (and plane), with tab-separated columns
+      <tt>image ROI [plane] volume integral integral_of_square mean stddev CV min max</tt>.
+      The plane column is only present if \a by_plane is \c true. Planes are numbered from 1
+      (for the first plane of the template image).
+  */
+  //@{
+  static void write_table_header(std::ostream& s, const bool by_plane);
+  void write_table(std::ostream& s, const std::string& image_name, const std::vector<ROIValues>& values) const;
+  void write_table(std::ostream& s,
+                   const std::string& image_name,
+                   const std::vector<VectorWithOffset<ROIValues>>& values) const;
+  //@}
+
+private:
+  //! Voxels of one ROI with non-zero weight
+  struct DiscretisedROI
+  {
+    std::string name;
+    //! voxels in plane \c z are at positions <tt>[plane_starts[z-min_z], plane_starts[z-min_z+1])</tt>
+    std::vector<std::size_t> plane_starts;
+    std::vector<int> y_indices;
+    std::vector<int> x_indices;
+    std::vector<float> weights;
+  };
+
+  shared_ptr<const DiscretisedDensity<3, float>> template_image_sptr;
+  float voxel_volume;
+  std::vector<DiscretisedROI> ROIs;
+
+  void check_image(const DiscretisedDensity<3, float>& image, const char* const caller) const;
+};
+
+END_NAMESPACE_STIR
+
+#endif
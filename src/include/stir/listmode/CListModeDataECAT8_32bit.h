@@ -47,6 +47,9 @@ public:
 
   std::string get_name() const override;
 
+  //! Returns the name of the binary file with the list mode data (not the header)
+  std::string get_data_filename() const override;
+
   shared_ptr<CListRecord> get_empty_record_sptr() const override;
 
   Succeeded get_next_record(CListRecord& record) const override;
@@ -57,6 +60,10 @@ public:
 
   Succeeded set_get_position(const SavedPosition&) override;
 
+  std::vector<std::streampos> get_saved_get_positions() const override;
+
+  Succeeded set_saved_get_positions(const std::vector<std::streampos>&) override;
+
   //! returns \c true, as ECAT listmode data stores delayed events (and prompts)
   /*! \todo this might depend on the acquisition parameters */
   bool has_delayeds() const override { return true; }
@@ -64,6 +71,8 @@ public:
 private:
   typedef CListRecordECAT8_32bit CListRecordT;
   std::string listmode_filename;
+  //! name of the binary file (including directory)
+  std::string data_filename;
   shared_ptr<InputStreamWithRecords<CListRecordT, bool>> current_lm_data_ptr;
 
   InterfileListmodeHeaderSiemens interfile_parser;
@@ -44,6 +44,8 @@ public:
 
   std::string get_name() const override;
 
+  std::string get_data_filename() const override { return get_name(); }
+
   virtual std::time_t get_scan_start_time_in_secs_since_1970() const;
 
   shared_ptr<CListRecord> get_empty_record_sptr() const override;
@@ -56,6 +58,10 @@ public:
 
   Succeeded set_get_position(const SavedPosition&) override;
 
+  std::vector<std::streampos> get_saved_get_positions() const override;
+
+  Succeeded set_saved_get_positions(const std::vector<std::streampos>&) override;
+
   //! returns \c false, as GEHDF5 listmode data does not store delayed events (and prompts)
   /*! \todo this depends on the acquisition parameters */
   bool has_delayeds() const override { return false; }
@@ -72,6 +72,7 @@ public:
   CListModeDataSAFIR(const std::string& listmode_filename, const shared_ptr<const ProjDataInfo>& proj_data_info_sptr);
 
   std::string get_name() const override;
+  std::string get_data_filename() const override { return get_name(); }
   shared_ptr<CListRecord> get_empty_record_sptr() const override;
   Succeeded get_next_record(CListRecord& record_of_general_type) const override;
   Succeeded reset() override;
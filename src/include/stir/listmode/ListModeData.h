@@ -23,6 +23,8 @@
 
 #include <string>
 #include <ctime>
+#include <vector>
+#include <ios>
 #include "stir/ProjDataInfo.h"
 #include "stir/ExamData.h"
 #include "stir/RegisteredParsingObject.h"
@@ -145,6 +147,16 @@ public:
   */
   virtual std::string get_name() const = 0;
 
+  //! Returns the name of the file containing the list mode events
+  /*! This can be different from get_name(), e.g. when the data consists of a header and a
+      separate data file. It is used to check if files derived from the data (such as a ListModeIndex)
+      are still consistent with it.
+
+      The default implementation returns an empty string, meaning that the file is unknown (or that
+      there is no single such file).
+  */
+  virtual std::string get_data_filename() const;
+
   //  //! Get const pointer to exam info
   //  const ExamInfo*
   //    get_exam_info_ptr() const;
@@ -210,6 +222,24 @@ public:
 
   virtual Succeeded set_get_position(const SavedPosition&) = 0;
 
+  //! Get the list of saved positions in a form that can be stored on disk
+  /*! The n-th element corresponds to the SavedPosition \c n returned by save_get_position().
+      Together with set_saved_get_positions(), this allows to reuse positions in another
+      ListModeData object that reads the same data (see ListModeIndex).
+
+      The default implementation returns an empty vector, which is also what a derived class
+      should return if it does not support this facility.
+  */
+  virtual std::vector<std::streampos> get_saved_get_positions() const;
+
+  //! Set the list of saved positions
+  /*! \a positions should be obtained from get_saved_get_positions() for the same data
+      (possibly by a different object). Afterwards, set_get_position(n) will go to \c positions[n].
+
+      \return Succeeded::no if the derived class does not support this facility (the default).
+  */
+  virtual Succeeded set_saved_get_positions(const std::vector<std::streampos>& positions);
+
   //! Get reference to scanner
   /*! Returns a reference to a scanner object that is appropriate for the
       list mode data that is being read.
@@ -0,0 +1,134 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup listmode
+  \brief Declaration of class stir::ListModeIndex
+*/
+
+#ifndef __stir_listmode_ListModeIndex_H__
+#define __stir_listmode_ListModeIndex_H__
+
+#include "stir/listmode/ListModeData.h"
+#include "stir/shared_ptr.h"
+#include <string>
+#include <vector>
+#include <ios>
+
+START_NAMESPACE_STIR
+
+class Succeeded;
+
+//! An index into list mode data, allowing to jump to a time and to get count rates without reading all events
+/*!
+  \ingroup listmode
+
+  List mode data can only be read sequentially, so finding the start of a time frame, or computing
+  a count-rate curve, normally requires reading all events. This class scans the data once, and
+  stores for every time interval
+  - the time (in secs) of the first time tag at or after the start of the interval,
+  - the position in the list mode data just after that time tag,
+  - the number of prompts and delayeds between this position and the next one.
+
+  The first entry corresponds to the start of the data (at time 0). Intervals where no
+  time tag occurs do not get an entry, so the entries are not necessarily equally spaced.
+
+  The index can be written to a (text) file, normally next to the file with the list mode events
+  (see get_default_filename() and ListModeData::get_data_filename()), such that it can be reused later.
+  After calling set_up() with the list mode data, you can use ListModeData::set_get_position() with
+  get_saved_position() to jump to an entry.
+
+  Storing positions relies on ListModeData::get_saved_get_positions(), which is not supported
+  by all list mode formats. If it is not supported, the index contains only the counts (see has_positions()).
+
+  The consistency of an index file with the list mode data is checked via the size and modification time
+  of the file with name <code>ListModeData::get_data_filename()</code>. If that file is not known (or
+  cannot be found), the index cannot be written to or read from file.
+*/
+class ListModeIndex
+{
+public:
+  //! information stored for every time interval
+  struct Entry
+  {
+    //! time (in secs) of the first time tag in this interval
+    double time_in_secs;
+    //! position in the list mode data just after that time tag
+    std::streampos position;
+    unsigned long num_prompts;
+    unsigned long num_delayeds;
+  };
+
+  //! Default constructor (an empty index)
+  ListModeIndex();
+
+  //! Scan the list mode data to construct the index
+  /*! The list mode data is reset() before and after scanning.
+      \a interval_in_secs has to be positive.
+  */
+  ListModeIndex(ListModeData& lm_data, const double interval_in_secs);
+
+  //! Default name of the index file for list mode events stored in \a lm_data_filename
+  static std::string get_default_filename(const std::string& lm_data_filename);
+
+  //! Read the index from the default file, or construct it if the file does not exist or is inconsistent
+  /*! An existing index file is also used if its interval is smaller than \a interval_in_secs,
+      as long as \a interval_in_secs is an integer multiple of it.
+      If the index is constructed and \a write_file is \c true, it is written to the default file.
+      A warning is written if this fails.
+
+      If <code>lm_data.get_data_filename()</code> is empty, the index is always constructed (and not written).
+  */
+  static shared_ptr<ListModeIndex>
+  read_or_create(ListModeData& lm_data, const double interval_in_secs, const bool write_file = true);
+
+  //! Write the index to file
+  /*! \return Succeeded::no if writing fails, or if the file with the list mode events is not known.
+   */
+  Succeeded write_to_file(const std::string& filename) const;
+  //! Read the index from file
+  /*! \return Succeeded::no if the file does not exist, cannot be parsed, or if the size and modification time
+      stored in the file do not correspond to the ones of \a lm_data_filename (normally obtained from
+      ListModeData::get_data_filename()).
+  */
+  Succeeded read_from_file(const std::string& filename, const std::string& lm_data_filename);
+
+  double get_interval_in_secs() const { return interval_in_secs; }
+  bool has_positions() const { return positions_available; }
+  const std::vector<Entry>& get_entries() const { return entries; }
+
+  //! Make the positions of the entries known to \a lm_data
+  /*! This appends the positions to the saved positions of \a lm_data, unless they were already
+      appended by a previous call to set_up() with the same object. */
+  Succeeded set_up(ListModeData& lm_data);
+
+  //! Find the last entry with a time not after \a time_in_secs
+  /*! \return the entry number, or -1 if there is none */
+  int find_entry_num(const double time_in_secs) const;
+
+  //! Position to be used with ListModeData::set_get_position() for the list mode data passed to set_up()
+  ListModeData::SavedPosition get_saved_position(const int entry_num) const;
+
+private:
+  double interval_in_secs;
+  bool positions_available;
+  //! size of the file with the list mode events, or -1 if unknown
+  long long lm_data_file_size;
+  //! modification time of the file with the list mode events (as returned by \c stat)
+  long long lm_data_file_modification_time;
+  std::vector<Entry> entries;
+  std::vector<ListModeData::SavedPosition> saved_positions;
+
+  //! find size and modification time of a file
+  static Succeeded get_file_info(long long& size, long long& modification_time, const std::string& filename);
+};
+
+END_NAMESPACE_STIR
+
+#endif
@@ -38,6 +38,7 @@ START_NAMESPACE_STIR
 
 class ListEvent;
 class ListTime;
+class ListModeIndex;
 
 /*!
   \ingroup listmode
@@ -107,6 +108,11 @@ class ListTime;
     num_segments_in_memory := -1
     ; same for TOF bins
     num_TOF_bins_in_memory := 1
+
+    ; use an index file next to the list mode file to jump to the start of
+    ; every time frame (see ListModeIndex). If the index file does not exist yet,
+    ; it will be created (at the cost of one extra pass through the data).
+    use list mode index := 0 ; default
   End :=
   \endverbatim
 
@@ -211,6 +217,8 @@ public:
   long int get_num_events_to_store() const;
   void set_time_frame_definitions(const TimeFrameDefinitions&);
   const TimeFrameDefinitions& get_time_frame_definitions() const;
+  void set_use_lm_index(bool);
+  bool get_use_lm_index() const;
   //@}
 
   //! Perform various checks
@@ -286,6 +294,9 @@ protected:
   /*! corresponds to key "list event coordinates" */
   bool interactive;
 
+  //! use a ListModeIndex to find the start of the time frames
+  bool use_lm_index;
+
   shared_ptr<ProjDataInfo> template_proj_data_info_ptr;
   //! This will be used for pre-normalisation
   shared_ptr<BinNormalisation> normalisation_ptr;
@@ -302,6 +313,9 @@ protected:
   //! Time frames
   TimeFrameDefinitions frame_defs;
 
+  //! Index for the list mode data (if use_lm_index is true)
+  shared_ptr<ListModeIndex> lm_index_sptr;
+
   //! stores the time (in secs) recorded in the previous timing event
   double current_time;
   //! stores the current frame number
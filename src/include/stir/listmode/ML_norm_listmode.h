@@ -0,0 +1,55 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup listmode
+  \brief Functions to compute data for ML normalisation estimation directly from list mode data
+
+  \see stir/ML_norm.h
+*/
+
+#ifndef __stir_listmode_ML_norm_listmode_H__
+#define __stir_listmode_ML_norm_listmode_H__
+
+#include "stir/common.h"
+#include <limits>
+
+START_NAMESPACE_STIR
+
+class FanProjData;
+class ListModeData;
+class ProjDataInfo;
+
+/*!
+  \ingroup listmode
+  \brief Construct fan data (without gaps) directly from list mode data
+
+  This is equivalent to binning the list mode data into projection data with \a proj_data_info,
+  and calling make_fan_data_remove_gaps(FanProjData&, const ProjData&), but avoids storing the
+  (potentially very large) projection data.
+
+  \a proj_data_info determines the size of the fan data, and which events are included (i.e. maximum ring
+  difference and fan size). It has to satisfy the same constraints as for the projection data version (no
+  arc-correction, span 1, no mashing, no TOF).
+
+  Only events with \a start_time <= time < \a end_time (in secs) are used. Prompts are added with weight 1,
+  delayeds with \a delayed_increment (use -1 for randoms subtraction, or 0 to ignore them).
+
+  \return the number of events added to the fan data (i.e. without those falling into gaps).
+*/
+unsigned long make_fan_data_remove_gaps(FanProjData& fan_data,
+                                        ListModeData& lm_data,
+                                        const ProjDataInfo& proj_data_info,
+                                        const double start_time = 0.,
+                                        const double end_time = std::numeric_limits<double>::max(),
+                                        const int delayed_increment = 0);
+
+END_NAMESPACE_STIR
+
+#endif
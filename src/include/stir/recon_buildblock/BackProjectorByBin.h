@@ -28,6 +28,7 @@
 #include "stir/RegisteredObject.h"
 #include "stir/TimedObject.h"
 #include "stir/shared_ptr.h"
+#include "stir/VectorWithOffset.h"
 #include "stir/Bin.h"
 #include "stir/recon_buildblock/ProjMatrixElemsForOneBin.h"
 
@@ -173,6 +174,21 @@ protected:
                                    const int max_axial_pos_num,
                                    const int min_tangential_pos_num,
                                    const int max_tangential_pos_num);
+
+  //! Return true if the derived class implements actual_back_project_all_tof_bins()
+  /*! If so, back_project(const ProjData&, int, int) calls it for TOF data, instead of
+      back projecting every TOF bin separately. Default returns \c false.
+  */
+  virtual bool processes_all_tof_bins_together() const;
+
+  //! Back project related viewgrams for all TOF bins at once
+  /*! \a viewgrams is indexed by the timing position number.
+      This is only called when processes_all_tof_bins_together() returns \c true.
+      The default implementation calls error().
+  */
+  virtual void actual_back_project_all_tof_bins(DiscretisedDensity<3, float>& density,
+                                                const VectorWithOffset<RelatedViewgrams<float>>& viewgrams);
+
   //! check if the argument is the same as what was used for set_up()
   /*! calls error() if anything is wrong.
 
@@ -189,6 +205,11 @@ protected:
    */
   virtual void check(const ProjDataInfo& proj_data_info, const DiscretisedDensity<3, float>& density_info) const;
 
+  //! Image in which the current thread accumulates the back projection
+  /*! When using OpenMP, the images of all threads are added by get_output().
+  */
+  DiscretisedDensity<3, float>& get_local_output_image();
+
   bool _already_set_up;
 
   //! Clone of the density sptr set with set_up()
@@ -41,6 +41,8 @@ START_NAMESPACE_STIR
   \brief This implements the BackProjectorByBin interface, given any
 ProjMatrixByBin object
 
+  For TOF data, back_project(const ProjData&, ...) handles all TOF bins of a LOR at once, using
+  ProjMatrixByBin::get_proj_matrix_elems_and_tof_kernel_for_one_bin().
   */
 class BackProjectorByBinUsingProjMatrixByBin
     : public RegisteredParsingObject<BackProjectorByBinUsingProjMatrixByBin, BackProjectorByBin>
@@ -79,6 +81,11 @@ protected:
   // currently not exposed, but leaving this ine for the future
   void actual_back_project(DiscretisedDensity<3, float>& image, const Bin& bin);
 
+  //! Returns \c true
+  bool processes_all_tof_bins_together() const override;
+  void actual_back_project_all_tof_bins(DiscretisedDensity<3, float>& image,
+                                        const VectorWithOffset<RelatedViewgrams<float>>& viewgrams) override;
+
 private:
   void set_defaults() override;
   void initialise_keymap() override;
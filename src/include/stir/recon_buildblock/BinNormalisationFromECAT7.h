@@ -65,6 +65,10 @@ START_NAMESPACE_ECAT7
   ; use_dead_time:=1
   ; use_geometric_factors:=1
   ; use_crystal_interference_factors:=1
+
+  ; keyword to compute the efficiencies for the current time frame once and store them in memory.
+  ; This speeds up repeated normalisation (e.g. in every subiteration) at the cost of memory.
+  ; use_precomputed_efficiencies := 0
   End Bin Normalisation From ECAT7:=
   \endverbatim
 
@@ -63,6 +63,10 @@ START_NAMESPACE_ECAT
   ; keyword that can be used to write the components to a separate text files for debugging
   ; files are written in the current directory and are called geom_out.txt etc.
   ; write_components_to_file := 0
+
+  ; keyword to compute the efficiencies for the current time frame once and store them in memory.
+  ; This speeds up repeated normalisation (e.g. in every subiteration) at the cost of memory.
+  ; use_precomputed_efficiencies := 0
   End Bin Normalisation From ECAT8:=
   \endverbatim
 
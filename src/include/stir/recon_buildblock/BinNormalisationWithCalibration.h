@@ -28,9 +28,12 @@
 #include "stir/shared_ptr.h"
 #include "stir/recon_buildblock/BinNormalisation.h"
 #include "stir/decay_correction_factor.h"
+#include <memory>
 
 START_NAMESPACE_STIR
 
+class ProjDataInMemory;
+
 /*!
   \ingroup normalisation
 This class provides the facility to use a calibration factor and (isotope) branching ratio when normalising data.
@@ -38,6 +41,22 @@ This class provides the facility to use a calibration factor and (isotope) branc
 
   Note that it is the responsibility of the derived classes to set the calibration factor.
   The branching ratio is obtained from the radionuclide set in \c ExamInfo (passed by set_up()).
+
+  Computing get_uncalibrated_bin_efficiency() can be expensive (e.g. for component-based normalisation
+  with dead-time correction). If set_use_precomputed_efficiencies() is set to \c true, the
+  efficiencies for the current time frame are computed once (in parallel if OpenMP is enabled)
+  and stored in memory. apply(), undo() and get_bin_efficiency() then use these stored values.
+  They are recomputed when the start or end time of the (first) time frame in the \c ExamInfo
+  changes (e.g. after set_exam_info_sptr()).
+
+  The computation is parallelised over segments and views, but this only works when it is not
+  started from inside another parallel region (e.g. the loop in BinNormalisation::apply(ProjData&)).
+  Therefore, the efficiencies are computed by precompute_efficiencies(), which is called at the end of
+  set_up() of derived classes, and in check(const ExamInfo&), i.e. before the loops in
+  BinNormalisation::apply(ProjData&) and undo(ProjData&). Call it yourself after changing the time frame
+  if you apply the normalisation to RelatedViewgrams in a parallel loop.
+
+  \warning The stored efficiencies are assumed to be independent of the TOF bin.
   */
 class BinNormalisationWithCalibration : public BinNormalisation
 {
@@ -57,16 +76,32 @@ public:
   void set_calibration_factor(const float);
   void set_radionuclide(const Radionuclide&);
 
+  //! Enable/disable storing the efficiencies for the current time frame in memory
+  /*! Defaults to \c false. */
+  void set_use_precomputed_efficiencies(const bool);
+  bool get_use_precomputed_efficiencies() const;
+  //! Compute the efficiencies for the current time frame, if enabled and not done yet
+  /*! Does nothing if set_use_precomputed_efficiencies() was not set to \c true. */
+  void precompute_efficiencies() const;
+
   // needs to be implemented by derived class
   virtual float get_uncalibrated_bin_efficiency(const Bin&) const = 0;
 
   //! return efficiency for 1 bin
   /*! returns get_uncalibrated_bin_efficiency(bin)/get_calib_decay_branching_ratio_factor(bin)
+      (using the stored value of the former if precomputed efficiencies are enabled)
    */
-  float get_bin_efficiency(const Bin& bin) const final
-  {
-    return this->get_uncalibrated_bin_efficiency(bin) / this->_calib_decay_branching_ratio;
-  }
+  float get_bin_efficiency(const Bin& bin) const final;
+
+  // import all apply/undo methods from base-class (we'll override some below)
+  using base_type::apply;
+  using base_type::undo;
+
+  //! normalise some data, using the precomputed efficiencies if enabled
+  void apply(RelatedViewgrams<float>& viewgrams) const override;
+
+  //! undo the normalisation of some data, using the precomputed efficiencies if enabled
+  void undo(RelatedViewgrams<float>& viewgrams) const override;
 
 protected:
   // parsing stuff
@@ -74,6 +109,13 @@ protected:
   void initialise_keymap() override;
   bool post_processing() override;
 
+  using base_type::check;
+  //! calls base_type::check() and precompute_efficiencies()
+  void check(const ExamInfo& exam_info) const override;
+
+  //! if \c true, efficiencies are computed once per time frame and stored
+  bool _use_precomputed_efficiencies;
+
 private:
   // provide facility to switch off things?
   //  need to be added to the parsing keywords
@@ -83,6 +125,19 @@ private:
   //! product of various factors
   /*! computed by set_up() */
   float _calib_decay_branching_ratio;
+
+  //! uncalibrated efficiencies for one time frame
+  struct PrecomputedEfficiencies
+  {
+    double start_time;
+    double end_time;
+    shared_ptr<ProjDataInMemory> efficiencies_sptr;
+  };
+  //! cached efficiencies, (re)computed by get_precomputed_efficiencies()
+  mutable shared_ptr<const PrecomputedEfficiencies> _precomputed_efficiencies_sptr;
+
+  //! return the stored efficiencies for the current time frame, computing them if necessary
+  shared_ptr<const PrecomputedEfficiencies> get_precomputed_efficiencies() const;
 };
 
 END_NAMESPACE_STIR
@@ -31,6 +31,7 @@
 #include "stir/TimedObject.h"
 #include "stir/VoxelsOnCartesianGrid.h"
 #include "stir/shared_ptr.h"
+#include "stir/VectorWithOffset.h"
 #include "stir/Bin.h"
 #include "stir/recon_buildblock/ProjMatrixElemsForOneBin.h"
 
@@ -148,6 +149,20 @@ protected:
                                       const int min_tangential_pos_num,
                                       const int max_tangential_pos_num);
 
+  //! Return true if the derived class implements actual_forward_project_all_tof_bins()
+  /*! If so, forward_project(ProjData&, int, int, bool) calls it for TOF data, instead of
+      forward projecting every TOF bin separately. Default returns \c false.
+  */
+  virtual bool processes_all_tof_bins_together() const;
+
+  //! Forward project related viewgrams for all TOF bins at once
+  /*! \a viewgrams is indexed by the timing position number.
+      This is only called when processes_all_tof_bins_together() returns \c true.
+      The default implementation calls error().
+  */
+  virtual void actual_forward_project_all_tof_bins(VectorWithOffset<RelatedViewgrams<float>>& viewgrams,
+                                                   const DiscretisedDensity<3, float>& density);
+
 #if 0 // disabled as currently not used. needs to be written in the new style anyway
     //! This virtual function has to be implemented by the derived class.
     virtual void actual_forward_project(Bin&,
@@ -43,6 +43,10 @@ class RelatedViewgrams;
 
   It stores a shared_ptr to a ProjMatrixByBin object, which will be used
   to get the relevant elements of the projection matrix.
+
+  For TOF data, forward_project(ProjData&, ...) handles all TOF bins of a LOR at once, using
+  ProjMatrixByBin::get_proj_matrix_elems_and_tof_kernel_for_one_bin(), such that the
+  geometric part of the matrix is only computed (or copied) once for all TOF bins.
   */
 class ForwardProjectorByBinUsingProjMatrixByBin
     : public RegisteredParsingObject<ForwardProjectorByBinUsingProjMatrixByBin, ForwardProjectorByBin>
@@ -67,6 +71,11 @@ public:
 private:
   shared_ptr<ProjMatrixByBin> proj_matrix_ptr;
 
+  //! Returns \c true
+  bool processes_all_tof_bins_together() const override;
+  void actual_forward_project_all_tof_bins(VectorWithOffset<RelatedViewgrams<float>>& viewgrams,
+                                           const DiscretisedDensity<3, float>& image) override;
+
   void actual_forward_project(RelatedViewgrams<float>&,
                               const DiscretisedDensity<3, float>& image,
                               const int min_axial_pos_num,
@@ -59,6 +59,7 @@ public:
 #ifdef PARALLEL
   friend PMessage& operator<<(PMessage&, PETCount_rebinned&);
   friend PMessage& operator>>(PMessage&, PETCount_rebinned&);
+#endif
 
   PETCount_rebinned& operator+=(const PETCount_rebinned& rebin)
   {
@@ -67,7 +68,6 @@ public:
     ssrb += rebin.ssrb;
     return *this;
   }
-#endif
   // Default constructor by initialising all the elements conter to null
   explicit PETCount_rebinned(int total_v = 0, int miss_v = 0, int ssrb_v = 0)
       : total(total_v),
@@ -165,6 +165,8 @@ private:
     and returns the updated stack of 2D rebinned sinograms still in Fourier space,
     the updated weigthing factors as well as  the new rebinned elements counter.
 
+    Only the angular frequencies (k) between \a min_k_index and \a max_k_index are processed,
+    such that different ranges can be processed in parallel.
 
   */
   void rebinning(Array<3, std::complex<float>>& FT_rebinned_data,
@@ -179,7 +181,9 @@ private:
                  const float sampling_distance_in_s,
                  const float radial_sampling_freq_w,
                  const float R_field_of_view_mm,
-                 const float ratio_ring_spacing_to_ring_radius);
+                 const float ratio_ring_spacing_to_ring_radius,
+                 const int min_k_index,
+                 const int max_k_index);
 
   /*!
     \brief This method takes as input the real 3D data set
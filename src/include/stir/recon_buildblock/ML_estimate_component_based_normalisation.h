@@ -18,6 +18,7 @@
 START_NAMESPACE_STIR
 
 class ProjData;
+class FanProjData;
 
 /*!
  \brief Find normalisation factors using a maximum likelihood approach
@@ -35,4 +36,25 @@ void ML_estimate_component_based_normalisation(const std::string& out_filename_p
                                                bool do_KL,
                                                bool do_display);
 
+/*!
+ \brief Find normalisation factors using a maximum likelihood approach, starting from measured fan data
+
+  \ingroup recon_buildblock
+
+  This avoids having to store the measured data as projection data, e.g. when computing \a measured_fan_data
+  directly from list mode data (see make_fan_data_remove_gaps(FanProjData&, ListModeData&, ...)).
+  Scanner information is taken from \a model_data. \a measured_fan_data will be modified (entries where the model is
+  zero are set to zero).
+*/
+void ML_estimate_component_based_normalisation(const std::string& out_filename_prefix,
+                                               FanProjData& measured_fan_data,
+                                               const ProjData& model_data,
+                                               int num_eff_iterations,
+                                               int num_iterations,
+                                               bool do_geo,
+                                               bool do_block,
+                                               bool do_symmetry_per_block,
+                                               bool do_KL,
+                                               bool do_display);
+
 END_NAMESPACE_STIR
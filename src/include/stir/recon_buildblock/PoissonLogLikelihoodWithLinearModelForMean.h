@@ -101,8 +101,26 @@ START_NAMESPACE_STIR
   ; e.g. subsens_%d.hv
   ; boost::format is used with the pattern (which means you can use it like sprintf)
   subset sensitivity filenames:=
+  ; directory for a cache of computed (subset) sensitivities (see below). Not used if empty.
+  sensitivity cache directory:=
   \endverbatim
 
+  \par Sensitivity cache
+  If a <tt>sensitivity cache directory</tt> is set and the (subset) sensitivities need to be computed
+  (i.e. no filenames were given to read them from), the cache is checked first. The entries in the
+  cache are identified by a hash of everything the sensitivities depend on: the projection data geometry,
+  the projectors, the normalisation (including attenuation), the image geometry and, for subset
+  sensitivities, the number of subsets. The full description is stored as well, and checked when reading.
+  When the sensitivities are computed, they are added to the cache, such that later reconstructions with
+  the same set-up (e.g. of other patients with the same protocol) can reuse them. The cache is also used
+  if <tt>recompute sensitivity</tt> is set. To force recomputation, remove the entry from the cache
+  (see get_sensitivity_cache_filename_prefix()).
+
+  \warning Input files (such as normalisation files or attenuation images) are identified by their name
+  in the parameters only. Clear the cache directory if such a file is modified without changing its name.
+
+  Currently the cache is only supported by some derived classes, see get_sensitivity_cache_key().
+
   \par Terminology
   We currently use \c sub_gradient for the gradient of the likelihood of the subset (not
   the mathematical subgradient).
@@ -188,6 +206,15 @@ public:
   boost::format is used with the pattern (which means you can use it like sprintf)
  */
   std::string get_subsensitivity_filenames() const;
+  //! get directory for the sensitivity cache
+  /*! will be a zero string if not set */
+  std::string get_sensitivity_cache_directory() const;
+  //! get the name (including directory, but without extension) of the files in the cache for the current settings
+  /*! The key file has extension \c .key. Images are written as \c .hv (total sensitivity) or
+      \c _subset0.hv etc (subset sensitivities). Returns an empty string if the cache cannot be used.
+      \warning Only valid after set_up().
+  */
+  std::string get_sensitivity_cache_filename_prefix(const TargetT& target) const;
 
   /*! \name Functions to set parameters
     This can be used as alternative to the parsing mechanism.
@@ -213,6 +240,9 @@ public:
   Calls error() if the pattern is invalid.
  */
   void set_subsensitivity_filenames(const std::string&);
+  //! set directory for the sensitivity cache
+  /*! set to a zero-length string to disable the cache */
+  void set_sensitivity_cache_directory(const std::string&);
   //@}
 
   /*! The implementation checks if the sensitivity of a voxel is zero. If so,
@@ -225,6 +255,7 @@ private:
   std::string subsensitivity_filenames;
   bool recompute_sensitivity;
   bool use_subset_sensitivities;
+  std::string sensitivity_cache_directory;
 
   VectorWithOffset<shared_ptr<TargetT>> subsensitivity_sptrs;
   shared_ptr<TargetT> sensitivity_sptr;
@@ -241,17 +272,49 @@ private:
   */
   void set_total_or_subset_sensitivities();
 
+  //! get the key for the sensitivity cache, or an empty string if the cache cannot be used
+  /*! Combines get_sensitivity_cache_key() with the geometry of \a target and the subset settings. */
+  std::string get_full_sensitivity_cache_key(const TargetT& target) const;
+  //! get the name of the files in the cache for a key, without extension
+  std::string get_sensitivity_cache_filename_prefix_for_key(const std::string& key) const;
+  //! read (subset) sensitivities from the cache if an entry for \a key exists
+  Succeeded read_sensitivities_from_cache(const TargetT& target, const std::string& key);
+  //! write (subset) sensitivities to the cache
+  void write_sensitivities_to_cache(const std::string& key) const;
+
 protected:
   //! set-up specifics for the derived class
   virtual Succeeded set_up_before_sensitivity(shared_ptr<const TargetT> const& target_sptr) = 0;
 
   //! compute subset and total sensitivity
   /*! This function fills in the sensitivity data by calling add_subset_sensitivity()
-      for all subsets. It assumes that the subsensitivity for the 1st subset has been
+      for all subsets, or add_sensitivity_of_all_subsets() if subset sensitivities are not used.
+      It assumes that the subsensitivity for the 1st subset has been
       allocated already (and is the correct size).
   */
   void compute_sensitivities();
 
+  //! Add the sensitivity of all subsets to existing data
+  /*! The default implementation calls add_subset_sensitivity() for every subset.
+      Derived classes can override this to compute all subsets in one pass over the data.
+  */
+  virtual void add_sensitivity_of_all_subsets(TargetT& sensitivity) const;
+
+  //! Get a description of all parameters that the sensitivity depends on
+  /*! This is used for the sensitivity cache. It should include the geometry of the data, the projectors
+      and normalisation (including attenuation), but not the image geometry nor the number of subsets,
+      which are added by this class.
+      The default implementation returns an empty string, meaning that the cache cannot be used.
+      Only call this after set_up_before_sensitivity().
+  */
+  virtual std::string get_sensitivity_cache_key() const;
+
+  //! Get the part of the key for the sensitivity cache that depends on the ExamInfo
+  /*! Includes the radionuclide, calibration factor and time frames (but not the absolute start time
+      of the acquisition), as these can be used by the normalisation.
+  */
+  static std::string get_sensitivity_cache_key_for_exam_info(const ExamInfo& exam_info);
+
   //! computes the subset gradient of the objective function without the penalty (optional: add subset sensitivity)
   /*!
     If \c add_sensitivity is \c true, this computes
@@ -30,6 +30,7 @@
 #include "stir/GatedProjData.h"
 #include "stir/GatedDiscretisedDensity.h"
 #include "stir/spatial_transformation/GatedSpatialTransformation.h"
+#include <functional>
 
 START_NAMESPACE_STIR
 
@@ -48,6 +49,20 @@ b}\frac{Y_{bg}}{\sum\limits_{\tilde{\nu}}P_{b\tilde{\nu}}\sum\limits_{\tilde{\nu
 
  For more information: Tsoumpas et al (2013) Physics in Medicine and Biology
 
+ \par Processing gates in parallel
+ When STIR is compiled with OpenMP, the computations for the different gates can be run concurrently
+ by setting
+ \verbatim
+ number of gates to process in parallel := 4
+ \endverbatim
+ (default 1, i.e. one gate after the other). The available threads are then divided over the gates,
+ such that every gate uses <tt>get_max_num_threads()/N</tt> threads for its own computations, with \c N the
+ number of gates processed in parallel. As projectors are not thread-safe, every gate then
+ gets its own copy of the projector pair (constructed from its parameter_info()), which increases memory usage.
+ This is mostly useful when there are many gates with relatively small projection data, where
+ parallelisation within a single gate does not scale well.
+ The result is the same as for serial processing (up to floating point rounding).
+
 */
 
 template <typename TargetT>
@@ -100,6 +115,11 @@ public:
 
   void set_time_gate_definitions(const TimeGateDefinitions& time_gate_definitions);
 
+  //! Set the number of gates that will be processed concurrently (only used with OpenMP)
+  /*! \warning After using this, you have to call set_up(). */
+  void set_num_gates_in_parallel(const int num_gates_in_parallel);
+  int get_num_gates_in_parallel() const;
+
   /*! \name Functions to get parameters
     \warning Be careful with changing shared pointers. If you modify the objects in
     one place, all objects that use the shared pointer will be affected.
@@ -177,6 +197,12 @@ protected:
 
   //! gated image template
   GatedDiscretisedDensity _gated_image_template;
+
+  //! number of gates that will be processed concurrently
+  int _num_gates_in_parallel;
+  //! calls \a gate_function for every gate, processing \c _num_gates_in_parallel gates concurrently if possible
+  void process_gates(const std::function<void(const unsigned int gate_num)>& gate_function) const;
+
   bool actual_subsets_are_approximately_balanced(std::string& warning_message) const override;
 
   //! Sets defaults before parsing
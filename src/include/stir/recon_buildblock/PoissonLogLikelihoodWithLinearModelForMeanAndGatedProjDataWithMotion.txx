@@ -27,6 +27,7 @@
 #include "stir/warning.h"
 #include "stir/error.h"
 #include "stir/is_null_ptr.h"
+#include "stir/num_threads.h"
 
 // include the following to set defaults
 #ifndef USE_PMRT
@@ -41,6 +42,11 @@
 
 #include <algorithm>
 #include <string>
+#include <sstream>
+#include <vector>
+#ifdef STIR_OPENMP
+#  include <omp.h>
+#endif
 // For Motion
 #include "stir/spatial_transformation/GatedSpatialTransformation.h"
 #include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion.h"
@@ -74,6 +80,7 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::s
   // this->_time_gate_definitions_sptr=NULL;
   this->_additive_gated_proj_data_filename = "0";
   this->_additive_gated_proj_data_sptr.reset();
+  this->_num_gates_in_parallel = 1;
 
 #ifndef USE_PMRT // set default for _projector_pair_ptr
   shared_ptr<ForwardProjectorByBin> forward_projector_ptr(new ForwardProjectorByBinUsingRayTracing());
@@ -115,6 +122,8 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::i
   this->parser.add_key("Gate Definitions filename", &this->_gate_definitions_filename);
   this->parser.add_key("Motion Vectors filename prefix", &this->_motion_vectors_filename_prefix);
   this->parser.add_key("Reverse Motion Vectors filename prefix", &this->_reverse_motion_vectors_filename_prefix);
+
+  this->parser.add_key("number of gates to process in parallel", &this->_num_gates_in_parallel);
 }
 
 template <typename TargetT>
@@ -128,6 +137,11 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::p
       warning("You need to specify an input filename");
       return true;
     }
+  if (this->_num_gates_in_parallel < 1)
+    {
+      warning("\"number of gates to process in parallel\" has to be at least 1");
+      return true;
+    }
 
   this->_gated_proj_data_sptr = GatedProjData::read_from_file(this->_input_filename);
 
@@ -299,6 +313,25 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::s
   this->_time_gate_definitions = time_gate_definitions;
 }
 
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::set_num_gates_in_parallel(
+    const int num_gates_in_parallel)
+{
+  if (num_gates_in_parallel < 1)
+    error("PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion: number of gates to process in parallel has to be "
+          "at least 1");
+  this->already_set_up = this->already_set_up && (this->_num_gates_in_parallel == num_gates_in_parallel);
+  this->_num_gates_in_parallel = num_gates_in_parallel;
+}
+
+template <typename TargetT>
+int
+PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::get_num_gates_in_parallel() const
+{
+  return this->_num_gates_in_parallel;
+}
+
 template <typename TargetT>
 void
 PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::set_input_data(const shared_ptr<ExamData>& arg)
@@ -381,7 +414,17 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::s
     for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
       {
         info(boost::format("Objective Function for Gate Number: %1%") % gate_num);
-        this->_single_gate_obj_funcs[gate_num].set_projector_pair_sptr(this->_projector_pair_ptr);
+        shared_ptr<ProjectorByBinPair> gate_projector_pair_sptr = this->_projector_pair_ptr;
+        if (this->_num_gates_in_parallel > 1 && gate_num > 1)
+          {
+            // projectors are not thread-safe, so every gate needs its own copy when processing gates in parallel
+            std::istringstream parameter_info_stream(this->_projector_pair_ptr->parameter_info());
+            gate_projector_pair_sptr.reset(ProjectorByBinPair::read_registered_object(
+                &parameter_info_stream, this->_projector_pair_ptr->get_registered_name()));
+            if (is_null_ptr(gate_projector_pair_sptr))
+              error("Could not construct a copy of the projector pair for gate %d", gate_num);
+          }
+        this->_single_gate_obj_funcs[gate_num].set_projector_pair_sptr(gate_projector_pair_sptr);
         this->_single_gate_obj_funcs[gate_num].set_proj_data_sptr(this->_gated_proj_data_sptr->get_proj_data_sptr(gate_num));
         this->_single_gate_obj_funcs[gate_num].set_max_segment_num_to_process(this->_max_segment_num_to_process);
         this->_single_gate_obj_funcs[gate_num].set_zero_seg0_end_planes(this->_zero_seg0_end_planes != 0);
@@ -416,6 +459,36 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::s
   functions that compute the value/gradient of the objective function etc
 *************************************************************************/
 
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::process_gates(
+    const std::function<void(const unsigned int gate_num)>& gate_function) const
+{
+  const int num_gates = static_cast<int>(this->get_time_gate_definitions().get_num_gates());
+#ifdef STIR_OPENMP
+  const int num_gates_in_parallel = std::min(this->_num_gates_in_parallel, num_gates);
+  if (num_gates_in_parallel > 1)
+    {
+      // make sure the default number of threads is set before we divide the threads over the gates
+      set_num_threads();
+      const int num_threads_per_gate = std::max(1, get_max_num_threads() / num_gates_in_parallel);
+      // allow the single gate computations to use their own threads
+      const int old_max_active_levels = omp_get_max_active_levels();
+      omp_set_max_active_levels(std::max(old_max_active_levels, 2));
+#  pragma omp parallel for num_threads(num_gates_in_parallel) schedule(dynamic)
+      for (int gate_num = 1; gate_num <= num_gates; ++gate_num)
+        {
+          omp_set_num_threads(num_threads_per_gate);
+          gate_function(static_cast<unsigned int>(gate_num));
+        }
+      omp_set_max_active_levels(old_max_active_levels);
+      return;
+    }
+#endif
+  for (int gate_num = 1; gate_num <= num_gates; ++gate_num)
+    gate_function(static_cast<unsigned int>(gate_num));
+}
+
 template <typename TargetT>
 void
 PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::actual_compute_subset_gradient_without_penalty(
@@ -430,12 +503,11 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::a
   for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
     std::fill(gated_image_estimate[gate_num].begin_all(), gated_image_estimate[gate_num].end_all(), 0.F);
   this->_motion_vectors.warp_image(gated_image_estimate, current_estimate);
-  for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
-    {
-      std::fill(gated_gradient[gate_num].begin_all(), gated_gradient[gate_num].end_all(), 0.F);
-      this->_single_gate_obj_funcs[gate_num].actual_compute_subset_gradient_without_penalty(
-          gated_gradient[gate_num], gated_image_estimate[gate_num], subset_num, add_sensitivity);
-    }
+  this->process_gates([&](const unsigned int gate_num) {
+    std::fill(gated_gradient[gate_num].begin_all(), gated_gradient[gate_num].end_all(), 0.F);
+    this->_single_gate_obj_funcs[gate_num].actual_compute_subset_gradient_without_penalty(
+        gated_gradient[gate_num], gated_image_estimate[gate_num], subset_num, add_sensitivity);
+  });
   //	if(this->_motion_correction_type==-1)
   this->_reverse_motion_vectors.warp_image(gradient, gated_gradient);
   //	else
@@ -450,18 +522,21 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<TargetT>::a
   assert(subset_num >= 0);
   assert(subset_num < this->num_subsets);
 
-  double result = 0.;
   GatedDiscretisedDensity gated_image_estimate = this->_gated_image_template;
   // The following initialization doesn't stabilize reconstruction.
   for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
     std::fill(gated_image_estimate[gate_num].begin_all(), gated_image_estimate[gate_num].end_all(), 0.F);
   this->_motion_vectors.warp_image(gated_image_estimate, current_estimate);
-  // loop over single_gate
+  // loop over single_gate, summing the results afterwards in a fixed order
+  std::vector<double> gate_results(this->get_time_gate_definitions().get_num_gates() + 1, 0.);
+  this->process_gates([&](const unsigned int gate_num) {
+    gate_results[gate_num]
+        = this->_single_gate_obj_funcs[gate_num].compute_objective_function_without_penalty(gated_image_estimate[gate_num],
+                                                                                            subset_num);
+  });
+  double result = 0.;
   for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
-    {
-      result += this->_single_gate_obj_funcs[gate_num].compute_objective_function_without_penalty(gated_image_estimate[gate_num],
-                                                                                                  subset_num);
-    }
+    result += gate_results[gate_num];
   return result;
 }
 
@@ -511,17 +586,16 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<
   this->_motion_vectors.warp_image(gated_input, input);
 
   VectorWithOffset<float> scale_factor(1, this->get_time_gate_definitions().get_num_gates());
-  for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
-    {
-      scale_factor[gate_num] = gated_input[gate_num].find_max();
-      /*! /note This is used to avoid higher values than these set in the precompute_denominator_of_conditioner_without_penalty()
-        function. /sa for more information see the recon_array_functions.cxx and the value of the max_quotient (originaly set to
-        10000.F) */
-      gated_input[gate_num] /= scale_factor[gate_num];
-      this->_single_gate_obj_funcs[gate_num].add_multiplication_with_approximate_sub_Hessian_without_penalty(
-          gated_output[gate_num], gated_input[gate_num], subset_num);
-      gated_output[gate_num] *= scale_factor[gate_num];
-    } // end of loop over gates
+  this->process_gates([&](const unsigned int gate_num) {
+    scale_factor[gate_num] = gated_input[gate_num].find_max();
+    /*! /note This is used to avoid higher values than these set in the precompute_denominator_of_conditioner_without_penalty()
+      function. /sa for more information see the recon_array_functions.cxx and the value of the max_quotient (originaly set to
+      10000.F) */
+    gated_input[gate_num] /= scale_factor[gate_num];
+    this->_single_gate_obj_funcs[gate_num].add_multiplication_with_approximate_sub_Hessian_without_penalty(
+        gated_output[gate_num], gated_input[gate_num], subset_num);
+    gated_output[gate_num] *= scale_factor[gate_num];
+  }); // end of loop over gates
   this->_reverse_motion_vectors.warp_image(output, gated_output);
   output /= static_cast<float>(
       this->get_time_gate_definitions().get_num_gates()); // Normalizing to get the average value to test if OSSPS works.
@@ -563,11 +637,10 @@ PoissonLogLikelihoodWithLinearModelForMeanAndGatedProjDataWithMotion<
   this->_motion_vectors.warp_image(gated_input, input);
   this->_motion_vectors.warp_image(gated_current_image_estimate, current_image_estimate);
 
-  for (unsigned int gate_num = 1; gate_num <= this->get_time_gate_definitions().get_num_gates(); ++gate_num)
-    {
-      this->_single_gate_obj_funcs[gate_num].accumulate_sub_Hessian_times_input_without_penalty(
-          gated_output[gate_num], gated_current_image_estimate[gate_num], gated_input[gate_num], subset_num);
-    } // end of loop over gates
+  this->process_gates([&](const unsigned int gate_num) {
+    this->_single_gate_obj_funcs[gate_num].accumulate_sub_Hessian_times_input_without_penalty(
+        gated_output[gate_num], gated_current_image_estimate[gate_num], gated_input[gate_num], subset_num);
+  }); // end of loop over gates
   this->_reverse_motion_vectors.warp_image(output, gated_output);
   output /= static_cast<float>(
       this->get_time_gate_definitions().get_num_gates()); // Normalizing to get the average value to test if OSSPS works.
@@ -118,6 +118,12 @@ protected:
 
   void add_subset_sensitivity(TargetT& sensitivity, const int subset_num) const override;
 
+  //! Computes the sensitivity in a single pass over all views (i.e. as if there is only 1 subset)
+  void add_sensitivity_of_all_subsets(TargetT& sensitivity) const override;
+
+  //! Describes projection data geometry, projectors and normalisation
+  std::string get_sensitivity_cache_key() const override;
+
 #if STIR_VERSION < 060000
   //! Maximum ring difference to take into account
   /*! @deprecated */
@@ -152,6 +158,9 @@ protected:
   bool skip_balanced_subsets;
 
 private:
+  //! add the sensitivity for the views in a subset, where the data are divided in \a num_subsets
+  void add_view_subset_sensitivity(TargetT& sensitivity, const int subset_num, const int num_subsets) const;
+
   //! Cache of the current "batch" in the listmode file
   /*! \todo Move this higher-up in the hierarchy as it doesn't depend on ProjMatrixByBin
    */
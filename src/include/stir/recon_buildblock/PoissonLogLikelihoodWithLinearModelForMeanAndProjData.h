@@ -224,6 +224,12 @@ public:
 protected:
   Succeeded set_up_before_sensitivity(shared_ptr<const TargetT> const& target_sptr) override;
 
+  //! Computes the sensitivity in a single pass over all views (i.e. as if there is only 1 subset)
+  void add_sensitivity_of_all_subsets(TargetT& sensitivity) const override;
+
+  //! Describes projection data geometry, projectors, normalisation and time frame
+  std::string get_sensitivity_cache_key() const override;
+
   double actual_compute_objective_function_without_penalty(const TargetT& current_estimate, const int subset_num) override;
 
   /*!
@@ -388,6 +394,8 @@ private:
   void ensure_norm_is_set_up(bool for_original_data = true) const;
   //! convenience for ensure_norm_is_set_up(false)
   void ensure_norm_is_set_up_for_sensitivity() const;
+  //! add the sensitivity for the views in a subset, where the data are divided in \a num_subsets
+  void add_view_subset_sensitivity(TargetT& sensitivity, const int subset_num, const int num_subsets) const;
   //!@}
 #if 0
   void
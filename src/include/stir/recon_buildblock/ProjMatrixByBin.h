@@ -32,6 +32,7 @@
 #include "stir/recon_buildblock/DataSymmetriesForBins.h"
 #include "stir/shared_ptr.h"
 #include "stir/VectorWithOffset.h"
+#include "stir/Array.h"
 #include "stir/TimedObject.h"
 #include "stir/VoxelsOnCartesianGrid.h"
 #include "stir/numerics/FastErf.h"
@@ -74,11 +75,19 @@ class Bin;
   The 2nd option allows to cache the whole matrix. This results in the fastest
   behaviour IF your system does not start swapping. The default choice caches
   only the 'basic' bins, and computes symmetry related bins from the 'basic' ones.
+
+  \par TOF
+
+  For TOF data, get_proj_matrix_elems_for_one_bin() caches the rows of (basic) TOF bins, i.e.
+  after applying the TOF kernel. Alternatively, get_proj_matrix_elems_and_tof_kernel_for_one_bin()
+  can be used to get the geometric (i.e. non-TOF) row and the TOF kernel for all TOF bins in one call.
+  This caches the geometric row and the kernel values instead, which is faster and uses less
+  memory than caching the rows of all TOF bins.
 */
 class ProjMatrixByBin : public RegisteredObject<ProjMatrixByBin>, public TimedObject
 {
 public:
-  ~ProjMatrixByBin() override {}
+  ~ProjMatrixByBin() override;
 
   //! To be called before any calculation is performed
   /*! Note that get_proj_matrix_elems_for_one_bin() will expect objects of
@@ -109,6 +118,25 @@ public:
   calculate_proj_matrix_elems_for_one_bin.*/
   inline void get_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneBin&, const Bin&) const;
 
+  //! Get the geometric (i.e. non-TOF) row of the matrix, and the TOF kernel for all TOF bins
+  /*!
+    The timing position of \a bin is ignored. On return, \a probabilities contains the row
+    for \a bin as for non-TOF data, and <code>(*tof_kernel_sptr)[timing_pos_num][i]</code> is the value
+    of the TOF kernel for the \c i-th element of \a probabilities (in the order of the iterators).
+    The row for a TOF bin is therefore found by multiplying the value of every element with
+    the corresponding kernel value. The first index of the kernel runs over all TOF bins
+    of the projection data, its second index from 0 to <code>probabilities.size()-1</code>.
+
+    This is faster than calling get_proj_matrix_elems_for_one_bin() for every TOF bin,
+    as the geometric part is only computed (or copied from the cache) once. The kernel of
+    'basic' bins is cached as well (unless caching is disabled), and is shared with the cache.
+
+    If TOF is not enabled, the kernel has a single row (for \c timing_pos_num 0) filled with 1.
+  */
+  void get_proj_matrix_elems_and_tof_kernel_for_one_bin(ProjMatrixElemsForOneBin& probabilities,
+                                                        shared_ptr<const Array<2, float>>& tof_kernel_sptr,
+                                                        const Bin& bin) const;
+
 #if 0
   // TODO
   /*! \brief Facility to write the 'independent' part of the matrix to file.
@@ -138,6 +166,9 @@ public:
   // void reserve_num_elements_in_cache(const std::size_t);
   //! Remove all elements from the cache
   void clear_cache() const;
+  //! Get the memory (in bytes) used by the elements stored in the cache
+  /*! This does not include the overhead of the cache itself. The same amount is registered in MemoryUsage. */
+  std::size_t get_cache_size_in_bytes() const;
 
 protected:
   shared_ptr<DataSymmetriesForBins> symmetries_sptr;
@@ -210,6 +241,10 @@ private:
 
   //! collection of  ProjMatrixElemsForOneBin (internal cache )
   mutable VectorWithOffset<VectorWithOffset<MapProjMatrixElemsForOneBin>> cache_collection;
+  //! TOF kernels of basic bins, see get_proj_matrix_elems_and_tof_kernel_for_one_bin()
+  /*! Uses the same keys as the geometric rows, and the same locks as \c cache_collection */
+  typedef std::unordered_map<CacheKey, shared_ptr<const Array<2, float>>> MapTOFKernel;
+  mutable VectorWithOffset<VectorWithOffset<MapTOFKernel>> tof_kernel_cache_collection;
 #ifdef STIR_OPENMP
   mutable VectorWithOffset<VectorWithOffset<omp_lock_t>> cache_locks;
 #endif
@@ -217,6 +252,17 @@ private:
   //! create the key for caching
   // KT 15/05/2002 not static anymore as it uses cache_stores_only_basic_bins
   CacheKey cache_key(const Bin& bin) const;
+  //! create the key for caching the geometric part of a TOF bin (independent of its timing position)
+  CacheKey geometric_cache_key(const Bin& bin) const;
+
+  //! store data in the cache with the given key
+  void cache_proj_matrix_elems_for_one_bin(const ProjMatrixElemsForOneBin&, const CacheKey key) const;
+  //! get data from the cache with the given key
+  Succeeded get_cached_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneBin&, const CacheKey key) const;
+
+  //! Get the geometric (non-TOF) part of the row for a 'basic' bin, using the cache if possible
+  /*! The bin is obtained via the ProjMatrixElemsForOneBin::get_bin() method, and is not modified. */
+  inline void get_basic_geometric_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneBin& probabilities) const;
 
   //! Activates the application of the timing kernel to the LOR
   //! and performs initial set_up().
@@ -234,6 +280,11 @@ private:
   //! Get the interal value erf(m - v_j) - erf(m -v_j)
   inline float get_tof_value(const float d1, const float d2) const;
 
+  //! Compute the TOF kernel for all TOF bins for the row of a 'basic' bin
+  void compute_tof_kernel(Array<2, float>& tof_kernel, const ProjMatrixElemsForOneBin& basic_probabilities) const;
+  //! Get the TOF kernel for the row of a 'basic' bin, using the cache if possible
+  shared_ptr<const Array<2, float>> get_basic_tof_kernel(const ProjMatrixElemsForOneBin& basic_probabilities) const;
+
   //! erf map
   FastErf erf_interpolation;
 };
@@ -111,6 +111,25 @@ ProjMatrixByBin::get_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneBin& pro
   // stop_timers(); TODO, can't do this in a const member
 }
 
+void
+ProjMatrixByBin::get_basic_geometric_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneBin& probabilities) const
+{
+  const Bin basic_bin = probabilities.get_bin();
+  const CacheKey key = geometric_cache_key(basic_bin);
+  if (get_cached_proj_matrix_elems_for_one_bin(probabilities, key) == Succeeded::no)
+    {
+      // note: the geometric part does not depend on the timing position
+      calculate_proj_matrix_elems_for_one_bin(probabilities);
+#ifndef NDEBUG
+      probabilities.check_state();
+#endif
+      if (cache_stores_only_basic_bins)
+        cache_proj_matrix_elems_for_one_bin(probabilities, key);
+    }
+  // the cached data might have been computed for a different timing position
+  probabilities.set_bin(basic_bin);
+}
+
 void
 ProjMatrixByBin::apply_tof_kernel(ProjMatrixElemsForOneBin& probabilities) const
 {
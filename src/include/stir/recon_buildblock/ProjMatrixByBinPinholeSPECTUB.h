@@ -70,6 +70,9 @@ class Bin;
         mask from attenuation map := 0
 
         keep all views in cache := 0
+        ; if next variable is set to 1 (and all views are kept), all views are computed
+        ; (in parallel if OpenMP is enabled) by set_up()
+        precompute all views := 0
 
     End Projection Matrix By Bin Pinhole SPECT UB Parameters:=
 \endverbatim
@@ -201,6 +204,12 @@ public:
   bool get_keep_all_views_in_cache() const;
   void set_keep_all_views_in_cache(bool value = false);
 
+  //! Enable computing all views in set_up()
+  /*! Views are computed in parallel if OpenMP is enabled. This is only used when
+      keep_all_views_in_cache is \c true. */
+  bool get_precompute_all_views() const;
+  void set_precompute_all_views(bool value = true);
+
   ProjMatrixByBinPinholeSPECTUB* clone() const override;
 
 private:
@@ -221,6 +230,7 @@ private:
   std::string mask_file;
   bool mask_from_attenuation_map;
   bool keep_all_views_in_cache; //!< if set to false, only a single view is kept in memory
+  bool precompute_all_views;    //!< if set to true (and keep_all_views_in_cache), all views are computed by set_up()
 
   // explicitly list necessary members for image details (should use an Info object instead)
   CartesianCoordinate3D<float> voxel_size;
@@ -257,15 +267,30 @@ private:
   SPECTUB_mph::prj_mph_type prj; //!< structure with projection information
   SPECTUB_mph::bin_type bin;     //!< structure with bin information
 
-  // mutable to allow compute_one_subset() const function to change the fields
-  mutable SPECTUB_mph::psf2d_type psf_bin;  // structure for total psf distribution in bins (bidimensional)
-  mutable SPECTUB_mph::psf2d_type psf_subs; // structure for total psf distribution: mid resolution (bidimensional)
-  mutable SPECTUB_mph::psf2d_type
+  // sizes of the psf distributions. Their values are stored in local copies such that views can be computed in parallel.
+  SPECTUB_mph::psf2d_type psf_bin;  // structure for total psf distribution in bins (bidimensional)
+  SPECTUB_mph::psf2d_type psf_subs; // structure for total psf distribution: mid resolution (bidimensional)
+  SPECTUB_mph::psf2d_type
       psf_aux; // structure for total psf distribution: mid resolution auxiliar for convolution (bidimensional)
-  mutable SPECTUB_mph::psf2d_type kern; // structure for intrinsic psf distribution: mid resolution (bidimensional)
+  SPECTUB_mph::psf2d_type kern; // structure for intrinsic psf distribution: mid resolution (bidimensional)
 
+  //! compute (or estimate the number of) non-zero weights for one view
+  /*! This can be called by different threads for different views concurrently. */
+  void wm_calculation_for_one_subset(const bool do_calc, const int kOS, SPECTUB_mph::wm_da_type& wm_for_subset) const;
+  //! compute all weights for one view and store them in the cache
   void compute_one_subset(const int kOS) const;
   void delete_PinholeSPECTUB_arrays();
+
+  enum SubsetStatus
+  {
+    subset_not_computed,
+    subset_computed
+  };
+  mutable std::vector<SubsetStatus> subset_status;
+#ifdef STIR_OPENMP
+  //! one lock per view, held while checking its status and computing it (if keep_all_views_in_cache)
+  mutable std::vector<omp_lock_t> subset_locks;
+#endif
 };
 
 END_NAMESPACE_STIR
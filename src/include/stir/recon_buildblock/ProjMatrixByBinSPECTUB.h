@@ -71,9 +71,29 @@ http://dx.doi.org/10.1118/1.4816676
 
     ; if next variable is set to 0, only a single view is kept in memory
    keep all views in cache:=1
+    ; if next variable is set to 1 (and all views are kept), all views are computed
+    ; (in parallel if OpenMP is enabled) by set_up()
+   precompute all views:=0
+
+    ; if set, matrix rows are stored in (and read from) files in this directory (see below)
+   matrix cache directory:=
 
 End Projection Matrix By Bin SPECT UB Parameters:=
 \endverbatim
+
+  \par On-disk matrix cache
+
+  If a <tt>matrix cache directory</tt> is set, the rows of every view are written to a file in that
+  directory when they are computed, and read from that file when the same matrix is needed later
+  (e.g. in another reconstruction). The file names contain a hash of all parameters that
+  determine the matrix (image and projection data geometry, rotation radii, PSF parameters and the
+  mask), while the files contain the full description which is checked when reading.
+
+  For "simple" attenuation correction (or none), the files contain the geometric and PSF part of
+  the matrix only, and the attenuation factors are computed and applied when a view is read or
+  computed. This means that the files can be reused for different attenuation maps (as long as the
+  mask is the same). For "full" attenuation correction, attenuation cannot be separated, so
+  the files contain the complete matrix and a hash of the attenuation map is part of the key.
 */
 // using namespace SPECTUB;
 class ProjMatrixByBinSPECTUB : public RegisteredParsingObject<ProjMatrixByBinSPECTUB, ProjMatrixByBin, ProjMatrixByBin>
@@ -104,6 +124,25 @@ public:
     You have to call set_up() after this (unless the value didn't change).
   */
   void set_keep_all_views_in_cache(bool value = true);
+  bool get_precompute_all_views() const;
+  //! Enable computing all views in set_up()
+  /*!
+    Views are computed in parallel if OpenMP is enabled. Otherwise, views are computed when first
+    needed (different views can then still be computed by different threads concurrently).
+
+    This is only used when keep_all_views_in_cache is \c true.
+
+    You have to call set_up() after this (unless the value didn't change).
+  */
+  void set_precompute_all_views(bool value = true);
+  std::string get_matrix_cache_directory() const;
+  //! Set directory for the on-disk matrix cache
+  /*!
+    An empty string disables the on-disk cache. The directory has to exist.
+
+    You have to call set_up() after this (unless the value didn't change).
+  */
+  void set_matrix_cache_directory(const std::string& value);
   std::string get_attenuation_type() const;
   //! Set type of attenuation modelling
   /*! Has to be "no", "simple" or "full"
@@ -158,6 +197,8 @@ private:
   std::string mask_type;
   std::string mask_file;
   bool keep_all_views_in_cache; //!< if set to false, only a single view is kept in memory
+  bool precompute_all_views;    //!< if set to true (and keep_all_views_in_cache), all views are computed by set_up()
+  std::string matrix_cache_directory; //!< if not empty, directory for the on-disk matrix cache
 
   // explicitly list necessary members for image details (should use an Info object instead)
   CartesianCoordinate3D<float> voxel_size;
@@ -202,9 +243,32 @@ private:
 
   int maxszb;
 
+  //! compute all weights for one view and store them in the cache
+  /*! This can be called by different threads for different views concurrently. */
   void compute_one_subset(const int kOS, const float* Rrad) const;
   void delete_UB_SPECT_arrays();
-  mutable std::vector<bool> subset_already_processed;
+
+  //! description of all parameters that determine the matrix stored in the on-disk cache (set by set_up())
+  std::string matrix_cache_key;
+  //! if true, the on-disk cache contains the matrix without attenuation, and simple attenuation factors are applied afterwards
+  bool apply_attenuation_after_matrix_cache;
+  std::string get_matrix_cache_filename(const int kOS) const;
+  //! read the rows of one view from the on-disk cache, returns Succeeded::no if the file does not exist or is not compatible
+  Succeeded read_subset_from_matrix_cache(const int kOS, std::vector<ProjMatrixElemsForOneBin>& lors) const;
+  void write_subset_to_matrix_cache(const int kOS, const std::vector<ProjMatrixElemsForOneBin>& lors) const;
+  //! multiply the rows of one view with the simple attenuation factors
+  void apply_attenuation_factors(SPECTUB::wmh_type& wmh_for_subset, std::vector<ProjMatrixElemsForOneBin>& lors) const;
+
+  enum SubsetStatus
+  {
+    subset_not_computed,
+    subset_computed
+  };
+  mutable std::vector<SubsetStatus> subset_status;
+#ifdef STIR_OPENMP
+  //! one lock per view, held while checking its status and computing it (if keep_all_views_in_cache)
+  mutable std::vector<omp_lock_t> subset_locks;
+#endif
 };
 
 END_NAMESPACE_STIR
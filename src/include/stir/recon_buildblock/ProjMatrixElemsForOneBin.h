@@ -38,6 +38,10 @@ class Succeeded;
 class RelatedBins;
 template <int num_dimensions, typename elemT>
 class DiscretisedDensity;
+template <int num_dimensions, typename elemT>
+class Array;
+template <class T>
+class VectorWithOffset;
 
 /*!
 \brief This stores the non-zero projection matrix elements
@@ -188,6 +192,20 @@ public:
   //! forward project related bins (accumulates)
   void forward_project(RelatedBins&, const DiscretisedDensity<3, float>&) const;
 
+  //! back project all TOF bins of a LOR (accumulates)
+  /*! This object has to contain the geometric (non-TOF) row, and \a tof_kernel the corresponding
+      kernel, as returned by ProjMatrixByBin::get_proj_matrix_elems_and_tof_kernel_for_one_bin().
+      \a tof_values needs to have the same index range as \a tof_kernel.
+  */
+  void back_project(DiscretisedDensity<3, float>&,
+                    const VectorWithOffset<float>& tof_values,
+                    const Array<2, float>& tof_kernel) const;
+  //! forward project into all TOF bins of a LOR (accumulates)
+  /*! \see back_project(DiscretisedDensity<3, float>&, const VectorWithOffset<float>&, const Array<2, float>&) */
+  void forward_project(VectorWithOffset<float>& tof_values,
+                       const DiscretisedDensity<3, float>&,
+                       const Array<2, float>& tof_kernel) const;
+
 private:
   std::vector<value_type> elements;
   Bin bin;
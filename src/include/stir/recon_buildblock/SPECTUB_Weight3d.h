@@ -58,6 +58,23 @@ void wm_size_estimation(int kOS,
                         SPECTUB::wmh_type& wmh,
                         const float* Rrad);
 
+//! compute the simple attenuation correction factors for all voxels and the angles of one subset
+/*! This gives the same factors as used by wm_calculation() for simple attenuation correction.
+    \a att_factors has to be of size prj.NangOS * vol.Nvox and is indexed as
+    <tt>k * vol.Nvox + iv</tt>, with \c k the index of the angle in the subset (see \c wmh.index).
+    Voxels outside the mask get a factor 0.
+*/
+void calc_att_factors_simple(const SPECTUB::angle_type* const ang,
+                             SPECTUB::voxel_type vox,
+                             bin_type bin,
+                             const SPECTUB::volume_type& vol,
+                             const SPECTUB::proj_type& prj,
+                             const float* attmap,
+                             const bool* msk_3d,
+                             const bool* msk_2d,
+                             float* att_factors,
+                             SPECTUB::wmh_type& wmh);
+
 //... geometric component ............................................
 
 void calc_gauss(SPECTUB::discrf_type* gaussdens);
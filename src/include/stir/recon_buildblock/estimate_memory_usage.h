@@ -0,0 +1,59 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup recon_buildblock
+
+  \brief Declaration of stir::estimate_memory_usage and stir::write_memory_usage_estimate
+*/
+
+#ifndef __stir_recon_buildblock_estimate_memory_usage_H__
+#define __stir_recon_buildblock_estimate_memory_usage_H__
+
+#include "stir/common.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+START_NAMESPACE_STIR
+
+template <int num_dimensions, typename elemT>
+class DiscretisedDensity;
+template <typename TargetT>
+class IterativeReconstruction;
+
+//! List of items and their estimated memory usage (in bytes)
+typedef std::vector<std::pair<std::string, std::size_t>> MemoryUsageEstimate;
+
+/*!
+  \brief Estimate the memory needed by an iterative image reconstruction
+  \ingroup recon_buildblock
+
+  The reconstruction object needs to have been initialised (e.g. from a parameter file),
+  but set_up() does not need to be called. The estimate takes into account the size of the
+  image, the number of subsets (for subset sensitivities), \a num_threads (for the per-thread
+  images used by the back projectors and list-mode computations), projection data stored in
+  memory (ProjDataInMemory) and the list-mode event cache.
+
+  Not included are the cache of the projection matrix (which depends on the projector and is
+  filled during the reconstruction), temporary projection data and the memory used by priors.
+  The estimate is therefore a lower bound.
+*/
+MemoryUsageEstimate estimate_memory_usage(const IterativeReconstruction<DiscretisedDensity<3, float>>& reconstruction,
+                                          const int num_threads);
+
+//! Write the estimate as a table (in MB), including the total
+/*! \ingroup recon_buildblock */
+void write_memory_usage_estimate(std::ostream& s, const MemoryUsageEstimate& estimate);
+
+END_NAMESPACE_STIR
+
+#endif
@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup recon_buildblock
+  \brief Declaration of fused element-wise kernels used for image updates in iterative algorithms
+
+  These functions combine operations that used to be performed as separate passes
+  over the image (division, thresholding, computation of minimum and maximum for
+  logging, etc.) into a single pass. When the image data are stored contiguously
+  (as is the case for normal DiscretisedDensity objects), the pass is parallelised
+  with OpenMP (if enabled) and written such that the compiler can vectorise the inner loop.
+  Otherwise (e.g. for parametric images), a serial loop over the full iterators is used.
+
+  All functions returning a <code>std::pair<float,float></code> return the minimum and maximum
+  (in that order) of the values indicated in their documentation.
+*/
+
+#ifndef __stir_recon_buildblock_image_update_kernels_H__
+#define __stir_recon_buildblock_image_update_kernels_H__
+
+#include "stir/common.h"
+#include <utility>
+
+START_NAMESPACE_STIR
+
+//! Computes the denominator of the MAP-OSL update from the prior gradient
+/*!
+  \ingroup recon_buildblock
+  On input, \a denominator has to contain the gradient of the prior. On output, it contains
+  - for the additive model: <tt>max(min(g/num_subsets + s, 10*s), s/10)</tt>
+  - for the multiplicative model: <tt>max(min(1 + g, 10), 1/10) * s</tt>
+
+  with \c g the prior gradient and \c s the subset sensitivity.
+*/
+template <class TargetT>
+void compute_MAP_OSL_denominator(TargetT& denominator,
+                                 const TargetT& sensitivity,
+                                 const int num_subsets,
+                                 const bool multiplicative_model);
+
+//! Divides \a numerator by \a denominator and thresholds the result, in a single pass
+/*!
+  \ingroup recon_buildblock
+  The division follows the same conventions as stir::divide, i.e. when both numerator and denominator
+  are smaller than <tt>small_num*max(numerator)</tt> (in absolute value), the result is set to 0.
+  (When \a small_num is 0, the maximum of the numerator is not computed.)
+
+  After division, the result is thresholded to [\a new_min, \a new_max].
+
+  \return minimum and maximum of the result of the division <i>before</i> thresholding.
+*/
+template <class TargetT>
+std::pair<float, float> divide_and_threshold_update(
+    TargetT& numerator, const TargetT& denominator, const float small_num, const float new_min, const float new_max);
+
+//! Multiplies \a image with \a factor (element-wise)
+/*! \ingroup recon_buildblock */
+template <class TargetT>
+void multiply_in_place(TargetT& image, const TargetT& factor);
+
+//! Multiplies \a image with the scalar \a factor
+/*!
+  \ingroup recon_buildblock
+  \return minimum and maximum of the result
+*/
+template <class TargetT>
+std::pair<float, float> scale_in_place(TargetT& image, const float factor);
+
+//! Sets \a numerator to <tt>numerator/denominator*factor</tt>
+/*!
+  \ingroup recon_buildblock
+  No check on division by zero is performed.
+  \return minimum and maximum of the result
+*/
+template <class TargetT>
+std::pair<float, float> divide_and_scale(TargetT& numerator, const TargetT& denominator, const float factor);
+
+//! Adds \a update to \a image and thresholds the result to [\a new_min, \a new_max]
+/*!
+  \ingroup recon_buildblock
+  \return minimum and maximum of the sum <i>before</i> thresholding
+*/
+template <class TargetT>
+std::pair<float, float> add_and_threshold(TargetT& image, const TargetT& update, const float new_min, const float new_max);
+
+END_NAMESPACE_STIR
+
+#endif
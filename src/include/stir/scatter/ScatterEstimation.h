@@ -327,6 +327,11 @@ private:
   //! variable storing the mask image
   shared_ptr<const DiscretisedDensity<3, float>> mask_image_sptr;
 
+  //! variable to check if the reconstruction object has been set up
+  /*! The reconstruction is only set up once, such that the sensitivity and projectors are
+      reused in all scatter iterations. */
+  bool reconstruction_already_set_up;
+
   //! \brief set_up iterative reconstruction
   Succeeded set_up_iterative(shared_ptr<IterativeReconstruction<DiscretisedDensity<3, float>>> arg);
 
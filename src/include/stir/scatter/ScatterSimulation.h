@@ -126,6 +126,12 @@ public:
 
   void set_template_proj_data_info(const ProjDataInfo&);
 
+  //! Set the activity image
+  /*! This removes the cached line integrals over the activity image. If the simulation was already set up and the
+      new image has the same characteristics as the previous one, the simulation stays set up, such that
+      set_up() does not need to be called again (keeping the cached line integrals over the attenuation image).
+      This is useful when the activity image is updated in place (e.g. in ScatterEstimation).
+  */
   void set_activity_image_sptr(const shared_ptr<const DiscretisedDensity<3, float>>);
 
   void set_activity_image(const std::string& filename);
@@ -232,6 +238,9 @@ public:
 
   virtual Succeeded set_up();
 
+  //! Return if set_up() was called, and no relevant parameters changed since then
+  bool already_set_up() const;
+
   //! Output the log of the process.
   virtual void write_log(const double simulation_time, const float total_scatter);
 
@@ -24,14 +24,21 @@
 #include "stir/numerics/BSplinesRegularGrid.h"
 #include "stir/RegisteredParsingObject.h"
 #include "stir/Succeeded.h"
+#include "stir/shared_ptr.h"
 #include <fstream>
 #include <iostream>
 
 START_NAMESPACE_STIR
 
+class PrecomputedWarpOperator;
+
 //! Class for spatial transformations for gated images
 /*!
  \ingroup spatial_transformation
+
+ The warping functions use a PrecomputedWarpOperator for every gate. These are computed
+ from the motion fields the first time they are needed, and reused afterwards (until the
+ motion fields are changed). The warps use linear interpolation.
 */
 class GatedSpatialTransformation : public RegisteredParsingObject<GatedSpatialTransformation, SpatialTransformation>
 {
@@ -65,6 +72,10 @@ public:
   void warp_image(DiscretisedDensity<3, float>& new_reference_image, const GatedDiscretisedDensity& gated_image) const;
   void warp_image(GatedDiscretisedDensity& gated_image, const DiscretisedDensity<3, float>& reference_image) const;
   void accumulate_warp_image(DiscretisedDensity<3, float>& new_reference_image, const GatedDiscretisedDensity& gated_image) const;
+  //! sets \a new_reference_image to the sum over gates of the transpose of the warp applied to \a gated_image
+  void warp_image_transpose(DiscretisedDensity<3, float>& new_reference_image, const GatedDiscretisedDensity& gated_image) const;
+  void accumulate_warp_image_transpose(DiscretisedDensity<3, float>& new_reference_image,
+                                       const GatedDiscretisedDensity& gated_image) const;
   void set_defaults() override;
   Succeeded set_up() override;
   //@}
@@ -81,6 +92,11 @@ private:
   BSpline::BSplineType _spline_type;
   std::string _time_gate_definition_filename;
   TimeGateDefinitions _gate_defs;
+
+  //! warp operators for every gate (index 1 corresponds to the first gate), computed on first use
+  mutable std::vector<shared_ptr<const PrecomputedWarpOperator>> _warp_operators;
+  //! computes _warp_operators if necessary
+  void set_up_warp_operators() const;
 };
 
 END_NAMESPACE_STIR
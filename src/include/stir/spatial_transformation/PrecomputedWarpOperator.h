@@ -0,0 +1,105 @@
+//
+/*
+ Copyright (C) 2026, University College London
+ This file is part of STIR.
+
+ SPDX-License-Identifier: Apache-2.0
+
+ See STIR/LICENSE.txt for details
+ */
+/*!
+ \file
+ \ingroup spatial_transformation
+
+ \brief Declaration of class stir::PrecomputedWarpOperator
+*/
+
+#ifndef __stir_spatial_transformation_PrecomputedWarpOperator_H__
+#define __stir_spatial_transformation_PrecomputedWarpOperator_H__
+
+#include "stir/DiscretisedDensity.h"
+#include "stir/BasicCoordinate.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+START_NAMESPACE_STIR
+
+//! A warp of an image with a motion field, stored as a sparse matrix
+/*!
+ \ingroup spatial_transformation
+
+ This class computes the interpolation weights and indices for warping an image
+ with a given motion field once, such that the warp can be applied (and its transpose)
+ to many images without recomputing the interpolation.
+
+ The result of apply() is identical (up to floating point rounding) to
+ stir::warp_image() with <code>BSpline::linear</code>, i.e. tri-linear interpolation
+ at the position <code>c + motion(c)/grid_spacing</code>, where \c c is the voxel index.
+ As in stir::warp_image(), voxels for which this position is on or outside
+ the border of the image are set to 0.
+
+ The transpose is precomputed as well (in compressed sparse row format), such that both
+ apply() and apply_transpose() are parallelised over the output voxels with OpenMP (if enabled)
+ without need for any synchronisation.
+
+ Indices are stored as 32-bit integers to reduce memory usage (about 130 bytes per voxel in total).
+ The constructor calls error() if the image is too large for this.
+
+ \warning All images (motion fields, input and output) need to have the same (regular) index range.
+*/
+class PrecomputedWarpOperator
+{
+public:
+  //! Compute the interpolation weights from the motion field (in mm)
+  PrecomputedWarpOperator(const DiscretisedDensity<3, float>& motion_x,
+                          const DiscretisedDensity<3, float>& motion_y,
+                          const DiscretisedDensity<3, float>& motion_z);
+
+  //! Warp \a in_density, overwriting \a out_density
+  void apply(DiscretisedDensity<3, float>& out_density, const DiscretisedDensity<3, float>& in_density) const;
+  //! Warp \a in_density and add the result to \a out_density
+  void accumulate_apply(DiscretisedDensity<3, float>& out_density, const DiscretisedDensity<3, float>& in_density) const;
+
+  //! Apply the transpose of the warp to \a in_density, overwriting \a out_density
+  void apply_transpose(DiscretisedDensity<3, float>& out_density, const DiscretisedDensity<3, float>& in_density) const;
+  //! Apply the transpose of the warp to \a in_density and add the result to \a out_density
+  void accumulate_apply_transpose(DiscretisedDensity<3, float>& out_density,
+                                  const DiscretisedDensity<3, float>& in_density) const;
+
+  //! Number of non-zero weights in the sparse matrix
+  std::size_t get_num_non_zeros() const { return transpose_indices.size(); }
+
+private:
+  //! number of (non-zero) weights per output voxel for tri-linear interpolation
+  static const int num_weights_per_voxel = 8;
+  //! type used to store indices in the sparse matrices
+  typedef std::int32_t index_type;
+
+  BasicCoordinate<3, int> min_index;
+  BasicCoordinate<3, int> max_index;
+  std::ptrdiff_t num_voxels;
+
+  //! indices (in the contiguous image) of the input voxels for each output voxel (num_weights_per_voxel per voxel)
+  std::vector<index_type> indices;
+  //! corresponding weights
+  std::vector<float> weights;
+
+  //! \name transposed matrix in compressed sparse row format
+  //@{
+  std::vector<index_type> transpose_row_start;
+  std::vector<index_type> transpose_indices;
+  std::vector<float> transpose_weights;
+  //@}
+
+  void check(const DiscretisedDensity<3, float>& density) const;
+
+  void apply_helper(DiscretisedDensity<3, float>& out_density,
+                    const DiscretisedDensity<3, float>& in_density,
+                    const bool accumulate,
+                    const bool transpose) const;
+};
+
+END_NAMESPACE_STIR
+
+#endif
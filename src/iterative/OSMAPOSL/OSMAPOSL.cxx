@@ -14,6 +14,14 @@
   \ingroup main_programs
   \brief main() for OSMAPOSLReconstruction
 
+  \par Usage
+  \verbatim
+  OSMAPOSL [--dry-run] [par_file]
+  \endverbatim
+  With \c --dry-run, the parameter file is parsed and an estimate of the memory needed
+  by the reconstruction is written, without running the reconstruction.
+  See stir::estimate_memory_usage().
+
   \author Matthew Jacobson
   \author Kris Thielemans
   \author PARAPET project
@@ -25,6 +33,9 @@
 #include "stir/CPUTimer.h"
 #include "stir/HighResWallClockTimer.h"
 #include "stir/recon_buildblock/distributable_main.h"
+#include "stir/recon_buildblock/estimate_memory_usage.h"
+#include "stir/num_threads.h"
+#include <cstring>
 #include <iostream>
 using std::cerr;
 using std::cout;
@@ -45,8 +56,21 @@ main(int argc, char** argv)
   t.reset();
   t.start();
 
+  const bool dry_run = argc > 1 && strcmp(argv[1], "--dry-run") == 0;
+  if (dry_run)
+    {
+      --argc;
+      ++argv;
+    }
+
   OSMAPOSLReconstruction<DiscretisedDensity<3, float>> reconstruction_object(argc > 1 ? argv[1] : "");
 
+  if (dry_run)
+    {
+      write_memory_usage_estimate(cout, estimate_memory_usage(reconstruction_object, get_default_num_threads()));
+      return EXIT_SUCCESS;
+    }
+
   // return reconstruction_object.reconstruct() == Succeeded::yes ?
   //     EXIT_SUCCESS : EXIT_FAILURE;
   if (reconstruction_object.reconstruct() == Succeeded::yes)
@@ -34,7 +34,7 @@
 #include "stir/ThresholdMinToSmallPositiveValueDataProcessor.h"
 #include "stir/ChainedDataProcessor.h"
 #include "stir/Succeeded.h"
-#include "stir/numerics/divide.h"
+#include "stir/recon_buildblock/image_update_kernels.h"
 #include "stir/thresholding.h"
 #include "stir/is_null_ptr.h"
 #include "stir/NumericInfo.h"
@@ -55,6 +55,7 @@
 
 #include "stir/unique_ptr.h"
 #include <algorithm>
+#include <limits>
 using std::min;
 using std::max;
 using std::cerr;
@@ -331,6 +332,11 @@ OSMAPOSLReconstruction<TargetT>::set_up(shared_ptr<TargetT> const& target_image_
 
   // initialise mutliplicative update to zeros
   multiplicative_update_image_ptr = unique_ptr<TargetT>(target_image_ptr->get_empty_copy());
+  // work image for the MAP-OSL denominator, reused across subiterations
+  if (this->objective_function_sptr->prior_is_zero())
+    denominator_ptr.reset();
+  else
+    denominator_ptr = unique_ptr<TargetT>(target_image_ptr->get_empty_copy());
 
   return Succeeded::yes;
 }
@@ -357,15 +363,7 @@ OSMAPOSLReconstruction<TargetT>::apply_multiplicative_update(TargetT& current_im
                                                              const TargetT& multiplicative_update_image)
 {
   this->check(current_image_estimate);
-  typename TargetT::const_full_iterator multiplicative_update_image_iter = multiplicative_update_image.begin_all_const();
-  const typename TargetT::const_full_iterator end_multiplicative_update_image_iter = multiplicative_update_image.end_all_const();
-  typename TargetT::full_iterator current_image_estimate_iter = current_image_estimate.begin_all();
-  while (multiplicative_update_image_iter != end_multiplicative_update_image_iter)
-    {
-      *current_image_estimate_iter *= (*multiplicative_update_image_iter);
-      ++current_image_estimate_iter;
-      ++multiplicative_update_image_iter;
-    }
+  multiply_in_place(current_image_estimate, multiplicative_update_image);
 }
 
 template <typename TargetT>
@@ -391,76 +389,53 @@ OSMAPOSLReconstruction<TargetT>::update_estimate(TargetT& current_image_estimate
   this->compute_sub_gradient_without_penalty_plus_sensitivity(
       *multiplicative_update_image_ptr, current_image_estimate, subset_num);
 
+  // the update is only thresholded from the 2nd subiteration onwards
+  const bool threshold_update = this->subiteration_num != 1;
+  // thresholding is done in the same pass as the division, unless we need to write the update image
+  const bool fuse_threshold = threshold_update && !(this->write_update_image && !this->_disable_output);
+  const float fused_min
+      = fuse_threshold ? static_cast<float>(this->minimum_relative_change) : std::numeric_limits<float>::lowest();
+  const float fused_max = fuse_threshold ? static_cast<float>(this->maximum_relative_change) : std::numeric_limits<float>::max();
+  std::pair<float, float> update_min_max;
+
   // divide by subset sensitivity
   {
     const TargetT& sensitivity = this->get_subset_sensitivity(subset_num);
 
     int count = 0;
 
-    // std::cerr <<this->MAP_model << std::endl;
-
     if (this->objective_function_sptr->prior_is_zero())
       {
-        divide(multiplicative_update_image_ptr->begin_all(),
-               multiplicative_update_image_ptr->end_all(),
-               sensitivity.begin_all(),
-               0.F); // no need to find a threshold for division by sensitivity
+        // no need to find a threshold for division by sensitivity
+        update_min_max = divide_and_threshold_update(*multiplicative_update_image_ptr, sensitivity, 0.F, fused_min, fused_max);
       }
     else
       {
-        unique_ptr<TargetT> denominator_ptr(current_image_estimate.get_empty_copy());
+        if (is_null_ptr(denominator_ptr) || !denominator_ptr->has_same_characteristics(current_image_estimate))
+          denominator_ptr = unique_ptr<TargetT>(current_image_estimate.get_empty_copy());
+        else
+          std::fill(denominator_ptr->begin_all(), denominator_ptr->end_all(), 0.F);
 
         this->objective_function_sptr->get_prior_ptr()->compute_gradient(*denominator_ptr, current_image_estimate);
 
-        typename TargetT::full_iterator denominator_iter = denominator_ptr->begin_all();
-        const typename TargetT::full_iterator denominator_end = denominator_ptr->end_all();
-        typename TargetT::const_full_iterator sensitivity_iter = sensitivity.begin_all();
-
-        if (this->MAP_model == "additive")
-          {
-            // lambda_new = lambda / (p_v + beta*prior_gradient/ num_subsets) *
-            //                   sum_subset backproj(measured/forwproj(lambda))
-            // with p_v = sum_{b in subset} p_bv
-            // actually, we restrict 1 + beta*prior_gradient/num_subsets/p_v between .1 and 10
-            while (denominator_iter != denominator_end)
-              {
-                *denominator_iter = *denominator_iter / this->get_num_subsets() + (*sensitivity_iter);
-                // bound denominator between (*sensitivity_iter)/10 and (*sensitivity_iter)*10
-                *denominator_iter = std::max(std::min(*denominator_iter, (*sensitivity_iter) * 10), (*sensitivity_iter) / 10);
-                ++denominator_iter;
-                ++sensitivity_iter;
-              }
-          }
-        else
-          {
-            if (this->MAP_model == "multiplicative")
-              {
-                // multiplicative form
-                // lambda_new = lambda / (p_v*(1 + beta*prior_gradient)) *
-                //                   sum_subset backproj(measured/forwproj(lambda))
-                // with p_v = sum_{b in subset} p_bv
-                // actually, we restrict 1 + beta*prior_gradient between .1 and 10
-                while (denominator_iter != denominator_end)
-                  {
-                    *denominator_iter += 1;
-                    // bound denominator between 1/10 and 1*10
-                    // TODO code will fail if *denominator_iter is not a float
-                    *denominator_iter = std::max(std::min(*denominator_iter, 10.F), 1 / 10.F);
-                    *denominator_iter *= (*sensitivity_iter);
-                    ++denominator_iter;
-                    ++sensitivity_iter;
-                  }
-              }
-          }
+        // additive form:
+        // lambda_new = lambda / (p_v + beta*prior_gradient/ num_subsets) *
+        //                   sum_subset backproj(measured/forwproj(lambda))
+        // with p_v = sum_{b in subset} p_bv
+        // actually, we restrict 1 + beta*prior_gradient/num_subsets/p_v between .1 and 10
+        // multiplicative form:
+        // lambda_new = lambda / (p_v*(1 + beta*prior_gradient)) *
+        //                   sum_subset backproj(measured/forwproj(lambda))
+        // with p_v = sum_{b in subset} p_bv
+        // actually, we restrict 1 + beta*prior_gradient between .1 and 10
+        compute_MAP_OSL_denominator(*denominator_ptr, sensitivity, this->get_num_subsets(), this->MAP_model == "multiplicative");
 
         // do the division
         // TODO: The thresholding implied in "divide" potentially fails with parametric images
         // as the different parametric images can have very different scales.
         // See https://github.com/UCL/STIR/issues/906
-        divide(multiplicative_update_image_ptr->begin_all(),
-               multiplicative_update_image_ptr->end_all(),
-               denominator_ptr->begin_all(),
-               small_num);
+        update_min_max
+            = divide_and_threshold_update(*multiplicative_update_image_ptr, *denominator_ptr, small_num, fused_min, fused_max);
       }
 
     info(boost::format("Number of (cancelled) singularities in Sensitivity division: %1%") % count);
@@ -487,19 +462,18 @@ OSMAPOSLReconstruction<TargetT>::update_estimate(TargetT& current_image_estimate
       delete[] fname;
     }
 
-  if (this->subiteration_num != 1)
+  if (threshold_update)
     {
-      const float current_min
-          = *std::min_element(multiplicative_update_image_ptr->begin_all(), multiplicative_update_image_ptr->end_all());
-      const float current_max
-          = *std::max_element(multiplicative_update_image_ptr->begin_all(), multiplicative_update_image_ptr->end_all());
+      const float current_min = update_min_max.first;
+      const float current_max = update_min_max.second;
       const float new_min = static_cast<float>(this->minimum_relative_change);
       const float new_max = static_cast<float>(this->maximum_relative_change);
       info(boost::format("Update image old min,max: %1%, %2%, new min,max %3%, %4%") % current_min % current_max
            % (min(current_min, new_min)) % (max(current_max, new_max)));
 
-      threshold_upper_lower(
-          multiplicative_update_image_ptr->begin_all(), multiplicative_update_image_ptr->end_all(), new_min, new_max);
+      if (!fuse_threshold)
+        threshold_upper_lower(
+            multiplicative_update_image_ptr->begin_all(), multiplicative_update_image_ptr->end_all(), new_min, new_max);
     }
 
   // current_image_estimate *= *multiplicative_update_image_ptr;
@@ -13,6 +13,12 @@
   \ingroup OSSPS
   \brief main() for stir::OSSPSReconstruction
 
+  \par Usage
+  \verbatim
+  OSSPS [--dry-run] [par_file]
+  \endverbatim
+  With \c --dry-run, only an estimate of the memory needed is written (see stir::estimate_memory_usage()).
+
   \author Sanida Mustafovic
   \author Kris Thielemans
 
@@ -21,6 +27,10 @@
 #include "stir/DiscretisedDensity.h"
 #include "stir/Succeeded.h"
 #include "stir/recon_buildblock/distributable_main.h"
+#include "stir/recon_buildblock/estimate_memory_usage.h"
+#include "stir/num_threads.h"
+#include <cstring>
+#include <iostream>
 
 USING_NAMESPACE_STIR
 
@@ -33,7 +43,20 @@ main(int argc, char** argv)
 #endif
 {
 
+  const bool dry_run = argc > 1 && strcmp(argv[1], "--dry-run") == 0;
+  if (dry_run)
+    {
+      --argc;
+      ++argv;
+    }
+
   OSSPSReconstruction<DiscretisedDensity<3, float>> reconstruction_object(argc > 1 ? argv[1] : "");
 
+  if (dry_run)
+    {
+      write_memory_usage_estimate(std::cout, estimate_memory_usage(reconstruction_object, get_default_num_threads()));
+      return EXIT_SUCCESS;
+    }
+
   return reconstruction_object.reconstruct() == Succeeded::yes ? EXIT_SUCCESS : EXIT_FAILURE;
 }
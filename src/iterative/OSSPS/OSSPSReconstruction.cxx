@@ -26,6 +26,7 @@
 #include "stir/Succeeded.h"
 #include "stir/recon_array_functions.h"
 #include "stir/thresholding.h"
+#include "stir/recon_buildblock/image_update_kernels.h"
 #include "stir/is_null_ptr.h"
 #include "stir/NumericInfo.h"
 #include "stir/utilities.h"
@@ -306,23 +307,27 @@ OSSPSReconstruction<TargetT>::update_estimate(TargetT& current_image_estimate)
   const int subset_num = this->get_subset_num();
   info(boost::format("Now processing subset #: %1%") % subset_num);
 
-  // TODO make member or static parameter to avoid reallocation all the time
-  unique_ptr<TargetT> numerator_ptr(current_image_estimate.get_empty_copy());
+  // reuse the numerator image across subiterations
+  if (is_null_ptr(numerator_ptr) || !numerator_ptr->has_same_characteristics(current_image_estimate))
+    numerator_ptr = unique_ptr<TargetT>(current_image_estimate.get_empty_copy());
 
   this->objective_function_sptr->compute_sub_gradient(*numerator_ptr, current_image_estimate, subset_num);
   //*numerator_ptr *= this->num_subsets;
-  std::transform(numerator_ptr->begin_all(), numerator_ptr->end_all(), numerator_ptr->begin_all(), _1 * this->num_subsets);
+  {
+    const std::pair<float, float> min_max = scale_in_place(*numerator_ptr, static_cast<float>(this->num_subsets));
 
-  info(boost::format("num subsets %1%") % this->num_subsets);
-  info(boost::format("this->num_subsets*subgradient : max %1%, min %2%")
-       % *std::max_element(numerator_ptr->begin_all(), numerator_ptr->end_all())
-       % *std::min_element(numerator_ptr->begin_all(), numerator_ptr->end_all()));
+    info(boost::format("num subsets %1%") % this->num_subsets);
+    info(boost::format("this->num_subsets*subgradient : max %1%, min %2%") % min_max.second % min_max.first);
+  }
 
   // now divide by denominator
 
   if (recompute_penalty_term_in_denominator || (this->get_subiteration_num() == this->get_start_subiteration_num()))
     {
-      unique_ptr<TargetT> work_image_ptr(current_image_estimate.get_empty_copy());
+      if (is_null_ptr(work_image_ptr) || !work_image_ptr->has_same_characteristics(current_image_estimate))
+        work_image_ptr = unique_ptr<TargetT>(current_image_estimate.get_empty_copy());
+      else
+        std::fill(work_image_ptr->begin_all(), work_image_ptr->end_all(), 0.F);
 
       // avoid work (or crash) when penalty is 0
       if (!this->objective_function_sptr->prior_is_zero())
@@ -352,20 +357,6 @@ OSSPSReconstruction<TargetT>::update_estimate(TargetT& current_image_estimate)
           // store for future use
           *precomputed_denominator_ptr = *work_image_ptr;
         }
-
-      //*numerator_ptr /= *work_image_ptr;
-      std::transform(
-          numerator_ptr->begin_all(), numerator_ptr->end_all(), work_image_ptr->begin_all(), numerator_ptr->begin_all(), _1 / _2);
-    }
-  else
-    {
-      // we have computed the denominator already
-      //*numerator_ptr /= *precomputed_denominator_ptr;
-      std::transform(numerator_ptr->begin_all(),
-                     numerator_ptr->end_all(),
-                     precomputed_denominator_ptr->begin_all(),
-                     numerator_ptr->begin_all(),
-                     _1 / _2);
     }
 
   // relaxation_parameter ~1/(1+n) where n is iteration number
@@ -375,9 +366,11 @@ OSSPSReconstruction<TargetT>::update_estimate(TargetT& current_image_estimate)
   info(boost::format("relaxation parameter = %1%") % relaxation_parameter);
 
   const float alpha = 1.F; //  line_search(current_image_estimate, *numerator_ptr);
-  // *numerator_ptr *= relaxation_parameter * alpha;
-  std::transform(
-      numerator_ptr->begin_all(), numerator_ptr->end_all(), numerator_ptr->begin_all(), _1 * relaxation_parameter * alpha);
+  //*numerator_ptr /= denominator; *numerator_ptr *= relaxation_parameter * alpha;
+  const std::pair<float, float> update_min_max
+      = divide_and_scale(*numerator_ptr,
+                         recompute_penalty_term_in_denominator ? *work_image_ptr : *precomputed_denominator_ptr,
+                         relaxation_parameter * alpha);
 
   if (write_update_image)
     {
@@ -386,23 +379,17 @@ OSSPSReconstruction<TargetT>::update_estimate(TargetT& current_image_estimate)
       this->output_file_format_ptr->write_to_file(fname, *numerator_ptr);
     }
 
-  {
-    info(boost::format("additive update image min,max: %1%, %2%")
-         % *std::min_element(numerator_ptr->begin_all(), numerator_ptr->end_all())
-         % *std::max_element(numerator_ptr->begin_all(), numerator_ptr->end_all()));
-  }
-  current_image_estimate += *numerator_ptr;
+  info(boost::format("additive update image min,max: %1%, %2%") % update_min_max.first % update_min_max.second);
 
-  // now threshold image
+  // current_image_estimate += *numerator_ptr, and threshold image
   {
-    const float current_min = *std::min_element(current_image_estimate.begin_all(), current_image_estimate.end_all());
-    const float current_max = *std::max_element(current_image_estimate.begin_all(), current_image_estimate.end_all());
     const float new_min = 0.F;
     const float new_max = static_cast<float>(upper_bound);
+    const std::pair<float, float> min_max = add_and_threshold(current_image_estimate, *numerator_ptr, new_min, new_max);
+    const float current_min = min_max.first;
+    const float current_max = min_max.second;
     info(boost::format("current image old min,max: %1%, %2%, new min,max %3%, %4%") % current_min % current_max
          % std::max(current_min, new_min) % std::min(current_max, new_max));
-
-    threshold_upper_lower(current_image_estimate.begin_all(), current_image_estimate.end_all(), new_min, new_max);
   }
 
 #ifndef PARALLEL
@@ -51,6 +51,12 @@ CListModeDataECAT8_32bit::get_name() const
   return listmode_filename;
 }
 
+std::string
+CListModeDataECAT8_32bit::get_data_filename() const
+{
+  return data_filename;
+}
+
 shared_ptr<CListRecord>
 CListModeDataECAT8_32bit::get_empty_record_sptr() const
 {
@@ -70,6 +76,7 @@ CListModeDataECAT8_32bit::open_lm_file()
   strcpy(full_data_file_name, filename.c_str());
   prepend_directory_name(full_data_file_name, directory_name);
   filename = std::string(full_data_file_name);
+  this->data_filename = filename;
 
   info(boost::format("CListModeDataECAT8_32bit: opening file %1%") % filename);
   shared_ptr<std::istream> stream_ptr(new std::fstream(filename.c_str(), std::ios::in | std::ios::binary));
@@ -109,5 +116,18 @@ CListModeDataECAT8_32bit::set_get_position(const CListModeDataECAT8_32bit::Saved
   return current_lm_data_ptr->set_get_position(pos);
 }
 
+std::vector<std::streampos>
+CListModeDataECAT8_32bit::get_saved_get_positions() const
+{
+  return current_lm_data_ptr->get_saved_get_positions();
+}
+
+Succeeded
+CListModeDataECAT8_32bit::set_saved_get_positions(const std::vector<std::streampos>& positions)
+{
+  current_lm_data_ptr->set_saved_get_positions(positions);
+  return Succeeded::yes;
+}
+
 } // namespace ecat
 END_NAMESPACE_STIR
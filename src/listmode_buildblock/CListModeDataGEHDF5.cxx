@@ -120,6 +120,19 @@ CListModeDataGEHDF5::set_get_position(const CListModeDataGEHDF5::SavedPosition&
   return current_lm_data_ptr->set_get_position(pos);
 }
 
+std::vector<std::streampos>
+CListModeDataGEHDF5::get_saved_get_positions() const
+{
+  return current_lm_data_ptr->get_saved_get_positions();
+}
+
+Succeeded
+CListModeDataGEHDF5::set_saved_get_positions(const std::vector<std::streampos>& positions)
+{
+  current_lm_data_ptr->set_saved_get_positions(positions);
+  return Succeeded::yes;
+}
+
 } // namespace RDF_HDF5
 } // namespace GE
 END_NAMESPACE_STIR
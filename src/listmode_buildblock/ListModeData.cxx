@@ -20,6 +20,7 @@
 #include "stir/listmode/ListModeData.h"
 #include "stir/ExamInfo.h"
 #include "stir/is_null_ptr.h"
+#include "stir/Succeeded.h"
 #include "stir/error.h"
 
 START_NAMESPACE_STIR
@@ -53,6 +54,24 @@ ListModeData::get_proj_data_info_sptr() const
   return proj_data_info_sptr;
 }
 
+std::string
+ListModeData::get_data_filename() const
+{
+  return std::string();
+}
+
+std::vector<std::streampos>
+ListModeData::get_saved_get_positions() const
+{
+  return std::vector<std::streampos>();
+}
+
+Succeeded
+ListModeData::set_saved_get_positions(const std::vector<std::streampos>&)
+{
+  return Succeeded::no;
+}
+
 #if 0
 std::time_t
 ListModeData::
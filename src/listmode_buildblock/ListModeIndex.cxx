@@ -0,0 +1,296 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup listmode
+  \brief Implementation of class stir::ListModeIndex
+*/
+
+#include "stir/listmode/ListModeIndex.h"
+#include "stir/listmode/ListRecord.h"
+#include "stir/Succeeded.h"
+#include "stir/info.h"
+#include "stir/warning.h"
+#include "stir/error.h"
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#if defined(__OS_WIN__)
+#  include <sys/types.h> // required for stat.h
+#endif
+#include <sys/stat.h>
+
+START_NAMESPACE_STIR
+
+static const char* const index_file_signature = "STIR list mode index";
+
+ListModeIndex::ListModeIndex()
+    : interval_in_secs(0.),
+      positions_available(false),
+      lm_data_file_size(-1),
+      lm_data_file_modification_time(0)
+{}
+
+ListModeIndex::ListModeIndex(ListModeData& lm_data, const double interval_in_secs_v)
+    : interval_in_secs(interval_in_secs_v),
+      positions_available(false),
+      lm_data_file_size(-1),
+      lm_data_file_modification_time(0)
+{
+  if (interval_in_secs <= 0)
+    error("ListModeIndex: time interval has to be positive");
+  if (get_file_info(lm_data_file_size, lm_data_file_modification_time, lm_data.get_data_filename()) == Succeeded::no)
+    lm_data_file_size = -1;
+  if (lm_data.reset() == Succeeded::no)
+    error("ListModeIndex: cannot reset the list mode data");
+
+  std::vector<ListModeData::SavedPosition> entry_saved_positions;
+  // first entry is the start of the data
+  {
+    Entry entry = { 0., std::streampos(0), 0UL, 0UL };
+    entries.push_back(entry);
+    entry_saved_positions.push_back(lm_data.save_get_position());
+  }
+
+  shared_ptr<ListRecord> record_sptr = lm_data.get_empty_record_sptr();
+  ListRecord& record = *record_sptr;
+  double next_interval_start = interval_in_secs;
+  while (lm_data.get_next_record(record) == Succeeded::yes)
+    {
+      if (record.is_time())
+        {
+          const double current_time = record.time().get_time_in_secs();
+          if (current_time >= next_interval_start)
+            {
+              Entry entry = { current_time, std::streampos(0), 0UL, 0UL };
+              entries.push_back(entry);
+              entry_saved_positions.push_back(lm_data.save_get_position());
+              next_interval_start = (std::floor(current_time / interval_in_secs) + 1) * interval_in_secs;
+            }
+        }
+      if (record.is_event())
+        {
+          if (record.event().is_prompt())
+            ++entries.back().num_prompts;
+          else
+            ++entries.back().num_delayeds;
+        }
+    }
+
+  const std::vector<std::streampos> all_positions = lm_data.get_saved_get_positions();
+  this->positions_available = !all_positions.empty();
+  if (this->positions_available)
+    {
+      for (std::size_t entry_num = 0; entry_num < entries.size(); ++entry_num)
+        entries[entry_num].position = all_positions[entry_saved_positions[entry_num]];
+    }
+  lm_data.reset();
+}
+
+std::string
+ListModeIndex::get_default_filename(const std::string& lm_data_filename)
+{
+  return lm_data_filename + ".lmindex";
+}
+
+shared_ptr<ListModeIndex>
+ListModeIndex::read_or_create(ListModeData& lm_data, const double interval_in_secs, const bool write_file)
+{
+  const std::string lm_data_filename = lm_data.get_data_filename();
+  if (lm_data_filename.empty())
+    {
+      info(boost::format("ListModeIndex: list mode data %1% is not stored in a single file. Constructing index (without file).")
+           % lm_data.get_name());
+      return shared_ptr<ListModeIndex>(new ListModeIndex(lm_data, interval_in_secs));
+    }
+  const std::string filename = get_default_filename(lm_data_filename);
+  shared_ptr<ListModeIndex> index_sptr(new ListModeIndex);
+  if (index_sptr->read_from_file(filename, lm_data_filename) == Succeeded::yes)
+    {
+      // check if interval_in_secs is an integer multiple of the interval in the file
+      const double ratio = interval_in_secs / index_sptr->get_interval_in_secs();
+      if (ratio > .5 && std::fabs(ratio - std::round(ratio)) <= ratio * 1E-6)
+        return index_sptr;
+    }
+
+  info(boost::format("ListModeIndex: constructing index for list mode data %1% (interval %2% secs)") % lm_data.get_name()
+       % interval_in_secs);
+  index_sptr.reset(new ListModeIndex(lm_data, interval_in_secs));
+  if (write_file && index_sptr->write_to_file(filename) == Succeeded::no)
+    warning(boost::format("ListModeIndex: could not write index file %1%") % filename);
+  return index_sptr;
+}
+
+Succeeded
+ListModeIndex::get_file_info(long long& size, long long& modification_time, const std::string& filename)
+{
+  if (filename.empty())
+    return Succeeded::no;
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0)
+    return Succeeded::no;
+  size = static_cast<long long>(info.st_size);
+  modification_time = static_cast<long long>(info.st_mtime);
+  return Succeeded::yes;
+}
+
+Succeeded
+ListModeIndex::write_to_file(const std::string& filename) const
+{
+  // without information on the list mode file, we would not be able to check consistency when reading
+  if (lm_data_file_size < 0)
+    return Succeeded::no;
+  std::ofstream s(filename.c_str());
+  if (!s)
+    return Succeeded::no;
+  s << index_file_signature << '\n'
+    << "version := 2\n"
+    << "list mode data file size := " << lm_data_file_size << '\n'
+    << "list mode data file modification time := " << lm_data_file_modification_time << '\n'
+    << "time interval (secs) := " << std::setprecision(17) << interval_in_secs << '\n'
+    << "positions available := " << (positions_available ? 1 : 0) << '\n'
+    << "number of entries := " << entries.size() << '\n'
+    << "time_in_secs , position , num_prompts , num_delayeds\n";
+  for (const auto& entry : entries)
+    s << entry.time_in_secs << " , " << static_cast<long long>(std::streamoff(entry.position)) << " , " << entry.num_prompts
+      << " , " << entry.num_delayeds << '\n';
+  return s.good() ? Succeeded::yes : Succeeded::no;
+}
+
+Succeeded
+ListModeIndex::read_from_file(const std::string& filename, const std::string& lm_data_filename)
+{
+  std::ifstream s(filename.c_str());
+  if (!s)
+    return Succeeded::no;
+
+  std::string line;
+  if (!std::getline(s, line) || line != index_file_signature)
+    {
+      warning(boost::format("ListModeIndex: %1% is not a list mode index file") % filename);
+      return Succeeded::no;
+    }
+
+  // read header lines "key := value" until the column headers
+  int version = 0;
+  long long file_size = -2;
+  long long modification_time = 0;
+  double interval = 0.;
+  int positions = 0;
+  std::size_t num_entries = 0;
+  while (std::getline(s, line))
+    {
+      const std::string::size_type pos = line.find(":=");
+      if (pos == std::string::npos)
+        break;
+      const std::string key = line.substr(0, pos);
+      std::istringstream value(line.substr(pos + 2));
+      if (key == "version ")
+        value >> version;
+      else if (key == "list mode data file size ")
+        value >> file_size;
+      else if (key == "list mode data file modification time ")
+        value >> modification_time;
+      else if (key == "time interval (secs) ")
+        value >> interval;
+      else if (key == "positions available ")
+        value >> positions;
+      else if (key == "number of entries ")
+        value >> num_entries;
+    }
+  if (version != 2 || interval <= 0 || num_entries == 0)
+    {
+      warning(boost::format("ListModeIndex: error parsing header of %1% (or unsupported version)") % filename);
+      return Succeeded::no;
+    }
+  long long lm_data_size, lm_data_modification_time;
+  if (get_file_info(lm_data_size, lm_data_modification_time, lm_data_filename) == Succeeded::no)
+    {
+      warning(boost::format("ListModeIndex: cannot find list mode data file \"%1%\". Ignoring index file %2%.") % lm_data_filename
+              % filename);
+      return Succeeded::no;
+    }
+  if (file_size != lm_data_size || modification_time != lm_data_modification_time)
+    {
+      warning(boost::format("ListModeIndex: index file %1% is inconsistent with list mode data %2%. Ignoring it.") % filename
+              % lm_data_filename);
+      return Succeeded::no;
+    }
+
+  std::vector<Entry> new_entries(num_entries);
+  for (auto& entry : new_entries)
+    {
+      long long position;
+      char sep1, sep2, sep3;
+      s >> entry.time_in_secs >> sep1 >> position >> sep2 >> entry.num_prompts >> sep3 >> entry.num_delayeds;
+      if (!s || sep1 != ',' || sep2 != ',' || sep3 != ',')
+        {
+          warning(boost::format("ListModeIndex: error reading entries from %1%") % filename);
+          return Succeeded::no;
+        }
+      entry.position = std::streampos(std::streamoff(position));
+    }
+
+  this->interval_in_secs = interval;
+  this->positions_available = positions != 0;
+  this->lm_data_file_size = file_size;
+  this->lm_data_file_modification_time = modification_time;
+  this->entries.swap(new_entries);
+  this->saved_positions.clear();
+  return Succeeded::yes;
+}
+
+Succeeded
+ListModeIndex::set_up(ListModeData& lm_data)
+{
+  if (!this->positions_available)
+    return Succeeded::no;
+  std::vector<std::streampos> all_positions = lm_data.get_saved_get_positions();
+  // check if a previous call already added our positions (e.g. with the same lm_data)
+  if (!this->saved_positions.empty())
+    {
+      const std::size_t first_position = static_cast<std::size_t>(this->saved_positions[0]);
+      if (first_position + entries.size() <= all_positions.size()
+          && std::equal(entries.begin(), entries.end(), all_positions.begin() + first_position,
+                        [](const Entry& entry, const std::streampos& position) { return entry.position == position; }))
+        return Succeeded::yes;
+    }
+  const std::size_t first_position = all_positions.size();
+  for (const auto& entry : entries)
+    all_positions.push_back(entry.position);
+  if (lm_data.set_saved_get_positions(all_positions) == Succeeded::no)
+    return Succeeded::no;
+  this->saved_positions.resize(entries.size());
+  for (std::size_t entry_num = 0; entry_num < entries.size(); ++entry_num)
+    this->saved_positions[entry_num] = static_cast<ListModeData::SavedPosition>(first_position + entry_num);
+  return Succeeded::yes;
+}
+
+int
+ListModeIndex::find_entry_num(const double time_in_secs) const
+{
+  const auto iter = std::upper_bound(
+      entries.begin(), entries.end(), time_in_secs, [](const double t, const Entry& entry) { return t < entry.time_in_secs; });
+  return static_cast<int>(iter - entries.begin()) - 1;
+}
+
+ListModeData::SavedPosition
+ListModeIndex::get_saved_position(const int entry_num) const
+{
+  if (this->saved_positions.empty())
+    error("ListModeIndex::get_saved_position called without (successful) set_up()");
+  if (entry_num < 0 || static_cast<std::size_t>(entry_num) >= this->saved_positions.size())
+    error(boost::format("ListModeIndex::get_saved_position: entry number %1% out of range") % entry_num);
+  return this->saved_positions[entry_num];
+}
+
+END_NAMESPACE_STIR
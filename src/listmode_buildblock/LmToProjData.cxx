@@ -57,6 +57,7 @@ typedef short elem_type;
 #include "stir/listmode/LmToProjData.h"
 #include "stir/listmode/ListRecord.h"
 #include "stir/listmode/ListModeData.h"
+#include "stir/listmode/ListModeIndex.h"
 #include "stir/ExamInfo.h"
 #include "stir/ProjDataInfoCylindricalNoArcCorr.h"
 
@@ -78,6 +79,7 @@ typedef short elem_type;
 #include "stir/is_null_ptr.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include "stir/Profiler.h"
 
 #include <fstream>
 #include <iostream>
@@ -220,6 +222,18 @@ LmToProjData::get_store_delayeds() const
   return store_delayeds;
 }
 
+void
+LmToProjData::set_use_lm_index(bool v)
+{
+  use_lm_index = v;
+}
+
+bool
+LmToProjData::get_use_lm_index() const
+{
+  return use_lm_index;
+}
+
 void
 LmToProjData::set_num_segments_in_memory(int v)
 {
@@ -267,6 +281,7 @@ LmToProjData::set_defaults()
   store_prompts = true;
   store_delayeds = true;
   interactive = false;
+  use_lm_index = false;
   num_segments_in_memory = -1;
   num_timing_poss_in_memory = -1;
   normalisation_ptr.reset(new TrivialBinNormalisation);
@@ -301,6 +316,7 @@ LmToProjData::initialise_keymap()
     // parser.add_key("increment to use for 'delayeds'",&delayed_increment);
   }
   parser.add_key("List event coordinates", &interactive);
+  parser.add_key("use list mode index", &use_lm_index);
   parser.add_stop_key("END");
 }
 
@@ -613,6 +629,7 @@ LmToProjData::start_new_time_frame(const unsigned int)
 void
 LmToProjData::process_data()
 {
+  ProfilerZone profiler_zone("LmToProjData::process_data");
   if (!_already_setup)
     error("LmToProjData: you need to call set_up() first");
 
@@ -653,6 +670,18 @@ LmToProjData::process_data()
   // few coincidence events (as happens with ECAT scanners)
   current_time = 0;
 
+  lm_index_sptr.reset();
+  if (use_lm_index && do_time_frame)
+    {
+      // an index with 1 sec intervals (or finer) is sufficient to find the start of the frames quickly
+      lm_index_sptr = ListModeIndex::read_or_create(*lm_data_ptr, 1.);
+      if (lm_index_sptr->set_up(*lm_data_ptr) == Succeeded::no)
+        {
+          warning("LmToProjData: list mode index cannot be used for this list mode data. Reading sequentially.");
+          lm_index_sptr.reset();
+        }
+    }
+
   double time_of_last_stored_event = 0;
   long num_stored_events = 0;
   VectorWithOffset<segment_type*> segments(template_proj_data_info_ptr->get_min_segment_num(),
@@ -754,6 +783,17 @@ LmToProjData::process_data()
                   // need to set it. In fact, setting it to start_time would be wrong
                   // as we first might have to skip some events before we get to start_time.
                   // So, let's do that now.
+                  if (!is_null_ptr(lm_index_sptr))
+                    {
+                      // jump to the last indexed time tag not after start_time (if that is further than where we are now)
+                      const int entry_num = lm_index_sptr->find_entry_num(start_time);
+                      if (entry_num >= 0 && lm_index_sptr->get_entries()[entry_num].time_in_secs > current_time)
+                        {
+                          if (lm_data_ptr->set_get_position(lm_index_sptr->get_saved_position(entry_num)) == Succeeded::no)
+                            error("LmToProjData: error jumping to position in list mode data");
+                          current_time = lm_index_sptr->get_entries()[entry_num].time_in_secs;
+                        }
+                    }
                   while (current_time < start_time && lm_data_ptr->get_next_record(record) == Succeeded::yes)
                     {
                       if (record.is_time())
@@ -0,0 +1,114 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup listmode
+  \brief Implementation of functions to compute data for ML normalisation estimation directly from list mode data
+*/
+
+#include "stir/listmode/ML_norm_listmode.h"
+#include "stir/listmode/ListModeData.h"
+#include "stir/listmode/ListRecord.h"
+#include "stir/ML_norm.h"
+#include "stir/ProjDataInfoCylindricalNoArcCorr.h"
+#include "stir/ProjDataInfoBlocksOnCylindricalNoArcCorr.h"
+#include "stir/Bin.h"
+#include "stir/Succeeded.h"
+#include "stir/info.h"
+#include "stir/error.h"
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+START_NAMESPACE_STIR
+
+template <class TProjDataInfo>
+static unsigned long
+make_fan_data_remove_gaps_help(FanProjData& fan_data,
+                               ListModeData& lm_data,
+                               const TProjDataInfo& proj_data_info,
+                               const double start_time,
+                               const double end_time,
+                               const int delayed_increment)
+{
+  const Scanner& scanner = *proj_data_info.get_scanner_sptr();
+  make_fan_data_remove_gaps(fan_data, proj_data_info);
+  // use the same (symmetric) range of tangential positions as make_fan_data_remove_gaps(FanProjData&, const ProjData&)
+  const int half_fan_size
+      = std::min(proj_data_info.get_max_tangential_pos_num(), -proj_data_info.get_min_tangential_pos_num());
+
+  if (lm_data.reset() == Succeeded::no)
+    error("make_fan_data_remove_gaps: cannot reset the list mode data");
+
+  unsigned long num_stored_events = 0;
+  shared_ptr<ListRecord> record_sptr = lm_data.get_empty_record_sptr();
+  ListRecord& record = *record_sptr;
+  double current_time = 0;
+  while (lm_data.get_next_record(record) == Succeeded::yes)
+    {
+      if (record.is_time())
+        {
+          current_time = record.time().get_time_in_secs();
+          if (current_time >= end_time)
+            break;
+        }
+      else if (record.is_event() && current_time >= start_time)
+        {
+          const int event_increment = record.event().is_prompt() ? 1 : delayed_increment;
+          if (event_increment == 0)
+            continue;
+
+          Bin bin;
+          record.event().get_bin(bin, proj_data_info);
+          // events outside the range of proj_data_info (e.g. fan size or segments) have a bin value <= 0
+          if (bin.get_bin_value() <= 0 || std::abs(bin.tangential_pos_num()) > half_fan_size)
+            continue;
+
+          int ra = 0, a = 0;
+          int rb = 0, b = 0;
+          proj_data_info.get_det_pair_for_bin(a, ra, b, rb, bin);
+          if (add_to_fan_data_remove_gaps(fan_data, scanner, ra, a, rb, b, static_cast<float>(event_increment)))
+            ++num_stored_events;
+        }
+    }
+
+  info(boost::format("make_fan_data_remove_gaps: stored %1% events from list mode data (last time %2% secs)")
+           % num_stored_events % current_time,
+       2);
+  return num_stored_events;
+}
+
+unsigned long
+make_fan_data_remove_gaps(FanProjData& fan_data,
+                          ListModeData& lm_data,
+                          const ProjDataInfo& proj_data_info,
+                          const double start_time,
+                          const double end_time,
+                          const int delayed_increment)
+{
+  if (proj_data_info.is_tof_data())
+    error("make_fan_data: Incompatible with TOF data. Abort.");
+
+  if (proj_data_info.get_scanner_ptr()->get_scanner_geometry() == "Cylindrical")
+    {
+      auto proj_data_info_ptr = dynamic_cast<const ProjDataInfoCylindricalNoArcCorr*>(&proj_data_info);
+      if (!proj_data_info_ptr)
+        error("make_fan_data_remove_gaps: can only handle non arc-corrected data");
+      return make_fan_data_remove_gaps_help(fan_data, lm_data, *proj_data_info_ptr, start_time, end_time, delayed_increment);
+    }
+  else
+    {
+      auto proj_data_info_ptr = dynamic_cast<const ProjDataInfoBlocksOnCylindricalNoArcCorr*>(&proj_data_info);
+      if (!proj_data_info_ptr)
+        error("make_fan_data_remove_gaps: can only handle non arc-corrected data");
+      return make_fan_data_remove_gaps_help(fan_data, lm_data, *proj_data_info_ptr, start_time, end_time, delayed_increment);
+    }
+}
+
+END_NAMESPACE_STIR
@@ -9,6 +9,12 @@
   start_time_in_secs , end_time_in_secs , num_prompts , num_delayeds
   \endverbatim
 
+  With the \c --index option, a ListModeIndex file next to the list mode file is used
+  (and created if it does not exist yet, or if its interval is not compatible with the requested one).
+  Once the index file exists, the count rate curve is then computed without reading the list mode data.
+  In this case, the time intervals start at 0 (as opposed to the time of the first time tag),
+  and the counts are assigned to an interval via the time of the first time tag in each index entry.
+
   \author Kris Thielemans
   \author Daniel Deidda
 */
@@ -22,6 +28,7 @@
 */
 #include "stir/listmode/ListModeData.h"
 #include "stir/listmode/ListRecord.h"
+#include "stir/listmode/ListModeIndex.h"
 #include "stir/shared_ptr.h"
 #include "stir/Succeeded.h"
 #include "stir/utilities.h"
@@ -31,16 +38,27 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <vector>
+#include <cmath>
 
 USING_NAMESPACE_STIR
 
 int
 main(int argc, char* argv[])
 {
+  const char* const program_name = argv[0];
+  bool use_index = false;
+  if (argc > 1 && std::string(argv[1]) == "--index")
+    {
+      use_index = true;
+      --argc;
+      ++argv;
+    }
   if (argc < 3 || argc > 4)
     {
-      std::cerr << "Usage: " << argv[0] << " output_filename listmode_file [time_interval_in_secs]\n"
+      std::cerr << "Usage: " << program_name << " [--index] output_filename listmode_file [time_interval_in_secs]\n"
                 << "time_interval_in_secs defaults to 1\n"
+                << "--index uses (and creates if necessary) an index file next to the listmode file\n"
                 << "Output is a file with the count-rates per time interval in CSV format as in\n"
                 << "start_time_in_secs , end_time_in_secs , num_prompts , num_delayeds\n";
       exit(EXIT_FAILURE);
@@ -56,6 +74,29 @@ main(int argc, char* argv[])
 
   const double interval = argc > 3 ? atof(argv[3]) : 1;
 
+  if (use_index)
+    {
+      const shared_ptr<ListModeIndex> index_sptr = ListModeIndex::read_or_create(*lm_data_ptr, interval);
+      // accumulate the counts of the index entries in the requested intervals
+      std::vector<unsigned long> num_prompts;
+      std::vector<unsigned long> num_delayeds;
+      for (const auto& entry : index_sptr->get_entries())
+        {
+          const std::size_t interval_num = static_cast<std::size_t>(std::floor(entry.time_in_secs / interval + 1E-6));
+          if (interval_num >= num_prompts.size())
+            {
+              num_prompts.resize(interval_num + 1, 0UL);
+              num_delayeds.resize(interval_num + 1, 0UL);
+            }
+          num_prompts[interval_num] += entry.num_prompts;
+          num_delayeds[interval_num] += entry.num_delayeds;
+        }
+      for (std::size_t interval_num = 0; interval_num < num_prompts.size(); ++interval_num)
+        headcurve << std::fixed << std::setprecision(3) << interval_num * interval << " , " << (interval_num + 1) * interval
+                  << " , " << num_prompts[interval_num] << " , " << num_delayeds[interval_num] << '\n';
+      return EXIT_SUCCESS;
+    }
+
   shared_ptr<ListRecord> record_sptr = lm_data_ptr->get_empty_record_sptr();
   ListRecord& record = *record_sptr;
 
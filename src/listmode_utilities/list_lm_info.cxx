@@ -16,14 +16,19 @@
   \par Usage
 
   <pre>
-  list_lm_info [--all  | --exam] listmode_filename
+  list_lm_info [--all  | --exam | --geom | --counts] listmode_filename
   </pre>
   Add one or more options to print the exam/geometric information.
   If no option is specified, exam info is printed.
 
+  With \c --counts, the total number of prompts and delayeds and the time of the last time tag
+  are printed. These are obtained from a ListModeIndex next to the list mode file, which is created
+  if it does not exist yet (requiring one pass through the data). This option is not included in \c --all.
+
   \author Kris Thielemans
 */
 #include "stir/listmode/ListModeData.h"
+#include "stir/listmode/ListModeIndex.h"
 #include "stir/ExamInfo.h"
 #include "stir/ProjDataInfo.h"
 #include "stir/is_null_ptr.h"
@@ -37,9 +42,11 @@ USING_NAMESPACE_STIR
 void
 print_usage_and_exit(const std::string& program_name)
 {
-  std::cerr << "Usage: " << program_name << " [--all | --geom | --exam] listmode_file\n"
+  std::cerr << "Usage: " << program_name << " [--all | --geom | --exam | --counts] listmode_file\n"
             << "\nAdd one or more options to print the exam/geometric information.\n"
-            << "\nIf no option is specified, exam info is printed.\n";
+            << "\nIf no option is specified, exam info is printed.\n"
+            << "\n--counts prints the number of counts and the duration, using (and creating if necessary)\n"
+            << "an index file next to the listmode file. It is not included in --all.\n";
   exit(EXIT_FAILURE);
 }
 
@@ -54,6 +61,7 @@ main(int argc, char* argv[])
   // default values
   bool print_exam = false;
   bool print_geom = false;
+  bool print_counts = false;
   bool no_options = true; // need this for default behaviour
 
   // first process command line options
@@ -78,6 +86,12 @@ main(int argc, char* argv[])
           --argc;
           ++argv;
         }
+      else if (strcmp(argv[0], "--counts") == 0)
+        {
+          print_counts = true;
+          --argc;
+          ++argv;
+        }
       else
         print_usage_and_exit(program_name);
     }
@@ -104,5 +118,19 @@ main(int argc, char* argv[])
     std::cout << lm_data_sptr->get_exam_info_sptr()->parameter_info();
   if (print_geom)
     std::cout << lm_data_sptr->get_proj_data_info_sptr()->parameter_info() << std::endl;
+  if (print_counts)
+    {
+      const shared_ptr<ListModeIndex> index_sptr = ListModeIndex::read_or_create(*lm_data_sptr, 1.);
+      unsigned long num_prompts = 0UL;
+      unsigned long num_delayeds = 0UL;
+      for (const auto& entry : index_sptr->get_entries())
+        {
+          num_prompts += entry.num_prompts;
+          num_delayeds += entry.num_delayeds;
+        }
+      std::cout << "Number of prompts: " << num_prompts << '\n'
+                << "Number of delayeds: " << num_delayeds << '\n'
+                << "Time of last indexed time tag (secs): " << index_sptr->get_entries().back().time_in_secs << std::endl;
+    }
   return EXIT_SUCCESS;
 }
@@ -6,6 +6,10 @@
 
   \brief Program to compute detector fansums directly from listmode data
 
+  If the parameter <tt>use list mode index</tt> is set to 1, a ListModeIndex next to the
+  list mode file is used (and created if necessary) to jump to the start of every time frame,
+  instead of reading all events before it.
+
   \author Kris Thielemans
 
   $Revision $
@@ -25,6 +29,7 @@
 #include "stir/listmode/ListRecord.h"
 #include "stir/listmode/CListEventCylindricalScannerWithDiscreteDetectors.h"
 #include "stir/listmode/ListModeData.h"
+#include "stir/listmode/ListModeIndex.h"
 #include "stir/TimeFrameDefinitions.h"
 #include "stir/Scanner.h"
 #include "stir/Array.h"
@@ -33,6 +38,8 @@
 #include "stir/CPUTimer.h"
 #include "stir/IO/read_from_file.h"
 #include "stir/error.h"
+#include "stir/warning.h"
+#include "stir/is_null_ptr.h"
 
 #include "stir/ProjDataInfoCylindricalNoArcCorr.h"
 #include <fstream>
@@ -75,6 +82,7 @@ private:
   int delayed_increment;
 
   bool interactive;
+  bool use_lm_index;
 
   void write_fan_sums(const Array<2, float>& data_fan_sums, const unsigned current_frame_num) const;
 };
@@ -87,6 +95,7 @@ LmFansums::set_defaults()
   store_prompts = true;
   delayed_increment = -1;
   interactive = false;
+  use_lm_index = false;
 }
 
 void
@@ -105,6 +114,7 @@ LmFansums::initialise_keymap()
     parser.add_key("increment to use for 'delayeds'", &delayed_increment);
   }
   parser.add_key("List event coordinates", &interactive);
+  parser.add_key("use list mode index", &use_lm_index);
   parser.add_stop_key("END");
 }
 
@@ -158,6 +168,18 @@ LmFansums::compute()
   // go to the beginning of the binary data
   lm_data_ptr->reset();
 
+  shared_ptr<ListModeIndex> lm_index_sptr;
+  if (use_lm_index)
+    {
+      // an index with 1 sec intervals is sufficient to find the start of the frames quickly
+      lm_index_sptr = ListModeIndex::read_or_create(*lm_data_ptr, 1.);
+      if (lm_index_sptr->set_up(*lm_data_ptr) == Succeeded::no)
+        {
+          warning("lm_fansums: list mode index cannot be used for this list mode data. Reading sequentially.");
+          lm_index_sptr.reset();
+        }
+    }
+
   unsigned int current_frame_num = 1;
   {
     // loop over all events in the listmode file
@@ -167,6 +189,19 @@ LmFansums::compute()
     bool first_event = true;
 
     double current_time = 0;
+    // jump to the last indexed time tag not after the start of the current frame (if that is further than where we are now)
+    auto skip_to_frame_start = [&]() {
+      if (is_null_ptr(lm_index_sptr) || current_frame_num > frame_defs.get_num_frames())
+        return;
+      const int entry_num = lm_index_sptr->find_entry_num(frame_defs.get_start_time(current_frame_num));
+      if (entry_num >= 0 && lm_index_sptr->get_entries()[entry_num].time_in_secs > current_time)
+        {
+          if (lm_data_ptr->set_get_position(lm_index_sptr->get_saved_position(entry_num)) == Succeeded::no)
+            error("lm_fansums: error jumping to position in list mode data");
+          current_time = lm_index_sptr->get_entries()[entry_num].time_in_secs;
+        }
+    };
+    skip_to_frame_start();
     while (true)
       {
         if (lm_data_ptr->get_next_record(record) == Succeeded::no)
@@ -187,8 +222,11 @@ LmFansums::compute()
                   }
                 if (current_frame_num > frame_defs.get_num_frames())
                   break; // get out of while loop
+                current_time = new_time;
+                skip_to_frame_start();
               }
-            current_time = new_time;
+            else
+              current_time = new_time;
           }
         else if (record.is_event() && frame_defs.get_start_time(current_frame_num) <= current_time)
           {
@@ -29,6 +29,7 @@
 #include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include "stir/MemoryUsage.h"
 #include <iostream>
 #include "stir/IO/OutputFileFormat.h"
 
@@ -175,6 +176,7 @@ AnalyticReconstruction::reconstruct(shared_ptr<TargetT> const& target_image_sptr
         }
     }
   this->stop_timers();
+  info(MemoryUsage::get_report());
   return success;
 }
 
@@ -31,6 +31,7 @@
 #include "stir/error.h"
 #include "stir/is_null_ptr.h"
 #include "stir/DataProcessor.h"
+#include "stir/Profiler.h"
 #include <vector>
 #ifdef STIR_OPENMP
 #  include "stir/is_null_ptr.h"
@@ -182,6 +183,7 @@ BackProjectorByBin::back_project(DiscretisedDensity<3, float>& density,
 void
 BackProjectorByBin::back_project(const ProjData& proj_data, int subset_num, int num_subsets)
 {
+  ProfilerZone profiler_zone("back_project proj_data");
   if (!_density_sptr)
     error("You need to call start_accumulating_in_new_target() before back_project()");
 
@@ -196,6 +198,11 @@ BackProjectorByBin::back_project(const ProjData& proj_data, int subset_num, int
                                              proj_data.get_max_segment_num(),
                                              subset_num,
                                              num_subsets);
+  const int min_timing_pos_num = proj_data.get_proj_data_info_sptr()->get_min_tof_pos_num();
+  const int max_timing_pos_num = proj_data.get_proj_data_info_sptr()->get_max_tof_pos_num();
+  // if true, every iteration handles all TOF bins, so the inner loop has only 1 iteration
+  const bool all_tof_bins_together = proj_data.get_proj_data_info_sptr()->is_tof_data() && processes_all_tof_bins_together();
+  const int max_k = all_tof_bins_together ? min_timing_pos_num : max_timing_pos_num;
 
 #ifdef STIR_OPENMP
 #  if _OPENMP < 201107
@@ -208,11 +215,24 @@ BackProjectorByBin::back_project(const ProjData& proj_data, int subset_num, int
   // note: older versions of openmp need an int as loop
   for (int i = 0; i < static_cast<int>(vs_nums_to_process.size()); ++i)
     {
-      for (int k = proj_data.get_proj_data_info_sptr()->get_min_tof_pos_num();
-           k <= proj_data.get_proj_data_info_sptr()->get_max_tof_pos_num();
-           ++k)
+      for (int k = min_timing_pos_num; k <= max_k; ++k)
         {
           const ViewSegmentNumbers vs = vs_nums_to_process[i];
+          if (all_tof_bins_together)
+            {
+              VectorWithOffset<RelatedViewgrams<float>> viewgrams(min_timing_pos_num, max_timing_pos_num);
+#ifdef STIR_OPENMP
+#  pragma omp critical(BACKPROJECTORBYBIN_GETVIEWGRAMS)
+#endif
+              {
+                for (int t = min_timing_pos_num; t <= max_timing_pos_num; ++t)
+                  viewgrams[t] = proj_data.get_related_viewgrams(vs, symmetries_sptr, false, t);
+              }
+              info(boost::format("Processing view %1% of segment %2% (all TOF bins)") % vs.view_num() % vs.segment_num(), 3);
+              ProfilerZone profiler_zone("back_project");
+              actual_back_project_all_tof_bins(get_local_output_image(), viewgrams);
+              continue;
+            }
 #ifdef STIR_OPENMP
           RelatedViewgrams<float> viewgrams;
 #  pragma omp critical(BACKPROJECTORBYBIN_GETVIEWGRAMS)
@@ -228,6 +248,20 @@ BackProjectorByBin::back_project(const ProjData& proj_data, int subset_num, int
     }
 }
 
+bool
+BackProjectorByBin::processes_all_tof_bins_together() const
+{
+  return false;
+}
+
+void
+BackProjectorByBin::actual_back_project_all_tof_bins(DiscretisedDensity<3, float>&,
+                                                     const VectorWithOffset<RelatedViewgrams<float>>&)
+{
+  error("BackProjectorByBin::actual_back_project_all_tof_bins() needs to be implemented by the derived class "
+        "if processes_all_tof_bins_together() returns true");
+}
+
 void
 BackProjectorByBin::back_project(const RelatedViewgrams<float>& viewgrams)
 {
@@ -289,6 +323,7 @@ BackProjectorByBin::back_project(const RelatedViewgrams<float>& viewgrams,
       }
   }
 
+  ProfilerZone profiler_zone("back_project");
   actual_back_project(viewgrams, min_axial_pos_num, max_axial_pos_num, min_tangential_pos_num, max_tangential_pos_num);
 }
 
@@ -316,6 +351,7 @@ BackProjectorByBin::start_accumulating_in_new_target()
 void
 BackProjectorByBin::get_output(DiscretisedDensity<3, float>& density) const
 {
+  ProfilerZone profiler_zone("back_project get_output");
   if (!density.has_same_characteristics(*_density_sptr))
     error("Images should have similar characteristics.");
 
@@ -365,13 +401,21 @@ BackProjectorByBin::actual_back_project(const RelatedViewgrams<float>& viewgrams
                                         const int min_tangential_pos_num,
                                         const int max_tangential_pos_num)
 {
-  shared_ptr<DiscretisedDensity<3, float>> density_sptr = _density_sptr;
+  actual_back_project(
+      get_local_output_image(), viewgrams, min_axial_pos_num, max_axial_pos_num, min_tangential_pos_num, max_tangential_pos_num);
+}
+
+DiscretisedDensity<3, float>&
+BackProjectorByBin::get_local_output_image()
+{
 #ifdef STIR_OPENMP
   const int thread_num = omp_get_thread_num();
-  density_sptr = _local_output_image_sptrs[thread_num];
+  if (is_null_ptr(_local_output_image_sptrs[thread_num]))
+    _local_output_image_sptrs[thread_num].reset(_density_sptr->get_empty_copy());
+  return *_local_output_image_sptrs[thread_num];
+#else
+  return *_density_sptr;
 #endif
-  actual_back_project(
-      *density_sptr, viewgrams, min_axial_pos_num, max_axial_pos_num, min_tangential_pos_num, max_tangential_pos_num);
 }
 
 END_NAMESPACE_STIR
@@ -25,6 +25,7 @@
 #include "stir/Bin.h"
 #include "stir/ProjData.h"
 #include "stir/is_null_ptr.h"
+#include "stir/Profiler.h"
 #include "stir/Succeeded.h"
 #include "stir/error.h"
 #include <boost/format.hpp>
@@ -122,6 +123,7 @@ BinNormalisation::undo(RelatedViewgrams<float>& viewgrams) const
 void
 BinNormalisation::apply(ProjData& proj_data, shared_ptr<DataSymmetriesForViewSegmentNumbers> symmetries_sptr) const
 {
+  ProfilerZone profiler_zone("BinNormalisation::apply proj_data");
   this->check(*proj_data.get_proj_data_info_sptr());
   this->check(proj_data.get_exam_info());
   if (is_null_ptr(symmetries_sptr))
@@ -175,6 +177,7 @@ BinNormalisation::apply(ProjData& proj_data, shared_ptr<DataSymmetriesForViewSeg
 void
 BinNormalisation::undo(ProjData& proj_data, shared_ptr<DataSymmetriesForViewSegmentNumbers> symmetries_sptr) const
 {
+  ProfilerZone profiler_zone("BinNormalisation::undo proj_data");
   this->check(*proj_data.get_proj_data_info_sptr());
   this->check(proj_data.get_exam_info());
   if (is_null_ptr(symmetries_sptr))
@@ -161,6 +161,7 @@ BinNormalisationFromECAT7::initialise_keymap()
   this->parser.add_key("use_dead_time", &this->_use_dead_time);
   this->parser.add_key("use_geometric_factors", &this->_use_geometric_factors);
   this->parser.add_key("use_crystal_interference_factors", &this->_use_crystal_interference_factors);
+  this->parser.add_key("use_precomputed_efficiencies", &this->_use_precomputed_efficiencies);
   this->parser.add_stop_key("End Bin Normalisation From ECAT7");
 }
 
@@ -161,6 +161,7 @@ BinNormalisationFromECAT8::initialise_keymap()
   this->parser.add_key("use_crystal_interference_factors", &this->_use_crystal_interference_factors);
   this->parser.add_key("use_axial_effects_factors", &this->_use_axial_effects_factors);
   this->parser.add_key("write_components_to_file", &this->_write_components_to_file);
+  this->parser.add_key("use_precomputed_efficiencies", &this->_use_precomputed_efficiencies);
   this->parser.add_stop_key("End Bin Normalisation From ECAT8");
 }
 
@@ -223,6 +224,7 @@ BinNormalisationFromECAT8::set_up(const shared_ptr<const ExamInfo>& exam_info_sp
 
   this->mash = scanner_ptr->get_num_detectors_per_ring() / 2 / proj_data_info_ptr->get_num_views();
 
+  this->precompute_efficiencies();
   return Succeeded::yes;
 }
 
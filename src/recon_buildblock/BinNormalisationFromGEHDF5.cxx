@@ -203,6 +203,7 @@ BinNormalisationFromGEHDF5::initialise_keymap()
   this->parser.add_key("use_detector_efficiencies", &this->_use_detector_efficiencies);
   // this->parser.add_key("use_dead_time", &this->_use_dead_time);
   this->parser.add_key("use_geometric_factors", &this->_use_geometric_factors);
+  this->parser.add_key("use_precomputed_efficiencies", &this->_use_precomputed_efficiencies);
   this->parser.add_stop_key("End Bin Normalisation From GE HDF5");
 }
 
@@ -247,6 +248,7 @@ BinNormalisationFromGEHDF5::set_up(const shared_ptr<const ExamInfo>& exam_info_s
 
   mash = scanner_ptr->get_num_detectors_per_ring() / 2 / proj_data_info_ptr->get_num_views();
 
+  this->precompute_efficiencies();
   return Succeeded::yes;
 }
 
@@ -20,9 +20,19 @@
 */
 
 #include "stir/recon_buildblock/BinNormalisationWithCalibration.h"
+#include "stir/ProjDataInMemory.h"
+#include "stir/ProjDataInfo.h"
+#include "stir/ExamInfo.h"
+#include "stir/RelatedViewgrams.h"
+#include "stir/ViewgramIndices.h"
 #include "stir/Succeeded.h"
+#include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include <boost/format.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 START_NAMESPACE_STIR
 
@@ -32,6 +42,8 @@ BinNormalisationWithCalibration::set_defaults()
   base_type::set_defaults();
 
   this->calibration_factor = 1;
+  this->_use_precomputed_efficiencies = false;
+  this->_precomputed_efficiencies_sptr.reset();
 }
 
 void
@@ -61,6 +73,7 @@ BinNormalisationWithCalibration::set_up(const shared_ptr<const ExamInfo>& exam_i
     warning("BinNormalisationWithCalibration:: calibration factor not set. I will use 1, but your data will not be calibrated.");
 
   this->_calib_decay_branching_ratio = this->calibration_factor * this->get_branching_ratio(); // TODO: multiply by decay
+  this->_precomputed_efficiencies_sptr.reset();
   return base_type::set_up(exam_info_sptr, proj_data_info_sptr);
 }
 
@@ -103,4 +116,151 @@ BinNormalisationWithCalibration::set_radionuclide(const Radionuclide& rnuclide)
   this->radionuclide = rnuclide;
 }
 
+void
+BinNormalisationWithCalibration::set_use_precomputed_efficiencies(const bool arg)
+{
+  this->_use_precomputed_efficiencies = arg;
+  if (!arg)
+    this->_precomputed_efficiencies_sptr.reset();
+}
+
+bool
+BinNormalisationWithCalibration::get_use_precomputed_efficiencies() const
+{
+  return this->_use_precomputed_efficiencies;
+}
+
+void
+BinNormalisationWithCalibration::precompute_efficiencies() const
+{
+  if (this->_use_precomputed_efficiencies)
+    this->get_precomputed_efficiencies();
+}
+
+void
+BinNormalisationWithCalibration::check(const ExamInfo& exam_info) const
+{
+  base_type::check(exam_info);
+  this->precompute_efficiencies();
+}
+
+shared_ptr<const BinNormalisationWithCalibration::PrecomputedEfficiencies>
+BinNormalisationWithCalibration::get_precomputed_efficiencies() const
+{
+  if (!this->_already_set_up)
+    error("BinNormalisationWithCalibration needs to be set-up first");
+
+  const TimeFrameDefinitions& frame_defs = this->get_exam_info_sptr()->get_time_frame_definitions();
+  const double start_time = frame_defs.get_num_time_frames() == 0 ? 0. : frame_defs.get_start_time();
+  const double end_time = frame_defs.get_num_time_frames() == 0 ? 0. : frame_defs.get_end_time();
+
+  {
+    auto current_sptr = std::atomic_load(&this->_precomputed_efficiencies_sptr);
+    if (current_sptr && current_sptr->start_time == start_time && current_sptr->end_time == end_time)
+      return current_sptr;
+  }
+
+  shared_ptr<const PrecomputedEfficiencies> result_sptr;
+#ifdef STIR_OPENMP
+#  pragma omp critical(BINNORMALISATIONWITHCALIBRATION_PRECOMPUTE)
+#endif
+  {
+    // check again, as another thread might have computed them in the mean time
+    result_sptr = std::atomic_load(&this->_precomputed_efficiencies_sptr);
+    if (!result_sptr || result_sptr->start_time != start_time || result_sptr->end_time != end_time)
+      {
+        info(boost::format("BinNormalisationWithCalibration: computing efficiencies for time frame [%1%, %2%]") % start_time
+                 % end_time,
+             2);
+        auto new_sptr = std::make_shared<PrecomputedEfficiencies>();
+        new_sptr->start_time = start_time;
+        new_sptr->end_time = end_time;
+        shared_ptr<const ProjDataInfo> non_tof_proj_data_info_sptr(this->proj_data_info_sptr->create_non_tof_clone());
+        new_sptr->efficiencies_sptr
+            = std::make_shared<ProjDataInMemory>(this->get_exam_info_sptr(), non_tof_proj_data_info_sptr, false);
+        ProjDataInMemory& efficiencies = *new_sptr->efficiencies_sptr;
+
+        std::vector<std::pair<int, int>> segment_and_view_nums;
+        for (int segment_num = efficiencies.get_min_segment_num(); segment_num <= efficiencies.get_max_segment_num();
+             ++segment_num)
+          for (int view_num = efficiencies.get_min_view_num(); view_num <= efficiencies.get_max_view_num(); ++view_num)
+            segment_and_view_nums.push_back(std::make_pair(segment_num, view_num));
+
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < static_cast<int>(segment_and_view_nums.size()); ++i)
+          {
+            const int segment_num = segment_and_view_nums[i].first;
+            const int view_num = segment_and_view_nums[i].second;
+            Viewgram<float> viewgram = efficiencies.get_empty_viewgram(ViewgramIndices(view_num, segment_num));
+            Bin bin(segment_num, view_num, 0, 0);
+            for (bin.axial_pos_num() = viewgram.get_min_axial_pos_num(); bin.axial_pos_num() <= viewgram.get_max_axial_pos_num();
+                 ++bin.axial_pos_num())
+              for (bin.tangential_pos_num() = viewgram.get_min_tangential_pos_num();
+                   bin.tangential_pos_num() <= viewgram.get_max_tangential_pos_num();
+                   ++bin.tangential_pos_num())
+                viewgram[bin.axial_pos_num()][bin.tangential_pos_num()] = this->get_uncalibrated_bin_efficiency(bin);
+#ifdef STIR_OPENMP
+#  pragma omp critical(BINNORMALISATIONWITHCALIBRATION_SET_VIEWGRAM)
+#endif
+            efficiencies.set_viewgram(viewgram);
+          }
+        result_sptr = new_sptr;
+        std::atomic_store(&this->_precomputed_efficiencies_sptr, result_sptr);
+      }
+  }
+  return result_sptr;
+}
+
+float
+BinNormalisationWithCalibration::get_bin_efficiency(const Bin& bin) const
+{
+  if (!this->_use_precomputed_efficiencies)
+    return this->get_uncalibrated_bin_efficiency(bin) / this->_calib_decay_branching_ratio;
+
+  Bin non_tof_bin(bin.segment_num(), bin.view_num(), bin.axial_pos_num(), bin.tangential_pos_num());
+  return this->get_precomputed_efficiencies()->efficiencies_sptr->get_bin_value(non_tof_bin) / this->_calib_decay_branching_ratio;
+}
+
+void
+BinNormalisationWithCalibration::apply(RelatedViewgrams<float>& viewgrams) const
+{
+  if (!this->_use_precomputed_efficiencies)
+    {
+      base_type::apply(viewgrams);
+      return;
+    }
+  this->check(*viewgrams.get_proj_data_info_sptr());
+  const auto precomputed_sptr = this->get_precomputed_efficiencies();
+  for (RelatedViewgrams<float>::iterator iter = viewgrams.begin(); iter != viewgrams.end(); ++iter)
+    {
+      const Viewgram<float> efficiencies
+          = precomputed_sptr->efficiencies_sptr->get_viewgram(iter->get_view_num(), iter->get_segment_num());
+      for (int a = iter->get_min_axial_pos_num(); a <= iter->get_max_axial_pos_num(); ++a)
+        for (int s = iter->get_min_tangential_pos_num(); s <= iter->get_max_tangential_pos_num(); ++s)
+          (*iter)[a][s] /= std::max(1.E-20F, efficiencies[a][s] / this->_calib_decay_branching_ratio);
+    }
+}
+
+void
+BinNormalisationWithCalibration::undo(RelatedViewgrams<float>& viewgrams) const
+{
+  if (!this->_use_precomputed_efficiencies)
+    {
+      base_type::undo(viewgrams);
+      return;
+    }
+  this->check(*viewgrams.get_proj_data_info_sptr());
+  const auto precomputed_sptr = this->get_precomputed_efficiencies();
+  for (RelatedViewgrams<float>::iterator iter = viewgrams.begin(); iter != viewgrams.end(); ++iter)
+    {
+      const Viewgram<float> efficiencies
+          = precomputed_sptr->efficiencies_sptr->get_viewgram(iter->get_view_num(), iter->get_segment_num());
+      for (int a = iter->get_min_axial_pos_num(); a <= iter->get_max_axial_pos_num(); ++a)
+        for (int s = iter->get_min_tangential_pos_num(); s <= iter->get_max_tangential_pos_num(); ++s)
+          (*iter)[a][s] *= efficiencies[a][s] / this->_calib_decay_branching_ratio;
+    }
+}
+
 END_NAMESPACE_STIR
@@ -24,6 +24,7 @@
 #include "stir/DataProcessor.h"
 #include "stir/is_null_ptr.h"
 #include "stir/warning.h"
+#include "stir/Profiler.h"
 
 START_NAMESPACE_STIR
 
@@ -91,6 +92,7 @@ template <typename DataT>
 void
 FilterRootPrior<DataT>::compute_gradient(DataT& prior_gradient, const DataT& current_image_estimate)
 {
+  ProfilerZone profiler_zone("FilterRootPrior::compute_gradient");
   assert(prior_gradient.get_index_range() == current_image_estimate.get_index_range());
   if (this->penalisation_factor == 0 || is_null_ptr(filter_ptr))
     {
@@ -37,6 +37,7 @@
 #include "stir/warning.h"
 #include "stir/DataProcessor.h"
 #include "stir/is_null_ptr.h"
+#include "stir/Profiler.h"
 #include <boost/format.hpp>
 #include <iostream>
 
@@ -167,6 +168,7 @@ ForwardProjectorByBin::forward_project(RelatedViewgrams<float>& viewgrams,
 void
 ForwardProjectorByBin::forward_project(ProjData& proj_data, int subset_num, int num_subsets, bool zero)
 {
+  ProfilerZone profiler_zone("forward_project proj_data");
   if (!_density_sptr)
     error("You need to call set_input() forward_project()");
 
@@ -195,6 +197,11 @@ ForwardProjectorByBin::forward_project(ProjData& proj_data, int subset_num, int
                                              proj_data.get_max_segment_num(),
                                              subset_num,
                                              num_subsets);
+  const int min_timing_pos_num = proj_data.get_proj_data_info_sptr()->get_min_tof_pos_num();
+  const int max_timing_pos_num = proj_data.get_proj_data_info_sptr()->get_max_tof_pos_num();
+  // if true, every iteration handles all TOF bins, so the inner loop has only 1 iteration
+  const bool all_tof_bins_together = proj_data.get_proj_data_info_sptr()->is_tof_data() && processes_all_tof_bins_together();
+  const int max_k = all_tof_bins_together ? min_timing_pos_num : max_timing_pos_num;
 #ifdef STIR_OPENMP
 #  if _OPENMP < 201107
 #    pragma omp parallel for shared(proj_data, symmetries_sptr) schedule(dynamic)
@@ -206,11 +213,29 @@ ForwardProjectorByBin::forward_project(ProjData& proj_data, int subset_num, int
   // note: older versions of openmp need an int as loop
   for (int i = 0; i < static_cast<int>(vs_nums_to_process.size()); ++i)
     {
-      for (int k = proj_data.get_proj_data_info_sptr()->get_min_tof_pos_num();
-           k <= proj_data.get_proj_data_info_sptr()->get_max_tof_pos_num();
-           ++k)
+      for (int k = min_timing_pos_num; k <= max_k; ++k)
         {
           const ViewSegmentNumbers vs = vs_nums_to_process[i];
+          if (all_tof_bins_together)
+            {
+              info(boost::format("Processing view %1% of segment %2% (all TOF bins)") % vs.view_num() % vs.segment_num(), 3);
+              VectorWithOffset<RelatedViewgrams<float>> viewgrams(min_timing_pos_num, max_timing_pos_num);
+              for (int t = min_timing_pos_num; t <= max_timing_pos_num; ++t)
+                viewgrams[t] = proj_data.get_empty_related_viewgrams(vs, symmetries_sptr, false, t);
+              {
+                ProfilerZone profiler_zone("forward_project");
+                actual_forward_project_all_tof_bins(viewgrams, *_density_sptr);
+              }
+#ifdef STIR_OPENMP
+#  pragma omp critical(FORWARDPROJ_SETVIEWGRAMS)
+#endif
+              {
+                for (int t = min_timing_pos_num; t <= max_timing_pos_num; ++t)
+                  if (!(proj_data.set_related_viewgrams(viewgrams[t]) == Succeeded::yes))
+                    error("Error set_related_viewgrams in forward projecting");
+              }
+              continue;
+            }
           if (proj_data.get_proj_data_info_sptr()->is_tof_data())
             info(boost::format("Processing view %1% of segment %2% of TOF bin %3%") % vs.view_num() % vs.segment_num() % k, 3);
           else
@@ -228,6 +253,20 @@ ForwardProjectorByBin::forward_project(ProjData& proj_data, int subset_num, int
     }
 }
 
+bool
+ForwardProjectorByBin::processes_all_tof_bins_together() const
+{
+  return false;
+}
+
+void
+ForwardProjectorByBin::actual_forward_project_all_tof_bins(VectorWithOffset<RelatedViewgrams<float>>&,
+                                                           const DiscretisedDensity<3, float>&)
+{
+  error("ForwardProjectorByBin::actual_forward_project_all_tof_bins() needs to be implemented by the derived class "
+        "if processes_all_tof_bins_together() returns true");
+}
+
 void
 ForwardProjectorByBin::forward_project(RelatedViewgrams<float>& viewgrams)
 {
@@ -281,6 +320,7 @@ ForwardProjectorByBin::forward_project(RelatedViewgrams<float>& viewgrams,
           error("ForwardProjectByBin: forward_project called with incorrect related_viewgrams. Problem with symmetries!\n");
       }
   }
+  ProfilerZone profiler_zone("forward_project");
   actual_forward_project(viewgrams, min_axial_pos_num, max_axial_pos_num, min_tangential_pos_num, max_tangential_pos_num);
 }
 
@@ -305,6 +345,7 @@ ForwardProjectorByBin::actual_forward_project(RelatedViewgrams<float>& viewgrams
 void
 ForwardProjectorByBin::set_input(const DiscretisedDensity<3, float>& density)
 {
+  ProfilerZone profiler_zone("forward_project set_input");
   _density_sptr.reset(density.clone());
 
   // If a pre-forward-projection data processor has been set, apply it.
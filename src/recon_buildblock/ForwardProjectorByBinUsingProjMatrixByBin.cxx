@@ -22,12 +22,17 @@
 */
 
 #include "stir/recon_buildblock/ForwardProjectorByBinUsingProjMatrixByBin.h"
+#include "stir/recon_buildblock/find_basic_vs_nums_in_subsets.h"
 #include "stir/Viewgram.h"
 #include "stir/RelatedViewgrams.h"
+#include "stir/ProjData.h"
 #include "stir/IndexRange2D.h"
+#include "stir/Succeeded.h"
 #include "stir/is_null_ptr.h"
+#include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include <boost/format.hpp>
 #include <algorithm>
 #include <vector>
 #include <list>
@@ -206,6 +211,89 @@ ForwardProjectorByBinUsingProjMatrixByBin::actual_forward_project(RelatedViewgra
     }
 }
 
+bool
+ForwardProjectorByBinUsingProjMatrixByBin::processes_all_tof_bins_together() const
+{
+  return true;
+}
+
+void
+ForwardProjectorByBinUsingProjMatrixByBin::actual_forward_project_all_tof_bins(
+    VectorWithOffset<RelatedViewgrams<float>>& viewgrams, const DiscretisedDensity<3, float>& image)
+{
+  // Similar to the version of actual_forward_project() which handles the symmetries explicitly,
+  // but gets the geometric row and TOF kernel for the basic bin only once.
+  const int min_timing_pos_num = viewgrams.get_min_index();
+  const int max_timing_pos_num = viewgrams.get_max_index();
+  const RelatedViewgrams<float>& first_viewgrams = viewgrams[min_timing_pos_num];
+  const int min_axial_pos_num = first_viewgrams.get_min_axial_pos_num();
+  const int max_axial_pos_num = first_viewgrams.get_max_axial_pos_num();
+  const int min_tangential_pos_num = first_viewgrams.get_min_tangential_pos_num();
+  const int max_tangential_pos_num = first_viewgrams.get_max_tangential_pos_num();
+
+  ProjMatrixElemsForOneBin proj_matrix_row;
+  ProjMatrixElemsForOneBin proj_matrix_row_copy;
+  shared_ptr<const Array<2, float>> tof_kernel_sptr;
+  VectorWithOffset<float> tof_values(min_timing_pos_num, max_timing_pos_num);
+  const DataSymmetriesForBins* symmetries = proj_matrix_ptr->get_symmetries_ptr();
+
+  Array<2, int> already_processed(
+      IndexRange2D(min_axial_pos_num, max_axial_pos_num, min_tangential_pos_num, max_tangential_pos_num));
+
+  for (int tang_pos = min_tangential_pos_num; tang_pos <= max_tangential_pos_num; ++tang_pos)
+    for (int ax_pos = min_axial_pos_num; ax_pos <= max_axial_pos_num; ++ax_pos)
+      {
+        if (already_processed[ax_pos][tang_pos])
+          continue;
+
+        Bin basic_bin(first_viewgrams.get_basic_segment_num(), first_viewgrams.get_basic_view_num(), ax_pos, tang_pos, 0);
+        symmetries->find_basic_bin(basic_bin);
+
+        proj_matrix_ptr->get_proj_matrix_elems_and_tof_kernel_for_one_bin(proj_matrix_row, tof_kernel_sptr, basic_bin);
+
+        vector<AxTangPosNumbers> r_ax_poss;
+        symmetries->get_related_bins_factorised(
+            r_ax_poss, basic_bin, min_axial_pos_num, max_axial_pos_num, min_tangential_pos_num, max_tangential_pos_num);
+
+        for (auto r_ax_poss_iter = r_ax_poss.begin(); r_ax_poss_iter != r_ax_poss.end(); ++r_ax_poss_iter)
+          {
+            const int axial_pos_tmp = (*r_ax_poss_iter)[1];
+            const int tang_pos_tmp = (*r_ax_poss_iter)[2];
+
+            // symmetries might take the ranges out of what the user wants
+            if (!(min_axial_pos_num <= axial_pos_tmp && axial_pos_tmp <= max_axial_pos_num
+                  && min_tangential_pos_num <= tang_pos_tmp && tang_pos_tmp <= max_tangential_pos_num))
+              continue;
+
+            already_processed[axial_pos_tmp][tang_pos_tmp] = 1;
+
+            for (int viewgram_num = 0; viewgram_num < first_viewgrams.get_num_viewgrams(); ++viewgram_num)
+              {
+                const Viewgram<float>& first_viewgram = *(first_viewgrams.begin() + viewgram_num);
+                proj_matrix_row_copy = proj_matrix_row;
+                // use timing position 1 to find out if the symmetry changes the sign of the timing position
+                Bin bin(first_viewgram.get_segment_num(), first_viewgram.get_view_num(), axial_pos_tmp, tang_pos_tmp, 1);
+
+                unique_ptr<SymmetryOperation> symm_op_ptr = symmetries->find_symmetry_operation_from_basic_bin(bin);
+                const int timing_pos_sign = bin.timing_pos_num();
+                assert(bin.segment_num() == basic_bin.segment_num() && bin.view_num() == basic_bin.view_num()
+                       && bin.axial_pos_num() == basic_bin.axial_pos_num()
+                       && bin.tangential_pos_num() == basic_bin.tangential_pos_num());
+
+                symm_op_ptr->transform_proj_matrix_elems_for_one_bin(proj_matrix_row_copy);
+                tof_values.fill(0.F);
+                proj_matrix_row_copy.forward_project(tof_values, image, *tof_kernel_sptr);
+
+                // tof_values are indexed with the timing position of the basic bin
+                for (int k = min_timing_pos_num; k <= max_timing_pos_num; ++k)
+                  (*(viewgrams[k].begin() + viewgram_num))[axial_pos_tmp][tang_pos_tmp] = tof_values[timing_pos_sign * k];
+              }
+          }
+      }
+  assert(already_processed.sum()
+         == ((max_axial_pos_num - min_axial_pos_num + 1) * (max_tangential_pos_num - min_tangential_pos_num + 1)));
+}
+
 #if 0 // disabled as currently not used. needs to be written in the new style anyway
 void
 ForwardProjectorByBinUsingProjMatrixByBin::
@@ -38,6 +38,8 @@
 #include <numeric>
 #include <ctime>
 #include <complex>
+#include <vector>
+#include <algorithm>
 #include <boost/format.hpp>
 #include "stir/numerics/fourier.h"
 #include "stir/interpolate.h"
@@ -267,6 +269,10 @@ FourierRebinning::rebin()
   // CL now finally fill in the new sinogram s
   SegmentBySinogram<float> sino2D_rebinned = rebinned_proj_data_sptr->get_empty_segment_by_sinogram(0);
 
+  // CON planes are independent, so can be processed in parallel (except when displaying intermediate results)
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic) if (fore_debug_level < 3)
+#endif
   for (int plane = FT_rebinned_data.get_min_index(); plane <= FT_rebinned_data.get_max_index(); plane++)
     {
 
@@ -360,12 +366,22 @@ FourierRebinning::do_rebinning(Array<3, std::complex<float>>& FT_rebinned_data,
   const int local_miss = count_rebinned.miss;
   const int local_ssrb = count_rebinned.ssrb;
 
-  // CON Loop over all slices, FFT the sinograms and call the actual rebinning kernel.
-  for (int axial_pos_num = segment.get_min_axial_pos_num(); axial_pos_num <= segment.get_max_axial_pos_num(); axial_pos_num++)
+  // CON FFT all sinograms of the segment first (in parallel), then call the actual rebinning kernel.
+  // CON The kernel accumulates the contribution of every frequency (w,k) of an oblique sinogram in the same k of
+  // CON the rebinned data. The accumulation is therefore parallelised over k, such that every thread updates
+  // CON its own part of FT_rebinned_data and no thread-local copies of the (large) rebinned data are needed.
+  // CON Contributions are added in the same order as in the serial version, so results do not depend on the number of threads.
+  const int min_axial_pos_num = segment.get_min_axial_pos_num();
+  const int max_axial_pos_num = segment.get_max_axial_pos_num();
+  std::vector<Array<2, std::complex<float>>> FT_sinograms(max_axial_pos_num - min_axial_pos_num + 1);
+  std::vector<float> z_in_mm(FT_sinograms.size());
+
+  const ProjDataInfo& proj_data_info = *segment.get_proj_data_info_sptr();
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (int axial_pos_num = min_axial_pos_num; axial_pos_num <= max_axial_pos_num; axial_pos_num++)
     {
-
-      if (axial_pos_num % 10 == 0)
-        info(boost::format("FORE Rebinning z (slice) = %1%") % axial_pos_num);
       Array<2, float> current_sinogram(IndexRange2D(0, num_tang_poss_pow2 - 1, 0, num_views_pow2 - 1));
 
       // CL Calculate the 2D FFT of P(w,k) of the merged segment
@@ -377,29 +393,52 @@ FourierRebinning::do_rebinning(Array<3, std::complex<float>>& FT_rebinned_data,
           current_sinogram[j][i] = segment[axial_pos_num][i][j + segment.get_min_tangential_pos_num()];
 
       // CON FFT slicedata
-      const Array<2, std::complex<float>> FT_current_sinogram = fourier_for_real_data(current_sinogram);
+      FT_sinograms[axial_pos_num - min_axial_pos_num] = fourier_for_real_data(current_sinogram);
 
       // CON determine the axial position of the middle of the LOR in mm relative to Bin(segment=0,view=0,axial_pos=0,tang_pos=0)
-      const ProjDataInfo& proj_data_info = *segment.get_proj_data_info_sptr();
-      const float z_in_mm
+      z_in_mm[axial_pos_num - min_axial_pos_num]
           = proj_data_info.get_m(Bin(segment.get_segment_num(), 0, axial_pos_num, 0)) - proj_data_info.get_m(Bin(0, 0, 0, 0));
+    }
 
-      // CON Call the rebinning kernel.
-      rebinning(FT_rebinned_data,
-                Weights_for_FT_rebinned_data,
-                count_rebinned,
-                FT_current_sinogram,
-                z_in_mm,
-                average_ring_difference_in_segment,
-                num_views_pow2,
-                num_tang_poss_pow2,
-                half_distance_between_rings,
-                sampling_distance_in_s,
-                radial_sampling_freq_w,
-                R_field_of_view_mm,
-                ratio_ring_spacing_to_ring_radius);
-
-    } // CL End of loop of axial_pos_num
+  // CON check the z-positions here, as the rebinning kernel is called in a parallel region where errors cannot be handled
+  for (const float z : z_in_mm)
+    if (fabs(static_cast<float>(z / half_distance_between_rings - round(z / half_distance_between_rings))) > .005F)
+      error(boost::format("FORE rebinning :: rebinning kernel expected integer z coordinate but found a non integer value %1%")
+            % z);
+
+  int num_total = 0;
+  int num_miss = 0;
+  int num_ssrb = 0;
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic) reduction(+ : num_total, num_miss, num_ssrb)
+#endif
+  for (int k_index = 0; k_index <= num_views_pow2 / 2; ++k_index)
+    {
+      PETCount_rebinned count_for_this_k;
+      for (int axial_pos_num = min_axial_pos_num; axial_pos_num <= max_axial_pos_num; axial_pos_num++)
+        {
+          // CON Call the rebinning kernel.
+          rebinning(FT_rebinned_data,
+                    Weights_for_FT_rebinned_data,
+                    count_for_this_k,
+                    FT_sinograms[axial_pos_num - min_axial_pos_num],
+                    z_in_mm[axial_pos_num - min_axial_pos_num],
+                    average_ring_difference_in_segment,
+                    num_views_pow2,
+                    num_tang_poss_pow2,
+                    half_distance_between_rings,
+                    sampling_distance_in_s,
+                    radial_sampling_freq_w,
+                    R_field_of_view_mm,
+                    ratio_ring_spacing_to_ring_radius,
+                    k_index,
+                    k_index);
+        }
+      num_total += count_for_this_k.total;
+      num_miss += count_for_this_k.miss;
+      num_ssrb += count_for_this_k.ssrb;
+    }
+  count_rebinned += PETCount_rebinned(num_total, num_miss, num_ssrb);
 
   if (fore_debug_level > 0)
     {
@@ -423,7 +462,9 @@ FourierRebinning::rebinning(Array<3, std::complex<float>>& FT_rebinned_data,
                             const float sampling_distance_in_s,
                             const float radial_sampling_freq_w,
                             const float R_field_of_view_mm,
-                            const float ratio_ring_spacing_to_ring_radius)
+                            const float ratio_ring_spacing_to_ring_radius,
+                            const int min_k_index,
+                            const int max_k_index)
 {
 
   // CON prevent rebinning to non existing z-positions (sinograms)
@@ -444,7 +485,7 @@ FourierRebinning::rebinning(Array<3, std::complex<float>>& FT_rebinned_data,
 
   for (int j = wmin; j <= num_tang_poss_pow2 / 2; j++)
     {
-      for (int i = kmin; i <= num_views_pow2 / 2; i++)
+      for (int i = std::max(kmin, min_k_index); i <= std::min(num_views_pow2 / 2, max_k_index); i++)
         {
 
           float w = static_cast<float>(j) * radial_sampling_freq_w;
@@ -533,7 +574,7 @@ FourierRebinning::rebinning(Array<3, std::complex<float>>& FT_rebinned_data,
 
       for (int j = 0; j < wmin; j++)
         {
-          for (int i = 0; i <= num_views_pow2 / 2; i++)
+          for (int i = std::max(0, min_k_index); i <= std::min(num_views_pow2 / 2, max_k_index); i++)
             {
 
               for (int shift_direction = POSITIVE_Z_SHIFT; shift_direction <= NEGATIVE_Z_SHIFT; shift_direction += CHANGE_Z_SHIFT)
@@ -562,7 +603,7 @@ FourierRebinning::rebinning(Array<3, std::complex<float>>& FT_rebinned_data,
       // CL Next treat small k's and w=wNyq=(num_tang_poss_pow2 / 2)+1, k=1..klim :
       for (int j = wmin; j <= num_tang_poss_pow2 / 2; j++)
         {
-          for (int i = 0; i <= kmin; i++)
+          for (int i = std::max(0, min_k_index); i <= std::min(kmin, max_k_index); i++)
             {
 
               for (int shift_direction = POSITIVE_Z_SHIFT; shift_direction <= NEGATIVE_Z_SHIFT; shift_direction += CHANGE_Z_SHIFT)
@@ -42,6 +42,7 @@
 #include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include "stir/MemoryUsage.h"
 
 using std::cerr;
 using std::endl;
@@ -421,6 +422,7 @@ IterativeReconstruction<TargetT>::reconstruct(shared_ptr<TargetT> const& target_
   this->stop_timers();
 
   info("Total CPU Time " + std::to_string(this->get_CPU_timer_value()) + "secs");
+  info(MemoryUsage::get_report());
 
   // currently, if there was something wrong, the programme is just aborted
   // so, if we get here, everything was fine
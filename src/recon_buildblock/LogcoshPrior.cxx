@@ -31,6 +31,7 @@
 #include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include "stir/Profiler.h"
 #include <algorithm>
 using std::min;
 using std::max;
@@ -251,6 +252,7 @@ template <typename elemT>
 double
 LogcoshPrior<elemT>::compute_value(const DiscretisedDensity<3, elemT>& current_image_estimate)
 {
+  ProfilerZone profiler_zone("LogcoshPrior::compute_value");
   if (this->penalisation_factor == 0)
     {
       return 0.;
@@ -319,6 +321,7 @@ void
 LogcoshPrior<elemT>::compute_gradient(DiscretisedDensity<3, elemT>& prior_gradient,
                                       const DiscretisedDensity<3, elemT>& current_image_estimate)
 {
+  ProfilerZone profiler_zone("LogcoshPrior::compute_gradient");
   assert(prior_gradient.has_same_characteristics(current_image_estimate));
   if (this->penalisation_factor == 0)
     {
@@ -536,6 +539,7 @@ LogcoshPrior<elemT>::accumulate_Hessian_times_input(DiscretisedDensity<3, elemT>
                                                     const DiscretisedDensity<3, elemT>& current_estimate,
                                                     const DiscretisedDensity<3, elemT>& input) const
 {
+  ProfilerZone profiler_zone("LogcoshPrior::accumulate_Hessian_times_input");
   // TODO this function overlaps enormously with parabolic_surrogate_curvature
   // the only difference is that parabolic_surrogate_curvature uses input==1
 
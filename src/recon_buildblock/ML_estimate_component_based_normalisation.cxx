@@ -27,6 +27,7 @@
 #include "stir/display.h"
 #include "stir/info.h"
 #include "stir/warning.h"
+#include "stir/error.h"
 #include "stir/ProjData.h"
 #include <boost/format.hpp>
 #include <fstream>
@@ -47,30 +48,48 @@ ML_estimate_component_based_normalisation(const std::string& out_filename_prefix
                                           bool do_KL,
                                           bool do_display)
 {
+  FanProjData measured_fan_data;
+  make_fan_data_remove_gaps(measured_fan_data, measured_data);
+  ML_estimate_component_based_normalisation(out_filename_prefix,
+                                            measured_fan_data,
+                                            model_data,
+                                            num_eff_iterations,
+                                            num_iterations,
+                                            do_geo,
+                                            do_block,
+                                            do_symmetry_per_block,
+                                            do_KL,
+                                            do_display);
+}
 
-  const int num_transaxial_blocks = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_transaxial_blocks();
-  const int num_axial_blocks = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_axial_blocks();
-  const int virtual_axial_crystals
-      = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_virtual_axial_crystals_per_block();
-  const int virtual_transaxial_crystals
-      = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_virtual_transaxial_crystals_per_block();
-  const int num_physical_rings = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_rings()
-                                 - (num_axial_blocks - 1) * virtual_axial_crystals;
+void
+ML_estimate_component_based_normalisation(const std::string& out_filename_prefix,
+                                          FanProjData& measured_fan_data,
+                                          const ProjData& model_data,
+                                          int num_eff_iterations,
+                                          int num_iterations,
+                                          bool do_geo,
+                                          bool do_block,
+                                          bool do_symmetry_per_block,
+                                          bool do_KL,
+                                          bool do_display)
+{
+  const Scanner& scanner = *model_data.get_proj_data_info_sptr()->get_scanner_sptr();
+  const int num_transaxial_blocks = scanner.get_num_transaxial_blocks();
+  const int num_axial_blocks = scanner.get_num_axial_blocks();
+  const int virtual_axial_crystals = scanner.get_num_virtual_axial_crystals_per_block();
+  const int virtual_transaxial_crystals = scanner.get_num_virtual_transaxial_crystals_per_block();
+  const int num_physical_rings = scanner.get_num_rings() - (num_axial_blocks - 1) * virtual_axial_crystals;
   const int num_physical_detectors_per_ring
-      = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_detectors_per_ring()
-        - num_transaxial_blocks * virtual_transaxial_crystals;
-  const int num_transaxial_buckets = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_transaxial_buckets();
-  const int num_axial_buckets = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_axial_buckets();
-  const int num_transaxial_blocks_per_bucket
-      = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_transaxial_blocks_per_bucket();
-  const int num_axial_blocks_per_bucket
-      = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_axial_blocks_per_bucket();
+      = scanner.get_num_detectors_per_ring() - num_transaxial_blocks * virtual_transaxial_crystals;
+  const int num_transaxial_buckets = scanner.get_num_transaxial_buckets();
+  const int num_axial_buckets = scanner.get_num_axial_buckets();
+  const int num_transaxial_blocks_per_bucket = scanner.get_num_transaxial_blocks_per_bucket();
+  const int num_axial_blocks_per_bucket = scanner.get_num_axial_blocks_per_bucket();
 
   int num_physical_transaxial_crystals_per_basic_unit
-      = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_transaxial_crystals_per_block()
-        - virtual_transaxial_crystals;
-  int num_physical_axial_crystals_per_basic_unit
-      = measured_data.get_proj_data_info_sptr()->get_scanner_sptr()->get_num_axial_crystals_per_block() - virtual_axial_crystals;
+      = scanner.get_num_transaxial_crystals_per_block() - virtual_transaxial_crystals;
+  int num_physical_axial_crystals_per_basic_unit = scanner.get_num_axial_crystals_per_block() - virtual_axial_crystals;
   // If there are multiple buckets, we increase the symmetry size to a bucket. Otherwise, we use a block.
   if (do_symmetry_per_block == false)
     {
@@ -102,15 +121,20 @@ ML_estimate_component_based_normalisation(const std::string& out_filename_prefix
   BlockData3D norm_block_data(num_axial_blocks, num_transaxial_blocks, num_axial_blocks - 1, num_transaxial_blocks - 1);
 
   make_fan_data_remove_gaps(model_fan_data, model_data);
+  if (measured_fan_data.get_num_rings() != model_fan_data.get_num_rings()
+      || measured_fan_data.get_num_detectors_per_ring() != model_fan_data.get_num_detectors_per_ring()
+      || measured_fan_data.get_max_delta() != model_fan_data.get_max_delta()
+      || measured_fan_data.get_max_b(0) - measured_fan_data.get_min_b(0)
+             != model_fan_data.get_max_b(0) - model_fan_data.get_min_b(0))
+    error("ML_estimate_component_based_normalisation: measured and model data have incompatible sizes");
   {
-    // next could be local if KL is not computed below
-    FanProjData measured_fan_data;
     float threshold_for_KL;
     // compute factors dependent on the data
     {
-      make_fan_data_remove_gaps(measured_fan_data, measured_data);
-
       /* TEMP FIX */
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
       for (int ra = model_fan_data.get_min_ra(); ra <= model_fan_data.get_max_ra(); ++ra)
         {
           for (int a = model_fan_data.get_min_a(); a <= model_fan_data.get_max_a(); ++a)
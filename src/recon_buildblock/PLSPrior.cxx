@@ -28,6 +28,7 @@
 #include "stir/is_null_ptr.h"
 #include "stir/info.h"
 #include "stir/error.h"
+#include "stir/Profiler.h"
 #include <algorithm>
 using std::min;
 using std::max;
@@ -456,6 +457,7 @@ template <typename elemT>
 double
 PLSPrior<elemT>::compute_value(const DiscretisedDensity<3, elemT>& current_image_estimate)
 {
+  ProfilerZone profiler_zone("PLSPrior::compute_value");
   if (this->penalisation_factor == 0)
     {
       return 0.;
@@ -519,6 +521,7 @@ void
 PLSPrior<elemT>::compute_gradient(DiscretisedDensity<3, elemT>& prior_gradient,
                                   const DiscretisedDensity<3, elemT>& current_image_estimate)
 {
+  ProfilerZone profiler_zone("PLSPrior::compute_gradient");
   this->check(current_image_estimate);
 
   if (this->penalisation_factor == 0)
@@ -27,7 +27,6 @@
 #include "stir/info.h"
 #include "stir/stream.h"
 #include <iostream>
-#include "stir/num_threads.h"
 
 START_NAMESPACE_STIR
 
@@ -83,84 +82,38 @@ detail::ParallelprojHelper::ParallelprojHelper(const ProjDataInfo& p_info, const
   // warning: next loop needs to be the same as how ProjDataInMemory stores its data. There is no guarantee that this will remain
   // the case in the future.
   const auto segment_sequence = ProjData::standard_segment_sequence(p_info);
+  const int num_views = p_info.get_num_views();
+  const int num_tangential_poss = p_info.get_num_tangential_poss();
+  // index of the first LOR of the current segment
   std::size_t index(0);
 
-#ifdef STIR_OPENMP
-  // Using too many threads is counterproductive according to my timings, so I limited to 8 (not necessarily optimal!).
-  const auto num_threads_to_use = std::min(8, get_max_num_threads());
-#  if _OPENMP >= 201012
-#    define ATOMICWRITE _Pragma("omp atomic write")
-
-#    define CRITICALSECTION
-#  else
-#    define ATOMICWRITE
-#    if defined(_MSC_VER) && (_MSC_VER < 1910)
-  // no _Pragma until VS 2017
-#      define CRITICALSECTION
-#    else
-#      define CRITICALSECTION _Pragma("omp critical(PARALLELPROJHELPER_INIT)")
-#    endif
-#  endif
-#else
-#  define ATOMICWRITE
-#  define CRITICALSECTION
-#endif
   for (int seg : segment_sequence)
     {
-      for (int axial_pos_num = p_info.get_min_axial_pos_num(seg); axial_pos_num <= p_info.get_max_axial_pos_num(seg);
-           ++axial_pos_num)
-        {
-          for (int view_num = p_info.get_min_view_num(); view_num <= p_info.get_max_view_num(); ++view_num)
-            {
+      const int num_axial_poss = p_info.get_num_axial_poss(seg);
 #ifdef STIR_OPENMP
-#  pragma omp parallel for num_threads(num_threads_to_use)
+#  pragma omp parallel for schedule(dynamic)
 #endif
-              for (int tangential_pos_num = p_info.get_min_tangential_pos_num();
-                   tangential_pos_num <= p_info.get_max_tangential_pos_num();
-                   ++tangential_pos_num)
-                {
-                  Bin bin;
-                  bin.segment_num() = seg;
-                  bin.axial_pos_num() = axial_pos_num;
-                  bin.view_num() = view_num;
-                  bin.tangential_pos_num() = tangential_pos_num;
-                  // compute index for this bin (independent of multi-threading)
-                  const std::size_t this_index = index + (bin.tangential_pos_num() - p_info.get_min_tangential_pos_num()) * 3;
-                  LORInAxialAndNoArcCorrSinogramCoordinates<float> lor;
-                  LORAs2Points<float> lor_points;
-
-                  p_info.get_LOR(lor, bin);
-                  if (lor.get_intersections_with_cylinder(lor_points, radius) == Succeeded::no)
-                    {
-                      // memory is already allocated, so just passing in points that will produce nothing
-                      CRITICALSECTION
-                      {
-                        ATOMICWRITE xstart[this_index] = 0;
-                        ATOMICWRITE xend[this_index] = 0;
-                        ATOMICWRITE xstart[this_index + 1] = 0;
-                        ATOMICWRITE xend[this_index + 1] = 0;
-                        ATOMICWRITE xstart[this_index + 2] = 0;
-                        ATOMICWRITE xend[this_index + 2] = 0;
-                      }
-                    }
-                  else
-                    {
-                      const auto p1 = lor_points.p1() * rescale;
-                      const auto p2 = lor_points.p2() * rescale;
-                      CRITICALSECTION
-                      {
-                        ATOMICWRITE xstart[this_index] = p1[1];
-                        ATOMICWRITE xend[this_index] = p2[1];
-                        ATOMICWRITE xstart[this_index + 1] = p1[2];
-                        ATOMICWRITE xend[this_index + 1] = p2[2];
-                        ATOMICWRITE xstart[this_index + 2] = p1[3];
-                        ATOMICWRITE xend[this_index + 2] = p2[3];
-                      }
-                    }
-                }
-              index += p_info.get_num_tangential_poss() * 3;
-            }
+      for (int view_num = p_info.get_min_view_num(); view_num <= p_info.get_max_view_num(); ++view_num)
+        {
+          // get end-points of all LORs in this viewgram (set to 0 if they do not intersect the FOV)
+          LOREndPoints end_points;
+          p_info.get_LOR_end_points_for_viewgram(end_points, ViewgramIndices(view_num, seg), radius);
+          const std::size_t view_index = view_num - p_info.get_min_view_num();
+          for (int a = 0; a < num_axial_poss; ++a)
+            for (int t = 0; t < num_tangential_poss; ++t)
+              {
+                // compute index for this bin (independent of multi-threading)
+                const std::size_t this_index = index + ((a * num_views + view_index) * num_tangential_poss + t) * 3;
+                const std::size_t lor_index = static_cast<std::size_t>(a) * num_tangential_poss + t;
+                xstart[this_index] = end_points.z1[lor_index] * rescale;
+                xend[this_index] = end_points.z2[lor_index] * rescale;
+                xstart[this_index + 1] = end_points.y1[lor_index] * rescale;
+                xend[this_index + 1] = end_points.y2[lor_index] * rescale;
+                xstart[this_index + 2] = end_points.x1[lor_index] * rescale;
+                xend[this_index + 2] = end_points.x2[lor_index] * rescale;
+              }
         }
+      index += static_cast<std::size_t>(num_axial_poss) * num_views * num_tangential_poss * 3;
     }
 
   info("done", 2);
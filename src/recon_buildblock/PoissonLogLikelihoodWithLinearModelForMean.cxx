@@ -17,6 +17,10 @@
 */
 #include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearModelForMean.h"
 #include "stir/DiscretisedDensity.h"
+#include "stir/DiscretisedDensityOnCartesianGrid.h"
+#include "stir/ExamInfo.h"
+#include "stir/FilePath.h"
+#include "stir/stream.h"
 #include "stir/is_null_ptr.h"
 #include "stir/IO/write_to_file.h"
 #include "stir/IO/read_from_file.h"
@@ -27,14 +31,61 @@
 #include "stir/modelling/ParametricDiscretisedDensity.h"
 #include "stir/modelling/KineticParameters.h"
 #include "stir/info.h"
+#include "stir/warning.h"
 #include "stir/error.h"
 #include "boost/format.hpp"
 #include "boost/lexical_cast.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
 
 using std::string;
 
 START_NAMESPACE_STIR
 
+namespace
+{
+const char* const sensitivity_cache_signature = "STIR sensitivity cache v1";
+
+//! 64-bit FNV-1a hash of a string
+std::uint64_t
+hash_of_string(const std::string& str)
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const char c : str)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+//! description of the image geometry for the sensitivity cache, or empty if not supported
+template <typename TargetT>
+std::string
+get_geometry_description(const TargetT&)
+{
+  return "";
+}
+
+std::string
+get_geometry_description(const DiscretisedDensity<3, float>& density)
+{
+  auto grid_ptr = dynamic_cast<const DiscretisedDensityOnCartesianGrid<3, float>*>(&density);
+  BasicCoordinate<3, int> min_indices, max_indices;
+  if (!grid_ptr || !density.get_regular_range(min_indices, max_indices))
+    return "";
+  std::ostringstream s;
+  s << std::setprecision(9) << "origin: " << density.get_origin() << "\ngrid spacing: " << grid_ptr->get_grid_spacing()
+    << "\nmin indices: " << min_indices << "\nmax indices: " << max_indices << '\n';
+  return s.str();
+}
+} // namespace
+
 template <typename TargetT>
 void
 PoissonLogLikelihoodWithLinearModelForMean<TargetT>::set_defaults()
@@ -45,6 +96,7 @@ PoissonLogLikelihoodWithLinearModelForMean<TargetT>::set_defaults()
   this->subsensitivity_filenames = "";
   this->recompute_sensitivity = false;
   this->use_subset_sensitivities = true;
+  this->sensitivity_cache_directory = "";
   this->subsensitivity_sptrs.resize(0);
 }
 
@@ -58,6 +110,7 @@ PoissonLogLikelihoodWithLinearModelForMean<TargetT>::initialise_keymap()
   this->parser.add_key("subset sensitivity filenames", &this->subsensitivity_filenames);
   this->parser.add_key("recompute sensitivity", &this->recompute_sensitivity);
   this->parser.add_key("use_subset_sensitivities", &this->use_subset_sensitivities);
+  this->parser.add_key("sensitivity cache directory", &this->sensitivity_cache_directory);
 }
 
 template <typename TargetT>
@@ -84,6 +137,21 @@ PoissonLogLikelihoodWithLinearModelForMean<TargetT>::get_subsensitivity_filename
   return this->subsensitivity_filenames;
 }
 
+template <typename TargetT>
+std::string
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::get_sensitivity_cache_directory() const
+{
+  return this->sensitivity_cache_directory;
+}
+
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::set_sensitivity_cache_directory(const std::string& directory)
+{
+  this->already_set_up = this->already_set_up && (this->sensitivity_cache_directory == directory);
+  this->sensitivity_cache_directory = directory;
+}
+
 template <typename TargetT>
 void
 PoissonLogLikelihoodWithLinearModelForMean<TargetT>::set_sensitivity_filename(const std::string& filename)
@@ -280,6 +348,22 @@ PoissonLogLikelihoodWithLinearModelForMean<TargetT>::set_up(shared_ptr<TargetT>
       return Succeeded::no;
     }
 
+  std::string sensitivity_cache_key;
+  if (this->recompute_sensitivity && !this->sensitivity_cache_directory.empty())
+    {
+      if (!FilePath::exists(this->sensitivity_cache_directory))
+        error(boost::format("Sensitivity cache directory '%1%' does not exist") % this->sensitivity_cache_directory);
+      sensitivity_cache_key = this->get_full_sensitivity_cache_key(*target_sptr);
+      if (sensitivity_cache_key.empty())
+        warning("PoissonLogLikelihoodWithLinearModelForMean: sensitivity cache is not supported for this objective function "
+                "or image type. The sensitivity will be computed.");
+      else if (this->read_sensitivities_from_cache(*target_sptr, sensitivity_cache_key) == Succeeded::yes)
+        {
+          this->already_set_up = true;
+          return Succeeded::yes;
+        }
+    }
+
   if (this->recompute_sensitivity)
     {
       info("Computing sensitivity");
@@ -323,6 +407,8 @@ PoissonLogLikelihoodWithLinearModelForMean<TargetT>::set_up(shared_ptr<TargetT>
           error("Error writing sensitivity to file:\n%s", e.what());
           return Succeeded::no;
         }
+      if (!sensitivity_cache_key.empty())
+        this->write_sensitivities_to_cache(sensitivity_cache_key);
     }
   this->already_set_up = true;
   return Succeeded::yes;
@@ -363,40 +449,198 @@ PoissonLogLikelihoodWithLinearModelForMean<TargetT>::compute_sensitivities()
         }
     } // end check balancing
 
-  // compute subset sensitivities
-  for (int subset_num = 0; subset_num < this->num_subsets; ++subset_num)
+  if (this->get_use_subset_sensitivities())
     {
-      if (subset_num == 0)
-        {
-          std::fill(this->subsensitivity_sptrs[subset_num]->begin_all(), this->subsensitivity_sptrs[subset_num]->end_all(), 0);
-        }
-      else
+      // compute subset sensitivities
+      for (int subset_num = 0; subset_num < this->num_subsets; ++subset_num)
         {
-          if (this->get_use_subset_sensitivities())
+          if (subset_num == 0)
             {
-              this->subsensitivity_sptrs[subset_num].reset(this->subsensitivity_sptrs[0]->get_empty_copy());
+              std::fill(
+                  this->subsensitivity_sptrs[subset_num]->begin_all(), this->subsensitivity_sptrs[subset_num]->end_all(), 0);
             }
           else
             {
-              // copy subsensitivity[0] pointer to current subset.
-              // do this as pointer such that we don't use more memory.
-              // This also means that we just accumulate in subsensitivity[0] for the moment.
-              // we will correct that below.
-              this->subsensitivity_sptrs[subset_num] = this->subsensitivity_sptrs[0];
+              this->subsensitivity_sptrs[subset_num].reset(this->subsensitivity_sptrs[0]->get_empty_copy());
             }
+          this->add_subset_sensitivity(*this->get_subset_sensitivity_sptr(subset_num), subset_num);
         }
-      this->add_subset_sensitivity(*this->get_subset_sensitivity_sptr(subset_num), subset_num);
     }
-  if (!this->get_use_subset_sensitivities())
+  else
     {
-      // copy full sensitivity (currently stored in subsensitivity[0])
+      // all subsets are accumulated in the full sensitivity (using the memory preallocated in subsensitivity[0])
       this->sensitivity_sptr = this->subsensitivity_sptrs[0];
       this->subsensitivity_sptrs[0].reset();
+      std::fill(this->sensitivity_sptr->begin_all(), this->sensitivity_sptr->end_all(), 0);
+      this->add_sensitivity_of_all_subsets(*this->sensitivity_sptr);
     }
   // compute total from subsensitivity or vice versa
   this->set_total_or_subset_sensitivities();
 }
 
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::add_sensitivity_of_all_subsets(TargetT& sensitivity) const
+{
+  for (int subset_num = 0; subset_num < this->num_subsets; ++subset_num)
+    this->add_subset_sensitivity(sensitivity, subset_num);
+}
+
+template <typename TargetT>
+std::string
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::get_sensitivity_cache_key() const
+{
+  return "";
+}
+
+template <typename TargetT>
+std::string
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::get_sensitivity_cache_key_for_exam_info(const ExamInfo& exam_info)
+{
+  std::ostringstream key;
+  key << std::setprecision(9) << "radionuclide:\n"
+      << exam_info.get_radionuclide().parameter_info() << "calibration factor: " << exam_info.get_calibration_factor()
+      << "\ntime frames (start, duration):";
+  const TimeFrameDefinitions& frame_defs = exam_info.get_time_frame_definitions();
+  for (unsigned int frame_num = 1; frame_num <= frame_defs.get_num_time_frames(); ++frame_num)
+    key << " (" << frame_defs.get_start_time(frame_num) << ", " << frame_defs.get_duration(frame_num) << ")";
+  key << '\n';
+  return key.str();
+}
+
+template <typename TargetT>
+std::string
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::get_full_sensitivity_cache_key(const TargetT& target) const
+{
+  const std::string key = this->get_sensitivity_cache_key();
+  const std::string geometry = get_geometry_description(target);
+  if (key.empty() || geometry.empty())
+    return "";
+  std::ostringstream full_key;
+  full_key << sensitivity_cache_signature << '\n' << key << "image:\n" << geometry;
+  // the total sensitivity does not depend on the number of subsets
+  if (this->get_use_subset_sensitivities())
+    full_key << "subset sensitivities for number of subsets: " << this->num_subsets << '\n';
+  else
+    full_key << "total sensitivity\n";
+  return full_key.str();
+}
+
+template <typename TargetT>
+std::string
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::get_sensitivity_cache_filename_prefix_for_key(const std::string& key) const
+{
+  std::ostringstream name;
+  name << "sensitivity_" << std::hex << std::setw(16) << std::setfill('0') << hash_of_string(key);
+  std::string filename = this->sensitivity_cache_directory;
+  FilePath::append_separator(filename);
+  return filename + name.str();
+}
+
+template <typename TargetT>
+std::string
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::get_sensitivity_cache_filename_prefix(const TargetT& target) const
+{
+  const std::string key = this->get_full_sensitivity_cache_key(target);
+  return key.empty() ? key : this->get_sensitivity_cache_filename_prefix_for_key(key);
+}
+
+template <typename TargetT>
+Succeeded
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::read_sensitivities_from_cache(const TargetT& target, const std::string& key)
+{
+  const std::string prefix = this->get_sensitivity_cache_filename_prefix_for_key(key);
+  // the key file is written last, so if it exists, the images are complete
+  std::ifstream key_file((prefix + ".key").c_str());
+  if (!key_file)
+    return Succeeded::no;
+  const std::string key_in_file((std::istreambuf_iterator<char>(key_file)), std::istreambuf_iterator<char>());
+  if (key_in_file != key)
+    {
+      warning(boost::format("Ignoring incompatible sensitivity cache entry %1%") % prefix);
+      return Succeeded::no;
+    }
+
+  try
+    {
+      if (this->get_use_subset_sensitivities())
+        {
+          for (int subset = 0; subset < this->get_num_subsets(); ++subset)
+            this->subsensitivity_sptrs[subset] = read_from_file<TargetT>(prefix + "_subset" + std::to_string(subset) + ".hv");
+        }
+      else
+        this->sensitivity_sptr = read_from_file<TargetT>(prefix + ".hv");
+    }
+  catch (std::exception& e)
+    {
+      warning(boost::format("Error reading sensitivity cache entry %1%. Recomputing. Error is:\n%2%") % prefix % e.what());
+      this->subsensitivity_sptrs.fill(shared_ptr<TargetT>());
+      return Succeeded::no;
+    }
+
+  for (int subset = 0; subset < (this->get_use_subset_sensitivities() ? this->get_num_subsets() : 1); ++subset)
+    {
+      const TargetT& sensitivity
+          = this->get_use_subset_sensitivities() ? *this->subsensitivity_sptrs[subset] : *this->sensitivity_sptr;
+      string explanation;
+      if (!target.has_same_characteristics(sensitivity, explanation))
+        {
+          warning(boost::format("Sensitivity cache entry %1% has different characteristics than the target. Recomputing.\n%2%")
+                  % prefix % explanation);
+          this->subsensitivity_sptrs.fill(shared_ptr<TargetT>());
+          return Succeeded::no;
+        }
+    }
+
+  info(boost::format("Read sensitivity from cache entry '%1%'") % prefix);
+  this->set_total_or_subset_sensitivities();
+  return Succeeded::yes;
+}
+
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMean<TargetT>::write_sensitivities_to_cache(const std::string& key) const
+{
+  const std::string prefix = this->get_sensitivity_cache_filename_prefix_for_key(key);
+  try
+    {
+      info(boost::format("Writing sensitivity to cache entry '%1%'") % prefix);
+      if (this->get_use_subset_sensitivities())
+        {
+          for (int subset = 0; subset < this->get_num_subsets(); ++subset)
+            write_to_file(prefix + "_subset" + std::to_string(subset) + ".hv", this->get_subset_sensitivity(subset));
+        }
+      else
+        write_to_file(prefix + ".hv", this->get_sensitivity());
+    }
+  catch (std::exception& e)
+    {
+      warning(boost::format("Error writing sensitivity cache entry %1%:\n%2%") % prefix % e.what());
+      return;
+    }
+
+  // write the key last via a temporary file, such that other processes never see an incomplete entry
+  const std::string key_filename = prefix + ".key";
+  const std::string tmp_filename
+      = key_filename + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+  {
+    std::ofstream key_file(tmp_filename.c_str());
+    key_file << key;
+    if (!key_file)
+      {
+        warning(boost::format("Error writing sensitivity cache file %1%") % tmp_filename);
+        key_file.close();
+        std::remove(tmp_filename.c_str());
+        return;
+      }
+  }
+  if (std::rename(tmp_filename.c_str(), key_filename.c_str()) != 0)
+    {
+      warning(boost::format("Cannot rename %1% to %2%") % tmp_filename % key_filename);
+      std::remove(tmp_filename.c_str());
+    }
+}
+
 template <typename TargetT>
 void
 PoissonLogLikelihoodWithLinearModelForMean<TargetT>::set_total_or_subset_sensitivities()
@@ -30,6 +30,7 @@
 #include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include "stir/Profiler.h"
 #include <boost/format.hpp>
 #include "stir/HighResWallClockTimer.h"
 #include "stir/Viewgram.h"
@@ -450,6 +451,7 @@ bool
 PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<TargetT>::read_listmode_batch(
     unsigned int ibatch) const
 {
+  ProfilerZone profiler_zone("list mode read_listmode_batch");
   double current_time = 0.;
   if (ibatch == 0)
     this->list_mode_data_sptr->reset();
@@ -604,6 +606,7 @@ bool
 PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<TargetT>::load_listmode_batch(
     unsigned int ibatch) const
 {
+  ProfilerZone profiler_zone("list mode load_listmode_batch");
   if (this->cache_lm_file)
     {
       return this->load_listmode_cache_file(ibatch);
@@ -618,6 +621,7 @@ template <typename TargetT>
 Succeeded
 PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<TargetT>::cache_listmode_file()
 {
+  ProfilerZone profiler_zone("list mode cache_listmode_file");
   if (!this->recompute_cache && this->cache_lm_file)
     {
       warning("Looking for existing cache files such as \"" + this->get_cache_filename(0) + "\".\n"
@@ -662,13 +666,45 @@ void
 PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<TargetT>::add_subset_sensitivity(
     TargetT& sensitivity, const int subset_num) const
 {
+  info(boost::format("Calculating sensitivity for subset %1%") % subset_num);
+  this->add_view_subset_sensitivity(sensitivity, subset_num, this->num_subsets);
+}
+
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<TargetT>::add_sensitivity_of_all_subsets(
+    TargetT& sensitivity) const
+{
+  // the union of all subsets is the set of all (basic) views
+  info("Calculating sensitivity for all subsets");
+  this->add_view_subset_sensitivity(sensitivity, 0, 1);
+}
+
+template <typename TargetT>
+std::string
+PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<TargetT>::get_sensitivity_cache_key() const
+{
+  std::ostringstream key;
+  key << "PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin\n"
+      << "projection data:\n"
+      << this->proj_data_info_sptr->parameter_info() << "use time-of-flight sensitivities: " << this->use_tofsens << '\n'
+      << this->get_sensitivity_cache_key_for_exam_info(*this->list_mode_data_sptr->get_exam_info_sptr()) << "projectors:\n"
+      << this->projector_pair_sptr->parameter_info() << "normalisation:\n"
+      << this->normalisation_sptr->parameter_info();
+  return key.str();
+}
+
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<TargetT>::add_view_subset_sensitivity(
+    TargetT& sensitivity, const int subset_num, const int num_subsets) const
+{
+  ProfilerZone profiler_zone("list mode add_subset_sensitivity");
   // TODO replace with call to distributable function
 
   const int min_segment_num = this->proj_data_info_sptr->get_min_segment_num();
   const int max_segment_num = this->proj_data_info_sptr->get_max_segment_num();
 
-  info(boost::format("Calculating sensitivity for subset %1%") % subset_num);
-
   int min_timing_pos_num = use_tofsens ? this->proj_data_info_sptr->get_min_tof_pos_num() : 0;
   int max_timing_pos_num = use_tofsens ? this->proj_data_info_sptr->get_max_tof_pos_num() : 0;
   if (min_timing_pos_num < 0 || max_timing_pos_num > 0)
@@ -688,7 +724,7 @@ PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<Tar
     {
       for (int view = this->sens_proj_data_info_sptr->get_min_view_num() + subset_num;
            view <= this->sens_proj_data_info_sptr->get_max_view_num();
-           view += this->num_subsets)
+           view += num_subsets)
         {
           const ViewSegmentNumbers view_segment_num(view, segment_num);
 
@@ -875,6 +911,7 @@ double
 PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<
     TargetT>::actual_compute_objective_function_without_penalty(const TargetT& current_estimate, const int subset_num)
 {
+  ProfilerZone profiler_zone("list mode actual_compute_objective_function_without_penalty");
   assert(subset_num >= 0);
   assert(subset_num < this->num_subsets);
   if (!this->get_use_subset_sensitivities() && this->num_subsets > 1)
@@ -917,6 +954,7 @@ PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<
                                                              const int subset_num,
                                                              const bool add_sensitivity)
 {
+  ProfilerZone profiler_zone("list mode actual_compute_subset_gradient_without_penalty");
   assert(subset_num >= 0);
   assert(subset_num < this->num_subsets);
   if (!add_sensitivity && !this->get_use_subset_sensitivities() && this->num_subsets > 1)
@@ -967,6 +1005,7 @@ PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<
                                                                         const TargetT& rhs,
                                                                         const int subset_num) const
 {
+  ProfilerZone profiler_zone("list mode actual_accumulate_sub_Hessian_times_input_without_penalty");
   { // check characteristics
 
     std::string explanation;
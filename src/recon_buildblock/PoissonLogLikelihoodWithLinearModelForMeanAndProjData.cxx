@@ -59,6 +59,7 @@
 #include "stir/Viewgram.h"
 #include "stir/recon_array_functions.h"
 #include "stir/is_null_ptr.h"
+#include "stir/Profiler.h"
 #include <iostream>
 #include <algorithm>
 #include <functional>
@@ -827,6 +828,44 @@ template <typename TargetT>
 void
 PoissonLogLikelihoodWithLinearModelForMeanAndProjData<TargetT>::add_subset_sensitivity(TargetT& sensitivity,
                                                                                        const int subset_num) const
+{
+  this->add_view_subset_sensitivity(sensitivity, subset_num, this->num_subsets);
+}
+
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndProjData<TargetT>::add_sensitivity_of_all_subsets(TargetT& sensitivity) const
+{
+  // the union of all subsets is the set of all (basic) views, but the distributed cache works per subset
+  if (this->distributed_cache_enabled)
+    base_type::add_sensitivity_of_all_subsets(sensitivity);
+  else
+    this->add_view_subset_sensitivity(sensitivity, 0, 1);
+}
+
+template <typename TargetT>
+std::string
+PoissonLogLikelihoodWithLinearModelForMeanAndProjData<TargetT>::get_sensitivity_cache_key() const
+{
+  std::ostringstream key;
+  key << "PoissonLogLikelihoodWithLinearModelForMeanAndProjData\n"
+      << "projection data:\n"
+      << this->sens_proj_data_info_sptr->parameter_info() << "maximum absolute segment number to process: "
+      << this->max_segment_num_to_process << "\nuse time-of-flight sensitivities: " << this->use_tofsens
+      << "\nmaximum absolute timing position number to process: " << this->max_timing_pos_num_to_process
+      << "\nzero end planes of segment 0: " << this->zero_seg0_end_planes << "\ntime frame: " << this->frame_num << '\n'
+      << this->get_sensitivity_cache_key_for_exam_info(*this->proj_data_sptr->get_exam_info_sptr())
+      << "projectors:\n"
+      << this->projector_pair_ptr->parameter_info() << "normalisation:\n"
+      << this->normalisation_sptr->parameter_info();
+  return key.str();
+}
+
+template <typename TargetT>
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndProjData<TargetT>::add_view_subset_sensitivity(TargetT& sensitivity,
+                                                                                            const int subset_num,
+                                                                                            const int num_subsets) const
 {
   const int min_segment_num = -this->max_segment_num_to_process;
   const int max_segment_num = this->max_segment_num_to_process;
@@ -880,7 +919,7 @@ PoissonLogLikelihoodWithLinearModelForMeanAndProjData<TargetT>::add_subset_sensi
                                         sensitivity,
                                         sens_proj_data_sptr,
                                         subset_num,
-                                        this->num_subsets,
+                                        num_subsets,
                                         min_segment_num,
                                         max_segment_num,
                                         this->zero_seg0_end_planes != 0,
@@ -1408,6 +1447,7 @@ RPC_process_related_viewgrams_gradient(const shared_ptr<ForwardProjectorByBin>&
                                        const RelatedViewgrams<float>* additive_binwise_correction_ptr,
                                        const RelatedViewgrams<float>* mult_viewgrams_ptr)
 {
+  ProfilerZone profiler_zone("RPC_process_related_viewgrams_gradient");
   assert(measured_viewgrams_ptr != NULL);
 
   RelatedViewgrams<float> estimated_viewgrams = measured_viewgrams_ptr->get_empty_copy();
@@ -1469,6 +1509,7 @@ RPC_process_related_viewgrams_accumulate_loglikelihood(const shared_ptr<ForwardP
                                                        const RelatedViewgrams<float>* additive_binwise_correction_ptr,
                                                        const RelatedViewgrams<float>* mult_viewgrams_ptr)
 {
+  ProfilerZone profiler_zone("RPC_process_related_viewgrams_accumulate_loglikelihood");
   assert(measured_viewgrams_ptr != NULL);
   assert(log_likelihood_ptr != NULL);
 
@@ -1503,6 +1544,7 @@ RPC_process_related_viewgrams_sensitivity_computation(const shared_ptr<ForwardPr
                                                       const RelatedViewgrams<float>* additive_binwise_correction_ptr,
                                                       const RelatedViewgrams<float>* mult_viewgrams_ptr)
 {
+  ProfilerZone profiler_zone("RPC_process_related_viewgrams_sensitivity_computation");
   assert(measured_viewgrams_ptr != NULL);
 
   if (mult_viewgrams_ptr)
@@ -26,7 +26,10 @@
 
 #include "stir/recon_buildblock/ProjMatrixByBin.h"
 #include "stir/recon_buildblock/ProjMatrixElemsForOneBin.h"
+#include "stir/recon_buildblock/SymmetryOperation.h"
+#include "stir/IndexRange2D.h"
 #include "stir/TOF_conversions.h"
+#include "stir/MemoryUsage.h"
 
 START_NAMESPACE_STIR
 
@@ -57,6 +60,11 @@ ProjMatrixByBin::ProjMatrixByBin()
   set_defaults();
 }
 
+ProjMatrixByBin::~ProjMatrixByBin()
+{
+  MemoryUsage::add_deallocation(MemoryUsage::proj_matrix_cache, this->get_cache_size_in_bytes());
+}
+
 void
 ProjMatrixByBin::enable_cache(const bool v)
 {
@@ -98,13 +106,34 @@ ProjMatrixByBin::clear_cache() const
 #ifdef STIR_OPENMP
 #  pragma omp critical(PROJMATRIXBYBINCLEARCACHE)
 #endif
+  {
+    MemoryUsage::add_deallocation(MemoryUsage::proj_matrix_cache, this->get_cache_size_in_bytes());
+    for (int i = this->cache_collection.get_min_index(); i <= this->cache_collection.get_max_index(); ++i)
+      {
+        for (int j = this->cache_collection[i].get_min_index(); j <= this->cache_collection[i].get_max_index(); ++j)
+          {
+            this->cache_collection[i][j].clear();
+            this->tof_kernel_cache_collection[i][j].clear();
+          }
+      }
+  }
+}
+
+std::size_t
+ProjMatrixByBin::get_cache_size_in_bytes() const
+{
+  std::size_t num_elements = 0;
   for (int i = this->cache_collection.get_min_index(); i <= this->cache_collection.get_max_index(); ++i)
-    {
-      for (int j = this->cache_collection[i].get_min_index(); j <= this->cache_collection[i].get_max_index(); ++j)
-        {
-          this->cache_collection[i][j].clear();
-        }
-    }
+    for (int j = this->cache_collection[i].get_min_index(); j <= this->cache_collection[i].get_max_index(); ++j)
+      for (const auto& key_and_elems : this->cache_collection[i][j])
+        num_elements += key_and_elems.second.size();
+  std::size_t num_kernel_values = 0;
+  for (int i = this->tof_kernel_cache_collection.get_min_index(); i <= this->tof_kernel_cache_collection.get_max_index(); ++i)
+    for (int j = this->tof_kernel_cache_collection[i].get_min_index(); j <= this->tof_kernel_cache_collection[i].get_max_index();
+         ++j)
+      for (const auto& key_and_kernel : this->tof_kernel_cache_collection[i][j])
+        num_kernel_values += key_and_kernel.second->size_all();
+  return num_elements * sizeof(ProjMatrixElemsForOneBin::value_type) + num_kernel_values * sizeof(float);
 }
 
 /*
@@ -154,8 +183,11 @@ ProjMatrixByBin::set_up(const shared_ptr<const ProjDataInfo>& proj_data_info_spt
       tof_enabled = false;
     }
 
+  MemoryUsage::add_deallocation(MemoryUsage::proj_matrix_cache, this->get_cache_size_in_bytes());
   this->cache_collection.recycle();
   this->cache_collection.resize(min_view_num, max_view_num);
+  this->tof_kernel_cache_collection.recycle();
+  this->tof_kernel_cache_collection.resize(min_view_num, max_view_num);
 #ifdef STIR_OPENMP
   this->cache_locks.recycle();
   this->cache_locks.resize(min_view_num, max_view_num);
@@ -164,6 +196,7 @@ ProjMatrixByBin::set_up(const shared_ptr<const ProjDataInfo>& proj_data_info_spt
   for (int view_num = min_view_num; view_num <= max_view_num; ++view_num)
     {
       this->cache_collection[view_num].resize(min_segment_num, max_segment_num);
+      this->tof_kernel_cache_collection[view_num].resize(min_segment_num, max_segment_num);
 #ifdef STIR_OPENMP
       this->cache_locks[view_num].resize(min_segment_num, max_segment_num);
       for (int seg_num = min_segment_num; seg_num <= max_segment_num; ++seg_num)
@@ -198,8 +231,27 @@ ProjMatrixByBin::cache_key(const Bin& bin) const
       | (static_cast<CacheKey>(abs(bin.timing_pos_num()))));
 }
 
+/*!
+  Uses the same bits as cache_key() for a bin with timing position 0, and sets
+  the (otherwise unused) most significant bit, such that geometric and TOF rows
+  can be stored in the same cache.
+*/
+ProjMatrixByBin::CacheKey
+ProjMatrixByBin::geometric_cache_key(const Bin& bin) const
+{
+  Bin non_tof_bin = bin;
+  non_tof_bin.timing_pos_num() = 0;
+  return cache_key(non_tof_bin) | (static_cast<CacheKey>(1) << (timing_pos_bits + tang_pos_bits + axial_pos_bits + 3));
+}
+
 void
 ProjMatrixByBin::cache_proj_matrix_elems_for_one_bin(const ProjMatrixElemsForOneBin& probabilities) const
+{
+  cache_proj_matrix_elems_for_one_bin(probabilities, cache_key(probabilities.get_bin()));
+}
+
+void
+ProjMatrixByBin::cache_proj_matrix_elems_for_one_bin(const ProjMatrixElemsForOneBin& probabilities, const CacheKey key) const
 {
   if (cache_disabled)
     return;
@@ -210,29 +262,37 @@ ProjMatrixByBin::cache_proj_matrix_elems_for_one_bin(const ProjMatrixElemsForOne
 #ifdef STIR_OPENMP
   omp_set_lock(&this->cache_locks[bin.view_num()][bin.segment_num()]);
 #endif
-  cache_collection[bin.view_num()][bin.segment_num()].insert(
-      MapProjMatrixElemsForOneBin::value_type(cache_key(bin), probabilities));
+  MapProjMatrixElemsForOneBin& cache_for_view_segment = cache_collection[bin.view_num()][bin.segment_num()];
+  const bool inserted = cache_for_view_segment.insert(MapProjMatrixElemsForOneBin::value_type(key, probabilities)).second;
 #ifdef STIR_OPENMP
   omp_unset_lock(&this->cache_locks[bin.view_num()][bin.segment_num()]);
 #endif
+  if (inserted)
+    MemoryUsage::add_allocation(MemoryUsage::proj_matrix_cache,
+                                probabilities.size() * sizeof(ProjMatrixElemsForOneBin::value_type));
 }
 
 Succeeded
 ProjMatrixByBin::get_cached_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneBin& probabilities) const
 {
-  if (cache_disabled)
-    return Succeeded::no;
-
-  const Bin bin = probabilities.get_bin();
-
 #ifndef NDEBUG
-  if (cache_stores_only_basic_bins)
+  if (!cache_disabled && cache_stores_only_basic_bins)
     {
       // Check that this is a 'basic' coordinate
-      Bin bin_copy = bin;
+      Bin bin_copy = probabilities.get_bin();
       assert(symmetries_sptr->find_basic_bin(bin_copy) == 0);
     }
 #endif
+  return get_cached_proj_matrix_elems_for_one_bin(probabilities, cache_key(probabilities.get_bin()));
+}
+
+Succeeded
+ProjMatrixByBin::get_cached_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneBin& probabilities, const CacheKey key) const
+{
+  if (cache_disabled)
+    return Succeeded::no;
+
+  const Bin bin = probabilities.get_bin();
 
   bool found = false;
 #ifdef STIR_OPENMP
@@ -240,7 +300,7 @@ ProjMatrixByBin::get_cached_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneB
 #endif
 
   {
-    const_MapProjMatrixElemsForOneBinIterator pos = cache_collection[bin.view_num()][bin.segment_num()].find(cache_key(bin));
+    const_MapProjMatrixElemsForOneBinIterator pos = cache_collection[bin.view_num()][bin.segment_num()].find(key);
 
     if (pos != cache_collection[bin.view_num()][bin.segment_num()].end())
       {
@@ -263,6 +323,146 @@ ProjMatrixByBin::get_cached_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneB
     }
 }
 
+void
+ProjMatrixByBin::get_proj_matrix_elems_and_tof_kernel_for_one_bin(ProjMatrixElemsForOneBin& probabilities,
+                                                                  shared_ptr<const Array<2, float>>& tof_kernel_sptr,
+                                                                  const Bin& bin) const
+{
+  probabilities.erase();
+
+  // find symmetry operator and basic bin (using a non-TOF bin, as we handle all TOF bins here)
+  Bin basic_bin = bin;
+  basic_bin.timing_pos_num() = 0;
+  unique_ptr<SymmetryOperation> symm_ptr = symmetries_sptr->find_symmetry_operation_from_basic_bin(basic_bin);
+  probabilities.set_bin(basic_bin);
+
+  if (!(proj_data_info_sptr->is_tof_data() && this->tof_enabled))
+    {
+      if (get_cached_proj_matrix_elems_for_one_bin(probabilities) == Succeeded::no)
+        {
+          calculate_proj_matrix_elems_for_one_bin(probabilities);
+#ifndef NDEBUG
+          probabilities.check_state();
+#endif
+          if (cache_stores_only_basic_bins)
+            cache_proj_matrix_elems_for_one_bin(probabilities);
+        }
+      symm_ptr->transform_proj_matrix_elems_for_one_bin(probabilities);
+      shared_ptr<Array<2, float>> ones_sptr(
+          new Array<2, float>(IndexRange2D(0, 0, 0, static_cast<int>(probabilities.size()) - 1)));
+      ones_sptr->fill(1.F);
+      tof_kernel_sptr = ones_sptr;
+      return;
+    }
+
+  get_basic_geometric_proj_matrix_elems_for_one_bin(probabilities);
+  const shared_ptr<const Array<2, float>> basic_tof_kernel_sptr = get_basic_tof_kernel(probabilities);
+
+  // Symmetries might change the sign of the timing position.
+  // Find out what happens by transforming a bin with timing position 1.
+  int timing_pos_sign;
+  {
+    Bin tof_bin = basic_bin;
+    tof_bin.timing_pos_num() = 1;
+    symm_ptr->transform_bin_coordinates(tof_bin);
+    timing_pos_sign = tof_bin.timing_pos_num();
+    assert(timing_pos_sign == 1 || timing_pos_sign == -1);
+  }
+  if (timing_pos_sign == 1)
+    tof_kernel_sptr = basic_tof_kernel_sptr;
+  else
+    {
+      // TOF positions are symmetric around 0, so we can just swap rows
+      shared_ptr<Array<2, float>> flipped_sptr(new Array<2, float>(basic_tof_kernel_sptr->get_index_range()));
+      for (int t = flipped_sptr->get_min_index(); t <= flipped_sptr->get_max_index(); ++t)
+        (*flipped_sptr)[t] = (*basic_tof_kernel_sptr)[-t];
+      tof_kernel_sptr = flipped_sptr;
+    }
+
+  // now transform to original bin (the order of the elements is unchanged)
+  symm_ptr->transform_proj_matrix_elems_for_one_bin(probabilities);
+}
+
+shared_ptr<const Array<2, float>>
+ProjMatrixByBin::get_basic_tof_kernel(const ProjMatrixElemsForOneBin& basic_probabilities) const
+{
+  const Bin bin = basic_probabilities.get_bin();
+  const CacheKey key = geometric_cache_key(bin);
+  shared_ptr<const Array<2, float>> tof_kernel_sptr;
+  if (!cache_disabled)
+    {
+#ifdef STIR_OPENMP
+      omp_set_lock(&this->cache_locks[bin.view_num()][bin.segment_num()]);
+#endif
+      const MapTOFKernel& cache_for_view_segment = tof_kernel_cache_collection[bin.view_num()][bin.segment_num()];
+      const auto pos = cache_for_view_segment.find(key);
+      if (pos != cache_for_view_segment.end())
+        tof_kernel_sptr = pos->second;
+#ifdef STIR_OPENMP
+      omp_unset_lock(&this->cache_locks[bin.view_num()][bin.segment_num()]);
+#endif
+      if (tof_kernel_sptr)
+        return tof_kernel_sptr;
+    }
+
+  shared_ptr<Array<2, float>> new_tof_kernel_sptr(new Array<2, float>);
+  compute_tof_kernel(*new_tof_kernel_sptr, basic_probabilities);
+  tof_kernel_sptr = new_tof_kernel_sptr;
+
+  if (!cache_disabled && cache_stores_only_basic_bins)
+    {
+#ifdef STIR_OPENMP
+      omp_set_lock(&this->cache_locks[bin.view_num()][bin.segment_num()]);
+#endif
+      MapTOFKernel& cache_for_view_segment = tof_kernel_cache_collection[bin.view_num()][bin.segment_num()];
+      const bool inserted = cache_for_view_segment.insert(MapTOFKernel::value_type(key, tof_kernel_sptr)).second;
+#ifdef STIR_OPENMP
+      omp_unset_lock(&this->cache_locks[bin.view_num()][bin.segment_num()]);
+#endif
+      if (inserted)
+        MemoryUsage::add_allocation(MemoryUsage::proj_matrix_cache, tof_kernel_sptr->size_all() * sizeof(float));
+    }
+  return tof_kernel_sptr;
+}
+
+void
+ProjMatrixByBin::compute_tof_kernel(Array<2, float>& tof_kernel, const ProjMatrixElemsForOneBin& basic_probabilities) const
+{
+  const int min_timing_pos_num = proj_data_info_sptr->get_min_tof_pos_num();
+  const int max_timing_pos_num = proj_data_info_sptr->get_max_tof_pos_num();
+  const int num_elements = static_cast<int>(basic_probabilities.size());
+
+  tof_kernel.resize(IndexRange2D(min_timing_pos_num, max_timing_pos_num, 0, num_elements - 1));
+
+  // same geometry as in apply_tof_kernel()
+  LORInAxialAndNoArcCorrSinogramCoordinates<float> lor;
+  proj_data_info_sptr->get_LOR(lor, basic_probabilities.get_bin());
+  const LORAs2Points<float> lor2(lor);
+  const CartesianCoordinate3D<float> point1 = lor2.p1();
+  const CartesianCoordinate3D<float> point2 = lor2.p2();
+
+  const CartesianCoordinate3D<float> middle = (point1 + point2) * 0.5f;
+  const CartesianCoordinate3D<float> diff = point2 - middle;
+  const CartesianCoordinate3D<float> diff_unit_vector(diff / static_cast<float>(norm(diff)));
+
+  int i = 0;
+  for (ProjMatrixElemsForOneBin::const_iterator element_ptr = basic_probabilities.begin();
+       element_ptr != basic_probabilities.end();
+       ++element_ptr, ++i)
+    {
+      // the distance along the LOR is the same for all TOF bins
+      const Coordinate3D<int> c(element_ptr->get_coords());
+      const float d2 = -inner_product(image_info_sptr->get_physical_coordinates_for_indices(c) - middle, diff_unit_vector);
+
+      for (int timing_pos_num = min_timing_pos_num; timing_pos_num <= max_timing_pos_num; ++timing_pos_num)
+        {
+          const float low_dist = proj_data_info_sptr->tof_bin_boundaries_mm[timing_pos_num].low_lim - d2;
+          const float high_dist = proj_data_info_sptr->tof_bin_boundaries_mm[timing_pos_num].high_lim - d2;
+          tof_kernel[timing_pos_num][i] = get_tof_value(low_dist, high_dist);
+        }
+    }
+}
+
 // TODO
 
 //////////////////////////////////////////////////////////////////////////
@@ -117,6 +117,7 @@ ProjMatrixByBinPinholeSPECTUB::initialise_keymap()
   parser.add_key("mask file", &mask_file);
   parser.add_key("mask from attenuation map", &mask_from_attenuation_map);
   parser.add_key("keep all views in cache", &keep_all_views_in_cache);
+  parser.add_key("precompute all views", &precompute_all_views);
 
   parser.add_stop_key("End Projection Matrix By Bin Pinhole SPECT UB Parameters");
 }
@@ -129,6 +130,7 @@ ProjMatrixByBinPinholeSPECTUB::set_defaults()
   this->already_setup = false;
 
   this->keep_all_views_in_cache = false;
+  this->precompute_all_views = false;
   minimum_weight = 0.0;
   maximum_number_of_sigmas = 2.;
   spatial_resolution_PSF = 0.001;
@@ -440,6 +442,22 @@ ProjMatrixByBinPinholeSPECTUB::set_keep_all_views_in_cache(bool value)
     }
 }
 
+bool
+ProjMatrixByBinPinholeSPECTUB::get_precompute_all_views() const
+{
+  return this->precompute_all_views;
+}
+
+void
+ProjMatrixByBinPinholeSPECTUB::set_precompute_all_views(bool value)
+{
+  if (this->precompute_all_views != value)
+    {
+      this->precompute_all_views = value;
+      this->already_setup = false;
+    }
+}
+
 //******************** actual implementation *************
 
 void
@@ -787,26 +805,13 @@ ProjMatrixByBinPinholeSPECTUB::set_up(
 
           psf_aux.max_dimx = psf_aux.dimx = psf_subs.max_dimx;
           psf_aux.max_dimz = psf_aux.dimz = psf_subs.max_dimz;
-
-          psf_aux.val = new float*[psf_aux.max_dimz];
-
-          for (int i = 0; i < psf_aux.max_dimz; i++)
-            psf_aux.val[i] = new float[psf_aux.max_dimx];
         }
 
-      psf_subs.val = new float*[psf_subs.max_dimz];
-
-      for (int i = 0; i < psf_subs.max_dimz; i++)
-        psf_subs.val[i] = new float[psf_subs.max_dimx];
-
       psf_bin.max_dimx = psf_subs.max_dimx / wmh.subsamp + 2;
       psf_bin.max_dimz = psf_subs.max_dimz / wmh.subsamp + 2;
     }
 
-  psf_bin.val = new float*[psf_bin.max_dimz];
-
-  for (int i = 0; i < psf_bin.max_dimz; i++)
-    psf_bin.val[i] = new float[psf_bin.max_dimx];
+  //... the psf values are allocated in wm_calculation_for_one_subset() ..........
 
   //... size estimation .........................................................
 
@@ -819,42 +824,44 @@ ProjMatrixByBinPinholeSPECTUB::set_up(
         Nitems[kOS][i] = 1; // Nitems initializated to one
     }
 
-  //... double array wm.val and wm.col .....................................................
-
-  if ((wm.val = new (nothrow) float*[wmh.prj.NbOS]) == nullptr)
-    error(
-        "Error allocating space to store values for SPECTUB matrix"); // error_wmtools_SPECT_mph( 200, wmh.prj.NbOS, "wm.val[]" );
-
-  if ((wm.col = new (nothrow) int*[wmh.prj.NbOS]) == nullptr)
-    error("Error allocating space to store column indices for SPECTUB matrix"); // error_wmtools_SPECT_mph( 200, wmh.prj.NbOS,
-                                                                                // "wm.col[]" );
-
-  //... array wm.ne .........................................................................
-
-  if ((wm.ne = new (nothrow) int[wmh.prj.NbOS + 1]) == 0)
-    error("Error allocating space to store number of elements for SPECTUB matrix"); // error_wmtools_SPECT_mph(200, wmh.prj.NbOS +
-                                                                                    // 1, "wm.ne[]");
-
-  // allocate memory for weight matrix
-  if (wm.do_save_STIR)
-    {
-      wm.ns = new int[wmh.prj.NbOS];
-      wm.nb = new int[wmh.prj.NbOS];
-      wm.na = new int[wmh.prj.NbOS];
-
-      wm.nx = new short int[wmh.vol.Nvox];
-      wm.ny = new short int[wmh.vol.Nvox];
-      wm.nz = new short int[wmh.vol.Nvox];
-    }
+  //... the weight matrix arrays (wm.val, wm.col etc) are allocated for each view in compute_one_subset()
 
   // size estimation
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
   for (int kOS = 0; kOS < wmh.prj.NOS; kOS++)
     {
-      wm_calculation_mph(false, kOS, &psf_bin, &psf_subs, &psf_aux, &kern, attmap, msk_3d, Nitems[kOS], wmh, wm, pcf);
+      wm_da_type wm_for_subset = wm;
+      wm_calculation_for_one_subset(false, kOS, wm_for_subset);
     }
   info(boost::format("Done estimating size of matrix. Execution time, CPU %1% s") % timer.value(), 2);
 
+  subset_status.assign(wmh.prj.NOS, subset_not_computed);
+#ifdef STIR_OPENMP
+  subset_locks.resize(wmh.prj.NOS);
+  for (auto& lock : subset_locks)
+    omp_init_lock(&lock);
+#endif
   this->already_setup = true;
+
+  if (this->precompute_all_views)
+    {
+      if (!this->keep_all_views_in_cache)
+        warning("Pinhole SPECTUB matrix: precompute all views is ignored as keep all views in cache is not set");
+      else
+        {
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+          for (int kOS = 0; kOS < wmh.prj.NOS; kOS++)
+            {
+              compute_one_subset(kOS);
+              subset_status[kOS] = subset_computed;
+            }
+          info(boost::format("Done computing all views of the matrix. Execution time, CPU %1% s") % timer.value(), 2);
+        }
+    }
 }
 
 ProjMatrixByBinPinholeSPECTUB*
@@ -877,22 +884,6 @@ ProjMatrixByBinPinholeSPECTUB::delete_PinholeSPECTUB_arrays()
   if (!this->already_setup)
     return;
 
-  //... freeing matrix memory....................................
-
-  delete[] wm.val;
-  delete[] wm.col;
-  delete[] wm.ne;
-
-  if (wm.do_save_STIR)
-    {
-      delete[] wm.ns;
-      delete[] wm.nb;
-      delete[] wm.na;
-      delete[] wm.nx;
-      delete[] wm.ny;
-      delete[] wm.nz;
-    }
-
   //... freeing pre-calculated functions ....................................
 
   if (wmh.do_round_cumsum)
@@ -914,27 +905,11 @@ ProjMatrixByBinPinholeSPECTUB::delete_PinholeSPECTUB_arrays()
 
   //... freeing memory ....................................
 
-  for (int i = 0; i < psf_bin.max_dimz; i++)
-    delete[] psf_bin.val[i];
-  delete[] psf_bin.val;
-
-  if (wmh.do_subsamp)
-    {
-      for (int i = 0; i < psf_subs.max_dimz; i++)
-        delete[] psf_subs.val[i];
-      delete[] psf_subs.val;
-    }
-
-  if (wmh.do_psfi)
+  if (wmh.do_subsamp && wmh.do_psfi)
     {
       for (int i = 0; i < kern.max_dimz; i++)
         delete[] kern.val[i];
       delete[] kern.val;
-
-      // original code did not deallocate psf_aux.val, possible memory leak
-      for (int i = 0; i < psf_aux.max_dimz; i++)
-        delete[] psf_aux.val[i];
-      delete[] psf_aux.val;
     }
 
   for (int kOS = 0; kOS < wmh.prj.NOS; kOS++)
@@ -947,6 +922,59 @@ ProjMatrixByBinPinholeSPECTUB::delete_PinholeSPECTUB_arrays()
   delete[] msk_3d;
 }
 
+namespace
+{
+//! copy of a psf2d_type with its own memory for the values
+class PSF2DWorkSpace
+{
+public:
+  PSF2DWorkSpace(const SPECTUB_mph::psf2d_type& psf_sizes, const bool allocate)
+      : psf(psf_sizes)
+  {
+    psf.val = nullptr;
+    if (!allocate)
+      return;
+    values.assign(psf.max_dimz, std::vector<float>(psf.max_dimx));
+    rows.resize(psf.max_dimz);
+    for (int i = 0; i < psf.max_dimz; i++)
+      rows[i] = values[i].data();
+    psf.val = rows.data();
+  }
+  PSF2DWorkSpace(const PSF2DWorkSpace&) = delete;
+  PSF2DWorkSpace& operator=(const PSF2DWorkSpace&) = delete;
+
+  SPECTUB_mph::psf2d_type psf;
+
+private:
+  std::vector<std::vector<float>> values;
+  std::vector<float*> rows;
+};
+} // namespace
+
+void
+ProjMatrixByBinPinholeSPECTUB::wm_calculation_for_one_subset(const bool do_calc, const int kOS, wm_da_type& wm_for_subset) const
+{
+  // use local psf arrays such that different views can be computed in parallel
+  PSF2DWorkSpace local_psf_bin(psf_bin, true);
+  PSF2DWorkSpace local_psf_subs(psf_subs, wmh.do_subsamp);
+  PSF2DWorkSpace local_psf_aux(psf_aux, wmh.do_subsamp && wmh.do_psfi);
+  // the values of the intrinsic kernel are only read, so can be shared
+  psf2d_type local_kern = kern;
+
+  wm_calculation_mph(do_calc,
+                     kOS,
+                     &local_psf_bin.psf,
+                     &local_psf_subs.psf,
+                     &local_psf_aux.psf,
+                     &local_kern,
+                     attmap,
+                     msk_3d,
+                     Nitems[kOS],
+                     wmh,
+                     wm_for_subset,
+                     pcf);
+}
+
 void
 ProjMatrixByBinPinholeSPECTUB::compute_one_subset(const int kOS) const
 {
@@ -964,13 +992,37 @@ ProjMatrixByBinPinholeSPECTUB::compute_one_subset(const int kOS) const
            % (wm.do_save_STIR ? (ne + 10 * wmh.prj.NbOS) / 104857.6 : ne / 131072),
        2);
 
-  //... memory allocation for wm float arrays ....................................................
+  //... memory allocation for wm arrays (initialised to zero) ....................................
 
-  wm_alloc(Nitems[kOS], wm, wmh);
+  // we use a local copy of wm (with its own arrays) such that different views can be computed in parallel
+  wm_da_type wm_for_subset = wm;
+  std::vector<std::vector<float>> val(wmh.prj.NbOS);
+  std::vector<std::vector<int>> col(wmh.prj.NbOS);
+  std::vector<float*> val_ptrs(wmh.prj.NbOS);
+  std::vector<int*> col_ptrs(wmh.prj.NbOS);
+  for (int i = 0; i < wmh.prj.NbOS; i++)
+    {
+      val[i].resize(Nitems[kOS][i]);
+      col[i].resize(Nitems[kOS][i]);
+      val_ptrs[i] = val[i].data();
+      col_ptrs[i] = col[i].data();
+    }
+  std::vector<int> ne_for_rows(wmh.prj.NbOS + 1, 0);
+  std::vector<int> na(wmh.prj.NbOS), nb(wmh.prj.NbOS), ns(wmh.prj.NbOS);
+  std::vector<short int> nx(wmh.vol.Nvox), ny(wmh.vol.Nvox), nz(wmh.vol.Nvox);
+  wm_for_subset.val = val_ptrs.data();
+  wm_for_subset.col = col_ptrs.data();
+  wm_for_subset.ne = ne_for_rows.data();
+  wm_for_subset.na = na.data();
+  wm_for_subset.nb = nb.data();
+  wm_for_subset.ns = ns.data();
+  wm_for_subset.nx = nx.data();
+  wm_for_subset.ny = ny.data();
+  wm_for_subset.nz = nz.data();
 
   //... wm calculation ...............................................................................
 
-  wm_calculation_mph(true, kOS, &psf_bin, &psf_subs, &psf_aux, &kern, attmap, msk_3d, Nitems[kOS], wmh, wm, pcf);
+  wm_calculation_for_one_subset(true, kOS, wm_for_subset);
   info(boost::format("Weight matrix calculation done, CPU %1% s") % timer.value(), 2);
 
   //... fill lor ..........................
@@ -979,23 +1031,22 @@ ProjMatrixByBinPinholeSPECTUB::compute_one_subset(const int kOS) const
       ProjMatrixElemsForOneBin lor;
       Bin bin;
       bin.segment_num() = 0;
-      bin.view_num() = wm.na[j];
-      bin.axial_pos_num() = wm.ns[j];
-      bin.tangential_pos_num() = wm.nb[j];
+      bin.view_num() = wm_for_subset.na[j];
+      bin.axial_pos_num() = wm_for_subset.ns[j];
+      bin.tangential_pos_num() = wm_for_subset.nb[j];
       bin.set_bin_value(0);
       lor.set_bin(bin);
 
-      lor.reserve(wm.ne[j]);
-      for (int i = 0; i < wm.ne[j]; i++)
+      lor.reserve(wm_for_subset.ne[j]);
+      for (int i = 0; i < wm_for_subset.ne[j]; i++)
         {
-
-          const ProjMatrixElemsForOneBin::value_type elem(
-              Coordinate3D<int>(wm.nz[wm.col[j][i]], wm.ny[wm.col[j][i]], wm.nx[wm.col[j][i]]), wm.val[j][i]);
+          const int iv = wm_for_subset.col[j][i];
+          const ProjMatrixElemsForOneBin::value_type elem(Coordinate3D<int>(nz[iv], ny[iv], nx[iv]), wm_for_subset.val[j][i]);
           lor.push_back(elem);
         }
-
-      delete[] wm.val[j];
-      delete[] wm.col[j];
+      // free memory for this row
+      std::vector<float>().swap(val[j]);
+      std::vector<int>().swap(col[j]);
 
       this->cache_proj_matrix_elems_for_one_bin(lor);
     }
@@ -1008,17 +1059,48 @@ ProjMatrixByBinPinholeSPECTUB::calculate_proj_matrix_elems_for_one_bin(ProjMatri
 {
   const int view_num = lor.get_bin().view_num();
 
+  if (!this->keep_all_views_in_cache)
+    {
+      // only a single view is kept in memory (and set_up() made sure we use only 1 thread)
+      if (subset_status[view_num] != subset_computed)
+        {
+          this->clear_cache();
+          subset_status.assign(wmh.prj.NOS, subset_not_computed);
+          info(boost::format("Computing matrix elements for view %1%") % view_num, 2);
+          compute_one_subset(view_num);
+          subset_status[view_num] = subset_computed;
+        }
+    }
+  else
+    {
+      // compute this view if necessary. Other threads that need the same view wait for the lock of the view.
 #ifdef STIR_OPENMP
-#  pragma omp critical(PROJMATRIXBYBINUBONEVIEW)
+      omp_set_lock(&subset_locks[view_num]);
 #endif
-
-  if (!this->keep_all_views_in_cache)
-    this->clear_cache();
-
-  info(boost::format("Computing matrix elements for view %1%") % view_num, 2);
-  compute_one_subset(view_num);
-
-  lor.erase();
+      try
+        {
+          if (subset_status[view_num] != subset_computed)
+            {
+              info(boost::format("Computing matrix elements for view %1%") % view_num, 2);
+              compute_one_subset(view_num);
+              subset_status[view_num] = subset_computed;
+            }
+        }
+      catch (...)
+        {
+          // the view is still marked as not computed, such that another call can retry
+#ifdef STIR_OPENMP
+          omp_unset_lock(&subset_locks[view_num]);
+#endif
+          throw;
+        }
+#ifdef STIR_OPENMP
+      omp_unset_lock(&subset_locks[view_num]);
+#endif
+    }
+  // the elements for this bin are now in the cache
+  if (this->get_cached_proj_matrix_elems_for_one_bin(lor) == Succeeded::no)
+    lor.erase();
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -34,6 +34,9 @@
 #include "stir/warning.h"
 #include "stir/error.h"
 #include "stir/CPUTimer.h"
+#include "stir/FilePath.h"
+#include "stir/Array.h"
+#include "stir/spatial_transformation/InvertAxis.h"
 #ifdef STIR_OPENMP
 #  include "stir/num_threads.h"
 #endif
@@ -43,6 +46,7 @@
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/cstdint.hpp>
 
 #include <fstream>
 #include <sstream>
@@ -51,6 +55,9 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
 #include <stdlib.h>
 #include <math.h>
 #include <ctype.h>
@@ -88,6 +95,8 @@ ProjMatrixByBinSPECTUB::initialise_keymap()
   parser.add_key("mask type", &mask_type);
   parser.add_key("mask file", &mask_file);
   parser.add_key("keep_all_views_in_cache", &keep_all_views_in_cache);
+  parser.add_key("precompute_all_views", &precompute_all_views);
+  parser.add_key("matrix cache directory", &matrix_cache_directory);
 
   parser.add_stop_key("End Projection Matrix By Bin SPECT UB Parameters");
 }
@@ -100,6 +109,8 @@ ProjMatrixByBinSPECTUB::set_defaults()
   this->already_setup = false;
 
   this->keep_all_views_in_cache = false;
+  this->precompute_all_views = false;
+  this->matrix_cache_directory = "";
   minimum_weight = 0.0;
   maximum_number_of_sigmas = 2.;
   spatial_resolution_PSF = 0.00001;
@@ -145,6 +156,38 @@ ProjMatrixByBinSPECTUB::set_keep_all_views_in_cache(bool value)
     }
 }
 
+bool
+ProjMatrixByBinSPECTUB::get_precompute_all_views() const
+{
+  return this->precompute_all_views;
+}
+
+void
+ProjMatrixByBinSPECTUB::set_precompute_all_views(bool value)
+{
+  if (this->precompute_all_views != value)
+    {
+      this->precompute_all_views = value;
+      this->already_setup = false;
+    }
+}
+
+std::string
+ProjMatrixByBinSPECTUB::get_matrix_cache_directory() const
+{
+  return this->matrix_cache_directory;
+}
+
+void
+ProjMatrixByBinSPECTUB::set_matrix_cache_directory(const std::string& value)
+{
+  if (this->matrix_cache_directory != value)
+    {
+      this->matrix_cache_directory = value;
+      this->already_setup = false;
+    }
+}
+
 std::string
 ProjMatrixByBinSPECTUB::get_attenuation_type() const
 {
@@ -213,6 +256,74 @@ ProjMatrixByBinSPECTUB::set_resolution_model(const float collimator_sigma_0_in_m
   this->already_setup = false;
 }
 
+namespace
+{
+//! 64-bit FNV-1a hash of the bytes of an array (stable across platforms with the same endianness)
+template <typename T>
+boost::uint64_t
+hash_of_array(const T* data, const int num_elements)
+{
+  boost::uint64_t hash = 14695981039346656037ULL;
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+  const std::size_t num_bytes = sizeof(T) * static_cast<std::size_t>(num_elements);
+  for (std::size_t i = 0; i < num_bytes; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+const char* const matrix_cache_signature = "STIR SPECTUB matrix cache";
+
+void
+write_lor(std::ostream& fst, const ProjMatrixElemsForOneBin& lor)
+{
+  const Bin bin = lor.get_bin();
+  const boost::int32_t bin_indices[4]
+      = { bin.segment_num(), bin.view_num(), bin.axial_pos_num(), bin.tangential_pos_num() };
+  fst.write(reinterpret_cast<const char*>(bin_indices), sizeof(bin_indices));
+  const boost::uint32_t count = static_cast<boost::uint32_t>(lor.size());
+  fst.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  for (ProjMatrixElemsForOneBin::const_iterator element_ptr = lor.begin(); element_ptr != lor.end(); ++element_ptr)
+    {
+      const boost::int16_t coords[3] = { static_cast<boost::int16_t>(element_ptr->coord1()),
+                                         static_cast<boost::int16_t>(element_ptr->coord2()),
+                                         static_cast<boost::int16_t>(element_ptr->coord3()) };
+      fst.write(reinterpret_cast<const char*>(coords), sizeof(coords));
+      const float value = element_ptr->get_value();
+      fst.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+}
+
+bool
+read_lor(std::istream& fst, ProjMatrixElemsForOneBin& lor)
+{
+  boost::int32_t bin_indices[4];
+  fst.read(reinterpret_cast<char*>(bin_indices), sizeof(bin_indices));
+  boost::uint32_t count;
+  fst.read(reinterpret_cast<char*>(&count), sizeof(count));
+  if (!fst)
+    return false;
+  Bin bin(bin_indices[0], bin_indices[1], bin_indices[2], bin_indices[3]);
+  bin.set_bin_value(0);
+  lor.erase();
+  lor.set_bin(bin);
+  lor.reserve(count);
+  for (boost::uint32_t i = 0; i < count; ++i)
+    {
+      boost::int16_t coords[3];
+      float value;
+      fst.read(reinterpret_cast<char*>(coords), sizeof(coords));
+      fst.read(reinterpret_cast<char*>(&value), sizeof(value));
+      if (!fst)
+        return false;
+      lor.push_back(ProjMatrixElemsForOneBin::value_type(Coordinate3D<int>(coords[0], coords[1], coords[2]), value));
+    }
+  return true;
+}
+} // namespace
+
 void
 ProjMatrixByBinSPECTUB::set_up(const shared_ptr<const ProjDataInfo>& proj_data_info_ptr_v,
                                const shared_ptr<const DiscretisedDensity<3, float>>& density_info_ptr // TODO should be Info only
@@ -606,6 +717,42 @@ ProjMatrixByBinSPECTUB::set_up(const shared_ptr<const ProjDataInfo>& proj_data_i
   else
     msk_2d = msk_3d = NULL;
 
+  //... key for the on-disk matrix cache .........................................
+  // simple attenuation is applied after reading/computing the geometric and PSF part, such that
+  // the stored matrix does not depend on the attenuation map (but it does depend on the mask)
+
+  this->apply_attenuation_after_matrix_cache = !this->matrix_cache_directory.empty() && wmh.do_att && !wmh.do_full_att;
+  this->matrix_cache_key = "";
+  if (!this->matrix_cache_directory.empty())
+    {
+      if (!FilePath::exists(this->matrix_cache_directory))
+        error(boost::format("SPECTUB matrix: matrix cache directory %1% does not exist") % this->matrix_cache_directory);
+
+      std::ostringstream key;
+      key << std::setprecision(9);
+      key << "SPECTUB matrix cache version 1\n";
+      key << "image: " << vol.Ncol << ' ' << vol.Nrow << ' ' << vol.Nsli << ' ' << vol.szcm << ' ' << vol.thcm << ' '
+          << vol.first_sl << ' ' << vol.last_sl << '\n';
+      key << "projections: " << prj.Nbin << ' ' << prj.szcm << ' ' << prj.Nsli << ' ' << prj.thcm << ' ' << prj.Nang << ' '
+          << prj.ang0 << ' ' << prj.incr << '\n';
+      key << "radii:";
+      for (int i = 0; i < prj.Nang; i++)
+        key << ' ' << Rrad[i];
+      key << '\n';
+      key << "psf: " << psf_type << ' ' << wmh.COL.A << ' ' << wmh.COL.B << ' ' << wmh.maxsigm << ' ' << wmh.psfres << ' '
+          << wmh.min_w << '\n';
+      if (wmh.do_full_att)
+        key << "attenuation: full, map hash " << std::hex << hash_of_array(attmap, vol.Nvox) << std::dec << '\n';
+      else
+        key << "attenuation: not included\n";
+      if (wmh.do_msk)
+        key << "mask hash: " << std::hex << hash_of_array(msk_3d, vol.Nvox) << std::dec << '\n';
+      else
+        key << "mask: none\n";
+      this->matrix_cache_key = key.str();
+      info("SPECTUB matrix: using on-disk matrix cache with key\n" + this->matrix_cache_key, 2);
+    }
+
   //... Initialization and memory allocation for the weight matrix ...................
 
   wm.NbOS = prj.NbOS; // number of rows in the weight matrix
@@ -620,39 +767,7 @@ ProjMatrixByBinSPECTUB::set_up(const shared_ptr<const ProjDataInfo>& proj_data_i
       NITEMS[kOS] = new int[wm.NbOS];
     }
 
-  //... double array wm.val and wm.col .....................................................
-
-  if ((wm.val = new (std::nothrow) float*[wm.NbOS]) == NULL)
-    {
-      // error_wm_SPECT( 200, "wm.val[]" );
-      error("Error allocating space to store values for SPECTUB matrix");
-    }
-  if ((wm.col = new (std::nothrow) int*[wm.NbOS]) == NULL)
-    {
-      // error_wm_SPECT( 200, "wm.col[]" );
-      error("Error allocating space to store column indices for SPECTUB matrix");
-    }
-
-  //... array wm.ne .........................................................................
-
-  if ((wm.ne = new (std::nothrow) int[wm.NbOS + 1]) == 0)
-    {
-      // error_wm_SPECT(200,"wm.ne[]");
-      error("Error allocating space to store number of elements for SPECTUB matrix");
-    }
-
-  //... STIR indices .......................................................................
-
-  if (wm.do_save_STIR)
-    {
-      wm.ns = new int[prj.NbOS];
-      wm.nb = new int[prj.NbOS];
-      wm.na = new int[prj.NbOS];
-
-      wm.nx = new short int[vol.Nvox];
-      wm.ny = new short int[vol.Nvox];
-      wm.nz = new short int[vol.Nvox];
-    }
+  //... the weight matrix arrays (wm.val, wm.col etc) are allocated for each view in compute_one_subset()
 
   //... memory allocation for wmh .........................................................
 
@@ -664,19 +779,39 @@ ProjMatrixByBinSPECTUB::set_up(const shared_ptr<const ProjDataInfo>& proj_data_i
   //..........................................................................................
 
   //... LOOP: Subsets .................................................................
-  subset_already_processed.assign(prj.NOS, false);
+  subset_status.assign(prj.NOS, subset_not_computed);
+#ifdef STIR_OPENMP
+  subset_locks.resize(prj.NOS);
+  for (auto& lock : subset_locks)
+    omp_init_lock(&lock);
+#endif
   for (int kOS = 0; kOS < prj.NOS; kOS++)
     {
-      wmh.subset_ind = kOS;
-
       for (int i = 0; i < prj.NangOS; i++)
         {
-
-          wmh.index[i] = prj.order[i + kOS * prj.NangOS];
-          wmh.Rrad[i] = Rrad[wmh.index[i]];
-          if (wmh.Rrad[i] != wmh.Rrad[0])
+          if (Rrad[prj.order[i + kOS * prj.NangOS]] != Rrad[prj.order[kOS * prj.NangOS]])
             wmh.fixed_Rrad = false;
         }
+    }
+
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (int kOS = 0; kOS < prj.NOS; kOS++)
+    {
+      // use a copy of wmh with its own angle indices, such that subsets can be handled in parallel
+      wmh_type wmh_for_subset = wmh;
+      std::vector<int> index(prj.NangOS);
+      std::vector<float> Rrad_for_subset(prj.NangOS);
+      wmh_for_subset.index = index.data();
+      wmh_for_subset.Rrad = Rrad_for_subset.data();
+      wmh_for_subset.subset_ind = kOS;
+
+      for (int i = 0; i < prj.NangOS; i++)
+        {
+          index[i] = prj.order[i + kOS * prj.NangOS];
+          Rrad_for_subset[i] = Rrad[index[i]];
+        }
 
       //... NITEMS initialization  ......................
 
@@ -685,11 +820,7 @@ ProjMatrixByBinSPECTUB::set_up(const shared_ptr<const ProjDataInfo>& proj_data_i
 
       //... size estimations ........................................................
 
-      wm_size_estimation(kOS, ang, vox, bin, vol, prj, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS[kOS], wmh, Rrad);
-
-      // cout << "\nwm_SPECT. Size estimation done. time (s): " << double( clock()-ini )/CLOCKS_PER_SEC <<std::endl;
-
-      // compute_one_subset(kOS);
+      wm_size_estimation(kOS, ang, vox, bin, vol, prj, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS[kOS], wmh_for_subset, Rrad);
     } // end of LOOP: Subsets
 
   // delete_UB_SPECT_arrays();
@@ -697,6 +828,24 @@ ProjMatrixByBinSPECTUB::set_up(const shared_ptr<const ProjDataInfo>& proj_data_i
   // wm_SPECT ends here ---------------------------------------------------------------------------------------------
 
   this->already_setup = true;
+
+  if (this->precompute_all_views)
+    {
+      if (!this->keep_all_views_in_cache)
+        warning("SPECTUB matrix: precompute_all_views is ignored as keep_all_views_in_cache is not set");
+      else
+        {
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+          for (int kOS = 0; kOS < prj.NOS; kOS++)
+            {
+              compute_one_subset(kOS, Rrad);
+              subset_status[kOS] = subset_computed;
+            }
+          info(boost::format("Done computing all views of the matrix. Execution (CPU) time %1% s ") % timer.value(), 2);
+        }
+    }
 }
 
 ProjMatrixByBinSPECTUB*
@@ -730,10 +879,6 @@ ProjMatrixByBinSPECTUB::delete_UB_SPECT_arrays()
         }
     }
 
-  delete[] wm.val;
-  delete[] wm.col;
-  delete[] wm.ne;
-
   //... freeing memory .............................................
 
   delete[] prj.order;
@@ -757,16 +902,6 @@ ProjMatrixByBinSPECTUB::delete_UB_SPECT_arrays()
       delete[] msk_3d;
       delete[] msk_2d;
     }
-
-  if (wm.do_save_STIR)
-    {
-      delete[] wm.ns;
-      delete[] wm.nb;
-      delete[] wm.na;
-      delete[] wm.nx;
-      delete[] wm.ny;
-      delete[] wm.nz;
-    }
 }
 void
 ProjMatrixByBinSPECTUB::compute_one_subset(const int kOS, const float* Rrad) const
@@ -777,109 +912,242 @@ ProjMatrixByBinSPECTUB::compute_one_subset(const int kOS, const float* Rrad) con
   // cout << "\n\n--- Processing subset: " << kOS+1 << "/" << prj.NOS << " ----------------------------------------\n" << endl;
 
   //... to fill wmh fields related to the subset ..................................
+  // we use local copies of wmh and wm (with their own arrays) such that different views can be computed in parallel
 
-  this->wmh.subset_ind = kOS;
+  wmh_type wmh_for_subset = this->wmh;
+  std::vector<int> index(prj.NangOS);
+  std::vector<float> Rrad_for_subset(prj.NangOS);
+  wmh_for_subset.index = index.data();
+  wmh_for_subset.Rrad = Rrad_for_subset.data();
+  wmh_for_subset.subset_ind = kOS;
 
   for (int i = 0; i < prj.NangOS; i++)
     {
-
-      this->wmh.index[i] = prj.order[i + kOS * prj.NangOS];
-      this->wmh.Rrad[i] = Rrad[this->wmh.index[i]];
+      index[i] = prj.order[i + kOS * prj.NangOS];
+      Rrad_for_subset[i] = Rrad[index[i]];
     }
 
-  //... NITEMS initialization  ......................
-
-  // for ( int i = 0 ; i < prj.NbOS ; i++ ) NITEMS[ i ] = 1;
-
-  //... size esmitations ........................................................
-
-  // wm_size_estimation ( kOS,  ang, vox, bin, vol, prj, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS );
-
-  // cout << "\nwm_SPECT. Size estimation done. time (s): " << double( clock()-ini )/CLOCKS_PER_SEC <<endl;
-
-  int ne = 0;
+  std::vector<ProjMatrixElemsForOneBin> lors;
+  if (!this->matrix_cache_directory.empty() && read_subset_from_matrix_cache(kOS, lors) == Succeeded::yes)
+    {
+      info(boost::format("Read matrix elements for view %1% from matrix cache. time %2% (s)") % prj.order[kOS] % timer.value(),
+           2);
+    }
+  else
+    {
+      if (this->apply_attenuation_after_matrix_cache)
+        wmh_for_subset.do_att = false;
 
-  for (int i = 0; i < this->wmh.prj.NbOS; i++)
-    ne += NITEMS[kOS][i];
+      int ne = 0;
 
-  //... size information ....................................................................
+      for (int i = 0; i < wmh_for_subset.prj.NbOS; i++)
+        ne += NITEMS[kOS][i];
 
-  info(boost::format("total number of non-zero weights in this view: %1%, estimated size: %2% MB") % ne
-           % (this->wm.do_save_STIR ? (ne + 10 * prj.NbOS) / 104857.6 : ne / 131072),
-       2);
+      //... size information ....................................................................
 
-  //... memory allocation for wm float arrays ...................................
+      info(boost::format("total number of non-zero weights in this view: %1%, estimated size: %2% MB") % ne
+               % (this->wm.do_save_STIR ? (ne + 10 * prj.NbOS) / 104857.6 : ne / 131072),
+           2);
 
-  for (int i = 0; i < this->wmh.prj.NbOS; i++)
-    {
+      //... memory allocation for wm arrays (initialised to zero) ...................................
 
-      if ((this->wm.val[i] = new (std::nothrow) float[NITEMS[kOS][i]]) == NULL)
+      wm_da_type wm_for_subset = this->wm;
+      std::vector<std::vector<float>> val(wm_for_subset.NbOS);
+      std::vector<std::vector<int>> col(wm_for_subset.NbOS);
+      std::vector<float*> val_ptrs(wm_for_subset.NbOS);
+      std::vector<int*> col_ptrs(wm_for_subset.NbOS);
+      for (int i = 0; i < wm_for_subset.NbOS; i++)
         {
-          // error_wm_SPECT( 200, "wm.val[][]" );
-          error("Error allocating space to store values for SPECTUB matrix");
+          val[i].resize(NITEMS[kOS][i]);
+          col[i].resize(NITEMS[kOS][i]);
+          val_ptrs[i] = val[i].data();
+          col_ptrs[i] = col[i].data();
         }
-
-      if ((this->wm.col[i] = new (std::nothrow) int[NITEMS[kOS][i]]) == NULL)
+      std::vector<int> ne_for_rows(wm_for_subset.NbOS + 1, 0);
+      std::vector<int> na(prj.NbOS), nb(prj.NbOS), ns(prj.NbOS);
+      std::vector<short int> nx(vol.Nvox), ny(vol.Nvox), nz(vol.Nvox);
+      wm_for_subset.val = val_ptrs.data();
+      wm_for_subset.col = col_ptrs.data();
+      wm_for_subset.ne = ne_for_rows.data();
+      wm_for_subset.na = na.data();
+      wm_for_subset.nb = nb.data();
+      wm_for_subset.ns = ns.data();
+      wm_for_subset.nx = nx.data();
+      wm_for_subset.ny = ny.data();
+      wm_for_subset.nz = nz.data();
+
+      //... wm calculation for this subset ...........................
+
+      wm_calculation(kOS,
+                     ang,
+                     vox,
+                     bin,
+                     vol,
+                     prj,
+                     attmap,
+                     msk_3d,
+                     msk_2d,
+                     maxszb,
+                     &gaussdens,
+                     NITEMS[kOS],
+                     wm_for_subset,
+                     wmh_for_subset,
+                     Rrad);
+      info(boost::format("Weight matrix calculation done. time %1% (s)") % timer.value(), 2);
+
+      //... fill lor .........................
+
+      for (int j = 0; j < wm_for_subset.NbOS; j++)
         {
-          // error_wm_SPECT( 200, "wm.col[]" );
-          error("Error allocating space to store column indices for SPECTUB matrix");
+          ProjMatrixElemsForOneBin lor;
+          Bin bin;
+          bin.segment_num() = 0;
+          bin.view_num() = wm_for_subset.na[j];
+          bin.axial_pos_num() = wm_for_subset.ns[j];
+          bin.tangential_pos_num() = wm_for_subset.nb[j];
+          bin.set_bin_value(0);
+          lor.set_bin(bin);
+
+          lor.reserve(wm_for_subset.ne[j]);
+          for (int i = 0; i < wm_for_subset.ne[j]; i++)
+            {
+              const int iv = wm_for_subset.col[j][i];
+              const ProjMatrixElemsForOneBin::value_type elem(Coordinate3D<int>(nz[iv], ny[iv], nx[iv]), wm_for_subset.val[j][i]);
+              lor.push_back(elem);
+            }
+          // free memory for this row
+          std::vector<float>().swap(val[j]);
+          std::vector<int>().swap(col[j]);
+
+          lors.push_back(std::move(lor));
         }
+
+      if (!this->matrix_cache_directory.empty())
+        write_subset_to_matrix_cache(kOS, lors);
     }
 
-  //... to initialize wm to zero ......................
+  if (this->apply_attenuation_after_matrix_cache)
+    apply_attenuation_factors(wmh_for_subset, lors);
 
-  for (int i = 0; i < this->wm.NbOS; i++)
-    {
+  for (const auto& lor : lors)
+    this->cache_proj_matrix_elems_for_one_bin(lor);
 
-      this->wm.ne[i] = 0;
+  info(boost::format("Total time after transfering to ProjMatrixElemsForOneBin. time %1% (s)") % timer.value(), 2);
+}
 
-      for (int j = 0; j < NITEMS[kOS][i]; j++)
-        {
+std::string
+ProjMatrixByBinSPECTUB::get_matrix_cache_filename(const int kOS) const
+{
+  std::ostringstream name;
+  const auto key_hash = hash_of_array(matrix_cache_key.data(), static_cast<int>(matrix_cache_key.size()));
+  name << "SPECTUB_" << std::hex << std::setw(16) << std::setfill('0') << key_hash << std::dec << "_subset" << kOS << ".pm";
+  std::string filename = this->matrix_cache_directory;
+  FilePath::append_separator(filename);
+  return filename + name.str();
+}
 
-          this->wm.val[i][j] = (float)0.;
-          this->wm.col[i][j] = 0;
-        }
+Succeeded
+ProjMatrixByBinSPECTUB::read_subset_from_matrix_cache(const int kOS, std::vector<ProjMatrixElemsForOneBin>& lors) const
+{
+  const std::string filename = get_matrix_cache_filename(kOS);
+  std::ifstream fst(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!fst)
+    return Succeeded::no;
+
+  std::string signature;
+  std::getline(fst, signature);
+  boost::uint32_t key_length = 0;
+  fst.read(reinterpret_cast<char*>(&key_length), sizeof(key_length));
+  if (!fst || signature != matrix_cache_signature || key_length != matrix_cache_key.size())
+    {
+      warning(boost::format("SPECTUB matrix: ignoring incompatible matrix cache file %1%") % filename);
+      return Succeeded::no;
+    }
+  std::string key(key_length, ' ');
+  fst.read(&key[0], key_length);
+  boost::uint32_t num_lors = 0;
+  fst.read(reinterpret_cast<char*>(&num_lors), sizeof(num_lors));
+  if (!fst || key != matrix_cache_key || num_lors != static_cast<boost::uint32_t>(prj.NbOS))
+    {
+      warning(boost::format("SPECTUB matrix: ignoring incompatible matrix cache file %1%") % filename);
+      return Succeeded::no;
     }
-  this->wm.ne[this->wm.NbOS] = 0;
-
-  //... wm calculation for this subset ...........................
-
-  wm_calculation(
-      kOS, ang, vox, bin, vol, prj, attmap, msk_3d, msk_2d, maxszb, &gaussdens, NITEMS[kOS], this->wm, this->wmh, Rrad);
-  info(boost::format("Weight matrix calculation done. time %1% (s)") % timer.value(), 2);
 
-  //... fill lor .........................
+  lors.resize(num_lors);
+  for (auto& lor : lors)
+    if (!read_lor(fst, lor))
+      {
+        warning(boost::format("SPECTUB matrix: error reading matrix cache file %1%. Recomputing.") % filename);
+        lors.clear();
+        return Succeeded::no;
+      }
+  return Succeeded::yes;
+}
 
-  for (int j = 0; j < this->wm.NbOS; j++)
+void
+ProjMatrixByBinSPECTUB::write_subset_to_matrix_cache(const int kOS, const std::vector<ProjMatrixElemsForOneBin>& lors) const
+{
+  // write to a temporary file first, such that other processes never see an incomplete file
+  const std::string filename = get_matrix_cache_filename(kOS);
+  const std::string tmp_filename
+      = filename + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+  {
+    std::ofstream fst(tmp_filename.c_str(), std::ios::out | std::ios::binary);
+    if (!fst)
+      {
+        warning(boost::format("SPECTUB matrix: cannot write matrix cache file %1%") % tmp_filename);
+        return;
+      }
+    fst << matrix_cache_signature << '\n';
+    const boost::uint32_t key_length = static_cast<boost::uint32_t>(matrix_cache_key.size());
+    fst.write(reinterpret_cast<const char*>(&key_length), sizeof(key_length));
+    fst.write(matrix_cache_key.data(), key_length);
+    const boost::uint32_t num_lors = static_cast<boost::uint32_t>(lors.size());
+    fst.write(reinterpret_cast<const char*>(&num_lors), sizeof(num_lors));
+    for (const auto& lor : lors)
+      write_lor(fst, lor);
+    if (!fst)
+      {
+        warning(boost::format("SPECTUB matrix: error writing matrix cache file %1%") % tmp_filename);
+        fst.close();
+        std::remove(tmp_filename.c_str());
+        return;
+      }
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
     {
-      ProjMatrixElemsForOneBin lor;
-      Bin bin;
-      bin.segment_num() = 0;
-      bin.view_num() = this->wm.na[j];
-      bin.axial_pos_num() = this->wm.ns[j];
-      bin.tangential_pos_num() = this->wm.nb[j];
-      bin.set_bin_value(0);
-      lor.set_bin(bin);
+      warning(boost::format("SPECTUB matrix: cannot rename %1% to %2%") % tmp_filename % filename);
+      std::remove(tmp_filename.c_str());
+    }
+}
 
-      lor.reserve(this->wm.ne[j]);
-      for (int i = 0; i < this->wm.ne[j]; i++)
+void
+ProjMatrixByBinSPECTUB::apply_attenuation_factors(wmh_type& wmh_for_subset, std::vector<ProjMatrixElemsForOneBin>& lors) const
+{
+  std::vector<float> att_factors(prj.NangOS * vol.Nvox);
+  calc_att_factors_simple(ang, vox, bin, vol, prj, attmap, msk_3d, msk_2d, att_factors.data(), wmh_for_subset);
+
+  // find the voxel index (as used by SPECTUB) from the STIR coordinates, see wm_calculation
+  Array<3, int> voxel_index(densel_range);
+  stir::InvertAxis invert;
+  for (int islc = 0; islc < vol.Nsli; islc++)
+    for (int irow = 0; irow < vol.Nrow; irow++)
+      for (int icol = 0; icol < vol.Ncol; icol++)
         {
-
-          const ProjMatrixElemsForOneBin::value_type elem(Coordinate3D<int>(this->wm.nz[this->wm.col[j][i]],
-                                                                            this->wm.ny[this->wm.col[j][i]],
-                                                                            this->wm.nx[this->wm.col[j][i]]),
-                                                          this->wm.val[j][i]);
-          lor.push_back(elem);
+          const int nx = invert.invert_axis_index((icol - (int)floor(vol.Ncold2)), vol.Ncold2 * 2, "x");
+          const int ny = irow - (int)floor(vol.Nrowd2);
+          voxel_index[islc][ny][nx] = icol + irow * vol.Ncol + islc * vol.Npix;
         }
 
-      delete[] this->wm.val[j];
-      delete[] this->wm.col[j];
-
-      this->cache_proj_matrix_elems_for_one_bin(lor);
+  for (int j = 0; j < static_cast<int>(lors.size()); j++)
+    {
+      // rows are ordered by angle in the subset, see wm_calculation
+      const float* const att_factors_for_angle = &att_factors[(j / prj.Nbp) * vol.Nvox];
+      for (auto element_ptr = lors[j].begin(); element_ptr != lors[j].end(); ++element_ptr)
+        *element_ptr *= att_factors_for_angle[voxel_index[element_ptr->coord1()][element_ptr->coord2()][element_ptr->coord3()]];
     }
-
-  info(boost::format("Total time after transfering to ProjMatrixElemsForOneBin. time %1% (s)") % timer.value(), 2);
 }
+
 void
 ProjMatrixByBinSPECTUB::calculate_proj_matrix_elems_for_one_bin(ProjMatrixElemsForOneBin& lor) const
 {
@@ -894,22 +1162,49 @@ ProjMatrixByBinSPECTUB::calculate_proj_matrix_elems_for_one_bin(ProjMatrixElemsF
       if (prj.order[kOS] == view_num)
         break;
     }
-#ifdef STIR_OPENMP
-#  pragma omp critical(PROJMATRIXBYBINUBONEVIEW)
-#endif
-  if (!subset_already_processed[kOS])
+
+  if (!this->keep_all_views_in_cache)
     {
-      if (!this->keep_all_views_in_cache)
+      // only a single view is kept in memory (and set_up() made sure we use only 1 thread)
+      if (subset_status[kOS] != subset_computed)
         {
           this->clear_cache();
-          subset_already_processed.assign(prj.NOS, false);
+          subset_status.assign(prj.NOS, subset_not_computed);
+          info(boost::format("Computing matrix elements for view %1%") % view_num, 2);
+          compute_one_subset(kOS, Rrad);
+          subset_status[kOS] = subset_computed;
         }
-      info(boost::format("Computing matrix elements for view %1%") % view_num,
-           2); // potentially pass a wm, wmh[threadh] not sure if works then in setup we need an array of wmh
-      compute_one_subset(kOS, Rrad);
-      subset_already_processed[kOS] = true;
     }
-  lor.erase();
+  else
+    {
+      // compute this view if necessary. Other threads that need the same view wait for the lock of the view.
+#ifdef STIR_OPENMP
+      omp_set_lock(&subset_locks[kOS]);
+#endif
+      try
+        {
+          if (subset_status[kOS] != subset_computed)
+            {
+              info(boost::format("Computing matrix elements for view %1%") % view_num, 2);
+              compute_one_subset(kOS, Rrad);
+              subset_status[kOS] = subset_computed;
+            }
+        }
+      catch (...)
+        {
+          // the view is still marked as not computed, such that another call can retry
+#ifdef STIR_OPENMP
+          omp_unset_lock(&subset_locks[kOS]);
+#endif
+          throw;
+        }
+#ifdef STIR_OPENMP
+      omp_unset_lock(&subset_locks[kOS]);
+#endif
+    }
+  // the elements for this bin are now in the cache
+  if (this->get_cached_proj_matrix_elems_for_one_bin(lor) == Succeeded::no)
+    lor.erase();
 }
 
 END_NAMESPACE_STIR
@@ -28,6 +28,7 @@
 #include "stir/Succeeded.h"
 #include "stir/recon_buildblock/ProjMatrixElemsForOneBin.h"
 #include "stir/DiscretisedDensity.h"
+#include "stir/Array.h"
 #include "stir/recon_buildblock/SymmetryOperation.h"
 #include "stir/recon_buildblock/DataSymmetriesForBins.h"
 
@@ -370,6 +371,54 @@ ProjMatrixElemsForOneBin::forward_project(Bin& single, const DiscretisedDensity<
   }
 }
 
+void
+ProjMatrixElemsForOneBin::back_project(DiscretisedDensity<3, float>& density,
+                                       const VectorWithOffset<float>& tof_values,
+                                       const Array<2, float>& tof_kernel) const
+{
+  assert(tof_values.get_min_index() == tof_kernel.get_min_index());
+  assert(tof_values.get_max_index() == tof_kernel.get_max_index());
+  if (std::all_of(tof_values.begin(), tof_values.end(), [](const float v) { return v == 0; }))
+    return;
+
+  BasicCoordinate<3, int> coords;
+  const_iterator element_ptr = begin();
+  for (int i = 0; element_ptr != end(); ++element_ptr, ++i)
+    {
+      coords = element_ptr->get_coords();
+      if (coords[1] < density.get_min_index() || coords[1] > density.get_max_index())
+        continue;
+      const float value = element_ptr->get_value();
+      float sum = 0.F;
+      for (int t = tof_values.get_min_index(); t <= tof_values.get_max_index(); ++t)
+        sum += value * tof_kernel[t][i] * tof_values[t];
+      density[coords[1]][coords[2]][coords[3]] += sum;
+    }
+}
+
+void
+ProjMatrixElemsForOneBin::forward_project(VectorWithOffset<float>& tof_values,
+                                          const DiscretisedDensity<3, float>& density,
+                                          const Array<2, float>& tof_kernel) const
+{
+  assert(tof_values.get_min_index() == tof_kernel.get_min_index());
+  assert(tof_values.get_max_index() == tof_kernel.get_max_index());
+
+  BasicCoordinate<3, int> coords;
+  const_iterator element_ptr = begin();
+  for (int i = 0; element_ptr != end(); ++element_ptr, ++i)
+    {
+      coords = element_ptr->get_coords();
+      if (coords[1] < density.get_min_index() || coords[1] > density.get_max_index())
+        continue;
+      // note: multiply in the same order as when using the row for a single TOF bin
+      const float density_value = density[coords[1]][coords[2]][coords[3]];
+      const float value = element_ptr->get_value();
+      for (int t = tof_values.get_min_index(); t <= tof_values.get_max_index(); ++t)
+        tof_values[t] += density_value * (value * tof_kernel[t][i]);
+    }
+}
+
 void
 ProjMatrixElemsForOneBin::back_project(DiscretisedDensity<3, float>& density, const RelatedBins& r_bins) const
 {
@@ -28,6 +28,7 @@
 #include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include "stir/Profiler.h"
 #include <algorithm>
 using std::min;
 using std::max;
@@ -231,6 +232,7 @@ template <typename elemT>
 double
 QuadraticPrior<elemT>::compute_value(const DiscretisedDensity<3, elemT>& current_image_estimate)
 {
+  ProfilerZone profiler_zone("QuadraticPrior::compute_value");
   if (this->penalisation_factor == 0)
     {
       return 0.;
@@ -302,6 +304,7 @@ void
 QuadraticPrior<elemT>::compute_gradient(DiscretisedDensity<3, elemT>& prior_gradient,
                                         const DiscretisedDensity<3, elemT>& current_image_estimate)
 {
+  ProfilerZone profiler_zone("QuadraticPrior::compute_gradient");
   assert(prior_gradient.has_same_characteristics(current_image_estimate));
   if (this->penalisation_factor == 0)
     {
@@ -535,6 +538,7 @@ void
 QuadraticPrior<elemT>::add_multiplication_with_approximate_Hessian(DiscretisedDensity<3, elemT>& output,
                                                                    const DiscretisedDensity<3, elemT>& input) const
 {
+  ProfilerZone profiler_zone("QuadraticPrior::add_multiplication_with_approximate_Hessian");
   // TODO this function overlaps enormously with parabolic_surrogate_curvature
   // the only difference is that parabolic_surrogate_curvature uses input==1
 
@@ -602,6 +606,7 @@ QuadraticPrior<elemT>::accumulate_Hessian_times_input(DiscretisedDensity<3, elem
                                                       const DiscretisedDensity<3, elemT>& current_estimate,
                                                       const DiscretisedDensity<3, elemT>& input) const
 {
+  ProfilerZone profiler_zone("QuadraticPrior::accumulate_Hessian_times_input");
   // TODO this function overlaps enormously with parabolic_surrogate_curvature
   // the only difference is that parabolic_surrogate_curvature uses input==1
 
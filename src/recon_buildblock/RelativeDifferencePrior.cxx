@@ -30,6 +30,7 @@
 #include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
+#include "stir/Profiler.h"
 #include <algorithm>
 #include <cmath>
 using std::min;
@@ -302,6 +303,7 @@ template <typename elemT>
 double
 RelativeDifferencePrior<elemT>::compute_value(const DiscretisedDensity<3, elemT>& current_image_estimate)
 {
+  ProfilerZone profiler_zone("RelativeDifferencePrior::compute_value");
   if (this->penalisation_factor == 0)
     {
       return 0.;
@@ -375,6 +377,7 @@ void
 RelativeDifferencePrior<elemT>::compute_gradient(DiscretisedDensity<3, elemT>& prior_gradient,
                                                  const DiscretisedDensity<3, elemT>& current_image_estimate)
 {
+  ProfilerZone profiler_zone("RelativeDifferencePrior::compute_gradient");
   assert(prior_gradient.has_same_characteristics(current_image_estimate));
   if (this->penalisation_factor == 0)
     {
@@ -526,6 +529,7 @@ void
 RelativeDifferencePrior<elemT>::add_multiplication_with_approximate_Hessian(DiscretisedDensity<3, elemT>& output,
                                                                             const DiscretisedDensity<3, elemT>& input) const
 {
+  ProfilerZone profiler_zone("RelativeDifferencePrior::add_multiplication_with_approximate_Hessian");
   error("add_multiplication_with_approximate_Hessian()  is not implemented in Relative Difference Prior.");
 }
 
@@ -535,6 +539,7 @@ RelativeDifferencePrior<elemT>::accumulate_Hessian_times_input(DiscretisedDensit
                                                                const DiscretisedDensity<3, elemT>& current_estimate,
                                                                const DiscretisedDensity<3, elemT>& input) const
 {
+  ProfilerZone profiler_zone("RelativeDifferencePrior::accumulate_Hessian_times_input");
   // TODO this function overlaps enormously with parabolic_surrogate_curvature
   // the only difference is that parabolic_surrogate_curvature uses input==1
 
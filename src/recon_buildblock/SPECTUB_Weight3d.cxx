@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <string>
 #include <math.h>
+#include <vector>
 
 namespace SPECTUB
 {
@@ -41,6 +42,47 @@ namespace SPECTUB
 #define REF_DIST 5. // reference distance for fanbeam PSF
 
 using namespace std;
+
+//! scratch memory for the PSF of one voxel
+/*! The arrays are owned by this object (and not shared), such that different threads can compute
+    weights for different views concurrently. */
+class PSFWorkSpace
+{
+public:
+  PSFWorkSpace(psf1d_type& psf1d_h, psf1d_type& psf1d_v, psf2da_type& psf, const int maxszb, const bool do_psf_3d)
+      : h_val(maxszb),
+        h_ind(maxszb)
+  {
+    psf1d_h.maxszb = maxszb;
+    psf1d_h.val = h_val.data();
+    psf1d_h.ind = h_ind.data();
+
+    if (do_psf_3d)
+      {
+        v_val.resize(maxszb);
+        v_ind.resize(maxszb);
+        psf1d_v.maxszb = maxszb;
+        psf1d_v.val = v_val.data();
+        psf1d_v.ind = v_ind.data();
+      }
+
+    psf.maxszb_h = maxszb;
+    psf.maxszb_v = do_psf_3d ? maxszb : 1;
+    psf.maxszb_t = psf.maxszb_h * psf.maxszb_v;
+
+    val.resize(psf.maxszb_t); // allocation for PSF values
+    ib.resize(psf.maxszb_t);  // allocation for PSF indices
+    jb.resize(psf.maxszb_t);  // allocation for PSF indices
+    psf.val = val.data();
+    psf.ib = ib.data();
+    psf.jb = jb.data();
+  }
+
+private:
+  std::vector<float> h_val, v_val, val;
+  std::vector<int> h_ind, v_ind, ib, jb;
+};
+
 //==========================================================================
 //=== wm_calculation =======================================================
 //==========================================================================
@@ -71,53 +113,29 @@ wm_calculation(const int kOS,
   //... variables for geometric component ..............................................
 
   psf1d_type psf1d_h, psf1d_v;
-
-  psf1d_h.maxszb = maxszb;
-  psf1d_h.val = new float[maxszb];
-  psf1d_h.ind = new int[maxszb];
-
-  if (wmh.do_psf_3d)
-    {
-      psf1d_v.maxszb = maxszb;
-      psf1d_v.val = new float[maxszb];
-      psf1d_v.ind = new int[maxszb];
-    }
-
   psf2da_type psf;
-
-  psf.maxszb_h = maxszb;
-  if (wmh.do_psf_3d)
-    psf.maxszb_v = maxszb;
-  else
-    psf.maxszb_v = 1;
-  psf.maxszb_t = psf.maxszb_h * psf.maxszb_v;
-
-  psf.val = new float[psf.maxszb_t]; // allocation for PSF values
-  psf.ib = new int[psf.maxszb_t];    // allocation for PSF indices
-  psf.jb = new int[psf.maxszb_t];    // allocation for PSF indices
+  PSFWorkSpace psf_work_space(psf1d_h, psf1d_v, psf, maxszb, wmh.do_psf_3d);
 
   //... variables for attenuation component .............................................
 
-  attpth_type* attpth = 0; // initialise to avoid compiler warning
-  int sizeattpth = 1;      // initialise to avoid compiler warning
+  std::vector<attpth_type> attpth;
+  std::vector<std::vector<float>> attpth_dl;
+  std::vector<std::vector<int>> attpth_iv;
 
   if (wmh.do_att || wmh.do_msk_att)
     {
+      const int sizeattpth = wmh.do_full_att ? psf.maxszb_t : 1;
+      const int maxlng = vol.Ncol + vol.Nrow + vol.Nsli; // maximum length of an attenuation path
 
-      if (!wmh.do_full_att)
-        sizeattpth = 1;
-      else
-        sizeattpth = psf.maxszb_t;
-
-      attpth = new attpth_type[sizeattpth];
-      attpth[0].maxlng = vol.Ncol + vol.Nrow + vol.Nsli; // maximum length of an attenuation path
+      attpth.resize(sizeattpth);
+      attpth_dl.assign(sizeattpth, std::vector<float>(maxlng));
+      attpth_iv.assign(sizeattpth, std::vector<int>(maxlng));
 
       for (int i = 0; i < sizeattpth; i++)
         {
-
-          attpth[i].dl = new float[attpth[0].maxlng];
-          attpth[i].iv = new int[attpth[0].maxlng];
-          attpth[i].maxlng = attpth[0].maxlng;
+          attpth[i].dl = attpth_dl[i].data();
+          attpth[i].iv = attpth_iv[i].data();
+          attpth[i].maxlng = maxlng;
         }
     }
 
@@ -318,30 +336,6 @@ wm_calculation(const int kOS,
         }         // end of LOOP2: image rows
     }             // end of LOOP1: image cols
 
-  //... detele allocated memory ..............
-
-  delete[] psf1d_h.val;
-  delete[] psf1d_h.ind;
-
-  if (wmh.do_psf_3d)
-    {
-      delete[] psf1d_v.val;
-      delete[] psf1d_v.ind;
-    }
-
-  delete[] psf.val;
-  delete[] psf.ib;
-  delete[] psf.jb;
-
-  if (wmh.do_att)
-    {
-      for (int i = 0; i < sizeattpth; i++)
-        {
-          delete[] attpth[i].dl;
-          delete[] attpth[i].iv;
-        }
-      delete[] attpth;
-    }
 }
 
 //=============================================================================
@@ -369,30 +363,8 @@ wm_size_estimation(int kOS,
   //... variables for geometric component ..............................................
 
   psf1d_type psf1d_h, psf1d_v;
-
-  psf1d_h.maxszb = maxszb;
-  psf1d_h.val = new float[maxszb];
-  psf1d_h.ind = new int[maxszb];
-
-  if (wmh.do_psf_3d)
-    {
-      psf1d_v.maxszb = maxszb;
-      psf1d_v.val = new float[maxszb];
-      psf1d_v.ind = new int[maxszb];
-    }
-
   psf2da_type psf;
-
-  psf.maxszb_h = maxszb;
-  if (wmh.do_psf_3d)
-    psf.maxszb_v = maxszb;
-  else
-    psf.maxszb_v = 1;
-  psf.maxszb_t = psf.maxszb_h * psf.maxszb_v;
-
-  psf.val = new float[psf.maxszb_t]; // allocation for PSF values
-  psf.ib = new int[psf.maxszb_t];    // allocation for PSF indices
-  psf.jb = new int[psf.maxszb_t];    // allocation for PSF indices
+  PSFWorkSpace psf_work_space(psf1d_h, psf1d_v, psf, maxszb, wmh.do_psf_3d);
 
   //=== LOOP1: IMAGE ROWS =======================================================================
 
@@ -501,20 +473,102 @@ wm_size_estimation(int kOS,
         }     // end of LOOP2: image rows
     }         // end of LOOP1: image cols
 
-  //... detele allocated memory ..............
+}
+
+//==========================================================================
+//=== calc_att_factors_simple ==============================================
+//==========================================================================
+
+void
+calc_att_factors_simple(const angle_type* const ang,
+                        voxel_type vox,
+                        bin_type bin,
+                        const volume_type& vol,
+                        const proj_type& prj,
+                        const float* attmap,
+                        const bool* msk_3d,
+                        const bool* msk_2d,
+                        float* att_factors,
+                        wmh_type& wmh)
+{
+  float eff;
+
+  //... memory for the attenuation path .............................
+
+  attpth_type attpth;
+  attpth.maxlng = vol.Ncol + vol.Nrow + vol.Nsli; // maximum length of an attenuation path
+  std::vector<float> dl(attpth.maxlng);
+  std::vector<int> iv(attpth.maxlng);
+  attpth.dl = dl.data();
+  attpth.iv = iv.data();
 
-  delete[] psf1d_h.val;
-  delete[] psf1d_h.ind;
+  for (int i = 0; i < prj.NangOS * vol.Nvox; i++)
+    att_factors[i] = (float)0.;
 
-  if (wmh.do_psf_3d)
+  //=== LOOP1: IMAGE ROWS =======================================================================
+
+  for (vox.irow = 0; vox.irow < vol.Nrow; vox.irow++)
     {
-      delete[] psf1d_v.val;
-      delete[] psf1d_v.ind;
-    }
 
-  delete[] psf.val;
-  delete[] psf.ib;
-  delete[] psf.jb;
+      vox.y = vol.y0 + vox.irow * vol.szcm; // y coordinate of the voxel (index 0->Nrow-1: irow)
+
+      //=== LOOP2: IMAGE COLUMNS =================================================================
+
+      for (vox.icol = 0; vox.icol < vol.Ncol; vox.icol++)
+        {
+
+          vox.x = vol.x0 + vox.icol * vol.szcm;    // x coordinate of the voxel (index 0->Ncol-1: icol)
+          vox.ip = vox.irow * vol.Ncol + vox.icol; // in-plane index of the voxel considering the slice as an array
+
+          if (wmh.do_msk)
+            {
+              if (!msk_2d[vox.ip])
+                continue; // to skip voxel if it is outside the 2d_mask
+            }
+
+          //=== LOOP3: ANGLES INTO SUBSETS ========================================================
+
+          for (int k = 0; k < prj.NangOS; k++)
+            {
+
+              int ka = wmh.index[k]; // angle index of the current projection (considering the whole set of projections)
+
+              //... same geometry as in wm_calculation ...........................
+
+              vox.dv2dp = vox.x * ang[ka].sin - vox.y * ang[ka].cos + ang[ka].Rrad;
+
+              if (vox.dv2dp <= 0.)
+                continue; // skipping voxel if it is beyond the detection plane (corner voxels)
+
+              vox.x1 = vox.x * ang[ka].cos + vox.y * ang[ka].sin;
+
+              voxel_projection(&vox, &eff, prj.lngcmd2, wmh);
+
+              vox.z = (float)0.;
+              bin.x = ang[ka].xbin0 + vox.xd0 * ang[ka].cos; // x coord of the projection of the center of the voxel
+              bin.y = ang[ka].ybin0 + vox.xd0 * ang[ka].sin;
+              bin.z = (float)0.;
+
+              calc_att_path(bin, vox, vol, &attpth);
+
+              //=== LOOP4: IMAGE SLICES ================================================================
+
+              for (vox.islc = vol.first_sl; vox.islc < vol.last_sl; vox.islc++)
+                {
+
+                  vox.iv = vox.ip + vox.islc * vol.Npix; // volume index of the voxel (volume as an array)
+
+                  if (wmh.do_msk)
+                    {
+                      if (!msk_3d[vox.iv])
+                        continue;
+                    }
+
+                  att_factors[k * vol.Nvox + vox.iv] = calc_att(&attpth, attmap, vox.islc, wmh);
+                }
+            } // end of LOOP3: projection angle into subset
+        }     // end of LOOP2: image cols
+    }         // end of LOOP1: image rows
 }
 
 //==========================================================================
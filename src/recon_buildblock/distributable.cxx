@@ -44,6 +44,7 @@
 #include "stir/ViewSegmentNumbers.h"
 #include "stir/CPUTimer.h"
 #include "stir/HighResWallClockTimer.h"
+#include "stir/Profiler.h"
 #include "stir/recon_buildblock/ForwardProjectorByBin.h"
 #include "stir/recon_buildblock/BackProjectorByBin.h"
 #include "stir/recon_buildblock/BinNormalisation.h"
@@ -174,6 +175,7 @@ get_viewgrams(shared_ptr<RelatedViewgrams<float>>& y,
               const ViewSegmentNumbers& view_segment_num,
               const int timing_pos_num)
 {
+  ProfilerZone profiler_zone("get_viewgrams");
   if (!is_null_ptr(binwise_correction))
     {
 #ifdef STIR_OPENMP
@@ -188,8 +190,11 @@ get_viewgrams(shared_ptr<RelatedViewgrams<float>>& y,
 #ifdef STIR_OPENMP
 #  pragma omp critical(VIEW)
 #endif
-      y.reset(new RelatedViewgrams<float>(
-          proj_dat_ptr->get_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+      {
+        ProfilerZone read_zone("read viewgrams");
+        y.reset(new RelatedViewgrams<float>(
+            proj_dat_ptr->get_related_viewgrams(view_segment_num, symmetries_ptr, false, timing_pos_num)));
+      }
     }
   else
     {
@@ -206,7 +211,10 @@ get_viewgrams(shared_ptr<RelatedViewgrams<float>>& y,
 #ifdef STIR_OPENMP
 #  pragma omp critical(MULT)
 #endif
-      normalisation_sptr->undo(*mult_viewgrams_sptr);
+      {
+        ProfilerZone normalisation_zone("normalisation undo");
+        normalisation_sptr->undo(*mult_viewgrams_sptr);
+      }
     }
   else if (zero_seg0_end_planes)
     {
@@ -293,6 +301,7 @@ distributable_computation(const shared_ptr<ForwardProjectorByBin>& forward_proje
                           int max_timing_pos_num)
 
 {
+  ProfilerZone profiler_zone("distributable_computation");
 #ifdef STIR_MPI
   // TODO need to differentiate depending on RPC_process_related_viewgrams
   int task_id;
@@ -0,0 +1,99 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup recon_buildblock
+
+  \brief Implementation of stir::estimate_memory_usage and stir::write_memory_usage_estimate
+*/
+
+#include "stir/recon_buildblock/estimate_memory_usage.h"
+#include "stir/recon_buildblock/IterativeReconstruction.h"
+#include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearModelForMeanAndProjData.h"
+#include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin.h"
+#include "stir/DiscretisedDensity.h"
+#include "stir/ProjDataInMemory.h"
+#include "stir/Bin.h"
+#include "stir/is_null_ptr.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+START_NAMESPACE_STIR
+
+namespace
+{
+//! add the size of \a proj_data if it is stored in memory
+void
+add_proj_data_in_memory(MemoryUsageEstimate& estimate, const std::string& name, const ProjData* proj_data_ptr)
+{
+  if (dynamic_cast<const ProjDataInMemory*>(proj_data_ptr) != nullptr)
+    estimate.emplace_back(name, proj_data_ptr->size_all() * sizeof(float));
+}
+} // namespace
+
+MemoryUsageEstimate
+estimate_memory_usage(const IterativeReconstruction<DiscretisedDensity<3, float>>& reconstruction, const int num_threads)
+{
+  typedef DiscretisedDensity<3, float> TargetT;
+  MemoryUsageEstimate estimate;
+
+  const unique_ptr<TargetT> image_uptr(reconstruction.get_initial_data_ptr());
+  const std::size_t image_size = image_uptr->size_all() * sizeof(float);
+  const int num_subsets = reconstruction.get_num_subsets();
+
+  estimate.emplace_back("current estimate", image_size);
+  // multiplicative update or gradient, and a copy for the sensitivity-weighted update
+  estimate.emplace_back("work images", 2 * image_size);
+
+  const GeneralisedObjectiveFunction<TargetT>& objective_function = reconstruction.get_objective_function();
+
+  if (auto poisson_ptr = dynamic_cast<const PoissonLogLikelihoodWithLinearModelForMean<TargetT>*>(&objective_function))
+    estimate.emplace_back("sensitivity images", (poisson_ptr->get_use_subset_sensitivities() ? num_subsets : 1) * image_size);
+
+  // the back projectors and list-mode computations use one image per thread
+  if (num_threads > 1)
+    estimate.emplace_back("per-thread images", num_threads * image_size);
+
+  if (auto proj_data_obj_ptr
+      = dynamic_cast<const PoissonLogLikelihoodWithLinearModelForMeanAndProjData<TargetT>*>(&objective_function))
+    {
+      add_proj_data_in_memory(estimate, "input projection data", &proj_data_obj_ptr->get_proj_data());
+      if (!is_null_ptr(proj_data_obj_ptr->get_additive_proj_data_sptr()))
+        add_proj_data_in_memory(estimate, "additive projection data", proj_data_obj_ptr->get_additive_proj_data_sptr().get());
+    }
+
+  typedef PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<TargetT> LMObjectiveFunctionT;
+  if (auto lm_obj_ptr = dynamic_cast<const LMObjectiveFunctionT*>(&objective_function))
+    {
+      // set_up() uses a default of 1000000 events if no cache size was set
+      const std::size_t num_cached_events = std::max(lm_obj_ptr->get_cache_max_size(), 1000000UL);
+      estimate.emplace_back("list-mode event cache", num_cached_events * sizeof(BinAndCorr));
+    }
+
+  return estimate;
+}
+
+void
+write_memory_usage_estimate(std::ostream& s, const MemoryUsageEstimate& estimate)
+{
+  const double MB = 1024. * 1024.;
+  std::size_t total = 0;
+  s << "Estimated memory usage (MB)\n" << std::fixed << std::setprecision(1);
+  for (const auto& item : estimate)
+    {
+      s << std::setw(28) << std::left << item.first << std::right << std::setw(12) << item.second / MB << '\n';
+      total += item.second;
+    }
+  s << std::setw(28) << std::left << "total" << std::right << std::setw(12) << total / MB << '\n'
+    << "(excluding projection matrix cache, temporary projection data and priors)\n"
+    << std::defaultfloat;
+}
+
+END_NAMESPACE_STIR
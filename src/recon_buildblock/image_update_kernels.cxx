@@ -0,0 +1,311 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup recon_buildblock
+  \brief Implementation of the fused image update kernels
+
+  \see stir/recon_buildblock/image_update_kernels.h
+*/
+
+#include "stir/recon_buildblock/image_update_kernels.h"
+#include "stir/DiscretisedDensity.h"
+#include "stir/modelling/ParametricDiscretisedDensity.h"
+#include "stir/is_null_ptr.h"
+#include "stir/error.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+START_NAMESPACE_STIR
+
+namespace detail
+{
+
+//! keeps track of the minimum and maximum of a sequence of numbers
+class MinMaxTracker
+{
+public:
+  MinMaxTracker()
+      : min_value(std::numeric_limits<float>::max()),
+        max_value(std::numeric_limits<float>::lowest())
+  {}
+
+  void update(const float value)
+  {
+    min_value = std::min(min_value, value);
+    max_value = std::max(max_value, value);
+  }
+
+  void merge(const MinMaxTracker& other)
+  {
+    update(other.min_value);
+    update(other.max_value);
+  }
+
+  std::pair<float, float> get() const { return std::make_pair(min_value, max_value); }
+
+private:
+  float min_value;
+  float max_value;
+};
+
+//! gives access to the contiguous float data of an image, if possible
+/*! If \a TargetT is not an Array<3,float>, or the array is not contiguous, get() returns 0.
+    Otherwise, access is released in the destructor.
+ */
+template <class TargetT>
+class ContiguousDataAccess
+{
+public:
+  explicit ContiguousDataAccess(TargetT& image)
+      : array_ptr(dynamic_cast<Array<3, float>*>(&image)),
+        data_ptr(0),
+        num_elements(0)
+  {
+    if (!is_null_ptr(array_ptr) && array_ptr->is_contiguous())
+      {
+        data_ptr = array_ptr->get_full_data_ptr();
+        num_elements = static_cast<std::ptrdiff_t>(array_ptr->size_all());
+      }
+  }
+  ~ContiguousDataAccess()
+  {
+    if (data_ptr)
+      array_ptr->release_full_data_ptr();
+  }
+  float* get() const { return data_ptr; }
+  std::ptrdiff_t size() const { return num_elements; }
+
+private:
+  Array<3, float>* const array_ptr;
+  float* data_ptr;
+  std::ptrdiff_t num_elements;
+};
+
+//! const version of ContiguousDataAccess
+template <class TargetT>
+class ConstContiguousDataAccess
+{
+public:
+  explicit ConstContiguousDataAccess(const TargetT& image)
+      : array_ptr(dynamic_cast<const Array<3, float>*>(&image)),
+        data_ptr(0),
+        num_elements(0)
+  {
+    if (!is_null_ptr(array_ptr) && array_ptr->is_contiguous())
+      {
+        data_ptr = array_ptr->get_const_full_data_ptr();
+        num_elements = static_cast<std::ptrdiff_t>(array_ptr->size_all());
+      }
+  }
+  ~ConstContiguousDataAccess()
+  {
+    if (data_ptr)
+      array_ptr->release_const_full_data_ptr();
+  }
+  const float* get() const { return data_ptr; }
+  std::ptrdiff_t size() const { return num_elements; }
+
+private:
+  const Array<3, float>* const array_ptr;
+  const float* data_ptr;
+  std::ptrdiff_t num_elements;
+};
+
+//! applies \a f to every element of \a image, keeping track of min/max of the values returned by \a f
+/*! \a f is called as <tt>f(float& elem)</tt> and should return a \c float.
+ */
+template <class TargetT, class FunctionT>
+MinMaxTracker
+transform_with_min_max(TargetT& image, FunctionT f)
+{
+  MinMaxTracker result;
+  {
+    ContiguousDataAccess<TargetT> data(image);
+    float* const data_ptr = data.get();
+    if (data_ptr)
+      {
+        const std::ptrdiff_t num_elements = data.size();
+#ifdef STIR_OPENMP
+#  pragma omp parallel
+#endif
+        {
+          MinMaxTracker local_min_max;
+#ifdef STIR_OPENMP
+#  pragma omp for schedule(static)
+#endif
+          for (std::ptrdiff_t i = 0; i < num_elements; ++i)
+            local_min_max.update(f(data_ptr[i]));
+#ifdef STIR_OPENMP
+#  pragma omp critical(IMAGEUPDATEKERNELSMINMAX)
+#endif
+          result.merge(local_min_max);
+        }
+        return result;
+      }
+  }
+  // fall-back to serial loop over full iterators
+  for (typename TargetT::full_iterator iter = image.begin_all(); iter != image.end_all(); ++iter)
+    result.update(f(*iter));
+  return result;
+}
+
+//! applies \a f to every element of \a image and \a other, keeping track of min/max of the values returned by \a f
+/*! \a f is called as <tt>f(float& elem, const float other_elem)</tt> and should return a \c float.
+ */
+template <class TargetT, class FunctionT>
+MinMaxTracker
+transform_with_min_max(TargetT& image, const TargetT& other, FunctionT f)
+{
+  MinMaxTracker result;
+  {
+    ContiguousDataAccess<TargetT> data(image);
+    ConstContiguousDataAccess<TargetT> other_data(other);
+    float* const data_ptr = data.get();
+    const float* const other_data_ptr = other_data.get();
+    if (data_ptr && other_data_ptr)
+      {
+        const std::ptrdiff_t num_elements = data.size();
+        if (other_data.size() != num_elements)
+          error("image update kernels: images have different number of elements");
+#ifdef STIR_OPENMP
+#  pragma omp parallel
+#endif
+        {
+          MinMaxTracker local_min_max;
+#ifdef STIR_OPENMP
+#  pragma omp for schedule(static)
+#endif
+          for (std::ptrdiff_t i = 0; i < num_elements; ++i)
+            local_min_max.update(f(data_ptr[i], other_data_ptr[i]));
+#ifdef STIR_OPENMP
+#  pragma omp critical(IMAGEUPDATEKERNELSMINMAX)
+#endif
+          result.merge(local_min_max);
+        }
+        return result;
+      }
+  }
+  // fall-back to serial loop over full iterators
+  typename TargetT::const_full_iterator other_iter = other.begin_all_const();
+  for (typename TargetT::full_iterator iter = image.begin_all(); iter != image.end_all(); ++iter, ++other_iter)
+    result.update(f(*iter, *other_iter));
+  return result;
+}
+
+} // namespace detail
+
+template <class TargetT>
+void
+compute_MAP_OSL_denominator(TargetT& denominator,
+                            const TargetT& sensitivity,
+                            const int num_subsets,
+                            const bool multiplicative_model)
+{
+  if (multiplicative_model)
+    {
+      // lambda_new = lambda / (p_v*(1 + beta*prior_gradient)) * sum_subset backproj(measured/forwproj(lambda))
+      // but we restrict 1 + beta*prior_gradient between .1 and 10
+      detail::transform_with_min_max(denominator, sensitivity, [](float& d, const float s) {
+        d = std::max(std::min(d + 1, 10.F), 1 / 10.F) * s;
+        return d;
+      });
+    }
+  else
+    {
+      // lambda_new = lambda / (p_v + beta*prior_gradient/ num_subsets) * sum_subset backproj(measured/forwproj(lambda))
+      // but we restrict the denominator between p_v/10 and p_v*10
+      detail::transform_with_min_max(denominator, sensitivity, [num_subsets](float& d, const float s) {
+        d = std::max(std::min(d / num_subsets + s, s * 10), s / 10);
+        return d;
+      });
+    }
+}
+
+template <class TargetT>
+std::pair<float, float>
+divide_and_threshold_update(
+    TargetT& numerator, const TargetT& denominator, const float small_num, const float new_min, const float new_max)
+{
+  float small_value = 0.F;
+  if (small_num != 0)
+    {
+      const float max_numerator = detail::transform_with_min_max(numerator, [](float& n) { return n; }).get().second;
+      small_value = std::max(max_numerator * small_num, 0.F);
+    }
+
+  return detail::transform_with_min_max(numerator, denominator, [small_value, new_min, new_max](float& n, const float d) {
+           const float ratio = (std::fabs(d) <= small_value && std::fabs(n) <= small_value) ? 0.F : n / d;
+           n = std::max(std::min(ratio, new_max), new_min);
+           return ratio;
+         })
+      .get();
+}
+
+template <class TargetT>
+void
+multiply_in_place(TargetT& image, const TargetT& factor)
+{
+  detail::transform_with_min_max(image, factor, [](float& x, const float f) {
+    x *= f;
+    return x;
+  });
+}
+
+template <class TargetT>
+std::pair<float, float>
+scale_in_place(TargetT& image, const float factor)
+{
+  return detail::transform_with_min_max(image, [factor](float& x) {
+           x *= factor;
+           return x;
+         })
+      .get();
+}
+
+template <class TargetT>
+std::pair<float, float>
+divide_and_scale(TargetT& numerator, const TargetT& denominator, const float factor)
+{
+  return detail::transform_with_min_max(numerator, denominator, [factor](float& n, const float d) {
+           n = n / d * factor;
+           return n;
+         })
+      .get();
+}
+
+template <class TargetT>
+std::pair<float, float>
+add_and_threshold(TargetT& image, const TargetT& update, const float new_min, const float new_max)
+{
+  return detail::transform_with_min_max(image, update, [new_min, new_max](float& x, const float u) {
+           const float sum = x + u;
+           x = std::max(std::min(sum, new_max), new_min);
+           return sum;
+         })
+      .get();
+}
+
+#define INSTANTIATE(TargetT)                                                                                                     \
+  template void compute_MAP_OSL_denominator(TargetT&, const TargetT&, const int, const bool);                                    \
+  template std::pair<float, float> divide_and_threshold_update(TargetT&, const TargetT&, const float, const float, const float); \
+  template void multiply_in_place(TargetT&, const TargetT&);                                                                     \
+  template std::pair<float, float> scale_in_place(TargetT&, const float);                                                        \
+  template std::pair<float, float> divide_and_scale(TargetT&, const TargetT&, const float);                                      \
+  template std::pair<float, float> add_and_threshold(TargetT&, const TargetT&, const float, const float);
+
+typedef DiscretisedDensity<3, float> DiscretisedDensityType;
+INSTANTIATE(DiscretisedDensityType)
+INSTANTIATE(ParametricVoxelsOnCartesianGrid)
+
+#undef INSTANTIATE
+
+END_NAMESPACE_STIR
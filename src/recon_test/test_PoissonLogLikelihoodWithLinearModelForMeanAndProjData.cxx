@@ -1,6 +1,6 @@
 /*
     Copyright (C) 2011, Hammersmith Imanet Ltd
-    Copyright (C) 2013, 2021, 2024 University College London
+    Copyright (C) 2013, 2021, 2024, 2026 University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -43,6 +43,7 @@
 #include "stir/recon_buildblock/distributable_main.h"
 #include "stir/IO/read_from_file.h"
 #include "stir/IO/write_to_file.h"
+#include "stir/FilePath.h"
 #include "stir/info.h"
 #include "stir/Succeeded.h"
 #include "stir/num_threads.h"
@@ -50,8 +51,10 @@
 #include <boost/random/normal_distribution.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/variate_generator.hpp>
+#include <cstdio>
 #include <iostream>
 #include <memory>
+#include <string>
 
 #include "stir/IO/OutputFileFormat.h"
 #include "stir/recon_buildblock/distributable_main.h"
@@ -111,6 +114,9 @@ protected:
 
   //! Test the approximate Hessian of the objective function by testing the (x^T Hx > 0) condition
   void test_approximate_Hessian_concavity(objective_function_type& objective_function, target_type& target);
+
+  //! Test writing and reading sensitivities to/from the cache (in the current directory)
+  void test_sensitivity_cache(const target_type& target);
 };
 
 PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests(
@@ -173,6 +179,41 @@ PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::test_approximate_Hes
     }
 }
 
+void
+PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::test_sensitivity_cache(const target_type& target)
+{
+  auto& objective_function = *this->objective_function_sptr;
+  const int num_subsets = objective_function.get_num_subsets();
+  // sensitivity computed without the cache
+  const shared_ptr<const target_type> subsens_sptr(objective_function.get_subset_sensitivity(num_subsets - 1).clone());
+
+  objective_function.set_sensitivity_cache_directory(".");
+  objective_function.set_recompute_sensitivity(true);
+  if (!check(objective_function.set_up(shared_ptr<target_type>(target.clone())) == Succeeded::yes, "set-up with cache"))
+    return;
+  const std::string prefix = objective_function.get_sensitivity_cache_filename_prefix(target);
+  check(!prefix.empty(), "sensitivity cache should be supported");
+  check(FilePath::exists(prefix + ".key"), "sensitivity cache key file should have been written");
+  check_if_equal(objective_function.get_subset_sensitivity(num_subsets - 1), *subsens_sptr, "subset sensitivity with cache");
+
+  // modify the cached image to check that it is read
+  const std::string filename = prefix + "_subset" + std::to_string(num_subsets - 1) + ".hv";
+  shared_ptr<target_type> modified_sptr(subsens_sptr->clone());
+  *modified_sptr += 1.F;
+  write_to_file(filename, *modified_sptr);
+  if (!check(objective_function.set_up(shared_ptr<target_type>(target.clone())) == Succeeded::yes, "set-up reading cache"))
+    return;
+  check_if_equal(
+      objective_function.get_subset_sensitivity(num_subsets - 1), *modified_sptr, "subset sensitivity read from cache");
+
+  // clean-up
+  std::remove((prefix + ".key").c_str());
+  for (int subset_num = 0; subset_num < num_subsets; ++subset_num)
+    for (const char* const extension : { ".hv", ".ahv", ".v" })
+      std::remove((prefix + "_subset" + std::to_string(subset_num) + extension).c_str());
+  objective_function.set_sensitivity_cache_directory("");
+}
+
 void
 PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::construct_input_data(shared_ptr<target_type>& density_sptr,
                                                                                  const bool TOF_or_not)
@@ -345,6 +386,8 @@ PoissonLogLikelihoodWithLinearModelForMeanAndProjDataTests::run_tests()
     shared_ptr<target_type> density_sptr;
     construct_input_data(density_sptr, /*TOF_or_not=*/false);
     this->run_tests_for_objective_function(*this->objective_function_sptr, *density_sptr);
+    std::cerr << "----- testing sensitivity cache\n";
+    this->test_sensitivity_cache(*density_sptr);
   }
   if (this->proj_data_filename == 0)
     {
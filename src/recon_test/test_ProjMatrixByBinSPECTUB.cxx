@@ -0,0 +1,195 @@
+/*!
+
+  \file
+  \ingroup recontest
+
+  \brief Test program for the on-disk matrix cache of stir::ProjMatrixByBinSPECTUB
+
+  \author Kris Thielemans
+*/
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+
+#include "stir/recon_buildblock/ProjMatrixByBinSPECTUB.h"
+#include "stir/recon_buildblock/ProjMatrixElemsForOneBin.h"
+#include "stir/ProjDataInfoCylindricalArcCorr.h"
+#include "stir/VoxelsOnCartesianGrid.h"
+#include "stir/Scanner.h"
+#include "stir/Bin.h"
+#include "stir/Verbosity.h"
+#include "stir/RunTests.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup test
+  \brief Test class for the on-disk matrix cache of ProjMatrixByBinSPECTUB
+
+  Computes the matrix without on-disk cache, then with an empty cache directory (which writes the files), and then
+  again with the same directory (which should read the files). Finally, it checks that damaged or incompatible files are
+  ignored and rewritten. All matrices should give identical rows.
+
+  The test uses "simple" attenuation, such that it also checks applying the attenuation factors after reading the files.
+*/
+class ProjMatrixByBinSPECTUBTests : public RunTests
+{
+public:
+  void run_tests() override;
+
+private:
+  typedef std::vector<ProjMatrixElemsForOneBin> Rows;
+
+  //! set up a matrix with the given cache directory (empty string disables the on-disk cache)
+  shared_ptr<ProjMatrixByBinSPECTUB> create_matrix(const std::string& cache_directory) const;
+  //! get the rows for all bins of segment 0
+  Rows get_rows(const ProjMatrixByBinSPECTUB& matrix) const;
+  //! get the names of all files in the cache directory
+  std::vector<std::filesystem::path> get_cache_files() const;
+  //! set the modification time of all files in the cache directory to an hour ago
+  std::filesystem::file_time_type set_cache_files_to_old_time() const;
+
+  shared_ptr<const ProjDataInfo> proj_data_info_sptr;
+  shared_ptr<VoxelsOnCartesianGrid<float>> image_sptr;
+  std::string cache_directory;
+};
+
+shared_ptr<ProjMatrixByBinSPECTUB>
+ProjMatrixByBinSPECTUBTests::create_matrix(const std::string& cache_directory) const
+{
+  auto attenuation_sptr = shared_ptr<VoxelsOnCartesianGrid<float>>(image_sptr->get_empty_copy());
+  attenuation_sptr->fill(0.15F);
+
+  auto matrix_sptr = std::make_shared<ProjMatrixByBinSPECTUB>();
+  matrix_sptr->set_keep_all_views_in_cache(true);
+  matrix_sptr->set_resolution_model(1.5F, 0.0163F, /* full_3D */ false);
+  matrix_sptr->set_attenuation_image_sptr(attenuation_sptr);
+  matrix_sptr->set_attenuation_type("simple");
+  matrix_sptr->set_matrix_cache_directory(cache_directory);
+  matrix_sptr->set_up(proj_data_info_sptr, image_sptr);
+  return matrix_sptr;
+}
+
+ProjMatrixByBinSPECTUBTests::Rows
+ProjMatrixByBinSPECTUBTests::get_rows(const ProjMatrixByBinSPECTUB& matrix) const
+{
+  Rows rows;
+  ProjMatrixElemsForOneBin lor;
+  for (int view_num = proj_data_info_sptr->get_min_view_num(); view_num <= proj_data_info_sptr->get_max_view_num(); ++view_num)
+    for (int axial_pos_num = proj_data_info_sptr->get_min_axial_pos_num(0);
+         axial_pos_num <= proj_data_info_sptr->get_max_axial_pos_num(0);
+         ++axial_pos_num)
+      for (int tang_pos_num = proj_data_info_sptr->get_min_tangential_pos_num();
+           tang_pos_num <= proj_data_info_sptr->get_max_tangential_pos_num();
+           ++tang_pos_num)
+        {
+          matrix.get_proj_matrix_elems_for_one_bin(lor, Bin(0, view_num, axial_pos_num, tang_pos_num));
+          rows.push_back(lor);
+        }
+  return rows;
+}
+
+std::vector<std::filesystem::path>
+ProjMatrixByBinSPECTUBTests::get_cache_files() const
+{
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(cache_directory))
+    files.push_back(entry.path());
+  return files;
+}
+
+std::filesystem::file_time_type
+ProjMatrixByBinSPECTUBTests::set_cache_files_to_old_time() const
+{
+  const auto old_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+  for (const auto& file : get_cache_files())
+    std::filesystem::last_write_time(file, old_time);
+  return old_time;
+}
+
+void
+ProjMatrixByBinSPECTUBTests::run_tests()
+{
+  auto scanner_sptr = std::make_shared<Scanner>(Scanner::E953);
+  scanner_sptr->set_num_rings(4);
+  proj_data_info_sptr = ProjDataInfo::construct_proj_data_info(scanner_sptr,
+                                                               /*span*/ 1,
+                                                               /*max_delta*/ 0,
+                                                               /*views*/ 8,
+                                                               /*tang_pos*/ 32,
+                                                               /*arc_corrected*/ true);
+  image_sptr = std::make_shared<VoxelsOnCartesianGrid<float>>(
+      *proj_data_info_sptr, 1.F, CartesianCoordinate3D<float>(0.F, 0.F, 0.F), CartesianCoordinate3D<int>(-1, 32, 32));
+
+  cache_directory = "test_ProjMatrixByBinSPECTUB_cache";
+  std::filesystem::remove_all(cache_directory);
+  std::filesystem::create_directory(cache_directory);
+
+  std::cerr << "Computing matrix without on-disk cache\n";
+  const Rows ref_rows = get_rows(*create_matrix(""));
+
+  std::cerr << "Computing matrix and writing it to the on-disk cache\n";
+  check(get_rows(*create_matrix(cache_directory)) == ref_rows, "rows should be identical when writing the cache files");
+  const auto cache_files = get_cache_files();
+  check_if_equal(static_cast<int>(cache_files.size()),
+                 proj_data_info_sptr->get_num_views(),
+                 "there should be one cache file per view");
+  if (!is_everything_ok())
+    return;
+
+  std::cerr << "Reading matrix from the on-disk cache\n";
+  {
+    // if files are read, they are not rewritten, so their modification time does not change
+    const auto old_time = set_cache_files_to_old_time();
+    check(get_rows(*create_matrix(cache_directory)) == ref_rows, "rows should be identical when reading the cache files");
+    for (const auto& file : cache_files)
+      check(std::filesystem::last_write_time(file) == old_time, "cache file " + file.string() + " should not be rewritten");
+  }
+
+  std::cerr << "Checking that damaged or incompatible cache files are ignored (expect warnings)\n";
+  {
+    // change one character of the key stored in the first file (after the signature line and the key length)
+    {
+      std::fstream fst(cache_files[0], std::ios::in | std::ios::out | std::ios::binary);
+      std::string signature;
+      std::getline(fst, signature);
+      fst.seekp(static_cast<std::streamoff>(signature.size() + 1 + 4));
+      fst.put('X');
+    }
+    // truncate the second file
+    std::filesystem::resize_file(cache_files[1], std::filesystem::file_size(cache_files[1]) / 2);
+
+    const auto old_time = set_cache_files_to_old_time();
+    check(get_rows(*create_matrix(cache_directory)) == ref_rows, "rows should be identical with damaged cache files");
+    check(std::filesystem::last_write_time(cache_files[0]) != old_time,
+          "cache file with a different key should be recomputed and rewritten");
+    check(std::filesystem::last_write_time(cache_files[1]) != old_time, "truncated cache file should be recomputed and rewritten");
+    check(std::filesystem::last_write_time(cache_files[2]) == old_time, "other cache files should not be rewritten");
+  }
+
+  if (is_everything_ok())
+    std::filesystem::remove_all(cache_directory);
+}
+
+END_NAMESPACE_STIR
+
+USING_NAMESPACE_STIR
+
+int
+main()
+{
+  Verbosity::set(1);
+  ProjMatrixByBinSPECTUBTests tests;
+  tests.run_tests();
+  return tests.main_return_value();
+}
@@ -38,6 +38,7 @@
 #include "stir/IO/write_to_file.h"
 #include "stir/IO/read_from_file.h"
 #include "stir/ArrayFunction.h"
+#include "stir/thresholding.h"
 #include "stir/NumericInfo.h"
 #include "stir/SegmentByView.h"
 #include "stir/VoxelsOnCartesianGrid.h"
@@ -58,6 +59,7 @@ void
 ScatterEstimation::set_defaults()
 {
   this->_already_setup = false;
+  this->reconstruction_already_set_up = false;
   this->scatter_simulation_sptr.reset(new SingleScatterSimulation);
   this->recompute_atten_projdata = true;
   this->recompute_mask_image = true;
@@ -655,6 +657,7 @@ Succeeded
 ScatterEstimation::set_up_iterative(shared_ptr<IterativeReconstruction<DiscretisedDensity<3, float>>> iterative_object)
 {
   info("ScatterEstimation: Setting up iterative reconstruction ...");
+  this->reconstruction_already_set_up = false;
 
   if (run_in_2d_projdata)
     {
@@ -941,8 +944,12 @@ ScatterEstimation::process_data()
         }
 
       info("ScatterEstimation: Scatter simulation in progress...");
-      if (this->scatter_simulation_sptr->set_up() == Succeeded::no)
-        error("ScatterEstimation: Failure at set_up() of the Scatter Simulation.");
+      // The simulation stays set up when only the activity image has changed, keeping its cache of attenuation integrals.
+      if (!this->scatter_simulation_sptr->already_set_up())
+        {
+          if (this->scatter_simulation_sptr->set_up() == Succeeded::no)
+            error("ScatterEstimation: Failure at set_up() of the Scatter Simulation.");
+        }
 
       if (this->scatter_simulation_sptr->process_data() == Succeeded::no)
         error("ScatterEstimation: Scatter simulation failed");
@@ -1127,10 +1134,23 @@ ScatterEstimation::reconstruct_iterative(int _current_iter_num)
   shared_ptr<IterativeReconstruction<DiscretisedDensity<3, float>>> tmp_iterative
       = dynamic_pointer_cast<IterativeReconstruction<DiscretisedDensity<3, float>>>(reconstruction_template_sptr);
 
-  // Now, we can call Reconstruction::set_up().
-  if (tmp_iterative->set_up(this->current_activity_image_sptr) == Succeeded::no)
+  // Now, we can call Reconstruction::set_up(), but only once.
+  // Afterwards, only the activity image and the additive sinogram (which is updated in-place) change, so we can keep
+  // the objective function (including sensitivities) and projectors.
+  if (!this->reconstruction_already_set_up)
+    {
+      if (tmp_iterative->set_up(this->current_activity_image_sptr) == Succeeded::no)
+        {
+          error("ScatterEstimation: Failure at set_up() of the reconstruction method. Aborting.");
+        }
+      this->reconstruction_already_set_up = true;
+    }
+  else if (tmp_iterative->get_registered_name() == "OSMAPOSL" || tmp_iterative->get_registered_name() == "KOSMAPOSL")
     {
-      error("ScatterEstimation: Failure at set_up() of the reconstruction method. Aborting.");
+      // set_up() of multiplicative algorithms would make the estimate positive, so we do that here.
+      // Otherwise, voxels that are zero could never become positive again.
+      threshold_min_to_small_positive_value(
+          this->current_activity_image_sptr->begin_all(), this->current_activity_image_sptr->end_all(), 0.000001F);
     }
 
   tmp_iterative->reconstruct(this->current_activity_image_sptr);
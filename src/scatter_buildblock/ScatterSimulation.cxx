@@ -433,9 +433,21 @@ ScatterSimulation::set_activity_image_sptr(const shared_ptr<const DiscretisedDen
   if (is_null_ptr(arg))
     error("ScatterSimulation: Unable to set the activity image");
 
+  // the set-up (including the cache for attenuation integrals) only depends on the characteristics of the activity image
+  const bool keep_set_up = this->_already_set_up && !is_null_ptr(this->activity_image_sptr)
+                           && this->activity_image_sptr->has_same_characteristics(*arg);
   this->activity_image_sptr = arg;
   this->remove_cache_for_integrals_over_activity();
-  this->_already_set_up = false;
+  if (keep_set_up)
+    this->initialise_cache_for_scattpoint_det_integrals_over_activity();
+  else
+    this->_already_set_up = false;
+}
+
+bool
+ScatterSimulation::already_set_up() const
+{
+  return this->_already_set_up;
 }
 
 void
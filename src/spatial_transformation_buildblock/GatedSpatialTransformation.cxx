@@ -17,7 +17,7 @@
 */
 
 #include "stir/spatial_transformation/GatedSpatialTransformation.h"
-#include "stir/spatial_transformation/warp_image.h"
+#include "stir/spatial_transformation/PrecomputedWarpOperator.h"
 #include "stir/info.h"
 #include "stir/warning.h"
 #include "stir/error.h"
@@ -122,6 +122,7 @@ GatedSpatialTransformation::read_from_files(const std::string input_string)
   this->_spatial_transformation_y = spatial_transformation_y;
   this->_spatial_transformation_x = spatial_transformation_x;
   this->_spatial_transformations_are_stored = true;
+  this->_warp_operators.clear();
 }
 
 //! Implementation to write the transformation vectors
@@ -134,6 +135,29 @@ GatedSpatialTransformation::write_to_files(const std::string output_string)
   //	return Succeeded::yes; // add a no case if you cannot write
 }
 
+void
+GatedSpatialTransformation::set_up_warp_operators() const
+{
+#ifdef STIR_OPENMP
+#  pragma omp critical(GATEDSPATIALTRANSFORMATIONWARPOPERATORS)
+#endif
+  {
+    if (!this->_spatial_transformations_are_stored)
+      error("The transformation fields haven't been set properly yet.");
+    const std::size_t num_gates = this->_spatial_transformation_x.get_densities().size();
+    if (this->_warp_operators.size() != num_gates + 1)
+      {
+        info(boost::format("GatedSpatialTransformation: computing warp operators for %1% gates") % num_gates);
+        std::vector<shared_ptr<const PrecomputedWarpOperator>> warp_operators(num_gates + 1);
+        for (unsigned int gate_num = 1; gate_num <= num_gates; ++gate_num)
+          warp_operators[gate_num].reset(new PrecomputedWarpOperator(this->_spatial_transformation_x[gate_num],
+                                                                     this->_spatial_transformation_y[gate_num],
+                                                                     this->_spatial_transformation_z[gate_num]));
+        this->_warp_operators.swap(warp_operators);
+      }
+  }
+}
+
 void
 GatedSpatialTransformation::warp_image(GatedDiscretisedDensity& new_gated_image, const GatedDiscretisedDensity& gated_image) const
 {
@@ -147,16 +171,9 @@ GatedSpatialTransformation::warp_image(GatedDiscretisedDensity& new_gated_image,
   assert(gated_image.get_time_gate_definitions().get_num_gates()
          == this->_spatial_transformation_x.get_time_gate_definitions().get_num_gates());
   new_gated_image.fill_with_zero();
-  if (this->_spatial_transformations_are_stored)
-    for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
-      new_gated_image[gate_num] = stir::warp_image((gated_image.get_densities())[gate_num - 1],
-                                                   (this->_spatial_transformation_x.get_densities())[gate_num - 1],
-                                                   (this->_spatial_transformation_y.get_densities())[gate_num - 1],
-                                                   (this->_spatial_transformation_z.get_densities())[gate_num - 1],
-                                                   BSpline::linear,
-                                                   false);
-  else
-    error("The transformation fields haven't been set properly yet.\n");
+  this->set_up_warp_operators();
+  for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
+    this->_warp_operators[gate_num]->apply(new_gated_image[gate_num], gated_image[gate_num]);
 }
 
 void
@@ -171,15 +188,30 @@ void
 GatedSpatialTransformation::accumulate_warp_image(DiscretisedDensity<3, float>& new_reference_image,
                                                   const GatedDiscretisedDensity& gated_image) const
 {
-  GatedDiscretisedDensity new_gated_image(gated_image);
-  new_gated_image.fill_with_zero();
-  this->warp_image(new_gated_image, gated_image);
+  this->set_up_warp_operators();
   //! todo This is not implemented as sum (or should it be the average?)
   for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
-    new_reference_image += new_gated_image[gate_num];
+    this->_warp_operators[gate_num]->accumulate_apply(new_reference_image, gated_image[gate_num]);
   //	new_reference_image /= gated_image.get_time_gate_definitions().get_num_gates();
 }
 
+void
+GatedSpatialTransformation::warp_image_transpose(DiscretisedDensity<3, float>& new_reference_image,
+                                                 const GatedDiscretisedDensity& gated_image) const
+{
+  new_reference_image.fill(0.F);
+  this->accumulate_warp_image_transpose(new_reference_image, gated_image);
+}
+
+void
+GatedSpatialTransformation::accumulate_warp_image_transpose(DiscretisedDensity<3, float>& new_reference_image,
+                                                            const GatedDiscretisedDensity& gated_image) const
+{
+  this->set_up_warp_operators();
+  for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
+    this->_warp_operators[gate_num]->accumulate_apply_transpose(new_reference_image, gated_image[gate_num]);
+}
+
 void
 GatedSpatialTransformation::warp_image(GatedDiscretisedDensity& gated_image,
                                        const DiscretisedDensity<3, float>& reference_image) const
@@ -195,24 +227,15 @@ GatedSpatialTransformation::warp_image(GatedDiscretisedDensity& gated_image,
            % (this->_spatial_transformation_y.get_densities())[0]->size_all());
       error("GatedSpatialTransformation::warp_image needs the same sizes for motion vectors and input/output images.\n");
     }
-  const shared_ptr<DiscretisedDensity<3, float>> reference_image_sptr(reference_image.clone());
   gated_image.resize_densities(this->_gate_defs);
 
-  if (this->_spatial_transformations_are_stored)
-    for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
-      {
-        const VoxelsOnCartesianGrid<float> density
-            = stir::warp_image(reference_image_sptr,
-                               (this->_spatial_transformation_x.get_densities())[gate_num - 1],
-                               (this->_spatial_transformation_y.get_densities())[gate_num - 1],
-                               (this->_spatial_transformation_z.get_densities())[gate_num - 1],
-                               BSpline::linear,
-                               false);
-        const shared_ptr<DiscretisedDensity<3, float>> density_sptr(density.clone());
-        gated_image.set_density_sptr(density_sptr, gate_num);
-      }
-  else
-    error("The transformation fields haven't been set properly yet.");
+  this->set_up_warp_operators();
+  for (unsigned int gate_num = 1; gate_num <= gated_image.get_time_gate_definitions().get_num_gates(); ++gate_num)
+    {
+      const shared_ptr<DiscretisedDensity<3, float>> density_sptr(reference_image.get_empty_copy());
+      this->_warp_operators[gate_num]->apply(*density_sptr, reference_image);
+      gated_image.set_density_sptr(density_sptr, gate_num);
+    }
 }
 
 void
@@ -224,6 +247,7 @@ GatedSpatialTransformation::set_spatial_transformations(const GatedDiscretisedDe
   this->_spatial_transformation_y = transformation_y;
   this->_spatial_transformation_x = transformation_x;
   this->_spatial_transformations_are_stored = true;
+  this->_warp_operators.clear();
 }
 
 void
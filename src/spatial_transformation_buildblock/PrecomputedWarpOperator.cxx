@@ -0,0 +1,228 @@
+//
+/*
+ Copyright (C) 2026, University College London
+ This file is part of STIR.
+
+ SPDX-License-Identifier: Apache-2.0
+
+ See STIR/LICENSE.txt for details
+ */
+/*!
+ \file
+ \ingroup spatial_transformation
+ \brief Implementation of class stir::PrecomputedWarpOperator
+*/
+
+#include "stir/spatial_transformation/PrecomputedWarpOperator.h"
+#include "stir/DiscretisedDensityOnCartesianGrid.h"
+#include "stir/IndexRange.h"
+#include "stir/is_null_ptr.h"
+#include "stir/error.h"
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+START_NAMESPACE_STIR
+
+PrecomputedWarpOperator::PrecomputedWarpOperator(const DiscretisedDensity<3, float>& motion_x,
+                                                 const DiscretisedDensity<3, float>& motion_y,
+                                                 const DiscretisedDensity<3, float>& motion_z)
+{
+  const DiscretisedDensityOnCartesianGrid<3, float>* motion_cartesian_ptr
+      = dynamic_cast<const DiscretisedDensityOnCartesianGrid<3, float>*>(&motion_x);
+  if (is_null_ptr(motion_cartesian_ptr))
+    error("PrecomputedWarpOperator: motion field has to be on a Cartesian grid");
+  const BasicCoordinate<3, float> grid_spacing = motion_cartesian_ptr->get_grid_spacing();
+
+  if (!motion_x.get_index_range().get_regular_range(min_index, max_index))
+    error("PrecomputedWarpOperator: motion field is not in regular grid.");
+  if (motion_y.get_index_range() != motion_x.get_index_range() || motion_z.get_index_range() != motion_x.get_index_range())
+    error("PrecomputedWarpOperator: motion fields need to have the same index range");
+
+  const BasicCoordinate<3, int> sizes = max_index - min_index + 1;
+  num_voxels = static_cast<std::ptrdiff_t>(sizes[1]) * sizes[2] * sizes[3];
+  if (num_voxels * num_weights_per_voxel > static_cast<std::ptrdiff_t>(std::numeric_limits<index_type>::max()))
+    error(boost::format("PrecomputedWarpOperator: image too large (%1% voxels) for 32-bit indices") % num_voxels);
+  indices.resize(num_voxels * num_weights_per_voxel);
+  weights.resize(num_voxels * num_weights_per_voxel);
+
+  // find interpolation weights for every output voxel
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+  for (int z = min_index[1]; z <= max_index[1]; ++z)
+    {
+      BasicCoordinate<3, int> c;
+      c[1] = z;
+      for (c[2] = min_index[2]; c[2] <= max_index[2]; ++c[2])
+        for (c[3] = min_index[3]; c[3] <= max_index[3]; ++c[3])
+          {
+            const std::ptrdiff_t row = ((static_cast<std::ptrdiff_t>(c[1] - min_index[1])) * sizes[2] + (c[2] - min_index[2]))
+                                           * sizes[3]
+                                       + (c[3] - min_index[3]);
+            index_type* const row_indices = &indices[row * num_weights_per_voxel];
+            float* const row_weights = &weights[row * num_weights_per_voxel];
+
+            BasicCoordinate<3, double> d;
+            d[1] = static_cast<double>(c[1]) + static_cast<double>(motion_z[c] / grid_spacing[1]);
+            d[2] = static_cast<double>(c[2]) + static_cast<double>(motion_y[c] / grid_spacing[2]);
+            d[3] = static_cast<double>(c[3]) + static_cast<double>(motion_x[c] / grid_spacing[3]);
+
+            // same convention as warp_image(): voxels that would need values on or outside the border are set to 0
+            bool outside = false;
+            for (int dim = 1; dim <= 3; ++dim)
+              if (d[dim] <= static_cast<double>(min_index[dim]) || d[dim] >= static_cast<double>(max_index[dim]))
+                outside = true;
+            if (outside)
+              {
+                std::fill(row_indices, row_indices + num_weights_per_voxel, static_cast<index_type>(row));
+                std::fill(row_weights, row_weights + num_weights_per_voxel, 0.F);
+                continue;
+              }
+
+            BasicCoordinate<3, int> lower;
+            BasicCoordinate<3, double> frac;
+            for (int dim = 1; dim <= 3; ++dim)
+              {
+                lower[dim] = static_cast<int>(std::floor(d[dim]));
+                frac[dim] = d[dim] - lower[dim];
+              }
+            // tri-linear interpolation (equivalent to linear B-splines)
+            for (int k = 0; k < num_weights_per_voxel; ++k)
+              {
+                const int dz = (k >> 2) & 1;
+                const int dy = (k >> 1) & 1;
+                const int dx = k & 1;
+                row_indices[k] = static_cast<index_type>(
+                    ((static_cast<std::ptrdiff_t>(lower[1] + dz - min_index[1])) * sizes[2] + (lower[2] + dy - min_index[2]))
+                        * sizes[3]
+                    + (lower[3] + dx - min_index[3]));
+                row_weights[k] = static_cast<float>((dz ? frac[1] : 1 - frac[1]) * (dy ? frac[2] : 1 - frac[2])
+                                                    * (dx ? frac[3] : 1 - frac[3]));
+              }
+          }
+    }
+
+  // construct transpose in compressed sparse row format, ignoring zero weights
+  transpose_row_start.assign(num_voxels + 1, 0);
+  for (std::size_t i = 0; i < weights.size(); ++i)
+    if (weights[i] != 0.F)
+      ++transpose_row_start[indices[i] + 1];
+  for (std::ptrdiff_t r = 0; r < num_voxels; ++r)
+    transpose_row_start[r + 1] += transpose_row_start[r];
+  transpose_indices.resize(transpose_row_start[num_voxels]);
+  transpose_weights.resize(transpose_row_start[num_voxels]);
+  {
+    std::vector<index_type> current_position(transpose_row_start.begin(), transpose_row_start.end() - 1);
+    for (std::ptrdiff_t row = 0; row < num_voxels; ++row)
+      for (int k = 0; k < num_weights_per_voxel; ++k)
+        {
+          const std::size_t i = row * num_weights_per_voxel + k;
+          if (weights[i] == 0.F)
+            continue;
+          const index_type position = current_position[indices[i]]++;
+          transpose_indices[position] = static_cast<index_type>(row);
+          transpose_weights[position] = weights[i];
+        }
+  }
+}
+
+void
+PrecomputedWarpOperator::check(const DiscretisedDensity<3, float>& density) const
+{
+  BasicCoordinate<3, int> min, max;
+  if (!density.get_index_range().get_regular_range(min, max) || min != min_index || max != max_index)
+    error("PrecomputedWarpOperator: image has a different index range from the motion field");
+}
+
+void
+PrecomputedWarpOperator::apply_helper(DiscretisedDensity<3, float>& out_density,
+                                      const DiscretisedDensity<3, float>& in_density,
+                                      const bool accumulate,
+                                      const bool transpose) const
+{
+  if (&out_density == &in_density)
+    error("PrecomputedWarpOperator: cannot warp an image in-place");
+  this->check(out_density);
+  this->check(in_density);
+
+  // get pointers to contiguous data (copying if necessary)
+  std::vector<float> in_buffer;
+  const float* in_ptr;
+  if (in_density.is_contiguous())
+    in_ptr = in_density.get_const_full_data_ptr();
+  else
+    {
+      in_buffer.assign(in_density.begin_all_const(), in_density.end_all_const());
+      in_ptr = in_buffer.data();
+    }
+  std::vector<float> out_buffer;
+  float* out_ptr;
+  if (out_density.is_contiguous())
+    out_ptr = out_density.get_full_data_ptr();
+  else
+    {
+      out_buffer.assign(out_density.begin_all_const(), out_density.end_all_const());
+      out_ptr = out_buffer.data();
+    }
+
+#ifdef STIR_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+  for (std::ptrdiff_t row = 0; row < num_voxels; ++row)
+    {
+      float sum = 0.F;
+      if (transpose)
+        {
+          for (index_type i = transpose_row_start[row]; i < transpose_row_start[row + 1]; ++i)
+            sum += transpose_weights[i] * in_ptr[transpose_indices[i]];
+        }
+      else
+        {
+          const std::size_t offset = row * num_weights_per_voxel;
+          for (int k = 0; k < num_weights_per_voxel; ++k)
+            sum += weights[offset + k] * in_ptr[indices[offset + k]];
+        }
+      if (accumulate)
+        out_ptr[row] += sum;
+      else
+        out_ptr[row] = sum;
+    }
+
+  if (in_density.is_contiguous())
+    in_density.release_const_full_data_ptr();
+  if (out_density.is_contiguous())
+    out_density.release_full_data_ptr();
+  else
+    std::copy(out_buffer.begin(), out_buffer.end(), out_density.begin_all());
+}
+
+void
+PrecomputedWarpOperator::apply(DiscretisedDensity<3, float>& out_density, const DiscretisedDensity<3, float>& in_density) const
+{
+  this->apply_helper(out_density, in_density, /*accumulate=*/false, /*transpose=*/false);
+}
+
+void
+PrecomputedWarpOperator::accumulate_apply(DiscretisedDensity<3, float>& out_density,
+                                          const DiscretisedDensity<3, float>& in_density) const
+{
+  this->apply_helper(out_density, in_density, /*accumulate=*/true, /*transpose=*/false);
+}
+
+void
+PrecomputedWarpOperator::apply_transpose(DiscretisedDensity<3, float>& out_density,
+                                         const DiscretisedDensity<3, float>& in_density) const
+{
+  this->apply_helper(out_density, in_density, /*accumulate=*/false, /*transpose=*/true);
+}
+
+void
+PrecomputedWarpOperator::accumulate_apply_transpose(DiscretisedDensity<3, float>& out_density,
+                                                    const DiscretisedDensity<3, float>& in_density) const
+{
+  this->apply_helper(out_density, in_density, /*accumulate=*/true, /*transpose=*/true);
+}
+
+END_NAMESPACE_STIR
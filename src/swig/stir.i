@@ -534,6 +534,131 @@
 #if defined(SWIGPYTHON)
 %include "numpy.i"
 %fragment("NumPy_Fragments");
+
+// helper functions for bulk conversions between numpy and STIR (needs the numpy includes from numpy.i)
+%{
+  namespace swigstir {
+    // create a numpy array that uses the (contiguous) data at \a data_ptr (no copy)
+    // The numpy array keeps a reference to \a owner_ptr (normally the Python object that owns the data) such that
+    // the data stays alive. Note that resizing the STIR object invalidates the numpy array.
+    PyObject* numpy_view_from_ptr(float* data_ptr, const int num_dimensions, npy_intp* dims, PyObject* owner_ptr)
+    {
+      PyObject* np = PyArray_SimpleNewFromData(num_dimensions, dims, NPY_FLOAT32, data_ptr);
+      if (np == NULL)
+	throw std::runtime_error("Error creating numpy array");
+      Py_INCREF(owner_ptr);
+      if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(np), owner_ptr) < 0)
+      {
+	Py_DECREF(np);
+	throw std::runtime_error("Error setting base object of numpy array");
+      }
+      return np;
+    }
+
+    // get numpy dimensions for a regular STIR Array
+    template <int num_dimensions, typename elemT>
+      void numpy_dims_from_Array(npy_intp* dims, const stir::Array<num_dimensions, elemT>& a)
+    {
+      stir::BasicCoordinate<num_dimensions,int> minind,maxind;
+      if (!a.get_regular_range(minind, maxind))
+	throw std::range_error("numpy conversion called on irregular array");
+      for (int d=1; d<=num_dimensions; ++d)
+	dims[d-1] = static_cast<npy_intp>(maxind[d]-minind[d]+1);
+    }
+
+    // return a numpy array referring to the data of a (contiguous) STIR Array (no copy)
+    template <int num_dimensions>
+      PyObject* Array_as_numpy(stir::Array<num_dimensions, float>& a, PyObject* owner_ptr)
+    {
+      npy_intp dims[num_dimensions];
+      numpy_dims_from_Array(dims, a);
+      if (a.size_all() == 0)
+	return PyArray_SimpleNew(num_dimensions, dims, NPY_FLOAT32);
+      if (!a.is_contiguous())
+	throw std::runtime_error("as_numpy() called on non-contiguous array. Use to_numpy() instead.");
+      float* data_ptr = a.get_full_data_ptr();
+      a.release_full_data_ptr();
+      return numpy_view_from_ptr(data_ptr, num_dimensions, dims, owner_ptr);
+    }
+
+    // copy a STIR Array to a new numpy array
+    template <int num_dimensions>
+      PyObject* Array_to_numpy(const stir::Array<num_dimensions, float>& a)
+    {
+      npy_intp dims[num_dimensions];
+      numpy_dims_from_Array(dims, a);
+      PyObject* np = PyArray_SimpleNew(num_dimensions, dims, NPY_FLOAT32);
+      if (np == NULL)
+	throw std::runtime_error("Error creating numpy array");
+      float* np_data_ptr = static_cast<float*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(np)));
+      if (a.size_all() == 0)
+	return np;
+      if (a.is_contiguous())
+      {
+	const float* data_ptr = a.get_const_full_data_ptr();
+	std::copy(data_ptr, data_ptr + a.size_all(), np_data_ptr);
+	a.release_const_full_data_ptr();
+      }
+      else
+	std::copy(a.begin_all_const(), a.end_all_const(), np_data_ptr);
+      return np;
+    }
+
+    // return if the argument is a numpy array, or a numpy flat iterator that has not been used yet
+    bool is_numpy_array_or_flat(PyObject* const arg)
+    {
+      return PyArray_Check(arg) ||
+	(PyArrayIter_Check(arg) && reinterpret_cast<PyArrayIterObject*>(arg)->index == 0);
+    }
+
+    // get a C-contiguous float numpy array with the data in \a arg (which can be a numpy array or flat iterator)
+    // This only copies if the data need conversion. The caller has to call Py_DECREF on the result.
+    PyArrayObject* contiguous_float_numpy_array(PyObject* const arg)
+    {
+      PyObject* np_arg = PyArrayIter_Check(arg) ? reinterpret_cast<PyObject*>(reinterpret_cast<PyArrayIterObject*>(arg)->ao) : arg;
+      PyObject* np = PyArray_FROMANY(np_arg, NPY_FLOAT32, 0, 0, NPY_ARRAY_IN_ARRAY);
+      if (np == NULL)
+	throw std::invalid_argument("Cannot convert argument to a numpy array of floats");
+      return reinterpret_cast<PyArrayObject*>(np);
+    }
+
+    // copy data from a numpy array or flat iterator (in C-order) to \a out_iter, checking the number of elements
+    template <typename OutIterT>
+      void copy_from_numpy(OutIterT out_iter, PyObject* const arg, const std::size_t expected_size)
+    {
+      PyArrayObject* np = contiguous_float_numpy_array(arg);
+      if (static_cast<std::size_t>(PyArray_SIZE(np)) != expected_size)
+      {
+	Py_DECREF(np);
+	throw std::runtime_error("fill() called with a numpy array of incorrect size, it needs to have the same number of elements");
+      }
+      const float* np_data_ptr = static_cast<const float*>(PyArray_DATA(np));
+      std::copy(np_data_ptr, np_data_ptr + expected_size, out_iter);
+      Py_DECREF(np);
+    }
+
+    // fill a STIR Array from a numpy array or flat iterator (in C-order)
+    // if \a do_resize is true, the array is resized to the shape of the numpy array (with all minimum indices 0)
+    template <int num_dimensions, typename elemT>
+      void fill_Array_from_numpy(stir::Array<num_dimensions, elemT>& a, PyObject* const arg, bool do_resize)
+    {
+      if (do_resize)
+      {
+	if (!PyArray_Check(arg))
+	  throw std::invalid_argument("Constructing a STIR array needs a numpy array");
+	PyArrayObject* np = reinterpret_cast<PyArrayObject*>(arg);
+	if (PyArray_NDIM(np) != num_dimensions)
+	  throw std::runtime_error(boost::str(boost::format("number of dimensions in numpy array is incorrect for constructing a stir array of dimension %d") %
+					      num_dimensions));
+	stir::BasicCoordinate<num_dimensions,int> sizes;
+	for (int d=1; d<=num_dimensions; ++d)
+	  sizes[d] = static_cast<int>(PyArray_DIM(np, d-1));
+	a.resize(sizes);
+      }
+      copy_from_numpy(a.begin_all(), arg, a.size_all());
+    }
+  } // end namespace swigstir
+%}
 #endif
 
 %include "attribute.i"
@@ -722,6 +847,32 @@ namespace std {
       return array;
   }
 
+#ifdef SWIGPYTHON
+  // get numpy dimensions corresponding to create_array_for_proj_data()
+  static void numpy_dims_for_proj_data(npy_intp* dims, const ProjData& proj_data)
+  {
+    dims[0] = static_cast<npy_intp>(proj_data.get_num_tof_poss());
+    dims[1] = static_cast<npy_intp>(proj_data.get_num_non_tof_sinograms());
+    dims[2] = static_cast<npy_intp>(proj_data.get_num_views());
+    dims[3] = static_cast<npy_intp>(proj_data.get_num_tangential_poss());
+  }
+
+  // fill ProjData from a numpy array or flat iterator in the order of create_array_for_proj_data() (without intermediate copy)
+  static void fill_proj_data_from_numpy(ProjData& proj_data, PyObject* const arg)
+  {
+    PyArrayObject* np = contiguous_float_numpy_array(arg);
+    const std::size_t size = proj_data.size_all();
+    if (static_cast<std::size_t>(PyArray_SIZE(np)) != size)
+      {
+        Py_DECREF(np);
+        throw std::runtime_error("fill() called with a numpy array of incorrect size, it needs to have the same number of elements");
+      }
+    const float* np_data_ptr = static_cast<const float*>(PyArray_DATA(np));
+    fill_from(proj_data, np_data_ptr, np_data_ptr + size);
+    Py_DECREF(np);
+  }
+#endif
+
   // a function for  converting ProjData to a 4D array as that's what is easy to use
   static Array<4,float> projdata_to_4D(const ProjData& proj_data)
   {
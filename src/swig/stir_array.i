@@ -143,10 +143,15 @@ namespace stir
       return swigstir::tuple_from_coord(sizes);
     }
 
-    %feature("autodoc", "fill from a Python iterator, e.g. array.fill(numpyarray.flat)") fill;
+    %feature("autodoc", "fill from a numpy array or a Python iterator, e.g. array.fill(numpyarray.flat)") fill;
     void fill(PyObject* const arg)
     {
-      if (PyIter_Check(arg))
+      if (swigstir::is_numpy_array_or_flat(arg))
+      {
+	// bulk copy
+	swigstir::fill_Array_from_numpy(*$self, arg, false /* do not resize */);
+      }
+      else if (PyIter_Check(arg))
       {
 	swigstir::fill_Array_from_Python_iterator($self, arg);
       }
@@ -161,6 +166,32 @@ namespace stir
   }
 #endif
 
+#ifdef SWIGPYTHON
+  %extend Array{
+    %feature("autodoc", "return a numpy array that refers to the data of this array (no copy).\n"
+             "The numpy array keeps this object alive, but is invalid after resizing this object.") as_numpy;
+    PyObject* as_numpy(PyObject **PYTHON_SELF)
+    {
+      return swigstir::Array_as_numpy(*$self, *PYTHON_SELF);
+    }
+
+    %feature("autodoc", "return a new numpy array with a copy of the data") to_numpy;
+    PyObject* to_numpy() const
+    {
+      return swigstir::Array_to_numpy(*$self);
+    }
+
+    %feature("autodoc", "create a new array from a numpy array (copying the data), with all minimum indices 0") from_numpy;
+    %newobject from_numpy;
+    static $parentclassname* from_numpy(PyObject* const arg)
+    {
+      $parentclassname * array_ptr = new $parentclassname();
+      swigstir::fill_Array_from_numpy(*array_ptr, arg, true /* do resize */);
+      return array_ptr;
+    }
+  }
+#endif
+
   %extend Array{
     %feature("autodoc", "return number of dimensions in the array") get_num_dimensions;
     int get_num_dimensions()
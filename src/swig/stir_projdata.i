@@ -154,10 +154,26 @@ namespace stir {
       return array;
     }
 
-    %feature("autodoc", "fill from a Python iterator, e.g. proj_data.fill(numpyarray.flat)") fill;
+    %feature("autodoc", "return a new 4D numpy array with a copy of the data, see to_array() for the order") to_numpy;
+    PyObject* to_numpy() const
+    {
+      npy_intp dims[4];
+      swigstir::numpy_dims_for_proj_data(dims, *$self);
+      PyObject* np = PyArray_SimpleNew(4, dims, NPY_FLOAT32);
+      if (np == NULL)
+        throw std::runtime_error("Error creating numpy array");
+      copy_to(*$self, static_cast<float*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(np))));
+      return np;
+    }
+
+    %feature("autodoc", "fill from a numpy array or a Python iterator, e.g. proj_data.fill(numpyarray.flat)") fill;
     void fill(PyObject* const arg)
     {
-      if (PyIter_Check(arg))
+      if (swigstir::is_numpy_array_or_flat(arg))
+      {
+        swigstir::fill_proj_data_from_numpy(*$self, arg);
+      }
+      else if (PyIter_Check(arg))
       {
         // TODO avoid need for copy to Array
         Array<4,float> array = swigstir::create_array_for_proj_data(*$self);
@@ -195,10 +211,25 @@ namespace stir {
 %extend ProjDataInMemory
   {
 #ifdef SWIGPYTHON
-    %feature("autodoc", "fill from a Python iterator, e.g. proj_data.fill(numpyarray.flat)") fill;
+    %feature("autodoc", "return a 4D numpy array that refers to the data of this object (no copy).\n"
+             "The numpy array keeps this object alive. See to_array() for the order.") as_numpy;
+    PyObject* as_numpy(PyObject **PYTHON_SELF)
+    {
+      npy_intp dims[4];
+      swigstir::numpy_dims_for_proj_data(dims, *$self);
+      float* data_ptr = $self->get_data_ptr();
+      $self->release_data_ptr();
+      return swigstir::numpy_view_from_ptr(data_ptr, 4, dims, *PYTHON_SELF);
+    }
+
+    %feature("autodoc", "fill from a numpy array or a Python iterator, e.g. proj_data.fill(numpyarray.flat)") fill;
     void fill(PyObject* const arg)
     {
-      if (PyIter_Check(arg))
+      if (swigstir::is_numpy_array_or_flat(arg))
+      {
+        swigstir::fill_proj_data_from_numpy(*$self, arg);
+      }
+      else if (PyIter_Check(arg))
       {
         Array<4,float> array = swigstir::create_array_for_proj_data(*$self);
 	swigstir::fill_Array_from_Python_iterator(&array, arg);
@@ -62,6 +62,9 @@ def to_numpy(stirdata):
     """
     return the data in a STIR image or other Array as a numpy array
     """
+    # bulk copy for STIR Arrays (with at least 2 dimensions) and projection data
+    if hasattr(stirdata, 'to_numpy'):
+        return stirdata.to_numpy()
     # construct a numpy array using the "flat" STIR iterator
     try:
         npstirdata=numpy.fromiter(stirdata.flat(), dtype=numpy.float32);
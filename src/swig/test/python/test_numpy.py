@@ -79,3 +79,46 @@ def test_ProjData():
     seg0=stirextra.to_numpy(projdata.get_segment_by_sinogram(0))
     assert(seg0.max() == 2)
 
+
+def test_Array3D_bulk():
+    minind=Int3BasicCoordinate((3,3,5));
+    a=FloatArray3D(IndexRange3D(minind, Int3BasicCoordinate((9,8,7))))
+    a.fill(2);
+    ind=Int3BasicCoordinate((4,5,6));
+    a[ind]=4
+    npind=(ind[1]-minind[1], ind[2]-minind[2], ind[3]-minind[3])
+    # copy
+    np=a.to_numpy()
+    assert np.shape==a.shape()
+    assert np[npind]==4
+    np[npind]=5
+    assert a[ind]==4
+    # view
+    view=a.as_numpy()
+    assert view.shape==a.shape()
+    view[npind]=5
+    assert a[ind]==5
+    del a
+    # the view keeps the array alive
+    assert view[npind]==5
+    # construct and fill from numpy arrays
+    b=FloatArray3D.from_numpy(view*2)
+    assert b.shape()==view.shape
+    assert b[Int3BasicCoordinate(npind)]==10
+    b.fill(view)
+    assert b[Int3BasicCoordinate(npind)]==5
+    b.fill((view+1).flat)
+    assert b[Int3BasicCoordinate(npind)]==6
+
+def test_ProjData_bulk():
+    s=Scanner.get_scanner_from_name("ECAT 962")
+    projdatainfo=ProjDataInfo.construct_proj_data_info(s,3,9,8,6)
+    projdata=ProjDataInMemory(ExamInfo(), projdatainfo)
+    projdata.fill(1)
+    np=projdata.to_numpy()
+    assert np.shape==projdata.to_array().shape()
+    view=projdata.as_numpy()
+    view+=2
+    assert projdata.to_numpy().max()==3
+    projdata.fill(np)
+    assert projdata.get_segment_by_sinogram(0).find_max()==1
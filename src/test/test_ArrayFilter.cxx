@@ -25,6 +25,12 @@
 #include "stir/ArrayFilter2DUsingConvolution.h"
 #include "stir/IndexRange2D.h"
 #include "stir/ArrayFilter3DUsingConvolution.h"
+#include "stir/SeparableArrayFunctionObject.h"
+#include "stir/ArrayFunction.h"
+#include "stir/MedianArrayFilter3D.h"
+#include "stir/MinimalArrayFilter3D.h"
+#include "stir/MaximalArrayFilter3D.h"
+#include "stir/Coordinate3D.h"
 #include "stir/IndexRange3D.h"
 #include "stir/Succeeded.h"
 #include "stir/modulo.h"
@@ -33,6 +39,7 @@
 #include "stir/stream.h" //XXX
 #include <iostream>
 #include <algorithm>
+#include <vector>
 #include <boost/static_assert.hpp>
 
 #ifdef DO_TIMINGS
@@ -154,6 +161,50 @@ private:
           }
       }
   }
+  //! compare the median, minimal and maximal filters with a straightforward implementation
+  /*! Only neighbours within the index range of \a test are used, as documented in the filter classes. */
+  void compare_rank_filters_3d(const Coordinate3D<int>& mask_radius, const Array<3, float>& test)
+  {
+    Array<3, float> median_ref(test.get_index_range());
+    Array<3, float> min_ref(test.get_index_range());
+    Array<3, float> max_ref(test.get_index_range());
+    std::vector<float> neighbours;
+    for (int z = test.get_min_index(); z <= test.get_max_index(); ++z)
+      for (int y = test[z].get_min_index(); y <= test[z].get_max_index(); ++y)
+        for (int x = test[z][y].get_min_index(); x <= test[z][y].get_max_index(); ++x)
+          {
+            neighbours.clear();
+            for (int zi = std::max(z - mask_radius[1], test.get_min_index());
+                 zi <= std::min(z + mask_radius[1], test.get_max_index());
+                 ++zi)
+              for (int yi = std::max(y - mask_radius[2], test[zi].get_min_index());
+                   yi <= std::min(y + mask_radius[2], test[zi].get_max_index());
+                   ++yi)
+                for (int xi = std::max(x - mask_radius[3], test[zi][yi].get_min_index());
+                     xi <= std::min(x + mask_radius[3], test[zi][yi].get_max_index());
+                     ++xi)
+                  neighbours.push_back(test[zi][yi][xi]);
+            std::sort(neighbours.begin(), neighbours.end());
+            const std::size_t n = neighbours.size();
+            median_ref[z][y][x] = n % 2 == 1 ? neighbours[n / 2] : (neighbours[n / 2 - 1] + neighbours[n / 2]) / 2;
+            min_ref[z][y][x] = neighbours.front();
+            max_ref[z][y][x] = neighbours.back();
+          }
+
+    const MedianArrayFilter3D<float> median_filter(mask_radius);
+    const MinimalArrayFilter3D<float> min_filter(mask_radius);
+    const MaximalArrayFilter3D<float> max_filter(mask_radius);
+    Array<3, float> out(test.get_index_range());
+    median_filter(out, test);
+    check_if_equal(out, median_ref, "median filter");
+    out = test;
+    median_filter(out);
+    check_if_equal(out, median_ref, "median filter, in-place");
+    min_filter(out, test);
+    check_if_equal(out, min_ref, "minimal filter");
+    max_filter(out, test);
+    check_if_equal(out, max_ref, "maximal filter");
+  }
 };
 void
 ArrayFilterTests::run_tests()
@@ -423,6 +474,73 @@ ArrayFilterTests::run_tests()
       compare_results_1arg(DFT_filter, conv_filter, test_pos_offset);
     }
   }
+  std::cerr << "\nTesting 3D separable convolution\n";
+  {
+    Array<3, float> test(IndexRange3D(-3, 7, 2, 80, -1, 70));
+    // initialise to some arbitrary values
+    {
+      Array<3, float>::full_iterator iter = test.begin_all();
+      for (int i = 0; iter != test.end_all(); ++i, ++iter)
+        *iter = static_cast<float>((i * 37) % 101) - 20.F;
+    }
+    VectorWithOffset<float> symmetric_kernel(0, 3);
+    symmetric_kernel[0] = .4F;
+    symmetric_kernel[1] = .2F;
+    symmetric_kernel[2] = .08F;
+    symmetric_kernel[3] = .02F;
+    VectorWithOffset<float> kernel(-2, 1);
+    kernel[-2] = .1F;
+    kernel[-1] = .3F;
+    kernel[0] = .5F;
+    kernel[1] = -.2F;
+    VectorWithOffset<float> shift_kernel(2, 3);
+    shift_kernel[2] = 1.F;
+    shift_kernel[3] = .5F;
+
+    typedef shared_ptr<ArrayFunctionObject<1, float>> filter_sptr;
+    std::vector<VectorWithOffset<filter_sptr>> all_filters;
+    {
+      VectorWithOffset<filter_sptr> filters(3);
+      filters[0].reset(new ArrayFilter1DUsingConvolutionSymmetricKernel<float>(symmetric_kernel));
+      filters[1].reset(new ArrayFilter1DUsingConvolutionSymmetricKernel<float>(symmetric_kernel));
+      filters[2].reset(new ArrayFilter1DUsingConvolutionSymmetricKernel<float>(symmetric_kernel));
+      all_filters.push_back(filters);
+      filters[0].reset(new ArrayFilter1DUsingConvolution<float>(kernel));
+      filters[1].reset(new ArrayFilter1DUsingConvolution<float>(kernel, BoundaryConditions::constant));
+      filters[2].reset(new ArrayFilter1DUsingConvolution<float>(shift_kernel));
+      all_filters.push_back(filters);
+      filters[0].reset(new ArrayFilter1DUsingConvolution<float>());
+      filters[1].reset(new ArrayFilter1DUsingConvolution<float>(shift_kernel, BoundaryConditions::constant));
+      filters[2].reset(new ArrayFilter1DUsingConvolution<float>(kernel, BoundaryConditions::constant));
+      all_filters.push_back(filters);
+    }
+    for (const auto& filters : all_filters)
+      {
+        const SeparableArrayFunctionObject<3, float> separable_filter(filters);
+        Array<3, float> out(test);
+        separable_filter(out);
+        // compare with applying the 1D filters one line at a time
+        Array<3, float> ref(test);
+        in_place_apply_array_functions_on_each_index(ref, filters.begin(), filters.end());
+        set_tolerance(ref.find_max() * 1.E-6);
+        check_if_equal(out, ref, "separable convolution");
+      }
+  }
+  std::cerr << "\nTesting 3D rank filters\n";
+  {
+    set_tolerance(.0001F);
+    Array<3, float> test(IndexRange3D(-2, 6, 1, 11, -3, 10));
+    // initialise to some arbitrary values, with many duplicates
+    {
+      Array<3, float>::full_iterator iter = test.begin_all();
+      for (int i = 0; iter != test.end_all(); ++i, ++iter)
+        *iter = static_cast<float>((i * 37) % 11) - 3.F + (i % 5) * .5F;
+    }
+    compare_rank_filters_3d(Coordinate3D<int>(1, 1, 1), test);
+    compare_rank_filters_3d(Coordinate3D<int>(2, 2, 2), test);
+    compare_rank_filters_3d(Coordinate3D<int>(0, 2, 1), test);
+    compare_rank_filters_3d(Coordinate3D<int>(1, 0, 3), test);
+  }
 }
 
 END_NAMESPACE_STIR
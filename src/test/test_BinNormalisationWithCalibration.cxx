@@ -0,0 +1,181 @@
+/*!
+
+  \file
+  \ingroup test
+  \ingroup normalisation
+
+  \brief Test program for the precomputed efficiencies of stir::BinNormalisationWithCalibration
+
+  \author Kris Thielemans
+*/
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+
+#include "stir/recon_buildblock/BinNormalisationWithCalibration.h"
+#include "stir/ProjDataInfo.h"
+#include "stir/ProjDataInMemory.h"
+#include "stir/ExamInfo.h"
+#include "stir/TimeFrameDefinitions.h"
+#include "stir/Scanner.h"
+#include "stir/Bin.h"
+#include "stir/RunTests.h"
+#include "stir/num_threads.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <utility>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup test
+  \brief A BinNormalisationWithCalibration with synthetic efficiencies, which depend on the time frame
+*/
+class SyntheticBinNormalisation : public BinNormalisationWithCalibration
+{
+public:
+  std::string get_registered_name() const override { return "Synthetic"; }
+
+  float get_uncalibrated_bin_efficiency(const Bin& bin) const override
+  {
+    const float start_time = static_cast<float>(this->get_exam_info_sptr()->get_time_frame_definitions().get_start_time());
+    const int pattern
+        = (bin.segment_num() + 10) * 7 + bin.view_num() * 3 + bin.axial_pos_num() * 5 + bin.tangential_pos_num() + 100;
+    return 1.F + 0.01F * (pattern % 97) + start_time;
+  }
+};
+
+/*!
+  \ingroup test
+  \brief Test class for the precomputed efficiencies of BinNormalisationWithCalibration
+
+  Checks that apply(), undo() and get_bin_efficiency() give the same results with and without precomputed efficiencies,
+  when the efficiencies are computed with 1 or more threads (if OpenMP is enabled), and after changing the time frame.
+*/
+class BinNormalisationWithCalibrationTests : public RunTests
+{
+public:
+  void run_tests() override;
+
+private:
+  shared_ptr<ExamInfo> create_exam_info(const double start_time) const;
+  //! set up a normalisation object, optionally with precomputed efficiencies
+  shared_ptr<SyntheticBinNormalisation> create_norm(const bool use_precomputed_efficiencies,
+                                                    const shared_ptr<const ExamInfo>& exam_info_sptr) const;
+  //! apply \a norm to data filled with 1 and compare with \a reference
+  void check_apply(const BinNormalisation& norm, const ProjDataInMemory& reference, const std::string& str);
+
+  shared_ptr<const ProjDataInfo> proj_data_info_sptr;
+};
+
+shared_ptr<ExamInfo>
+BinNormalisationWithCalibrationTests::create_exam_info(const double start_time) const
+{
+  auto exam_info_sptr = std::make_shared<ExamInfo>(ImagingModality::PT);
+  std::vector<std::pair<double, double>> frame_times(1, std::make_pair(start_time, start_time + 10.));
+  exam_info_sptr->set_time_frame_definitions(TimeFrameDefinitions(frame_times));
+  return exam_info_sptr;
+}
+
+shared_ptr<SyntheticBinNormalisation>
+BinNormalisationWithCalibrationTests::create_norm(const bool use_precomputed_efficiencies,
+                                                  const shared_ptr<const ExamInfo>& exam_info_sptr) const
+{
+  auto norm_sptr = std::make_shared<SyntheticBinNormalisation>();
+  norm_sptr->set_calibration_factor(2.F);
+  norm_sptr->set_use_precomputed_efficiencies(use_precomputed_efficiencies);
+  if (norm_sptr->set_up(exam_info_sptr, this->proj_data_info_sptr) == Succeeded::no)
+    error("test_BinNormalisationWithCalibration: set_up failed");
+  return norm_sptr;
+}
+
+void
+BinNormalisationWithCalibrationTests::check_apply(const BinNormalisation& norm,
+                                                  const ProjDataInMemory& reference,
+                                                  const std::string& str)
+{
+  ProjDataInMemory proj_data(reference.get_exam_info_sptr(), this->proj_data_info_sptr, false);
+  proj_data.fill(1.F);
+  norm.apply(proj_data);
+  {
+    float max_diff = 0.F;
+    auto ref_iter = reference.begin();
+    for (auto iter = proj_data.begin(); iter != proj_data.end(); ++iter, ++ref_iter)
+      max_diff = std::max(max_diff, std::abs(*iter - *ref_iter));
+    check(max_diff < 1E-6F, str + ": apply should give the same result as without precomputed efficiencies");
+  }
+  norm.undo(proj_data);
+  bool all_one = true;
+  for (auto iter = proj_data.begin(); all_one && iter != proj_data.end(); ++iter)
+    all_one = std::abs(*iter - 1.F) < 1E-5F;
+  check(all_one, str + ": undo(apply()) should be 1");
+}
+
+void
+BinNormalisationWithCalibrationTests::run_tests()
+{
+  shared_ptr<Scanner> scanner_sptr(new Scanner(Scanner::E953));
+  this->proj_data_info_sptr = ProjDataInfo::construct_proj_data_info(scanner_sptr,
+                                                                     /*span*/ 3,
+                                                                     /*max_delta*/ 5,
+                                                                     /*views*/ scanner_sptr->get_num_detectors_per_ring() / 4,
+                                                                     /*tang_pos*/ 32,
+                                                                     /*arc_corrected*/ false);
+
+  for (double start_time : { 0., 100. })
+    {
+      std::cerr << "\nTesting frame starting at " << start_time << "\n";
+      const auto exam_info_sptr = create_exam_info(start_time);
+
+      // reference: no precomputed efficiencies
+      const auto ref_norm_sptr = create_norm(false, exam_info_sptr);
+      ProjDataInMemory reference(exam_info_sptr, this->proj_data_info_sptr, false);
+      reference.fill(1.F);
+      ref_norm_sptr->apply(reference);
+
+      for (int num_threads : { 1, 4 })
+        {
+          set_num_threads(num_threads);
+          const std::string str = "precomputed with " + std::to_string(num_threads) + " thread(s)";
+          const auto norm_sptr = create_norm(true, exam_info_sptr);
+          check_apply(*norm_sptr, reference, str);
+          const Bin bin(1, 3, 4, -5);
+          check_if_equal(
+              norm_sptr->get_bin_efficiency(bin), ref_norm_sptr->get_bin_efficiency(bin), str + ": get_bin_efficiency");
+        }
+      set_default_num_threads();
+
+      // precomputed values need to be updated when the frame changes
+      {
+        const auto norm_sptr = create_norm(true, create_exam_info(start_time + 33.));
+        const Bin bin(0, 1, 2, 3);
+        norm_sptr->get_bin_efficiency(bin); // make sure that efficiencies for the other frame are computed
+        norm_sptr->set_exam_info_sptr(exam_info_sptr);
+        check_apply(*norm_sptr, reference, "precomputed after changing the time frame");
+        check_if_equal(norm_sptr->get_bin_efficiency(bin),
+                       ref_norm_sptr->get_bin_efficiency(bin),
+                       "get_bin_efficiency after changing the time frame");
+      }
+    }
+}
+
+END_NAMESPACE_STIR
+
+USING_NAMESPACE_STIR
+
+int
+main()
+{
+  set_default_num_threads();
+
+  BinNormalisationWithCalibrationTests tests;
+  tests.run_tests();
+  return tests.main_return_value();
+}
@@ -19,24 +19,33 @@
 
 #include "stir/RunTests.h"
 #include "stir/Array.h"
+#include "stir/IndexRange3D.h"
 #include "stir/GeneralisedPoissonNoiseGenerator.h"
+#include "stir/ProjDataInMemory.h"
+#include "stir/ProjDataInfo.h"
+#include "stir/ExamInfo.h"
+#include "stir/Scanner.h"
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 #include <boost/format.hpp>
 #include <algorithm>
 #include <iostream>
+#include <string>
 
 START_NAMESPACE_STIR
 
 /*!
   \brief Tests GeneralisedPoissonNoiseGenerator functionality
   \ingroup test
-  Currently contains only simple tests to check mean and variance.
+  Currently contains only simple tests to check mean and variance, and
+  reproducibility of the counter-based generator.
 */
 class GeneralisedPoissonNoiseGeneratorTests : public RunTests
 {
 private:
-  void run_one_test(const int size, const float mu, const float scaling_factor, const bool preserve_mean);
+  void run_one_test(
+      const int size, const float mu, const float scaling_factor, const bool preserve_mean, const bool counter_based = false);
+  void test_counter_based_reproducibility();
 
 public:
   void run_tests() override;
@@ -46,13 +55,15 @@ void
 GeneralisedPoissonNoiseGeneratorTests::run_one_test(const int size,
                                                     const float mu,
                                                     const float scaling_factor,
-                                                    const bool preserve_mean)
+                                                    const bool preserve_mean,
+                                                    const bool counter_based)
 {
   Array<1, float> input(size);
   Array<1, float> output(size);
   input.fill(mu);
 
   GeneralisedPoissonNoiseGenerator generator(scaling_factor, preserve_mean);
+  generator.set_use_counter_based_generator(counter_based);
 
   generator.generate_random(output, input);
 
@@ -68,8 +79,8 @@ GeneralisedPoissonNoiseGeneratorTests::run_one_test(const int size,
   const float actual_mean = preserve_mean ? mu : mu * scaling_factor;
   const float actual_variance = preserve_mean ? mu / scaling_factor : actual_mean;
 
-  boost::format formatter("size %1%, mu %2%, scaling_factor %3%, preserve_mean %4%");
-  formatter % size % mu % scaling_factor % preserve_mean;
+  boost::format formatter("size %1%, mu %2%, scaling_factor %3%, preserve_mean %4%, counter_based %5%");
+  formatter % size % mu % scaling_factor % preserve_mean % counter_based;
 
   check_if_equal(mean(acc), actual_mean, "test mean with " + formatter.str());
   check_if_equal(variance(acc), actual_variance, "test variance with " + formatter.str());
@@ -88,6 +99,67 @@ GeneralisedPoissonNoiseGeneratorTests::run_tests()
   run_one_test(1000, 4.2F, 1.0F, true);
   run_one_test(1000, 4.2F, 3.0F, true);
   run_one_test(1000, 4.2F, 3.0F, false);
+
+  for (const float mu : { 100.0F, 4.2F })
+    {
+      run_one_test(1000, mu, 1.0F, true, true);
+      run_one_test(1000, mu, 3.0F, true, true);
+      run_one_test(1000, mu, 3.0F, false, true);
+    }
+
+  test_counter_based_reproducibility();
+}
+
+void
+GeneralisedPoissonNoiseGeneratorTests::test_counter_based_reproducibility()
+{
+  // input with a range of values, such that both the normal approximation and inversion are used
+  Array<3, float> input(IndexRange3D(-1, 4, 3, 20, 0, 30));
+  {
+    float value = 0.F;
+    for (auto iter = input.begin_all(); iter != input.end_all(); ++iter, value += .37F)
+      *iter = value;
+  }
+  GeneralisedPoissonNoiseGenerator generator(2.F, true);
+  generator.set_use_counter_based_generator(true);
+  generator.seed(7u);
+  Array<3, float> output1(input.get_index_range());
+  Array<3, float> output2(input.get_index_range());
+  generator.generate_random(output1, input);
+  generator.generate_random(output2, input);
+  check(!std::equal(output1.begin_all(), output1.end_all(), output2.begin_all()),
+        "counter-based: successive realisations should be different");
+  generator.seed(7u);
+  Array<3, float> output(input.get_index_range());
+  generator.generate_random(output, input);
+  check_if_equal(output, output1, "counter-based: first realisation after seeding again");
+  generator.generate_random(output, input);
+  check_if_equal(output, output2, "counter-based: second realisation after seeding again");
+
+  // projection data: several realisations at once should be the same as generating them one by one
+  {
+    shared_ptr<Scanner> scanner_sptr(new Scanner(Scanner::E953));
+    shared_ptr<const ProjDataInfo> proj_data_info_sptr(
+        ProjDataInfo::construct_proj_data_info(scanner_sptr, 1, 2, 8, 16, false).release());
+    auto exam_info_sptr = std::make_shared<ExamInfo>(ImagingModality::PT);
+    ProjDataInMemory input_projdata(exam_info_sptr, proj_data_info_sptr);
+    input_projdata.fill(50.F);
+    std::vector<shared_ptr<ProjData>> outputs;
+    for (int r = 0; r < 3; ++r)
+      outputs.push_back(std::make_shared<ProjDataInMemory>(exam_info_sptr, proj_data_info_sptr));
+    generator.seed(11u);
+    generator.generate_random(outputs, input_projdata);
+
+    generator.seed(11u);
+    ProjDataInMemory output_projdata(exam_info_sptr, proj_data_info_sptr);
+    for (int r = 0; r < 3; ++r)
+      {
+        generator.generate_random(output_projdata, input_projdata);
+        const auto& batch_output = dynamic_cast<const ProjDataInMemory&>(*outputs[r]);
+        check(std::equal(output_projdata.begin_all(), output_projdata.end_all(), batch_output.begin_all()),
+              "counter-based: ProjData realisation " + std::to_string(r) + " should be the same when generated in a batch");
+      }
+  }
 }
 
 END_NAMESPACE_STIR
@@ -0,0 +1,194 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup test
+  \ingroup listmode
+  \brief Test program for stir::ListModeIndex
+
+  The program needs the filename of some list mode data as argument, e.g.
+  \verbatim
+  test_ListModeIndex recon_test_pack/PET_ACQ_small.l.hdr.STIR
+  \endverbatim
+*/
+
+#include "stir/listmode/ListModeIndex.h"
+#include "stir/listmode/ListModeData.h"
+#include "stir/listmode/ListRecord.h"
+#include "stir/IO/read_from_file.h"
+#include "stir/RunTests.h"
+#include "stir/Succeeded.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+START_NAMESPACE_STIR
+
+/*!
+  \ingroup test
+  \brief Test class for ListModeIndex
+
+  Checks that the counts in the index correspond to the counts in the list mode data,
+  that writing and reading the index gives the same result (and that an index file that is
+  inconsistent with the list mode data is rejected), and that jumping to an entry
+  with ListModeData::set_get_position() gives the same events as reading sequentially.
+*/
+class ListModeIndexTests : public RunTests
+{
+public:
+  explicit ListModeIndexTests(const std::string& lm_filename)
+      : lm_filename(lm_filename)
+  {}
+  void run_tests() override;
+
+private:
+  std::string lm_filename;
+};
+
+void
+ListModeIndexTests::run_tests()
+{
+  shared_ptr<ListModeData> lm_data_sptr(read_from_file<ListModeData>(lm_filename));
+  shared_ptr<ListRecord> record_sptr = lm_data_sptr->get_empty_record_sptr();
+  ListRecord& record = *record_sptr;
+
+  // count all events
+  unsigned long total_num_prompts = 0UL;
+  unsigned long total_num_delayeds = 0UL;
+  while (lm_data_sptr->get_next_record(record) == Succeeded::yes)
+    {
+      if (record.is_event())
+        {
+          if (record.event().is_prompt())
+            ++total_num_prompts;
+          else
+            ++total_num_delayeds;
+        }
+    }
+
+  const double interval = .1;
+  const ListModeIndex index(*lm_data_sptr, interval);
+  const std::vector<ListModeIndex::Entry>& entries = index.get_entries();
+  check(entries.size() > 1, "index should have more than 1 entry");
+  check(index.has_positions(), "index should have positions for this data");
+  check_if_equal(index.get_interval_in_secs(), interval, "interval");
+  {
+    unsigned long num_prompts = 0UL;
+    unsigned long num_delayeds = 0UL;
+    for (const auto& entry : entries)
+      {
+        num_prompts += entry.num_prompts;
+        num_delayeds += entry.num_delayeds;
+      }
+    check_if_equal(num_prompts, total_num_prompts, "total number of prompts in index");
+    check_if_equal(num_delayeds, total_num_delayeds, "total number of delayeds in index");
+  }
+
+  check_if_equal(index.find_entry_num(-1.), -1, "find_entry_num before start");
+  check_if_equal(index.find_entry_num(entries.back().time_in_secs + 10), static_cast<int>(entries.size()) - 1,
+                 "find_entry_num after end");
+  for (std::size_t entry_num = 1; entry_num < entries.size(); ++entry_num)
+    check_if_equal(index.find_entry_num(entries[entry_num].time_in_secs), static_cast<int>(entry_num), "find_entry_num");
+
+  // write and read back
+  const std::string index_filename = "test_ListModeIndex.lmindex";
+  check(index.write_to_file(index_filename) == Succeeded::yes, "writing index");
+  ListModeIndex index_from_file;
+  check(!lm_data_sptr->get_data_filename().empty(), "list mode data file should be known for this data");
+  check(index_from_file.read_from_file(index_filename, lm_data_sptr->get_data_filename()) == Succeeded::yes, "reading index");
+  {
+    // modify the stored modification time of the list mode data, such that the index is stale
+    std::string contents;
+    {
+      std::ifstream s(index_filename.c_str());
+      std::stringstream buffer;
+      buffer << s.rdbuf();
+      contents = buffer.str();
+    }
+    const std::string key = "list mode data file modification time := ";
+    const std::string::size_type pos = contents.find(key);
+    if (check(pos != std::string::npos, "index file should contain the modification time"))
+      {
+        contents.insert(pos + key.size(), "1");
+        const std::string stale_index_filename = "test_ListModeIndex_stale.lmindex";
+        {
+          std::ofstream s(stale_index_filename.c_str());
+          s << contents;
+        }
+        ListModeIndex stale_index;
+        std::cerr << "\nThe next test should write a warning about an inconsistent index file\n";
+        check(stale_index.read_from_file(stale_index_filename, lm_data_sptr->get_data_filename()) == Succeeded::no,
+              "reading index with different modification time should fail");
+        std::remove(stale_index_filename.c_str());
+      }
+  }
+  std::remove(index_filename.c_str());
+  if (!check_if_equal(index_from_file.get_entries().size(), entries.size(), "number of entries after reading"))
+    return;
+  for (std::size_t entry_num = 0; entry_num < entries.size(); ++entry_num)
+    {
+      const ListModeIndex::Entry& entry = index_from_file.get_entries()[entry_num];
+      check_if_equal(entry.time_in_secs, entries[entry_num].time_in_secs, "time of entry after reading");
+      check(entry.position == entries[entry_num].position, "position of entry after reading");
+      check_if_equal(entry.num_prompts, entries[entry_num].num_prompts, "num_prompts of entry after reading");
+      check_if_equal(entry.num_delayeds, entries[entry_num].num_delayeds, "num_delayeds of entry after reading");
+    }
+
+  // jump to entries (in reverse order) with a new ListModeData object
+  shared_ptr<ListModeData> other_lm_data_sptr(read_from_file<ListModeData>(lm_filename));
+  if (!check(index_from_file.set_up(*other_lm_data_sptr) == Succeeded::yes, "set_up"))
+    return;
+  {
+    const std::size_t num_saved_positions = other_lm_data_sptr->get_saved_get_positions().size();
+    check(index_from_file.set_up(*other_lm_data_sptr) == Succeeded::yes, "second set_up");
+    check_if_equal(other_lm_data_sptr->get_saved_get_positions().size(), num_saved_positions,
+                   "second set_up should not add positions");
+  }
+  for (int entry_num = static_cast<int>(entries.size()) - 1; entry_num >= 0; --entry_num)
+    {
+      check(other_lm_data_sptr->set_get_position(index_from_file.get_saved_position(entry_num)) == Succeeded::yes,
+            "set_get_position");
+      const double end_time = entry_num + 1 < static_cast<int>(entries.size()) ? entries[entry_num + 1].time_in_secs : -1.;
+      unsigned long num_prompts = 0UL;
+      unsigned long num_delayeds = 0UL;
+      while (other_lm_data_sptr->get_next_record(record) == Succeeded::yes)
+        {
+          if (record.is_time() && end_time >= 0 && record.time().get_time_in_secs() >= end_time)
+            break;
+          if (record.is_event())
+            {
+              if (record.event().is_prompt())
+                ++num_prompts;
+              else
+                ++num_delayeds;
+            }
+        }
+      check_if_equal(num_prompts, entries[entry_num].num_prompts, "num_prompts after jumping to entry");
+      check_if_equal(num_delayeds, entries[entry_num].num_delayeds, "num_delayeds after jumping to entry");
+    }
+}
+
+END_NAMESPACE_STIR
+
+USING_NAMESPACE_STIR
+
+int
+main(int argc, char** argv)
+{
+  if (argc != 2)
+    {
+      std::cerr << "Usage : " << argv[0] << " listmode_filename\n";
+      return EXIT_FAILURE;
+    }
+  ListModeIndexTests tests(argv[1]);
+  tests.run_tests();
+  return tests.main_return_value();
+}
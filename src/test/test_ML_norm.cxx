@@ -181,6 +181,63 @@ ML_normTests::test_proj_data_info(shared_ptr<TProjDataInfo> proj_data_info_sptr)
         }
     }
   }
+
+  // test constructing the fan data event by event (as done for list mode data)
+  {
+    // fill with different values for every bin
+    ProjDataInMemory proj_data3(proj_data);
+    for (int segment_num = proj_data3.get_min_segment_num(); segment_num <= proj_data3.get_max_segment_num(); ++segment_num)
+      {
+        SegmentBySinogram<float> segment = proj_data3.get_empty_segment_by_sinogram(segment_num);
+        for (int axial_pos_num = segment.get_min_axial_pos_num(); axial_pos_num <= segment.get_max_axial_pos_num();
+             ++axial_pos_num)
+          for (int view_num = segment.get_min_view_num(); view_num <= segment.get_max_view_num(); ++view_num)
+            for (int tangential_pos_num = segment.get_min_tangential_pos_num();
+                 tangential_pos_num <= segment.get_max_tangential_pos_num();
+                 ++tangential_pos_num)
+              segment[axial_pos_num][view_num][tangential_pos_num] = static_cast<float>(
+                  1 + std::abs(segment_num) + axial_pos_num + 2 * view_num + 3 * std::abs(tangential_pos_num));
+        proj_data3.set_segment(segment);
+      }
+    FanProjData fan_data3;
+    make_fan_data_remove_gaps(fan_data3, proj_data3);
+
+    // make_fan_data_remove_gaps only uses a symmetric range of tangential positions
+    const int half_fan_size
+        = std::min(proj_data_info_sptr->get_max_tangential_pos_num(), -proj_data_info_sptr->get_min_tangential_pos_num());
+    FanProjData fan_data_by_event;
+    make_fan_data_remove_gaps(fan_data_by_event, *proj_data_info_sptr);
+    check_if_zero(fan_data_by_event.find_max(), "make_fan_data_remove_gaps from proj_data_info should give zero data");
+    for (int segment_num = proj_data3.get_min_segment_num(); segment_num <= proj_data3.get_max_segment_num(); ++segment_num)
+      {
+        const SegmentBySinogram<float> segment = proj_data3.get_segment_by_sinogram(segment_num);
+        for (int axial_pos_num = segment.get_min_axial_pos_num(); axial_pos_num <= segment.get_max_axial_pos_num();
+             ++axial_pos_num)
+          for (int view_num = segment.get_min_view_num(); view_num <= segment.get_max_view_num(); ++view_num)
+            for (int tangential_pos_num = -half_fan_size; tangential_pos_num <= half_fan_size; ++tangential_pos_num)
+              {
+                int ra = 0, a = 0;
+                int rb = 0, b = 0;
+                proj_data_info_sptr->get_det_pair_for_bin(
+                    a, ra, b, rb, Bin(segment_num, view_num, axial_pos_num, tangential_pos_num));
+                add_to_fan_data_remove_gaps(fan_data_by_event,
+                                            *proj_data_info_sptr->get_scanner_sptr(),
+                                            ra,
+                                            a,
+                                            rb,
+                                            b,
+                                            segment[axial_pos_num][view_num][tangential_pos_num]);
+              }
+      }
+    bool all_equal = true;
+    for (int ra = fan_data3.get_min_ra(); all_equal && ra <= fan_data3.get_max_ra(); ++ra)
+      for (int a = fan_data3.get_min_a(); all_equal && a <= fan_data3.get_max_a(); ++a)
+        for (int rb = std::max(ra, fan_data3.get_min_rb(ra)); all_equal && rb <= fan_data3.get_max_rb(ra); ++rb)
+          for (int b = fan_data3.get_min_b(a); all_equal && b <= fan_data3.get_max_b(a); ++b)
+            all_equal = check_if_equal(fan_data_by_event(ra, a, rb, b),
+                                       fan_data3(ra, a, rb, b),
+                                       "add_to_fan_data_remove_gaps vs make_fan_data_remove_gaps");
+  }
 }
 
 END_NAMESPACE_STIR
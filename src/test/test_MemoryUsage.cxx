@@ -0,0 +1,100 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+
+/*!
+  \file
+  \ingroup test
+  \brief A simple program to test stir::MemoryUsage
+*/
+#include "stir/RunTests.h"
+#include "stir/MemoryUsage.h"
+#include "stir/Array.h"
+#include "stir/IndexRange3D.h"
+#include "stir/ProjDataInMemory.h"
+#include "stir/ProjDataInfo.h"
+#include "stir/ExamInfo.h"
+#include "stir/Scanner.h"
+#include <iostream>
+
+START_NAMESPACE_STIR
+
+/*!
+  \brief Class with tests for MemoryUsage
+  \ingroup test
+*/
+class MemoryUsageTests : public RunTests
+{
+public:
+  void run_tests() override;
+};
+
+void
+MemoryUsageTests::run_tests()
+{
+  std::cerr << "Testing tracking of Array allocations\n";
+  {
+    MemoryUsage::reset_peaks();
+    const std::size_t start_bytes = MemoryUsage::get_current_bytes(MemoryUsage::arrays);
+    const std::size_t num_bytes = 10 * 20 * 30 * sizeof(float);
+    {
+      Array<3, float> array(IndexRange3D(10, 20, 30));
+      check_if_equal(MemoryUsage::get_current_bytes(MemoryUsage::arrays), start_bytes + num_bytes, "allocation of Array");
+      Array<3, float> other(array.get_index_range());
+      check_if_equal(
+          MemoryUsage::get_current_bytes(MemoryUsage::arrays), start_bytes + 2 * num_bytes, "allocation of second Array");
+    }
+    check_if_equal(MemoryUsage::get_current_bytes(MemoryUsage::arrays), start_bytes, "deallocation of Array");
+    check(MemoryUsage::get_peak_bytes(MemoryUsage::arrays) >= start_bytes + 2 * num_bytes, "peak after deallocation");
+    check(MemoryUsage::get_total_peak_bytes() >= MemoryUsage::get_peak_bytes(MemoryUsage::arrays),
+          "total peak should not be smaller than the peak of a category");
+  }
+
+  std::cerr << "Testing tracking of ProjDataInMemory allocations\n";
+  {
+    const std::size_t start_bytes = MemoryUsage::get_current_bytes(MemoryUsage::proj_data_in_memory);
+    shared_ptr<Scanner> scanner_sptr(new Scanner(Scanner::E953));
+    shared_ptr<ProjDataInfo> proj_data_info_sptr(ProjDataInfo::ProjDataInfoCTI(scanner_sptr,
+                                                                               /*span*/ 1,
+                                                                               2,
+                                                                               /*views*/ 96,
+                                                                               /*tang_pos*/ 64,
+                                                                               /*arc_corrected*/ false));
+    {
+      ProjDataInMemory proj_data(std::make_shared<ExamInfo>(ImagingModality::PT), proj_data_info_sptr);
+      check_if_equal(MemoryUsage::get_current_bytes(MemoryUsage::proj_data_in_memory),
+                     start_bytes + proj_data_info_sptr->size_all() * sizeof(float),
+                     "allocation of ProjDataInMemory");
+      check_if_equal(proj_data.find_max(), 0.F, "ProjDataInMemory should be initialised to 0");
+    }
+    check_if_equal(
+        MemoryUsage::get_current_bytes(MemoryUsage::proj_data_in_memory), start_bytes, "deallocation of ProjDataInMemory");
+  }
+
+  std::cerr << "Testing report\n";
+  {
+    const std::string report = MemoryUsage::get_report();
+    check(report.find("proj_data_in_memory") != std::string::npos, "report should list all categories");
+#ifdef __linux__
+    check(MemoryUsage::get_peak_resident_set_size() > 0, "peak RSS should be available");
+    check(MemoryUsage::get_current_resident_set_size() > 0, "current RSS should be available");
+#endif
+  }
+}
+
+END_NAMESPACE_STIR
+
+USING_NAMESPACE_STIR
+
+int
+main()
+{
+  MemoryUsageTests tests;
+  tests.run_tests();
+  return tests.main_return_value();
+}
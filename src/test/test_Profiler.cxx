@@ -0,0 +1,134 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+
+/*!
+  \file
+  \ingroup test
+  \brief A simple program to test stir::Profiler and stir::ProfilerZone
+*/
+#include "stir/RunTests.h"
+#include "stir/Profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+START_NAMESPACE_STIR
+
+/*!
+  \brief Class with tests for the Profiler
+  \ingroup test
+*/
+class ProfilerTests : public RunTests
+{
+public:
+  void run_tests() override;
+};
+
+static void
+profiled_function(const int depth)
+{
+  ProfilerZone zone("inner");
+  if (depth > 0)
+    profiled_function(depth - 1);
+}
+
+void
+ProfilerTests::run_tests()
+{
+  // make sure that we start from a known state, independent of environment variables
+  Profiler::set_trace_enabled(false);
+  Profiler::set_enabled(false);
+  Profiler::reset();
+
+  std::cerr << "Testing disabled profiler\n";
+  {
+    {
+      ProfilerZone zone("outer");
+    }
+    check_if_equal(Profiler::get_statistics("outer").num_calls, 0UL, "disabled profiler should not record zones");
+  }
+
+  std::cerr << "Testing nested zones\n";
+  Profiler::set_enabled(true);
+  {
+    for (int i = 0; i < 3; ++i)
+      {
+        ProfilerZone zone("outer");
+        profiled_function(1);
+      }
+    const Profiler::ZoneStatistics outer = Profiler::get_statistics("outer");
+    const Profiler::ZoneStatistics inner = Profiler::get_statistics("outer/inner");
+    const Profiler::ZoneStatistics inner_inner = Profiler::get_statistics("outer/inner/inner");
+    check_if_equal(outer.num_calls, 3UL, "number of calls of outer zone");
+    check_if_equal(inner.num_calls, 3UL, "number of calls of nested zone");
+    check_if_equal(inner_inner.num_calls, 3UL, "number of calls of recursively nested zone");
+    check_if_equal(Profiler::get_statistics("inner").num_calls, 0UL, "nested zone should not be recorded at top level");
+    check(outer.min_time <= outer.max_time, "min time should not be larger than max time");
+    check(outer.total_time >= 3 * outer.min_time, "total time should be at least number of calls times the min time");
+    check(outer.total_time >= inner.total_time, "time of outer zone should include time of nested zone");
+
+    std::ostringstream s;
+    Profiler::write_statistics(s);
+    check(s.str().find("    inner") != std::string::npos, "statistics should list indented nested zones");
+  }
+
+  std::cerr << "Testing zones in multiple threads\n";
+  {
+    Profiler::reset();
+    check_if_equal(Profiler::get_statistics("outer").num_calls, 0UL, "reset should remove all statistics");
+    const int num_iterations = 20;
+#ifdef STIR_OPENMP
+#  pragma omp parallel for
+#endif
+    for (int i = 0; i < num_iterations; ++i)
+      {
+        ProfilerZone zone("parallel");
+      }
+    check_if_equal(Profiler::get_statistics("parallel").num_calls,
+                   static_cast<unsigned long>(num_iterations),
+                   "number of calls summed over all threads");
+  }
+
+  std::cerr << "Testing trace output\n";
+  {
+    Profiler::reset();
+    Profiler::set_trace_enabled(true);
+    {
+      ProfilerZone zone("traced \"zone\"");
+    }
+    const std::string filename = "test_Profiler_trace.json";
+    Profiler::write_chrome_trace(filename);
+    std::ifstream s(filename.c_str());
+    const std::string contents((std::istreambuf_iterator<char>(s)), std::istreambuf_iterator<char>());
+    s.close();
+    check(contents.find("\"traceEvents\"") != std::string::npos, "trace should contain traceEvents");
+    check(contents.find("{\"name\":\"traced \\\"zone\\\"\",\"cat\":\"stir\",\"ph\":\"X\"") != std::string::npos,
+          "trace should contain the (escaped) zone as complete event");
+    std::remove(filename.c_str());
+  }
+
+  Profiler::set_trace_enabled(false);
+  Profiler::set_enabled(false);
+  Profiler::reset();
+}
+
+END_NAMESPACE_STIR
+
+USING_NAMESPACE_STIR
+
+int
+main()
+{
+  ProfilerTests tests;
+  tests.run_tests();
+  return tests.main_return_value();
+}
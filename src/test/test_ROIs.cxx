@@ -37,6 +37,7 @@
 #include "stir/Shape/DiscretisedShape3D.h"
 #include "stir/evaluation/ROIValues.h"
 #include "stir/evaluation/compute_ROI_values.h"
+#include "stir/evaluation/ROIValuesCalculator.h"
 #include "stir/IndexRange.h"
 #include "stir/RunTests.h"
 #include "stir/is_null_ptr.h"
@@ -47,6 +48,7 @@
 #  include "stir/display.h"
 #endif
 #include <iostream>
+#include <vector>
 
 START_NAMESPACE_STIR
 
@@ -80,8 +82,83 @@ private:
                            VoxelsOnCartesianGrid<float>& image,
                            const bool do_rotated_ROI_test = true,
                            const bool do_separate_translate_test = true);
+
+  //! Compare ROIValuesCalculator with a direct computation for several shapes and images
+  /*! \warning changes image */
+  void run_tests_ROIValuesCalculator(VoxelsOnCartesianGrid<float>& image);
 };
 
+void
+ROITests::run_tests_ROIValuesCalculator(VoxelsOnCartesianGrid<float>& image)
+{
+  std::cerr << "\tTests with ROIValuesCalculator.\n";
+  const CartesianCoordinate3D<float> grid_spacing = image.get_voxel_size();
+  const float voxel_volume = grid_spacing.x() * grid_spacing.y() * grid_spacing.z();
+  const float z_centre = (image.get_min_index() + image.get_max_index()) / 2 * grid_spacing.z();
+  Ellipsoid ellipsoid(CartesianCoordinate3D<float>(image.size() * grid_spacing.z() / 3,
+                                                   image[0].size() * grid_spacing.y() / 5,
+                                                   image[0][0].size() * grid_spacing.x() / 4),
+                      CartesianCoordinate3D<float>(z_centre, 0, 0));
+  Box3D box(image[0][0].size() * grid_spacing.x() / 5,
+            image[0].size() * grid_spacing.y() / 6,
+            image.size() * grid_spacing.z() / 4,
+            CartesianCoordinate3D<float>(z_centre, 10, -20));
+  const std::vector<Shape3D*> shapes{ &ellipsoid, &box };
+  // use smooth ROIs to check the weights
+  const CartesianCoordinate3D<int> num_samples(2, 2, 2);
+
+  ROIValuesCalculator calculator(image);
+  for (auto shape_ptr : shapes)
+    calculator.add_ROI(*shape_ptr, num_samples);
+  check_if_equal(calculator.get_num_ROIs(), 2, "ROIValuesCalculator: number of ROIs");
+
+  VoxelsOnCartesianGrid<float> discretised_shape(image);
+  for (int image_num = 0; image_num < 2; ++image_num)
+    {
+      // fill image with a (different) ramp
+      for (int z = image.get_min_index(); z <= image.get_max_index(); ++z)
+        for (int y = image[z].get_min_index(); y <= image[z].get_max_index(); ++y)
+          for (int x = image[z][y].get_min_index(); x <= image[z][y].get_max_index(); ++x)
+            image[z][y][x] = 1.F + (image_num + 1) * (z + .1F * y) + .01F * x;
+
+      std::vector<VectorWithOffset<ROIValues>> values;
+      calculator.compute_ROI_values_per_plane(values, image);
+      const std::vector<ROIValues> total_values = calculator.compute_total_ROI_values(image);
+      for (std::size_t ROI_num = 0; ROI_num < shapes.size(); ++ROI_num)
+        {
+          shapes[ROI_num]->construct_volume(discretised_shape, num_samples);
+          double total_volume = 0;
+          double total_integral = 0;
+          for (int z = image.get_min_index(); z <= image.get_max_index(); ++z)
+            {
+              double volume = 0;
+              double integral = 0;
+              double integral_of_square = 0;
+              for (int y = image[z].get_min_index(); y <= image[z].get_max_index(); ++y)
+                for (int x = image[z][y].get_min_index(); x <= image[z][y].get_max_index(); ++x)
+                  {
+                    const double weight = discretised_shape[z][y][x];
+                    volume += weight;
+                    integral += weight * image[z][y][x];
+                    integral_of_square += weight * square(image[z][y][x]);
+                  }
+              check_if_equal(values[ROI_num][z].get_roi_volume(), volume * voxel_volume, "ROIValuesCalculator: volume per plane");
+              check_if_equal(values[ROI_num][z].get_integral(), integral * voxel_volume, "ROIValuesCalculator: integral per plane");
+              check_if_equal(values[ROI_num][z].get_integral_of_square(),
+                             integral_of_square * voxel_volume,
+                             "ROIValuesCalculator: integral of square per plane");
+              total_volume += volume;
+              total_integral += integral;
+            }
+          check_if_equal(total_values[ROI_num].get_roi_volume(), total_volume * voxel_volume, "ROIValuesCalculator: volume");
+          check_if_equal(total_values[ROI_num].get_mean(), total_integral / total_volume, "ROIValuesCalculator: mean");
+          // compare with the function for a single ROI
+          const ROIValues single_ROI_values = compute_total_ROI_values(image, *shapes[ROI_num], num_samples);
+          check_if_equal(total_values[ROI_num].get_mean(), single_ROI_values.get_mean(), "ROIValuesCalculator: mean vs single ROI");
+        }
+    }
+}
+
 void
 ROITests::run_tests_one_shape(Shape3D& shape,
                               VoxelsOnCartesianGrid<float>& image,
@@ -373,6 +450,8 @@ ROITests::run_tests()
       this->run_tests_one_shape(discretised_shape, image, false, false);
     }
   }
+  image.set_origin(origin);
+  this->run_tests_ROIValuesCalculator(image);
 }
 
 END_NAMESPACE_STIR
@@ -112,6 +112,11 @@ ScannerTests::test_scanner(const Scanner& scanner)
     name += " ";
     shared_ptr<Scanner> scanner_from_name_sptr(Scanner::get_scanner_from_name(name));
     check_if_equal(scanner.get_type(), scanner_from_name_sptr->get_type(), "get_scanner_from_name");
+    check(*scanner_from_name_sptr == scanner, "get_scanner_from_name should return the predefined scanner");
+    // modifying the returned scanner should not affect the next one
+    scanner_from_name_sptr->set_num_rings(scanner.get_num_rings() + 1);
+    shared_ptr<Scanner> other_scanner_from_name_sptr(Scanner::get_scanner_from_name(name));
+    check_if_equal(other_scanner_from_name_sptr->get_num_rings(), scanner.get_num_rings(), "get_scanner_from_name returns a copy");
   }
 #ifdef HAVE_LLN_MATRIX
   if (scanner.get_type() <= Scanner::E966) // TODO relies on ordering of enum
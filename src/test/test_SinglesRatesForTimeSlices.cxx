@@ -0,0 +1,156 @@
+/*
+    Copyright (C) 2026, University College London
+    This file is part of STIR.
+
+    SPDX-License-Identifier: Apache-2.0
+
+    See STIR/LICENSE.txt for details
+*/
+/*!
+  \file
+  \ingroup test
+  \ingroup singles_buildblock
+
+  \brief Test program for stir::SinglesRatesForTimeSlices
+*/
+
+#include "stir/data/SinglesRatesForTimeSlices.h"
+#include "stir/IndexRange2D.h"
+#include "stir/Scanner.h"
+#include "stir/RunTests.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+START_NAMESPACE_STIR
+
+namespace
+{
+//! Derived class that allows setting singles directly
+class SinglesRatesForTesting : public SinglesRatesForTimeSlices
+{
+public:
+  SinglesRatesForTesting(const shared_ptr<Scanner>& scanner_sptr, const std::vector<double>& times)
+  {
+    this->scanner_sptr = scanner_sptr;
+    this->_times = times;
+    this->_num_time_slices = static_cast<int>(times.size());
+    this->_singles = Array<2, int>(IndexRange2D(0, this->_num_time_slices - 1, 0, scanner_sptr->get_num_singles_units() - 1));
+    this->set_time_interval();
+  }
+
+  std::string get_registered_name() const override { return "SinglesRatesForTesting"; }
+};
+} // namespace
+
+/*!
+  \ingroup test
+  \brief Test class for SinglesRatesForTimeSlices
+
+  Compares get_singles() with a straightforward sum over the time slices.
+*/
+class SinglesRatesForTimeSlicesTests : public RunTests
+{
+public:
+  void run_tests() override;
+
+private:
+  //! sum over all slices of the overlap of [start_time,end_time] with the slice
+  double reference_singles(const SinglesRatesForTimeSlices& singles,
+                           const std::vector<std::vector<int>>& values,
+                           const int singles_bin_index,
+                           const double start_time,
+                           const double end_time) const;
+};
+
+double
+SinglesRatesForTimeSlicesTests::reference_singles(const SinglesRatesForTimeSlices& singles,
+                                                  const std::vector<std::vector<int>>& values,
+                                                  const int singles_bin_index,
+                                                  const double start_time,
+                                                  const double end_time) const
+{
+  const std::vector<double> times = singles.get_times();
+  const double interval = singles.get_singles_time_interval();
+  double total = 0;
+  for (unsigned slice = 0; slice < times.size(); ++slice)
+    {
+      const double slice_start = slice == 0 ? times[0] - interval : times[slice - 1];
+      const double slice_end = times[slice];
+      const double overlap = std::min(end_time, slice_end) - std::max(start_time, slice_start);
+      if (overlap > 0)
+        total += overlap / (slice_end - slice_start) * values[slice][singles_bin_index];
+    }
+  return total;
+}
+
+void
+SinglesRatesForTimeSlicesTests::run_tests()
+{
+  std::cerr << "Testing SinglesRatesForTimeSlices" << std::endl;
+
+  shared_ptr<Scanner> scanner_sptr(new Scanner(Scanner::E953));
+  const int num_singles_units = scanner_sptr->get_num_singles_units();
+  check(num_singles_units > 0, "scanner should have singles units");
+  const int num_time_slices = 20;
+  std::vector<double> times(num_time_slices);
+  for (int slice = 0; slice < num_time_slices; ++slice)
+    times[slice] = 2. * (slice + 1);
+
+  SinglesRatesForTesting singles(scanner_sptr, times);
+  std::vector<std::vector<int>> values(num_time_slices, std::vector<int>(num_singles_units));
+  for (int slice = 0; slice < num_time_slices; ++slice)
+    for (int singles_bin = 0; singles_bin < num_singles_units; ++singles_bin)
+      {
+        values[slice][singles_bin] = 1000 + 37 * slice + 11 * singles_bin + (slice * singles_bin) % 7;
+        singles.set_singles(singles_bin, slice, values[slice][singles_bin]);
+      }
+
+  const std::vector<std::pair<double, double>> intervals{
+    { 0., 40. }, { 0., 2. }, { 3., 3.5 }, { 2., 4. }, { 1.3, 17.7 }, { 10., 10. }, { 5.5, 39.1 }
+  };
+  for (const auto& interval : intervals)
+    {
+      const std::vector<float> all_units = singles.get_singles_for_all_units(interval.first, interval.second);
+      check_if_equal(static_cast<int>(all_units.size()), num_singles_units, "number of singles units");
+      for (int singles_bin = 0; singles_bin < num_singles_units; ++singles_bin)
+        {
+          const double reference = reference_singles(singles, values, singles_bin, interval.first, interval.second);
+          set_tolerance(1e-4 * std::max(reference, 1.));
+          check_if_equal(static_cast<double>(singles.get_singles(singles_bin, interval.first, interval.second)),
+                         reference,
+                         "get_singles for interval");
+          check_if_equal(static_cast<double>(all_units[singles_bin]), reference, "get_singles_for_all_units for interval");
+        }
+    }
+
+  // check that modifying the singles is taken into account
+  {
+    values[3][1] += 500;
+    singles.set_singles(1, 3, values[3][1]);
+    const double reference = reference_singles(singles, values, 1, 1., 20.);
+    set_tolerance(1e-4 * reference);
+    check_if_equal(static_cast<double>(singles.get_singles(1, 1., 20.)), reference, "get_singles after set_singles");
+  }
+
+  // check rebinning (first slice is not checked, as its start time is not stored)
+  {
+    const double reference = reference_singles(singles, values, 2, 10., 40.);
+    std::vector<double> new_times{ 10., 20., 30., 40. };
+    check_if_equal(singles.rebin(new_times), 4, "number of slices after rebin");
+    set_tolerance(1e-4 * reference);
+    check_if_equal(static_cast<double>(singles.get_singles(2, 10., 40.)), reference, "get_singles after rebin");
+  }
+}
+
+END_NAMESPACE_STIR
+
+USING_NAMESPACE_STIR
+
+int
+main()
+{
+  SinglesRatesForTimeSlicesTests tests;
+  tests.run_tests();
+  return tests.main_return_value();
+}
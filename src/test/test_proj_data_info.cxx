@@ -354,6 +354,51 @@ ProjDataInfoTests::test_generic_proj_data_info(ProjDataInfo& proj_data_info)
        << ", view = " << max_diff_view_num << ", tangential_pos_num = " << max_diff_tangential_pos_num
        << ", timing_pos_num = " << max_diff_timing_pos_num << "\n";
 
+  // test get_LOR_end_points_for_viewgram by comparing with get_LOR() for every bin
+  {
+    cerr << "\tTesting get_LOR_end_points_for_viewgram\n";
+    const float radius = proj_data_info.get_scanner_ptr()->get_inner_ring_radius();
+    LOREndPoints end_points;
+    LORInAxialAndNoArcCorrSinogramCoordinates<float> lor;
+    LORAs2Points<float> lor_points;
+    for (int segment_num : { proj_data_info.get_min_segment_num(), 0, proj_data_info.get_max_segment_num() })
+      for (int view_num : { proj_data_info.get_min_view_num(), proj_data_info.get_num_views() / 3 })
+        {
+          const ViewgramIndices viewgram_indices(view_num, segment_num);
+          proj_data_info.get_LOR_end_points_for_viewgram(end_points, viewgram_indices, radius);
+          if (!check_if_equal(end_points.size(),
+                              static_cast<std::size_t>(proj_data_info.get_num_axial_poss(segment_num))
+                                  * proj_data_info.get_num_tangential_poss(),
+                              "get_LOR_end_points_for_viewgram: size"))
+            continue;
+          float max_diff = 0.F;
+          std::size_t index = 0;
+          for (int axial_pos_num = proj_data_info.get_min_axial_pos_num(segment_num);
+               axial_pos_num <= proj_data_info.get_max_axial_pos_num(segment_num);
+               ++axial_pos_num)
+            for (int tangential_pos_num = proj_data_info.get_min_tangential_pos_num();
+                 tangential_pos_num <= proj_data_info.get_max_tangential_pos_num();
+                 ++tangential_pos_num, ++index)
+              {
+                const Bin bin(segment_num, view_num, axial_pos_num, tangential_pos_num);
+                proj_data_info.get_LOR(lor, bin);
+                CartesianCoordinate3D<float> p1(0.F, 0.F, 0.F), p2(0.F, 0.F, 0.F);
+                if (lor.get_intersections_with_cylinder(lor_points, radius) == Succeeded::yes)
+                  {
+                    p1 = lor_points.p1();
+                    p2 = lor_points.p2();
+                  }
+                const CartesianCoordinate3D<float> batch_p1(end_points.z1[index], end_points.y1[index], end_points.x1[index]);
+                const CartesianCoordinate3D<float> batch_p2(end_points.z2[index], end_points.y2[index], end_points.x2[index]);
+                max_diff = max(max_diff, static_cast<float>(norm(p1 - batch_p1)));
+                max_diff = max(max_diff, static_cast<float>(norm(p2 - batch_p2)));
+              }
+          check(max_diff < .01F,
+                "get_LOR_end_points_for_viewgram differs from get_LOR for segment " + std::to_string(segment_num) + ", view "
+                    + std::to_string(view_num));
+        }
+  }
+
   // test on reduce_segment_range and operator>=
   {
     shared_ptr<ProjDataInfo> smaller(proj_data_info.clone());
@@ -1240,6 +1285,32 @@ ProjDataInfoCylindricalNoArcCorrTests::run_tests()
                                                               /*arc_corrected*/ false,
                                                               /*tof_mashing*/ 5);
   test_proj_data_info(dynamic_cast<ProjDataInfoCylindricalNoArcCorr&>(*proj_data_info_ptr));
+
+  cerr << "\nTests of shared look-up tables\n";
+  {
+    const int num_detectors = scanner_ptr->get_num_detectors_per_ring();
+    const auto table_sptr = DetNumPairToViewTangPosTable::get_shared_table(num_detectors);
+    check(table_sptr == DetNumPairToViewTangPosTable::get_shared_table(num_detectors),
+          "DetNumPairToViewTangPosTable should be shared");
+    check(table_sptr != DetNumPairToViewTangPosTable::get_shared_table(num_detectors + 2),
+          "DetNumPairToViewTangPosTable should depend on number of detectors");
+    const auto inverse_table_sptr = ViewTangPosToDetNumPairTable::get_shared_table(num_detectors);
+    check(inverse_table_sptr == ViewTangPosToDetNumPairTable::get_shared_table(num_detectors),
+          "ViewTangPosToDetNumPairTable should be shared");
+    for (int view_num = 0; view_num < num_detectors / 2; ++view_num)
+      for (int tang_pos_num = inverse_table_sptr->get_min_tang_pos_num(); tang_pos_num <= inverse_table_sptr->get_max_tang_pos_num();
+           ++tang_pos_num)
+        {
+          const auto& dets = (*inverse_table_sptr)(view_num, tang_pos_num);
+          if (dets.det1_num == dets.det2_num)
+            continue;
+          const auto& view_tangpos = (*table_sptr)(dets.det1_num, dets.det2_num);
+          if (!check_if_equal(view_tangpos.view_num, view_num, "view_num from shared tables")
+              || !check_if_equal(view_tangpos.tang_pos_num, tang_pos_num, "tang_pos_num from shared tables")
+              || !check(view_tangpos.swap_detectors, "swap_detectors from shared tables"))
+            return;
+        }
+  }
 }
 
 void
@@ -41,6 +41,7 @@
 #endif
 #include "stir/info.h"
 #include "stir/warning.h"
+#include <algorithm>
 #include <cmath>
 
 START_NAMESPACE_STIR
@@ -72,6 +73,9 @@ public:
 
   *. Check that the sum of the TOF LOR is the same as the non TOF.
 
+  *. Check that ProjMatrixByBin::get_proj_matrix_elems_and_tof_kernel_for_one_bin() gives the same
+     projections as getting the rows for every TOF bin.
+
   \warning If you change the mashing factor the test_tof_proj_data_info() will fail.
   \warning The execution time strongly depends on the value of the TOF mashing factor
 */
@@ -92,6 +96,10 @@ private:
   //! of the TOF bins is equal to the non-TOF LOR.
   void test_tof_kernel_application(bool export_to_file);
 
+  //! Compares forward projections of an image using the geometric row and TOF kernel of a bin
+  //! with those using the rows for all TOF bins, for bins related by various symmetries.
+  void test_tof_kernel_for_all_tof_bins();
+
   //! Exports the nonTOF LOR to a file indicated by the current_id value
   //! in the filename.
   void export_lor(ProjMatrixElemsForOneBin& probabilities,
@@ -164,6 +172,8 @@ TOF_Tests::run_tests()
 
   // Switch to true in order to export the LORs at files in the current directory
   test_tof_kernel_application(false);
+
+  test_tof_kernel_for_all_tof_bins();
 }
 
 void
@@ -460,6 +470,66 @@ TOF_Tests::test_tof_kernel_application(bool print_to_file)
   std::cerr << std::endl;
 }
 
+void
+TOF_Tests::test_tof_kernel_for_all_tof_bins()
+{
+  shared_ptr<DiscretisedDensity<3, float>> density_sptr(test_discretised_density_sptr->get_empty_copy());
+  {
+    int count = 0;
+    for (auto iter = density_sptr->begin_all(); iter != density_sptr->end_all(); ++iter, ++count)
+      *iter = 1.F + (count % 17);
+  }
+
+  const int min_timing_pos_num = test_proj_data_info_sptr->get_min_tof_pos_num();
+  const int max_timing_pos_num = test_proj_data_info_sptr->get_max_tof_pos_num();
+  const int num_views = test_proj_data_info_sptr->get_num_views();
+  const int max_tang_pos_num = test_proj_data_info_sptr->get_max_tangential_pos_num();
+  // bins related by view, tangential and segment symmetries
+  std::vector<Bin> bins;
+  bins.push_back(Bin(0, 0, 5, 10, 0, 1.F));
+  bins.push_back(Bin(0, 3, 5, -10, 0, 1.F));
+  bins.push_back(Bin(0, num_views - 3, 5, 10, 0, 1.F));
+  bins.push_back(Bin(0, num_views / 2 + 3, 7, max_tang_pos_num / 2, 0, 1.F));
+  bins.push_back(Bin(1, num_views / 4, 5, 7, 0, 1.F));
+  bins.push_back(Bin(-1, num_views / 4, 5, -7, 0, 1.F));
+  bins.push_back(Bin(-1, 3 * num_views / 4, 5, 7, 0, 1.F));
+
+  ProjMatrixElemsForOneBin geometric_row;
+  ProjMatrixElemsForOneBin tof_row;
+  shared_ptr<const Array<2, float>> tof_kernel_sptr;
+  VectorWithOffset<float> tof_values(min_timing_pos_num, max_timing_pos_num);
+  // go through the bins twice, such that the 2nd time the geometric row and TOF kernel come from the cache
+  for (int pass = 0; pass < 2; ++pass)
+    for (const Bin& bin : bins)
+      {
+        test_proj_matrix_sptr->get_proj_matrix_elems_and_tof_kernel_for_one_bin(geometric_row, tof_kernel_sptr, bin);
+        const Array<2, float>& tof_kernel = *tof_kernel_sptr;
+        check_if_equal(tof_kernel.get_min_index(), min_timing_pos_num, "TOF kernel min index");
+        check_if_equal(tof_kernel.get_max_index(), max_timing_pos_num, "TOF kernel max index");
+        check_if_equal(static_cast<std::size_t>(tof_kernel[0].get_length()), geometric_row.size(), "TOF kernel row length");
+        tof_values.fill(0.F);
+        geometric_row.forward_project(tof_values, *density_sptr, tof_kernel);
+
+        for (int timing_pos_num = min_timing_pos_num; timing_pos_num <= max_timing_pos_num; ++timing_pos_num)
+          {
+            Bin tof_bin = bin;
+            tof_bin.timing_pos_num() = timing_pos_num;
+            tof_bin.set_bin_value(0.F);
+            test_proj_matrix_sptr->get_proj_matrix_elems_for_one_bin(tof_row, tof_bin);
+            tof_row.forward_project(tof_bin, *density_sptr);
+            set_tolerance(std::max(tof_bin.get_bin_value(), 1.F) * 1E-4);
+            check_if_equal(static_cast<double>(tof_values[timing_pos_num]),
+                           static_cast<double>(tof_bin.get_bin_value()),
+                           "forward projection with TOF kernel for bin "
+                               + boost::lexical_cast<std::string>(bin.segment_num()) + ","
+                               + boost::lexical_cast<std::string>(bin.view_num()) + ","
+                               + boost::lexical_cast<std::string>(bin.axial_pos_num()) + ","
+                               + boost::lexical_cast<std::string>(bin.tangential_pos_num()) + " TOF "
+                               + boost::lexical_cast<std::string>(timing_pos_num));
+          }
+      }
+}
+
 void
 TOF_Tests::export_lor(ProjMatrixElemsForOneBin& probabilities,
                       const CartesianCoordinate3D<float>& point1,
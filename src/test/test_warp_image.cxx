@@ -24,6 +24,8 @@
 #include "stir/spatial_transformation/warp_image.h"
 #include "stir/RunTests.h"
 #include "stir/spatial_transformation/GatedSpatialTransformation.h"
+#include "stir/spatial_transformation/PrecomputedWarpOperator.h"
+#include <cmath>
 #include <iostream>
 #include <algorithm>
 
@@ -40,11 +42,87 @@ class warp_imageTests : public RunTests
 {
 public:
   void run_tests() override;
+
+private:
+  void run_tests_for_PrecomputedWarpOperator();
 };
 
+void
+warp_imageTests::run_tests_for_PrecomputedWarpOperator()
+{
+  std::cerr << "Tests for PrecomputedWarpOperator" << std::endl;
+
+  const CartesianCoordinate3D<float> origin(0, 1, 2);
+  const CartesianCoordinate3D<float> grid_spacing(3, 4, 5);
+  const IndexRange<3> range(CartesianCoordinate3D<int>(0, -7, -6), CartesianCoordinate3D<int>(10, 8, 9));
+
+  VoxelsOnCartesianGrid<float> image(range, origin, grid_spacing);
+  VoxelsOnCartesianGrid<float> motion_x(range, origin, grid_spacing);
+  VoxelsOnCartesianGrid<float> motion_y(range, origin, grid_spacing);
+  VoxelsOnCartesianGrid<float> motion_z(range, origin, grid_spacing);
+  VoxelsOnCartesianGrid<float> other_image(range, origin, grid_spacing);
+  // smoothly varying, non-integer motion fields and arbitrary images
+  for (int z = image.get_min_index(); z <= image.get_max_index(); ++z)
+    for (int y = image[z].get_min_index(); y <= image[z].get_max_index(); ++y)
+      for (int x = image[z][y].get_min_index(); x <= image[z][y].get_max_index(); ++x)
+        {
+          image[z][y][x] = static_cast<float>(1 + std::sin(0.3 * x + 0.2 * y) + 0.1 * z);
+          other_image[z][y][x] = static_cast<float>(2 + std::cos(0.1 * x * y + z));
+          motion_x[z][y][x] = static_cast<float>(grid_spacing[3] * 1.3 * std::sin(0.2 * z));
+          motion_y[z][y][x] = static_cast<float>(grid_spacing[2] * (0.4 + 0.05 * x));
+          motion_z[z][y][x] = static_cast<float>(grid_spacing[1] * -0.7 * std::cos(0.1 * y));
+        }
+
+  const PrecomputedWarpOperator warp_operator(motion_x, motion_y, motion_z);
+
+  // compare with warp_image
+  {
+    const shared_ptr<VoxelsOnCartesianGrid<float>> image_sptr(image.clone());
+    const shared_ptr<VoxelsOnCartesianGrid<float>> motion_x_sptr(motion_x.clone());
+    const shared_ptr<VoxelsOnCartesianGrid<float>> motion_y_sptr(motion_y.clone());
+    const shared_ptr<VoxelsOnCartesianGrid<float>> motion_z_sptr(motion_z.clone());
+    const VoxelsOnCartesianGrid<float> warped_image
+        = warp_image(image_sptr, motion_x_sptr, motion_y_sptr, motion_z_sptr, BSpline::linear, false);
+    VoxelsOnCartesianGrid<float> warped_image_by_operator(range, origin, grid_spacing);
+    warp_operator.apply(warped_image_by_operator, image);
+    check_if_equal(warped_image, warped_image_by_operator, "PrecomputedWarpOperator::apply vs warp_image");
+  }
+  // check that apply_transpose is the adjoint of apply: <A x, y> == <x, A^T y>
+  {
+    VoxelsOnCartesianGrid<float> warped_image(range, origin, grid_spacing);
+    warp_operator.apply(warped_image, image);
+    VoxelsOnCartesianGrid<float> transposed_image(range, origin, grid_spacing);
+    warp_operator.apply_transpose(transposed_image, other_image);
+    double inner_product1 = 0;
+    double inner_product2 = 0;
+    VoxelsOnCartesianGrid<float>::const_full_iterator iter_warped = warped_image.begin_all_const();
+    VoxelsOnCartesianGrid<float>::const_full_iterator iter_other = other_image.begin_all_const();
+    VoxelsOnCartesianGrid<float>::const_full_iterator iter_transposed = transposed_image.begin_all_const();
+    for (VoxelsOnCartesianGrid<float>::const_full_iterator iter = image.begin_all_const(); iter != image.end_all_const();
+         ++iter, ++iter_warped, ++iter_other, ++iter_transposed)
+      {
+        inner_product1 += static_cast<double>(*iter_warped) * (*iter_other);
+        inner_product2 += static_cast<double>(*iter) * (*iter_transposed);
+      }
+    check_if_equal(inner_product1, inner_product2, "PrecomputedWarpOperator::apply_transpose is adjoint of apply");
+
+    // accumulate versions
+    VoxelsOnCartesianGrid<float> accumulated_transposed_image(transposed_image);
+    warp_operator.accumulate_apply_transpose(accumulated_transposed_image, other_image);
+    transposed_image *= 2;
+    check_if_equal(accumulated_transposed_image, transposed_image, "PrecomputedWarpOperator::accumulate_apply_transpose");
+    VoxelsOnCartesianGrid<float> accumulated_image(warped_image);
+    warp_operator.accumulate_apply(accumulated_image, image);
+    warped_image *= 2;
+    check_if_equal(accumulated_image, warped_image, "PrecomputedWarpOperator::accumulate_apply");
+  }
+}
+
 void
 warp_imageTests::run_tests()
 {
+  run_tests_for_PrecomputedWarpOperator();
+
   std::cerr << "Tests for warp_image" << std::endl;
 
   CartesianCoordinate3D<float> origin(0, 1, 2);
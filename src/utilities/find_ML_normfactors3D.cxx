@@ -15,12 +15,20 @@
  \brief Find normalisation factors using an ML approach
 
  Just a wrapper around ML_estimate_component_based_normalisation
+
+ With the \c --listmode option, \c measured_data is a list mode file. The fan data are then computed directly
+ from the list mode events (using the model data to determine the maximum ring difference and fan size),
+ without storing the measured projection data.
  \author Kris Thielemans
  */
 #include "stir/recon_buildblock/ML_estimate_component_based_normalisation.h"
 #include "stir/CPUTimer.h"
 #include "stir/info.h"
 #include "stir/ProjData.h"
+#include "stir/ML_norm.h"
+#include "stir/listmode/ListModeData.h"
+#include "stir/listmode/ML_norm_listmode.h"
+#include "stir/IO/read_from_file.h"
 #include <boost/format.hpp>
 #include <iostream>
 #include <string>
@@ -29,9 +37,10 @@ static void
 print_usage_and_exit(const std::string& program_name)
 {
   std::cerr << "Usage: " << program_name
-            << " [--display | --print-KL | --include-block-timing-model | --for-symmetry-per-block] \\\n"
+            << " [--display | --print-KL | --include-block-timing-model | --for-symmetry-per-block | --listmode] \\\n"
             << " out_filename_prefix measured_data model num_iterations num_eff_iterations\n"
-            << " set num_iterations to 0 to do only efficiencies\n";
+            << " set num_iterations to 0 to do only efficiencies\n"
+            << " use --listmode if measured_data is a list mode file (prompts only are used)\n";
   exit(EXIT_FAILURE);
 }
 
@@ -50,6 +59,7 @@ main(int argc, char** argv)
   bool do_geo = true;
   bool do_block = false;
   bool do_symmetry_per_block = false;
+  bool measured_data_is_listmode = false;
 
   // first process command line options
   while (argc > 0 && argv[0][0] == '-' && argc >= 1)
@@ -84,6 +94,12 @@ main(int argc, char** argv)
           --argc;
           ++argv;
         }
+      else if (strcmp(argv[0], "--listmode") == 0)
+        {
+          measured_data_is_listmode = true;
+          --argc;
+          ++argv;
+        }
       else
         print_usage_and_exit(program_name);
     }
@@ -99,14 +115,25 @@ main(int argc, char** argv)
   const int num_eff_iterations = atoi(argv[5]);
   const int num_iterations = atoi(argv[4]);
   shared_ptr<ProjData> model_data = ProjData::read_from_file(argv[3]);
-  shared_ptr<ProjData> measured_data = ProjData::read_from_file(argv[2]);
   const std::string out_filename_prefix = argv[1];
 
   CPUTimer timer;
   timer.start();
 
+  FanProjData measured_fan_data;
+  if (measured_data_is_listmode)
+    {
+      shared_ptr<ListModeData> lm_data_sptr = read_from_file<ListModeData>(argv[2]);
+      make_fan_data_remove_gaps(measured_fan_data, *lm_data_sptr, *model_data->get_proj_data_info_sptr());
+    }
+  else
+    {
+      shared_ptr<ProjData> measured_data = ProjData::read_from_file(argv[2]);
+      make_fan_data_remove_gaps(measured_fan_data, *measured_data);
+    }
+
   ML_estimate_component_based_normalisation(out_filename_prefix,
-                                            *measured_data,
+                                            measured_fan_data,
                                             *model_data,
                                             num_eff_iterations,
                                             num_iterations,
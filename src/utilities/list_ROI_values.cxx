@@ -41,7 +41,7 @@
   \author Kris Thielemans
 */
 #include "stir/utilities.h"
-#include "stir/evaluation/compute_ROI_values.h"
+#include "stir/evaluation/ROIValuesCalculator.h"
 #include "stir/Shape/DiscretisedShape3D.h"
 #include "stir/VoxelsOnCartesianGrid.h"
 #include "stir/DataProcessor.h"
@@ -162,6 +162,7 @@ main(int argc, char* argv[])
   bool do_filename = false;
   bool do_max = false;
   bool do_min = false;
+  bool do_table = false;
 
   const char* const progname = argv[0];
 
@@ -177,6 +178,8 @@ main(int argc, char* argv[])
         do_CV = true;
       else if (strcmp(argv[1], "--V") == 0)
         do_V = true;
+      else if (strcmp(argv[1], "--table") == 0)
+        do_table = true;
       else
         error(boost::format("Unknown option %s") % argv[1]);
       --argc;
@@ -186,14 +189,16 @@ main(int argc, char* argv[])
   if (argc != 6 && argc != 5 && argc != 4 && argc != 3)
     {
       cerr << "\nUsage: " << progname << " \\\n"
-           << "\t[--CV] [--V] [--list-filename] [--max] [--min] output_filename data_filename [ ROI_filename.par [min_plane_num "
-              "max_plane_num]]\n";
+           << "\t[--CV] [--V] [--list-filename] [--max] [--min] [--table] \\\n"
+           << "\toutput_filename data_filename [ ROI_filename.par [min_plane_num max_plane_num]]\n";
       cerr << "Normally, only mean and stddev are listed.\n"
            << "Use the option --CV to output the Coefficient of Variation as well.\n"
            << "Use the option --V to output the Total Volume, as well.\n"
            << "Use the option --list-filename to output the filename as well.\n"
            << "Use the option --max to output the max value as well.\n"
-           << "Use the option --min to output the min as well.\n";
+           << "Use the option --min to output the min as well.\n"
+           << "Use the option --table to output all values as a tab-separated table (with a header line)\n"
+           << "suitable for reading by other programs. The other options are then ignored.\n";
       ;
       cerr << "If [min_plane_num] is set to 0 and no [max_plane_num given] then sum of the plane values will be listed.\n";
       cerr << "When ROI_filename.par is not given, the user will be asked for the parameters.\n"
@@ -228,78 +233,98 @@ main(int argc, char* argv[])
 
   if (!is_null_ptr(parameters.filter_ptr))
     parameters.filter_ptr->apply(*image_ptr);
-  if (do_filename)
-    out << std::setw(15) << "ImageName";
-  else
-    out << input_file << '\n';
-
-  out << std::setw(15) << "ROI";
-
-  if (by_plane)
-    out << std::setw(10) << "Plane_num";
-  out << std::setw(15) << "Mean " << std::setw(15) << "Stddev";
-  if (do_max)
-    out << std::setw(15) << "Max ";
-  if (do_min)
-    out << std::setw(15) << "Min ";
-  if (do_CV)
-    out << std::setw(15) << "CV";
-  if (do_V)
-    out << std::setw(15) << "Volume";
-  out << '\n';
+  if (!do_table)
+    {
+      if (do_filename)
+        out << std::setw(15) << "ImageName";
+      else
+        out << input_file << '\n';
+
+      out << std::setw(15) << "ROI";
+
+      if (by_plane)
+        out << std::setw(10) << "Plane_num";
+      out << std::setw(15) << "Mean " << std::setw(15) << "Stddev";
+      if (do_max)
+        out << std::setw(15) << "Max ";
+      if (do_min)
+        out << std::setw(15) << "Min ";
+      if (do_CV)
+        out << std::setw(15) << "CV";
+      if (do_V)
+        out << std::setw(15) << "Volume";
+      out << '\n';
+    }
   {
-    std::vector<shared_ptr<Shape3D>>::const_iterator current_shape_iter = parameters.shape_ptrs.begin();
-    std::vector<std::string>::const_iterator current_name_iter = parameters.shape_names.begin();
-    for (; current_shape_iter != parameters.shape_ptrs.end(); ++current_shape_iter, ++current_name_iter)
+    // discretise all ROIs once, and compute their values in a single pass over the image
+    ROIValuesCalculator calculator(*image_ptr);
+    for (std::size_t i = 0; i < parameters.shape_ptrs.size(); ++i)
+      calculator.add_ROI(*parameters.shape_ptrs[i], parameters.num_samples, parameters.shape_names[i]);
+
+    if (by_plane)
       {
-        if (by_plane)
+        std::vector<VectorWithOffset<ROIValues>> all_values;
+        calculator.compute_ROI_values_per_plane(all_values, *image_ptr);
+        if (do_table)
           {
-            VectorWithOffset<ROIValues> values;
-            compute_ROI_values_per_plane(values, *image_ptr, **current_shape_iter, parameters.num_samples);
-
-            for (int i = min_plane_number; i <= max_plane_number; i++)
+            ROIValuesCalculator::write_table_header(out, by_plane);
+            for (auto& values : all_values)
               {
-                if (do_filename)
-                  out << std::setw(15) << input_file;
-                out << std::setw(15) << *current_name_iter << std::setw(10) << i + 1 << std::setw(15) << values[i].get_mean()
-                    << std::setw(15) << values[i].get_stddev();
-                if (do_max)
-                  out << std::setw(15) << values[i].get_max();
-                if (do_min)
-                  out << std::setw(15) << values[i].get_min();
-                if (do_CV)
-                  out << std::setw(15) << values[i].get_CV();
-                if (do_V)
-                  out << std::setw(15) << values[i].get_roi_volume();
-                out << '\n';
+                VectorWithOffset<ROIValues> selected_values(min_plane_number, max_plane_number);
+                for (int i = min_plane_number; i <= max_plane_number; i++)
+                  selected_values[i] = values[i];
+                swap(values, selected_values);
               }
+            calculator.write_table(out, input_file, all_values);
           }
-        if (!by_plane)
+        else
+          for (int ROI_num = 0; ROI_num < calculator.get_num_ROIs(); ++ROI_num)
+            {
+              const VectorWithOffset<ROIValues>& values = all_values[ROI_num];
+              for (int i = min_plane_number; i <= max_plane_number; i++)
+                {
+                  if (do_filename)
+                    out << std::setw(15) << input_file;
+                  out << std::setw(15) << calculator.get_ROI_name(ROI_num) << std::setw(10) << i + 1 << std::setw(15)
+                      << values[i].get_mean() << std::setw(15) << values[i].get_stddev();
+                  if (do_max)
+                    out << std::setw(15) << values[i].get_max();
+                  if (do_min)
+                    out << std::setw(15) << values[i].get_min();
+                  if (do_CV)
+                    out << std::setw(15) << values[i].get_CV();
+                  if (do_V)
+                    out << std::setw(15) << values[i].get_roi_volume();
+                  out << '\n';
+                }
+            }
+      }
+    if (!by_plane)
+      {
+        const std::vector<ROIValues> all_values = calculator.compute_total_ROI_values(*image_ptr);
+        if (do_table)
           {
-            ROIValues values;
-            values = compute_total_ROI_values(*image_ptr, **current_shape_iter, parameters.num_samples);
-            if (do_filename)
-              out << std::setw(15) << input_file;
-            out << std::setw(15) << *current_name_iter << std::setw(15) << values.get_mean() << std::setw(15)
-                << values.get_stddev();
-            if (do_max)
-              out << std::setw(15) << values.get_max();
-            if (do_min)
-              out << std::setw(15) << values.get_min();
-            if (do_CV)
-              out << std::setw(15) << values.get_CV();
-            if (do_V)
-              out << std::setw(15) << values.get_roi_volume();
-            out << '\n';
+            ROIValuesCalculator::write_table_header(out, by_plane);
+            calculator.write_table(out, input_file, all_values);
           }
-#if 0
-    for (VectorWithOffset<ROIValues>::const_iterator iter = values.begin();
-         iter != values.end();
-         iter++)
-      {
-        std::cout << iter->report();
-      }
-#endif
+        else
+          for (int ROI_num = 0; ROI_num < calculator.get_num_ROIs(); ++ROI_num)
+            {
+              const ROIValues& values = all_values[ROI_num];
+              if (do_filename)
+                out << std::setw(15) << input_file;
+              out << std::setw(15) << calculator.get_ROI_name(ROI_num) << std::setw(15) << values.get_mean() << std::setw(15)
+                  << values.get_stddev();
+              if (do_max)
+                out << std::setw(15) << values.get_max();
+              if (do_min)
+                out << std::setw(15) << values.get_min();
+              if (do_CV)
+                out << std::setw(15) << values.get_CV();
+              if (do_V)
+                out << std::setw(15) << values.get_roi_volume();
+              out << '\n';
+            }
       }
   }
 
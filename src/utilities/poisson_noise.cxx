@@ -9,7 +9,7 @@
 
   Usage:
   \code
-  poisson_noise [-p | --preserve-mean] \
+  poisson_noise [-p | --preserve-mean] [--counter-based] [--num-realisations N] \
         output_filename input_projdata_filename \
         scaling_factor seed-unsigned-int
   \endcode
@@ -20,7 +20,12 @@
   Without the -p option, the mean of the output data will
   be equal to <tt>scaling_factor*mean_of_input</tt>, otherwise it
   will be equal to mean_of_input.<br>
-  The options -p and --preserve-mean are identical.
+  The options -p and --preserve-mean are identical.<br>
+  With --counter-based, a counter-based random number generator is used, such that the noise is
+  generated in parallel (if STIR is compiled with OpenMP), and the result does not depend on the number of threads.
+  See GeneralisedPoissonNoiseGenerator::set_use_counter_based_generator().<br>
+  With --num-realisations N (and N larger than 1), N realisations are written to
+  <tt>output_filename_1</tt>, <tt>output_filename_2</tt> etc, while the input data is read only once.
 */
 /*
     Copyright (C) 2000 - 2004, Hammersmith Imanet Ltd
@@ -34,6 +39,8 @@
 
 #include "stir/GeneralisedPoissonNoiseGenerator.h"
 #include "stir/ProjDataInterfile.h"
+#include <boost/format.hpp>
+#include <vector>
 
 USING_NAMESPACE_STIR
 
@@ -41,37 +48,49 @@ void
 usage()
 {
   using std::cerr;
-  cerr << "Usage: poisson_noise [-p | --preserve-mean] <output_filename (no extension)> <input_projdata_filename> scaling_factor "
-          "seed-unsigned-int\n"
+  cerr << "Usage: poisson_noise [-p | --preserve-mean] [--counter-based] [--num-realisations N] \\\n"
+       << "   <output_filename (no extension)> <input_projdata_filename> scaling_factor seed-unsigned-int\n"
        << "The seed value for the random number generator has to be strictly positive.\n"
        << "Without the -p option, the mean of the output data will"
        << " be equal to\nscaling_factor*mean_of_input, otherwise it"
        << "will be equal to mean_of_input.\n"
-       << "The options -p and --preserve-mean are identical.\n";
+       << "The options -p and --preserve-mean are identical.\n"
+       << "With --counter-based, the noise is generated in parallel, independent of the number of threads.\n"
+       << "With --num-realisations N, N realisations are written to output_filename_1, output_filename_2 etc.\n";
 }
 
 int
 main(int argc, char* argv[])
 {
-  if (argc < 5)
-    {
-      usage();
-      return (EXIT_FAILURE);
-    }
-
   bool preserve_mean = false;
+  bool counter_based = false;
+  int num_realisations = 1;
 
   // option processing
-  if (argv[1][0] == '-')
+  while (argc > 1 && argv[1][0] == '-')
     {
       if (strcmp(argv[1], "-p") == 0 || strcmp(argv[1], "--preserve-mean") == 0)
         preserve_mean = true;
+      else if (strcmp(argv[1], "--counter-based") == 0)
+        counter_based = true;
+      else if (strcmp(argv[1], "--num-realisations") == 0 && argc > 2)
+        {
+          num_realisations = atoi(argv[2]);
+          ++argv;
+          --argc;
+        }
       else
         {
           usage();
           return (EXIT_FAILURE);
         }
       ++argv;
+      --argc;
+    }
+  if (argc != 5 || num_realisations < 1)
+    {
+      usage();
+      return (EXIT_FAILURE);
     }
 
   const char* const filename = argv[1];
@@ -82,10 +101,24 @@ main(int argc, char* argv[])
 
   GeneralisedPoissonNoiseGenerator generator(scaling_factor, preserve_mean);
   generator.seed(seed);
+  generator.set_use_counter_based_generator(counter_based);
 
-  ProjDataInterfile new_data(in_data->get_exam_info_sptr(), in_data->get_proj_data_info_sptr()->create_shared_clone(), filename);
+  if (num_realisations == 1)
+    {
+      ProjDataInterfile new_data(
+          in_data->get_exam_info_sptr(), in_data->get_proj_data_info_sptr()->create_shared_clone(), filename);
 
-  generator.generate_random(new_data, *in_data);
+      generator.generate_random(new_data, *in_data);
+    }
+  else
+    {
+      std::vector<shared_ptr<ProjData>> new_data_sptrs;
+      for (int r = 1; r <= num_realisations; ++r)
+        new_data_sptrs.push_back(std::make_shared<ProjDataInterfile>(in_data->get_exam_info_sptr(),
+                                                                     in_data->get_proj_data_info_sptr()->create_shared_clone(),
+                                                                     boost::str(boost::format("%1%_%2%") % filename % r)));
+      generator.generate_random(new_data_sptrs, *in_data);
+    }
 
   return EXIT_SUCCESS;
 }
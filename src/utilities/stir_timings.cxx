@@ -1,5 +1,5 @@
 /*
-    Copyright (C) 2023, 2024 University College London
+    Copyright (C) 2023, 2024, 2026 University College London
     This file is part of STIR.
 
     SPDX-License-Identifier: Apache-2.0
@@ -20,6 +20,16 @@
 
   Run the utility without any arguments to get a help message.
   If you want to know what is actually timed, you will have to look at the source code.
+
+  Timings can be run for a range of thread counts, and on projection data of an existing
+  file or of a synthetic scanner (optionally with TOF). All timings can be written to a JSON
+  file, which is intended for tracking performance between STIR versions. For instance
+  \verbatim
+  for mash in 1 2 4; do
+    stir_timings --name mash$mash --scanner "Siemens mMR" --view-mashing $mash --threads 1,4,8 \
+        --json timings_mash$mash.json
+  done
+  \endverbatim
 */
 
 #include "stir/KeyParser.h"
@@ -27,14 +37,31 @@
 #include "stir/ProjDataInMemory.h"
 #include "stir/DiscretisedDensity.h"
 #include "stir/VoxelsOnCartesianGrid.h"
+#include "stir/ExamInfo.h"
+#include "stir/Scanner.h"
+#include "stir/SSRB.h"
 #include "stir/IO/read_from_file.h"
 #include "stir/IO/write_to_file.h"
+#include "stir/IO/InterfileOutputFileFormat.h"
+#ifdef HAVE_ITK
+#  include "stir/IO/ITKOutputFileFormat.h"
+#endif
+#include "stir/listmode/ListModeData.h"
+#include "stir/listmode/ListRecord.h"
 #include "stir/recon_buildblock/ProjectorByBinPairUsingProjMatrixByBin.h"
 #ifdef STIR_WITH_Parallelproj_PROJECTOR
 #  include "stir/recon_buildblock/Parallelproj_projector/ProjectorByBinPairUsingParallelproj.h"
 #endif
 #include "stir/recon_buildblock/ProjMatrixByBinUsingRayTracing.h"
+#include "stir/recon_buildblock/ProjMatrixElemsForOneBin.h"
 #include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearModelForMeanAndProjData.h"
+#include "stir/recon_buildblock/PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin.h"
+#include "stir/recon_buildblock/BinNormalisationFromProjData.h"
+#include "stir/recon_buildblock/FourierRebinning.h"
+#include "stir/analytic/FBP2D/FBP2DReconstruction.h"
+#include "stir/recon_buildblock/QuadraticPrior.h"
+#include "stir/recon_buildblock/LogcoshPrior.h"
+#include "stir/recon_buildblock/PLSPrior.h"
 #include "stir/recon_buildblock/RelativeDifferencePrior.h"
 #ifdef STIR_WITH_CUDA
 #  include "stir/recon_buildblock/CUDA/CudaRelativeDifferencePrior.h"
@@ -46,22 +73,37 @@
 #include "stir/num_threads.h"
 #include "stir/Verbosity.h"
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <cstdlib>
 #include <iomanip>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 static void
 print_usage_and_exit()
 {
-  std::cerr << "\nUsage:\nstir_timings [--name some_string] [--threads num_threads] [--runs num_runs]\\\n"
+  std::cerr << "\nUsage:\nstir_timings [--name some_string] [--threads num_threads[,num_threads...]] [--runs num_runs]\\\n"
             << "\t[--skip-BB 1] [--skip-PP 1] [--skip-PMRT 1] [--skip-priors 1]\\\n"
+            << "\t[--skip-norm 1] [--skip-rebinning 1] [--skip-IO 1]\\\n"
             << "\t[--projector_par_filename parfile]\\\n"
             << "\t[--image image_filename]\\\n"
-            << "\t--template-projdata template_proj_data_filename\n\n"
-            << "skip BB: basic building blocks; PP: Parallelproj; PMRT: ray-tracing matrix; priors: prior timing\n\n"
+            << "\t[--listmode listmode_filename]\\\n"
+            << "\t[--json json_filename]\\\n"
+            << "\t{--template-projdata template_proj_data_filename |\\\n"
+            << "\t --scanner scanner_name [--span span] [--view-mashing factor] [--TOF-mashing factor]}\n\n"
+            << "skip BB: basic building blocks; PP: Parallelproj; PMRT: ray-tracing matrix; priors: prior timing\n"
+            << "     norm: normalisation; rebinning: SSRB, FBP2D and FORE; IO: image I/O in supported file formats\n\n"
+            << "With --scanner, synthetic projection data are used (default span 11, no mashing, non-TOF).\n"
+            << "Use --TOF-mashing 1 (or higher) for TOF data of a TOF-ready scanner.\n"
+            << "When a list of thread counts is given, all timings are repeated for every thread count.\n"
+            << "With --listmode, reading of the events and the list-mode objective function (using the ray-tracing matrix)\n"
+            << "are timed as well.\n"
+            << "The list-mode data have to be compatible with the template (or scanner).\n\n"
             << "Timings are reported to stdout as:\n"
-            << "name\ttiming_name\tCPU_time_in_ms\twall-clock_time_in_ms\n";
+            << "name\ttiming_name\tCPU_time_in_ms\twall-clock_time_in_ms\tnum_threads\n"
+            << "and are also written to the JSON file (if specified).\n";
   std::cerr << "\nExample projector-pair par-file (the following corresponds to the PMRT configuration normally used)\n"
             << "projector pair parameters:=\n"
             << "   type := Matrix\n"
@@ -83,13 +125,30 @@ class Timings : public TimedObject
   typedef void (Timings::*TimedFunction)();
 
 public:
+  //! Result of one timing
+  struct Result
+  {
+    std::string item;
+    int num_threads;
+    unsigned runs;
+    double CPU_time_in_ms;
+    double wall_clock_time_in_ms;
+  };
+
   //! Use as prefix for all output
   std::string name;
+  //! Number of threads used for the current timings (only used for the output)
+  int num_threads;
   // variables that select timings
-  bool skip_BB;     //! skip basic building blocks
-  bool skip_PMRT;   //! skip ProjMatrixByBinUsingRayTracing
-  bool skip_PP;     //! skip Parallelproj
-  bool skip_priors; //! skip GeneralisedPrior
+  bool skip_BB;        //! skip basic building blocks
+  bool skip_PMRT;      //! skip ProjMatrixByBinUsingRayTracing
+  bool skip_PP;        //! skip Parallelproj
+  bool skip_priors;    //! skip GeneralisedPrior
+  bool skip_norm;      //! skip BinNormalisation
+  bool skip_rebinning; //! skip SSRB, FBP2D and FORE
+  bool skip_IO;        //! skip image I/O
+  //! Results of all timings so far
+  std::vector<Result> results;
   // variables used for running timings
   shared_ptr<VoxelsOnCartesianGrid<float>> image_sptr;
   shared_ptr<ProjData> output_proj_data_sptr;
@@ -103,25 +162,43 @@ public:
   shared_ptr<ProjectorByBinPairUsingParallelproj> parallelproj_projectors_sptr;
 #endif
   shared_ptr<ProjectorByBinPair> parsed_projectors_sptr;
-  shared_ptr<ProjData> template_proj_data_sptr;
+  shared_ptr<const ExamInfo> template_exam_info_sptr;
+  shared_ptr<const ProjDataInfo> template_proj_data_info_sptr;
   shared_ptr<ExamInfo> exam_info_sptr;
   shared_ptr<PoissonLogLikelihoodWithLinearModelForMeanAndProjData<DiscretisedDensity<3, float>>> objective_function_sptr;
 
   shared_ptr<GeneralisedPrior<DiscretisedDensity<3, float>>> prior_sptr;
+  shared_ptr<BinNormalisation> normalisation_sptr;
+  shared_ptr<ProjDataInMemory> SSRB_proj_data_sptr;
+  shared_ptr<OutputFileFormat<DiscretisedDensity<3, float>>> output_file_format_sptr;
+  std::string written_image_filename;
+  std::string listmode_filename;
+  shared_ptr<ListModeData> listmode_data_sptr;
+  shared_ptr<PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<DiscretisedDensity<3, float>>>
+      listmode_objective_function_sptr;
   // basic methods
-  Timings(const std::string& image_filename, const std::string& template_proj_data_filename)
+  Timings(const std::string& image_filename,
+          const shared_ptr<const ExamInfo>& template_exam_info_sptr,
+          const shared_ptr<const ProjDataInfo>& template_proj_data_info_sptr)
+      : num_threads(1),
+        template_exam_info_sptr(template_exam_info_sptr),
+        template_proj_data_info_sptr(template_proj_data_info_sptr)
   {
     if (!image_filename.empty())
       this->image_sptr = read_from_file<VoxelsOnCartesianGrid<float>>(image_filename);
-
-    if (!template_proj_data_filename.empty())
-      this->template_proj_data_sptr = ProjData::read_from_file(template_proj_data_filename);
   }
 
   void run_it(TimedFunction f, const std::string& item, const unsigned runs = 1);
   void run_projectors(const std::string& prefix, const shared_ptr<ProjectorByBinPair> proj_sptr, const unsigned runs);
+  void run_prior(const std::string& prefix, const shared_ptr<GeneralisedPrior<DiscretisedDensity<3, float>>>& prior_sptr,
+                 const unsigned runs);
+  void run_image_IO(const std::string& prefix,
+                    const shared_ptr<OutputFileFormat<DiscretisedDensity<3, float>>>& output_file_format_sptr,
+                    const unsigned runs);
   void run_all(const unsigned runs = 1);
   void init();
+  //! Write all results and a description of the data to file in JSON format
+  void write_results_as_JSON(const std::string& filename) const;
 
   // functions that are timed
 
@@ -174,14 +251,14 @@ public:
   //! create proj_data in memory object
   void create_proj_data_in_mem_no_init()
   {
-    ProjDataInMemory tmp(this->template_proj_data_sptr->get_exam_info_sptr(),
-                         this->template_proj_data_sptr->get_proj_data_info_sptr(),
+    ProjDataInMemory tmp(this->template_exam_info_sptr,
+                         this->template_proj_data_info_sptr,
                          /* initialise*/ false);
   }
   void create_proj_data_in_mem_init()
   {
-    ProjDataInMemory tmp(this->template_proj_data_sptr->get_exam_info_sptr(),
-                         this->template_proj_data_sptr->get_proj_data_info_sptr(),
+    ProjDataInMemory tmp(this->template_exam_info_sptr,
+                         this->template_proj_data_info_sptr,
                          /* initialise*/ true);
   }
   //! call ProjDataInMemory::fill(ProjDataInMemory&)
@@ -193,8 +270,8 @@ public:
   //! copy from output_proj_data_sptr to new Interfile file
   void copy_proj_data_file_to_file()
   {
-    ProjDataInterfile tmp(this->template_proj_data_sptr->get_exam_info_sptr(),
-                          this->template_proj_data_sptr->get_proj_data_info_sptr(),
+    ProjDataInterfile tmp(this->template_exam_info_sptr,
+                          this->template_proj_data_info_sptr,
                           "my_timings_copy.hs");
     tmp.fill(*this->output_proj_data_sptr);
   }
@@ -202,8 +279,8 @@ public:
   //! copy from output_proj_data_sptr to memory object
   void copy_proj_data_file_to_mem()
   {
-    ProjDataInMemory tmp(this->template_proj_data_sptr->get_exam_info_sptr(),
-                         this->template_proj_data_sptr->get_proj_data_info_sptr(),
+    ProjDataInMemory tmp(this->template_exam_info_sptr,
+                         this->template_proj_data_info_sptr,
                          /* initialise*/ false);
     tmp.fill(*this->output_proj_data_sptr);
   }
@@ -211,8 +288,8 @@ public:
   //! copy from mem_proj_data_sptr to new Interfile file
   void copy_proj_data_mem_to_file()
   {
-    ProjDataInterfile tmp(this->template_proj_data_sptr->get_exam_info_sptr(),
-                          this->template_proj_data_sptr->get_proj_data_info_sptr(),
+    ProjDataInterfile tmp(this->template_exam_info_sptr,
+                          this->template_proj_data_info_sptr,
                           "my_timings_copy.hs");
     tmp.fill(*this->mem_proj_data_sptr);
   }
@@ -220,8 +297,8 @@ public:
   //! copy from output_proj_data_sptr to memory object
   void copy_proj_data_mem_to_mem()
   {
-    ProjDataInMemory tmp(this->template_proj_data_sptr->get_exam_info_sptr(),
-                         this->template_proj_data_sptr->get_proj_data_info_sptr(),
+    ProjDataInMemory tmp(this->template_exam_info_sptr,
+                         this->template_proj_data_info_sptr,
                          /* initialise*/ false);
     tmp.fill(*this->mem_proj_data_sptr);
   }
@@ -238,7 +315,7 @@ public:
 
   void projector_setup()
   {
-    this->projectors_sptr->set_up(this->template_proj_data_sptr->get_proj_data_info_sptr(), this->image_sptr);
+    this->projectors_sptr->set_up(this->template_proj_data_info_sptr, this->image_sptr);
   }
 
   void forward_file()
@@ -258,6 +335,44 @@ public:
     this->projectors_sptr->get_back_projector_sptr()->back_project(*this->image_sptr, *this->mem_proj_data_sptr);
   }
 
+  //! Forward project segment 0 (central axial position only) with the matrix, 1 TOF bin at a time
+  void proj_matrix_TOF_bin_rows()
+  {
+    const ProjMatrixByBin& proj_matrix = *this->pmrt_projectors_sptr->get_proj_matrix_sptr();
+    const ProjDataInfo& proj_data_info = *this->template_proj_data_info_sptr;
+    ProjMatrixElemsForOneBin row;
+    for (int view_num = proj_data_info.get_min_view_num(); view_num <= proj_data_info.get_max_view_num(); ++view_num)
+      for (int tang_pos_num = proj_data_info.get_min_tangential_pos_num();
+           tang_pos_num <= proj_data_info.get_max_tangential_pos_num();
+           ++tang_pos_num)
+        for (int timing_pos_num = proj_data_info.get_min_tof_pos_num(); timing_pos_num <= proj_data_info.get_max_tof_pos_num();
+             ++timing_pos_num)
+          {
+            Bin bin(0, view_num, 0, tang_pos_num, timing_pos_num, 0.F);
+            proj_matrix.get_proj_matrix_elems_for_one_bin(row, bin);
+            row.forward_project(bin, *this->image_sptr);
+          }
+  }
+  //! Same as proj_matrix_TOF_bin_rows(), but using the geometric row and TOF kernel for all TOF bins
+  void proj_matrix_TOF_kernel()
+  {
+    const ProjMatrixByBin& proj_matrix = *this->pmrt_projectors_sptr->get_proj_matrix_sptr();
+    const ProjDataInfo& proj_data_info = *this->template_proj_data_info_sptr;
+    ProjMatrixElemsForOneBin row;
+    shared_ptr<const Array<2, float>> tof_kernel_sptr;
+    VectorWithOffset<float> tof_values(proj_data_info.get_min_tof_pos_num(), proj_data_info.get_max_tof_pos_num());
+    for (int view_num = proj_data_info.get_min_view_num(); view_num <= proj_data_info.get_max_view_num(); ++view_num)
+      for (int tang_pos_num = proj_data_info.get_min_tangential_pos_num();
+           tang_pos_num <= proj_data_info.get_max_tangential_pos_num();
+           ++tang_pos_num)
+        {
+          const Bin bin(0, view_num, 0, tang_pos_num, 0, 0.F);
+          proj_matrix.get_proj_matrix_elems_and_tof_kernel_for_one_bin(row, tof_kernel_sptr, bin);
+          tof_values.fill(0.F);
+          row.forward_project(tof_values, *this->image_sptr, *tof_kernel_sptr);
+        }
+  }
+
   void obj_func_set_up()
   {
     this->objective_function_sptr->set_up(this->image_sptr);
@@ -284,18 +399,112 @@ public:
     v += 2; // to avoid compiler warning about unused variable
     delete im;
   }
+
+  void norm_set_up()
+  {
+    if (this->normalisation_sptr->set_up(this->exam_info_sptr, this->template_proj_data_info_sptr) != Succeeded::yes)
+      error("set-up of normalisation failed");
+  }
+  void norm_apply()
+  {
+    this->normalisation_sptr->apply(*this->mem_proj_data_sptr);
+  }
+  void norm_undo()
+  {
+    this->normalisation_sptr->undo(*this->mem_proj_data_sptr);
+  }
+
+  //! SSRB of mem_proj_data_sptr to segment 0 in SSRB_proj_data_sptr
+  void SSRB_mem_to_mem()
+  {
+    SSRB(*this->SSRB_proj_data_sptr, *this->mem_proj_data_sptr);
+  }
+  //! FBP2D of SSRB_proj_data_sptr
+  void FBP2D()
+  {
+    FBP2DReconstruction reconstruction(this->SSRB_proj_data_sptr);
+    shared_ptr<DiscretisedDensity<3, float>> target_sptr(this->image_sptr->get_empty_copy());
+    if (reconstruction.set_up(target_sptr) != Succeeded::yes || reconstruction.reconstruct(target_sptr) != Succeeded::yes)
+      error("FBP2D reconstruction failed");
+  }
+  //! FORE of mem_proj_data_sptr, writing the result to file
+  void FORE()
+  {
+    FourierRebinning rebinning;
+    // FORE has no defaults for these, so use some small values (they hardly influence timings)
+    rebinning.set_kmin(2);
+    rebinning.set_wmin(2);
+    rebinning.set_deltamin(2);
+    rebinning.set_kc(2);
+    rebinning.set_input_proj_data_sptr(this->mem_proj_data_sptr);
+    rebinning.set_output_filename_prefix("my_timings_FORE");
+    if (rebinning.set_up() != Succeeded::yes || rebinning.rebin() != Succeeded::yes)
+      error("FORE failed");
+  }
+
+  void write_image()
+  {
+    std::string filename = "my_timings_image";
+    if (this->output_file_format_sptr->write_to_file(filename, *this->image_sptr) != Succeeded::yes)
+      error("Error writing " + filename);
+    this->written_image_filename = filename;
+  }
+  void read_image()
+  {
+    auto im = read_from_file<DiscretisedDensity<3, float>>(this->written_image_filename);
+  }
+
+  //! read all events in the list-mode file
+  void listmode_read_events()
+  {
+    this->listmode_data_sptr->reset();
+    shared_ptr<ListRecord> record_sptr = this->listmode_data_sptr->get_empty_record_sptr();
+    unsigned long num_records = 0;
+    while (this->listmode_data_sptr->get_next_record(*record_sptr) == Succeeded::yes)
+      ++num_records;
+    if (num_records == 0)
+      warning("stir_timings: no events in list-mode file");
+  }
+  void listmode_obj_func_set_up()
+  {
+    if (this->listmode_objective_function_sptr->set_up(this->image_sptr) != Succeeded::yes)
+      error("set-up of list-mode objective function failed");
+  }
+  void listmode_obj_func_grad_no_sens()
+  {
+    auto im = this->image_sptr->clone();
+    this->listmode_objective_function_sptr->compute_sub_gradient_without_penalty_plus_sensitivity(*im, *this->image_sptr, 0);
+    delete im;
+  }
 };
 
 void
 Timings::run_it(TimedFunction f, const std::string& item, const unsigned runs)
 {
-  this->start_timers(true);
-  for (unsigned r = runs; r != 0; --r)
-    (this->*f)();
-  this->stop_timers();
+  // some cases are not supported for every type of data (e.g. FORE), so just report and continue
+  try
+    {
+      this->start_timers(true);
+      for (unsigned r = runs; r != 0; --r)
+        (this->*f)();
+      this->stop_timers();
+    }
+  catch (const std::exception& e)
+    {
+      this->stop_timers();
+      // write to std::cerr, as warnings are not shown with the verbosity used here
+      std::cerr << "stir_timings: " << item << " failed and will not be reported:\n" << e.what() << std::endl;
+      return;
+    }
+  const Result result{ item,
+                       this->num_threads,
+                       runs,
+                       this->get_CPU_timer_value() / runs * 1000,
+                       this->get_wall_clock_timer_value() / runs * 1000 };
+  this->results.push_back(result);
   std::cout << name << '\t' << std::setw(32) << std::left << item << '\t' << std::fixed << std::setprecision(3) << std::setw(24)
-            << std::right << this->get_CPU_timer_value() / runs * 1000 << '\t' << std::fixed << std::setprecision(3)
-            << std::setw(24) << std::right << this->get_wall_clock_timer_value() / runs * 1000 << std::endl;
+            << std::right << result.CPU_time_in_ms << '\t' << std::fixed << std::setprecision(3) << std::setw(24) << std::right
+            << result.wall_clock_time_in_ms << '\t' << result.num_threads << std::endl;
 }
 
 void
@@ -313,6 +522,31 @@ Timings::run_projectors(const std::string& prefix, const shared_ptr<ProjectorByB
   this->run_it(&Timings::obj_func_set_up, prefix + "_LogLik set_up", 1);
   this->run_it(&Timings::obj_func_grad_no_sens, prefix + "_LogLik grad_no_sens", 1);
 }
+
+void
+Timings::run_prior(const std::string& prefix,
+                   const shared_ptr<GeneralisedPrior<DiscretisedDensity<3, float>>>& prior_sptr,
+                   const unsigned runs)
+{
+  this->prior_sptr = prior_sptr;
+  this->prior_sptr->set_up(this->image_sptr);
+  this->run_it(&Timings::prior_value, prefix + "_value", runs);
+  this->run_it(&Timings::prior_grad, prefix + "_grad", runs);
+  this->prior_sptr = nullptr;
+}
+
+void
+Timings::run_image_IO(const std::string& prefix,
+                      const shared_ptr<OutputFileFormat<DiscretisedDensity<3, float>>>& output_file_format_sptr,
+                      const unsigned runs)
+{
+  this->output_file_format_sptr = output_file_format_sptr;
+  this->run_it(&Timings::write_image, prefix + "_write_image", runs);
+  if (!this->written_image_filename.empty())
+    this->run_it(&Timings::read_image, prefix + "_read_image", runs);
+  this->written_image_filename.clear();
+  this->output_file_format_sptr = nullptr;
+}
 void
 Timings::run_all(const unsigned runs)
 {
@@ -322,9 +556,9 @@ Timings::run_all(const unsigned runs)
   if (!this->skip_BB)
     {
       this->mem_proj_data_sptr2
-          = std::make_shared<ProjDataInMemory>(this->exam_info_sptr, this->template_proj_data_sptr->get_proj_data_info_sptr());
-      this->v1.resize(this->template_proj_data_sptr->size_all());
-      this->v2.resize(this->template_proj_data_sptr->size_all());
+          = std::make_shared<ProjDataInMemory>(this->exam_info_sptr, this->template_proj_data_info_sptr);
+      this->v1.resize(this->template_proj_data_info_sptr->size_all());
+      this->v2.resize(this->template_proj_data_info_sptr->size_all());
       this->run_it(&Timings::copy_image, "copy_image", runs * 20);
       this->run_it(&Timings::copy_add_image, "copy_add_image", runs * 20);
       this->run_it(&Timings::copy_mult_image, "copy_mult_image", runs * 20);
@@ -344,11 +578,54 @@ Timings::run_all(const unsigned runs)
       this->run_it(&Timings::copy_add_proj_data_mem, "copy_add_proj_data_mem", runs * 2);
       this->run_it(&Timings::copy_mult_proj_data_mem, "copy_mult_proj_data_mem", runs * 2);
     }
+  if (!this->skip_IO)
+    {
+      this->run_image_IO("Interfile", std::make_shared<InterfileOutputFileFormat>(), runs * 2);
+#ifdef HAVE_ITK
+      auto ITK_output_file_format_sptr = std::make_shared<ITKOutputFileFormat>();
+      ITK_output_file_format_sptr->default_extension = ".nii";
+      this->run_image_IO("ITK_nifti", ITK_output_file_format_sptr, runs * 2);
+#endif
+    }
+  if (!this->skip_norm)
+    {
+      auto norm_proj_data_sptr
+          = std::make_shared<ProjDataInMemory>(this->exam_info_sptr, this->template_proj_data_info_sptr, /* initialise*/ false);
+      norm_proj_data_sptr->fill(2.F);
+      this->normalisation_sptr = std::make_shared<BinNormalisationFromProjData>(norm_proj_data_sptr);
+      this->run_it(&Timings::norm_set_up, "norm_from_projdata_set_up", 1);
+      this->run_it(&Timings::norm_apply, "norm_from_projdata_apply", runs * 2);
+      this->run_it(&Timings::norm_undo, "norm_from_projdata_undo", runs * 2);
+      this->normalisation_sptr.reset();
+    }
+  if (!this->skip_rebinning)
+    {
+      const int num_segments = this->template_proj_data_info_sptr->get_num_segments();
+      shared_ptr<const ProjDataInfo> SSRB_proj_data_info_sptr(SSRB(*this->template_proj_data_info_sptr, num_segments));
+      this->SSRB_proj_data_sptr = std::make_shared<ProjDataInMemory>(this->exam_info_sptr, SSRB_proj_data_info_sptr);
+      this->run_it(&Timings::SSRB_mem_to_mem, "SSRB_mem_to_mem", runs);
+      this->run_it(&Timings::FBP2D, "FBP2D", runs);
+      this->SSRB_proj_data_sptr.reset();
+      this->run_it(&Timings::FORE, "FORE", 1);
+    }
   this->objective_function_sptr.reset(new PoissonLogLikelihoodWithLinearModelForMeanAndProjData<DiscretisedDensity<3, float>>);
   this->objective_function_sptr->set_proj_data_sptr(this->mem_proj_data_sptr);
   // this->objective_function.set_num_subsets(proj_data_sptr->get_num_views()/2);
   if (!this->skip_PMRT)
     {
+      if (this->template_proj_data_info_sptr->is_tof_data())
+        {
+          // compare getting matrix rows for every TOF bin with the geometric row and TOF kernel, with an empty
+          // ("first") and filled cache
+          this->projectors_sptr = this->pmrt_projectors_sptr;
+          this->projector_setup();
+          ProjMatrixByBin& proj_matrix = *this->pmrt_projectors_sptr->get_proj_matrix_sptr();
+          this->run_it(&Timings::proj_matrix_TOF_bin_rows, "PMRT_matrix_TOF_bin_rows_first", 1);
+          this->run_it(&Timings::proj_matrix_TOF_bin_rows, "PMRT_matrix_TOF_bin_rows", runs);
+          proj_matrix.clear_cache();
+          this->run_it(&Timings::proj_matrix_TOF_kernel, "PMRT_matrix_TOF_kernel_first", 1);
+          this->run_it(&Timings::proj_matrix_TOF_kernel, "PMRT_matrix_TOF_kernel", runs);
+        }
       this->run_projectors("PMRT", this->pmrt_projectors_sptr, 1);
     }
 #ifdef STIR_WITH_Parallelproj_PROJECTOR
@@ -363,39 +640,93 @@ Timings::run_all(const unsigned runs)
     }
   // write_to_file("my_timings_backproj.hv", *this->image_sptr);
 
+  if (!this->listmode_filename.empty())
+    {
+      this->listmode_data_sptr = read_from_file<ListModeData>(this->listmode_filename);
+      this->run_it(&Timings::listmode_read_events, "LM_read_events", runs);
+      // note: set_up includes computation of the sensitivity
+      this->listmode_objective_function_sptr = std::make_shared<
+          PoissonLogLikelihoodWithLinearModelForMeanAndListModeDataWithProjMatrixByBin<DiscretisedDensity<3, float>>>();
+      this->listmode_objective_function_sptr->set_input_data(this->listmode_data_sptr);
+      this->listmode_objective_function_sptr->set_proj_matrix(this->pmrt_projectors_sptr->get_proj_matrix_sptr());
+      this->run_it(&Timings::listmode_obj_func_set_up, "PMRT_LM_LogLik set_up", 1);
+      this->run_it(&Timings::listmode_obj_func_grad_no_sens, "PMRT_LM_LogLik grad_no_sens", 1);
+      this->listmode_objective_function_sptr.reset();
+      this->listmode_data_sptr.reset();
+    }
+
   if (!skip_priors)
     {
+      this->run_prior("QP", std::make_shared<QuadraticPrior<float>>(false, 1.F), runs * 10);
+      this->run_prior("Logcosh", std::make_shared<LogcoshPrior<float>>(false, 1.F, 1.F), runs * 10);
+      this->run_prior("RDP", std::make_shared<RelativeDifferencePrior<float>>(false, 1.F, 2.F, 0.1F), runs * 10);
       {
-        this->prior_sptr = std::make_shared<RelativeDifferencePrior<float>>(false, 1.F, 2.F, 0.1F);
-        this->prior_sptr->set_up(this->image_sptr);
-        this->run_it(&Timings::prior_value, "RDP_value", runs * 10);
-        this->run_it(&Timings::prior_grad, "RDP_grad", runs * 10);
-        this->prior_sptr = nullptr;
+        // use the image itself as anatomical image
+        auto PLS_sptr = std::make_shared<PLSPrior<float>>(false, 1.F);
+        PLS_sptr->set_anatomical_image_sptr(shared_ptr<const DiscretisedDensity<3, float>>(this->image_sptr->clone()));
+        this->run_prior("PLS", PLS_sptr, runs * 10);
       }
 #ifdef STIR_WITH_CUDA
-      {
-        this->prior_sptr = std::make_shared<CudaRelativeDifferencePrior<float>>(false, 1.F, 2.F, 0.1F);
-        this->prior_sptr->set_up(this->image_sptr);
-        this->run_it(&Timings::prior_value, "Cuda_RDP_value", runs * 30);
-        this->run_it(&Timings::prior_grad, "Cuda_RDP_grad", runs * 30);
-        this->prior_sptr = nullptr;
-      }
+      this->run_prior("Cuda_RDP", std::make_shared<CudaRelativeDifferencePrior<float>>(false, 1.F, 2.F, 0.1F), runs * 30);
 #endif
     }
 }
 
+static std::string
+JSON_escape(const std::string& str)
+{
+  std::string result;
+  for (const char c : str)
+    {
+      if (c == '"' || c == '\\')
+        result += '\\';
+      result += c;
+    }
+  return result;
+}
+
+void
+Timings::write_results_as_JSON(const std::string& filename) const
+{
+  std::ofstream s(filename.c_str());
+  if (!s)
+    error("Error opening " + filename + " for writing");
+  const ProjDataInfo& proj_data_info = *this->template_proj_data_info_sptr;
+  s << "{\n  \"name\": \"" << JSON_escape(this->name) << "\",\n"
+    << "  \"configuration\": {\n"
+    << "    \"scanner\": \"" << JSON_escape(proj_data_info.get_scanner_ptr()->get_name()) << "\",\n"
+    << "    \"num_segments\": " << proj_data_info.get_num_segments() << ",\n"
+    << "    \"num_sinograms\": " << proj_data_info.get_num_sinograms() << ",\n"
+    << "    \"num_views\": " << proj_data_info.get_num_views() << ",\n"
+    << "    \"num_tangential_poss\": " << proj_data_info.get_num_tangential_poss() << ",\n"
+    << "    \"num_tof_bins\": " << proj_data_info.get_num_tof_poss() << "\n"
+    << "  },\n"
+    << "  \"results\": [";
+  s << std::fixed << std::setprecision(3);
+  for (std::size_t i = 0; i < this->results.size(); ++i)
+    {
+      const Result& result = this->results[i];
+      s << (i == 0 ? "\n" : ",\n") << "    {\"case\": \"" << JSON_escape(result.item) << "\", \"num_threads\": "
+        << result.num_threads << ", \"runs\": " << result.runs << ", \"CPU_time_in_ms\": " << result.CPU_time_in_ms
+        << ", \"wall_clock_time_in_ms\": " << result.wall_clock_time_in_ms << "}";
+    }
+  s << "\n  ]\n}\n";
+  if (!s)
+    error("Error writing " + filename);
+}
+
 void
 Timings::init()
 {
 
-  if (!this->template_proj_data_sptr)
+  if (!this->template_proj_data_info_sptr)
     print_usage_and_exit();
 
   if (!image_sptr)
     {
-      this->exam_info_sptr = this->template_proj_data_sptr->get_exam_info().create_shared_clone();
-      this->image_sptr = std::make_shared<VoxelsOnCartesianGrid<float>>(
-          this->exam_info_sptr, *this->template_proj_data_sptr->get_proj_data_info_sptr());
+      this->exam_info_sptr = std::make_shared<ExamInfo>(*this->template_exam_info_sptr);
+      this->image_sptr
+          = std::make_shared<VoxelsOnCartesianGrid<float>>(this->exam_info_sptr, *this->template_proj_data_info_sptr);
       this->image_sptr->fill(1.F);
     }
   else
@@ -404,20 +735,19 @@ Timings::init()
       this->exam_info_sptr = this->image_sptr->get_exam_info().create_shared_clone();
 
       if (this->image_sptr->get_exam_info().imaging_modality.is_unknown()
-          && this->template_proj_data_sptr->get_exam_info().imaging_modality.is_known())
+          && this->template_exam_info_sptr->imaging_modality.is_known())
         {
-          this->exam_info_sptr->imaging_modality = this->template_proj_data_sptr->get_exam_info().imaging_modality;
+          this->exam_info_sptr->imaging_modality = this->template_exam_info_sptr->imaging_modality;
         }
-      else if (this->image_sptr->get_exam_info().imaging_modality
-               != this->template_proj_data_sptr->get_exam_info().imaging_modality)
+      else if (this->image_sptr->get_exam_info().imaging_modality != this->template_exam_info_sptr->imaging_modality)
         error("forward_project: Imaging modality should be the same for the image and the projection data");
 
-      if (this->template_proj_data_sptr->get_exam_info().has_energy_information())
+      if (this->template_exam_info_sptr->has_energy_information())
         {
           if (this->image_sptr->get_exam_info().has_energy_information())
             warning("Both image and template have energy information. Using the latter.");
 
-          this->exam_info_sptr->set_energy_information_from(this->template_proj_data_sptr->get_exam_info());
+          this->exam_info_sptr->set_energy_information_from(*this->template_exam_info_sptr);
         }
     }
 
@@ -425,11 +755,11 @@ Timings::init()
   {
     std::string output_filename = "my_timings.hs";
     this->output_proj_data_sptr = std::make_shared<ProjDataInterfile>(this->exam_info_sptr,
-                                                                      this->template_proj_data_sptr->get_proj_data_info_sptr(),
+                                                                      this->template_proj_data_info_sptr,
                                                                       output_filename,
                                                                       std::ios::in | std::ios::out | std::ios::trunc);
     this->mem_proj_data_sptr
-        = std::make_shared<ProjDataInMemory>(this->exam_info_sptr, this->template_proj_data_sptr->get_proj_data_info_sptr());
+        = std::make_shared<ProjDataInMemory>(this->exam_info_sptr, this->template_proj_data_info_sptr);
   }
 
   // projector set-up
@@ -460,13 +790,22 @@ main(int argc, char** argv)
   std::string image_filename;
   std::string template_proj_data_filename;
   std::string projector_par_filename;
+  std::string listmode_filename;
+  std::string json_filename;
+  std::string scanner_name;
+  int span = 11;
+  int view_mashing = 1;
+  int TOF_mashing = 0;
   std::string prog_name = argv[0];
   unsigned num_runs = 3;
-  int num_threads = get_default_num_threads();
+  std::vector<int> all_num_threads(1, get_default_num_threads());
   bool skip_BB = false;
   bool skip_PMRT = false;
   bool skip_PP = false;
   bool skip_priors = false;
+  bool skip_norm = false;
+  bool skip_rebinning = false;
+  bool skip_IO = false;
   // prefix output with this string
   std::string name;
 
@@ -483,7 +822,28 @@ main(int argc, char** argv)
       else if (!strcmp(argv[0], "--runs"))
         num_runs = std::atoi(argv[1]);
       else if (!strcmp(argv[0], "--threads"))
-        num_threads = std::atoi(argv[1]);
+        {
+          // comma-separated list
+          all_num_threads.clear();
+          std::istringstream str(argv[1]);
+          std::string num_threads;
+          while (std::getline(str, num_threads, ','))
+            all_num_threads.push_back(std::atoi(num_threads.c_str()));
+          if (all_num_threads.empty())
+            print_usage_and_exit();
+        }
+      else if (!strcmp(argv[0], "--scanner"))
+        scanner_name = argv[1];
+      else if (!strcmp(argv[0], "--span"))
+        span = std::atoi(argv[1]);
+      else if (!strcmp(argv[0], "--view-mashing"))
+        view_mashing = std::atoi(argv[1]);
+      else if (!strcmp(argv[0], "--TOF-mashing"))
+        TOF_mashing = std::atoi(argv[1]);
+      else if (!strcmp(argv[0], "--listmode"))
+        listmode_filename = argv[1];
+      else if (!strcmp(argv[0], "--json"))
+        json_filename = argv[1];
       else if (!strcmp(argv[0], "--skip-BB"))
         skip_BB = std::atoi(argv[1]) != 0;
       else if (!strcmp(argv[0], "--skip-PMRT"))
@@ -492,6 +852,12 @@ main(int argc, char** argv)
         skip_PP = std::atoi(argv[1]) != 0;
       else if (!strcmp(argv[0], "--skip-priors"))
         skip_priors = std::atoi(argv[1]) != 0;
+      else if (!strcmp(argv[0], "--skip-norm"))
+        skip_norm = std::atoi(argv[1]) != 0;
+      else if (!strcmp(argv[0], "--skip-rebinning"))
+        skip_rebinning = std::atoi(argv[1]) != 0;
+      else if (!strcmp(argv[0], "--skip-IO"))
+        skip_IO = std::atoi(argv[1]) != 0;
       else if (!strcmp(argv[0], "--projector_par_filename"))
         projector_par_filename = argv[1];
       else
@@ -503,15 +869,45 @@ main(int argc, char** argv)
   if (argc > 0)
     print_usage_and_exit();
 
-  set_num_threads(num_threads);
-  std::cerr << "Using " << num_threads << " threads.\n";
+  shared_ptr<const ExamInfo> template_exam_info_sptr;
+  shared_ptr<const ProjDataInfo> template_proj_data_info_sptr;
+  if (!scanner_name.empty())
+    {
+      if (!template_proj_data_filename.empty())
+        error("stir_timings: cannot use both --scanner and --template-projdata");
+      shared_ptr<Scanner> scanner_sptr(Scanner::get_scanner_from_name(scanner_name));
+      if (scanner_sptr->get_type() == Scanner::Unknown_scanner)
+        error("stir_timings: unknown scanner " + scanner_name);
+      if (view_mashing < 1 || scanner_sptr->get_max_num_views() % view_mashing != 0)
+        error("stir_timings: view mashing factor has to be a divisor of the number of views");
+      if (TOF_mashing > 0 && !scanner_sptr->is_tof_ready())
+        error("stir_timings: TOF mashing can only be used with a TOF-ready scanner");
+      template_proj_data_info_sptr = ProjDataInfo::construct_proj_data_info(scanner_sptr,
+                                                                            span,
+                                                                            scanner_sptr->get_num_rings() - 1,
+                                                                            scanner_sptr->get_max_num_views() / view_mashing,
+                                                                            scanner_sptr->get_max_num_non_arccorrected_bins(),
+                                                                            /* arc_corrected */ false,
+                                                                            TOF_mashing);
+      template_exam_info_sptr = std::make_shared<ExamInfo>(ImagingModality::PT);
+    }
+  else if (!template_proj_data_filename.empty())
+    {
+      shared_ptr<ProjData> template_proj_data_sptr = ProjData::read_from_file(template_proj_data_filename);
+      template_exam_info_sptr = template_proj_data_sptr->get_exam_info_sptr();
+      template_proj_data_info_sptr = template_proj_data_sptr->get_proj_data_info_sptr();
+    }
 
-  Timings timings(image_filename, template_proj_data_filename);
+  Timings timings(image_filename, template_exam_info_sptr, template_proj_data_info_sptr);
   timings.name = name;
   timings.skip_BB = skip_BB;
   timings.skip_PMRT = skip_PMRT;
   timings.skip_PP = skip_PP;
   timings.skip_priors = skip_priors;
+  timings.skip_norm = skip_norm;
+  timings.skip_rebinning = skip_rebinning;
+  timings.skip_IO = skip_IO;
+  timings.listmode_filename = listmode_filename;
   if (!projector_par_filename.empty())
     {
       KeyParser parser;
@@ -522,6 +918,14 @@ main(int argc, char** argv)
         error("Error parsing " + projector_par_filename);
     }
 
-  timings.run_all(num_runs);
+  for (const int num_threads : all_num_threads)
+    {
+      set_num_threads(num_threads);
+      std::cerr << "Using " << num_threads << " threads.\n";
+      timings.num_threads = num_threads;
+      timings.run_all(num_runs);
+    }
+  if (!json_filename.empty())
+    timings.write_results_as_JSON(json_filename);
   return EXIT_SUCCESS;
 }